@@ -35,8 +35,12 @@
 #include "core/io/image_loader.h"
 #include "core/io/resource_loader.h"
 #include "core/math/math_funcs.h"
+#include "core/math/simd.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/dictionary.h"
 
 #include <stdio.h>
@@ -465,47 +469,157 @@ int Image::get_mipmap_count() const {
 	}
 }
 
+// Rows are split into stripes of roughly this many pixels to be processed on the WorkerThreadPool.
+static constexpr uint32_t IMAGE_STRIPE_PIXELS = 1 << 16;
+
+template <typename F>
+struct ImageRowStripes {
+	const F *func = nullptr;
+	uint32_t rows = 0;
+	uint32_t stripe_rows = 0;
+};
+
+template <typename F>
+static void _process_row_stripe(void *p_userdata, uint32_t p_index) {
+	const ImageRowStripes<F> *stripes = static_cast<const ImageRowStripes<F> *>(p_userdata);
+	const uint32_t from = p_index * stripes->stripe_rows;
+	(*stripes->func)(from, MIN(from + stripes->stripe_rows, stripes->rows));
+}
+
+// Calls p_func(from, to) for ranges of rows covering [0, p_rows).
+// Large images are split in stripes which run in parallel, so p_func must only write to its own rows.
+// Images are processed inline on pool threads that can't wait for group tasks (see
+// WorkerThreadPool::can_wait_for_group_task()). Low priority tasks like threaded imports can.
+template <typename F>
+static void _process_rows(uint32_t p_rows, uint32_t p_row_pixels, const F &p_func) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const uint32_t stripe_rows = MAX(IMAGE_STRIPE_PIXELS / MAX(p_row_pixels, 1u), 1u);
+	const uint32_t stripe_count = (p_rows + stripe_rows - 1) / stripe_rows;
+
+	if (stripe_count <= 1 || pool == nullptr || pool->get_thread_count() <= 1 || !WorkerThreadPool::can_wait_for_group_task()) {
+		p_func(0, p_rows);
+		return;
+	}
+
+	ImageRowStripes<F> stripes;
+	stripes.func = &p_func;
+	stripes.rows = p_rows;
+	stripes.stripe_rows = stripe_rows;
+
+	WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&_process_row_stripe<F>, &stripes, stripe_count, -1, true, SNAME("ImageProcessRows"));
+	pool->wait_for_group_task_completion(group_task);
+}
+
+#if defined(SIMD_SSE2)
+
+// Same operations as the scalar RGBAF paths, on all four channels at once.
+static _FORCE_INLINE_ void _interpolate_bilinear_rgbaf(const float *p_00, const float *p_10, const float *p_01, const float *p_11, float p_x_frac, float p_y_frac, float *r_dst) {
+	const __m128 p00 = _mm_loadu_ps(p_00);
+	const __m128 p01 = _mm_loadu_ps(p_01);
+	const __m128 x_frac = _mm_set1_ps(p_x_frac);
+	const __m128 interp_up = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_10), p00), x_frac));
+	const __m128 interp_down = _mm_add_ps(p01, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_11), p01), x_frac));
+	_mm_storeu_ps(r_dst, _mm_add_ps(interp_up, _mm_mul_ps(_mm_sub_ps(interp_down, interp_up), _mm_set1_ps(p_y_frac))));
+}
+
+static _FORCE_INLINE_ void _average_4_rgbaf(const float *p_a, const float *p_b, const float *p_c, const float *p_d, float *r_dst) {
+	const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_loadu_ps(p_a), _mm_loadu_ps(p_b)), _mm_loadu_ps(p_c)), _mm_loadu_ps(p_d));
+	_mm_storeu_ps(r_dst, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+}
+
+// Averages 2x2 blocks of p_up and p_down into 4 RGBA8 pixels, rounding like Image::average_4_uint8().
+static _FORCE_INLINE_ void _average_2x2_rgba8_x4(const uint8_t *p_up, const uint8_t *p_down, uint8_t *r_dst) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	__m128i averages[2];
+	for (int i = 0; i < 2; i++) {
+		const __m128i up = _mm_loadu_si128((const __m128i *)(p_up + i * 16));
+		const __m128i down = _mm_loadu_si128((const __m128i *)(p_down + i * 16));
+		const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(up, zero), _mm_unpacklo_epi8(down, zero));
+		const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(up, zero), _mm_unpackhi_epi8(down, zero));
+		const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+		averages[i] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+	}
+	_mm_storeu_si128((__m128i *)r_dst, _mm_packus_epi16(averages[0], averages[1]));
+}
+
+#elif defined(SIMD_NEON)
+
+static _FORCE_INLINE_ void _interpolate_bilinear_rgbaf(const float *p_00, const float *p_10, const float *p_01, const float *p_11, float p_x_frac, float p_y_frac, float *r_dst) {
+	const float32x4_t p00 = vld1q_f32(p_00);
+	const float32x4_t p01 = vld1q_f32(p_01);
+	const float32x4_t x_frac = vdupq_n_f32(p_x_frac);
+	const float32x4_t interp_up = vaddq_f32(p00, vmulq_f32(vsubq_f32(vld1q_f32(p_10), p00), x_frac));
+	const float32x4_t interp_down = vaddq_f32(p01, vmulq_f32(vsubq_f32(vld1q_f32(p_11), p01), x_frac));
+	vst1q_f32(r_dst, vaddq_f32(interp_up, vmulq_f32(vsubq_f32(interp_down, interp_up), vdupq_n_f32(p_y_frac))));
+}
+
+static _FORCE_INLINE_ void _average_4_rgbaf(const float *p_a, const float *p_b, const float *p_c, const float *p_d, float *r_dst) {
+	const float32x4_t sum = vaddq_f32(vaddq_f32(vaddq_f32(vld1q_f32(p_a), vld1q_f32(p_b)), vld1q_f32(p_c)), vld1q_f32(p_d));
+	vst1q_f32(r_dst, vmulq_f32(sum, vdupq_n_f32(0.25f)));
+}
+
+static _FORCE_INLINE_ void _average_2x2_rgba8_x4(const uint8_t *p_up, const uint8_t *p_down, uint8_t *r_dst) {
+	uint16x4_t averages[4];
+	for (int i = 0; i < 2; i++) {
+		const uint8x16_t up = vld1q_u8(p_up + i * 16);
+		const uint8x16_t down = vld1q_u8(p_down + i * 16);
+		const uint16x8_t lo = vaddl_u8(vget_low_u8(up), vget_low_u8(down));
+		const uint16x8_t hi = vaddl_u8(vget_high_u8(up), vget_high_u8(down));
+		averages[i * 2 + 0] = vadd_u16(vget_low_u16(lo), vget_high_u16(lo));
+		averages[i * 2 + 1] = vadd_u16(vget_low_u16(hi), vget_high_u16(hi));
+	}
+	// Rounding shift, (sum + 2) >> 2.
+	const uint8x8_t first = vrshrn_n_u16(vcombine_u16(averages[0], averages[1]), 2);
+	const uint8x8_t second = vrshrn_n_u16(vcombine_u16(averages[2], averages[3]), 2);
+	vst1q_u8(r_dst, vcombine_u8(first, second));
+}
+
+#endif
+
 //using template generates perfectly optimized code due to constant expression reduction and unused variable removal present in all compilers
 template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
 static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
 	constexpr uint32_t max_bytes = MAX(read_bytes, write_bytes);
 
-	for (int y = 0; y < p_height; y++) {
-		for (int x = 0; x < p_width; x++) {
-			const uint8_t *rofs = &p_src[((y * p_width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
-			uint8_t *wofs = &p_dst[((y * p_width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
+	_process_rows(p_height, p_width, [&](uint32_t p_from, uint32_t p_to) {
+		for (int y = p_from; y < (int)p_to; y++) {
+			for (int x = 0; x < p_width; x++) {
+				const uint8_t *rofs = &p_src[((y * p_width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
+				uint8_t *wofs = &p_dst[((y * p_width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
 
-			uint8_t rgba[4] = { 0, 0, 0, 255 };
+				uint8_t rgba[4] = { 0, 0, 0, 255 };
 
-			if constexpr (read_gray) {
-				rgba[0] = rofs[0];
-				rgba[1] = rofs[0];
-				rgba[2] = rofs[0];
-			} else {
-				for (uint32_t i = 0; i < max_bytes; i++) {
-					rgba[i] = (i < read_bytes) ? rofs[i] : 0;
+				if constexpr (read_gray) {
+					rgba[0] = rofs[0];
+					rgba[1] = rofs[0];
+					rgba[2] = rofs[0];
+				} else {
+					for (uint32_t i = 0; i < max_bytes; i++) {
+						rgba[i] = (i < read_bytes) ? rofs[i] : 0;
+					}
 				}
-			}
 
-			if constexpr (read_alpha || write_alpha) {
-				rgba[3] = read_alpha ? rofs[read_bytes] : 255;
-			}
+				if constexpr (read_alpha || write_alpha) {
+					rgba[3] = read_alpha ? rofs[read_bytes] : 255;
+				}
 
-			if constexpr (write_gray) {
-				// REC.709
-				const uint8_t luminance = (13938U * rgba[0] + 46869U * rgba[1] + 4729U * rgba[2] + 32768U) >> 16U;
-				wofs[0] = luminance;
-			} else {
-				for (uint32_t i = 0; i < write_bytes; i++) {
-					wofs[i] = rgba[i];
+				if constexpr (write_gray) {
+					// REC.709
+					const uint8_t luminance = (13938U * rgba[0] + 46869U * rgba[1] + 4729U * rgba[2] + 32768U) >> 16U;
+					wofs[0] = luminance;
+				} else {
+					for (uint32_t i = 0; i < write_bytes; i++) {
+						wofs[i] = rgba[i];
+					}
 				}
-			}
 
-			if constexpr (write_alpha) {
-				wofs[write_bytes] = rgba[3];
+				if constexpr (write_alpha) {
+					wofs[write_bytes] = rgba[3];
+				}
 			}
 		}
-	}
+	});
 }
 
 void Image::convert(Format p_new_format) {
@@ -525,24 +639,24 @@ void Image::convert(Format p_new_format) {
 		ERR_FAIL_MSG("Cannot convert to <-> from compressed formats. Use compress() and decompress() instead.");
 
 	} else if (format > FORMAT_RGBA8 || p_new_format > FORMAT_RGBA8) {
-		//use put/set pixel which is slower but works with non byte formats
+		//use get/set color which is slower but works with non byte formats
 		Image new_img(width, height, mipmaps, p_new_format);
 
 		for (int mip = 0; mip < mipmap_count; mip++) {
-			Ref<Image> src_mip = get_image_from_mipmap(mip);
-			Ref<Image> new_mip = new_img.get_image_from_mipmap(mip);
-
-			for (int y = 0; y < src_mip->height; y++) {
-				for (int x = 0; x < src_mip->width; x++) {
-					new_mip->set_pixel(x, y, src_mip->get_pixel(x, y));
-				}
-			}
-
 			int mip_offset = 0;
 			int mip_size = 0;
-			new_img.get_mipmap_offset_and_size(mip, mip_offset, mip_size);
+			int mip_width = 0;
+			int mip_height = 0;
+			get_mipmap_offset_size_and_dimensions(mip, mip_offset, mip_size, mip_width, mip_height);
+
+			const uint8_t *rptr = data.ptr() + mip_offset;
+			uint8_t *wptr = new_img.data.ptrw() + new_img.get_mipmap_offset(mip);
 
-			memcpy(new_img.data.ptrw() + mip_offset, new_mip->data.ptr(), mip_size);
+			_process_rows(mip_height, mip_width, [&](uint32_t p_from, uint32_t p_to) {
+				for (uint32_t ofs = p_from * mip_width; ofs < p_to * mip_width; ofs++) {
+					new_img._set_color_at_ofs(wptr, ofs, _get_color_at_ofs(rptr, ofs));
+				}
+			});
 		}
 
 		_copy_internals_from(new_img);
@@ -686,84 +800,85 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	int height = p_src_height;
 	double xfac = (double)width / p_dst_width;
 	double yfac = (double)height / p_dst_height;
-	// coordinates of source points and coefficients
-	double ox, oy, dx, dy;
-	int ox1, oy1, ox2, oy2;
-	// destination pixel values
 	// width and height decreased by 1
 	int ymax = height - 1;
 	int xmax = width - 1;
-	// temporary pointer
-
-	for (uint32_t y = 0; y < p_dst_height; y++) {
-		// Y coordinates
-		oy = (double)y * yfac - 0.5f;
-		oy1 = (int)oy;
-		dy = oy - (double)oy1;
 
-		for (uint32_t x = 0; x < p_dst_width; x++) {
-			// X coordinates
-			ox = (double)x * xfac - 0.5f;
-			ox1 = (int)ox;
-			dx = ox - (double)ox1;
+	_process_rows(p_dst_height, p_dst_width, [&](uint32_t p_from, uint32_t p_to) {
+		// coordinates of source points and coefficients
+		double ox, oy, dx, dy;
+		int ox1, oy1, ox2, oy2;
 
-			// initial pixel value
+		for (uint32_t y = p_from; y < p_to; y++) {
+			// Y coordinates
+			oy = (double)y * yfac - 0.5f;
+			oy1 = (int)oy;
+			dy = oy - (double)oy1;
 
-			T *__restrict dst = ((T *)p_dst) + (y * p_dst_width + x) * CC;
+			for (uint32_t x = 0; x < p_dst_width; x++) {
+				// X coordinates
+				ox = (double)x * xfac - 0.5f;
+				ox1 = (int)ox;
+				dx = ox - (double)ox1;
 
-			double color[CC];
-			for (int i = 0; i < CC; i++) {
-				color[i] = 0;
-			}
+				// initial pixel value
 
-			for (int n = -1; n < 3; n++) {
-				// get Y coefficient
-				[[maybe_unused]] double k1 = _bicubic_interp_kernel(dy - (double)n);
+				T *__restrict dst = ((T *)p_dst) + (y * p_dst_width + x) * CC;
 
-				oy2 = oy1 + n;
-				if (oy2 < 0) {
-					oy2 = 0;
-				}
-				if (oy2 > ymax) {
-					oy2 = ymax;
+				double color[CC];
+				for (int i = 0; i < CC; i++) {
+					color[i] = 0;
 				}
 
-				for (int m = -1; m < 3; m++) {
-					// get X coefficient
-					[[maybe_unused]] double k2 = k1 * _bicubic_interp_kernel((double)m - dx);
+				for (int n = -1; n < 3; n++) {
+					// get Y coefficient
+					[[maybe_unused]] double k1 = _bicubic_interp_kernel(dy - (double)n);
 
-					ox2 = ox1 + m;
-					if (ox2 < 0) {
-						ox2 = 0;
+					oy2 = oy1 + n;
+					if (oy2 < 0) {
+						oy2 = 0;
 					}
-					if (ox2 > xmax) {
-						ox2 = xmax;
+					if (oy2 > ymax) {
+						oy2 = ymax;
 					}
 
-					// get pixel of original image
-					const T *__restrict p = ((T *)p_src) + (oy2 * p_src_width + ox2) * CC;
+					for (int m = -1; m < 3; m++) {
+						// get X coefficient
+						[[maybe_unused]] double k2 = k1 * _bicubic_interp_kernel((double)m - dx);
 
-					for (int i = 0; i < CC; i++) {
-						if constexpr (sizeof(T) == 2) { //half float
-							color[i] = Math::half_to_float(p[i]);
-						} else {
-							color[i] += p[i] * k2;
+						ox2 = ox1 + m;
+						if (ox2 < 0) {
+							ox2 = 0;
+						}
+						if (ox2 > xmax) {
+							ox2 = xmax;
+						}
+
+						// get pixel of original image
+						const T *__restrict p = ((T *)p_src) + (oy2 * p_src_width + ox2) * CC;
+
+						for (int i = 0; i < CC; i++) {
+							if constexpr (sizeof(T) == 2) { //half float
+								color[i] = Math::half_to_float(p[i]);
+							} else {
+								color[i] += p[i] * k2;
+							}
 						}
 					}
 				}
-			}
 
-			for (int i = 0; i < CC; i++) {
-				if constexpr (sizeof(T) == 1) { //byte
-					dst[i] = CLAMP(Math::fast_ftoi(color[i]), 0, 255);
-				} else if constexpr (sizeof(T) == 2) { //half float
-					dst[i] = Math::make_half_float(color[i]);
-				} else {
-					dst[i] = color[i];
+				for (int i = 0; i < CC; i++) {
+					if constexpr (sizeof(T) == 1) { //byte
+						dst[i] = CLAMP(Math::fast_ftoi(color[i]), 0, 255);
+					} else if constexpr (sizeof(T) == 2) { //half float
+						dst[i] = Math::make_half_float(color[i]);
+					} else {
+						dst[i] = color[i];
+					}
 				}
 			}
 		}
-	}
+	});
 }
 
 template <int CC, typename T>
@@ -775,22 +890,10 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 		FRAC_MASK = FRAC_LEN - 1
 	};
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
-		// Add 0.5 in order to interpolate based on pixel center
-		uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
-		// Calculate nearest src pixel center above current, and truncate to get y index
-		uint32_t src_yofs_up = src_yofs_up_fp >= FRAC_HALF ? (src_yofs_up_fp - FRAC_HALF) >> FRAC_BITS : 0;
-		uint32_t src_yofs_down = (src_yofs_up_fp + FRAC_HALF) >> FRAC_BITS;
-		if (src_yofs_down >= p_src_height) {
-			src_yofs_down = p_src_height - 1;
-		}
-		// Calculate distance to pixel center of src_yofs_up
-		uint32_t src_yofs_frac = src_yofs_up_fp & FRAC_MASK;
-		src_yofs_frac = src_yofs_frac >= FRAC_HALF ? src_yofs_frac - FRAC_HALF : src_yofs_frac + FRAC_HALF;
-
-		uint32_t y_ofs_up = src_yofs_up * p_src_width * CC;
-		uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
-
+	_process_rows(p_dst_height, p_dst_width, [&](uint32_t p_from, uint32_t p_to) {
+		// Horizontal sample positions are the same for every row.
+		LocalVector<uint32_t> x_samples;
+		x_samples.resize(p_dst_width * 3);
 		for (uint32_t j = 0; j < p_dst_width; j++) {
 			uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
 			uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
@@ -801,80 +904,115 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 			uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
 			src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
 
-			src_xofs_left *= CC;
-			src_xofs_right *= CC;
-
-			for (uint32_t l = 0; l < CC; l++) {
-				if constexpr (sizeof(T) == 1) { //uint8
-					uint32_t p00 = p_src[y_ofs_up + src_xofs_left + l] << FRAC_BITS;
-					uint32_t p10 = p_src[y_ofs_up + src_xofs_right + l] << FRAC_BITS;
-					uint32_t p01 = p_src[y_ofs_down + src_xofs_left + l] << FRAC_BITS;
-					uint32_t p11 = p_src[y_ofs_down + src_xofs_right + l] << FRAC_BITS;
-
-					uint32_t interp_up = p00 + (((p10 - p00) * src_xofs_frac) >> FRAC_BITS);
-					uint32_t interp_down = p01 + (((p11 - p01) * src_xofs_frac) >> FRAC_BITS);
-					uint32_t interp = interp_up + (((interp_down - interp_up) * src_yofs_frac) >> FRAC_BITS);
-					interp >>= FRAC_BITS;
-					p_dst[i * p_dst_width * CC + j * CC + l] = uint8_t(interp);
-				} else if constexpr (sizeof(T) == 2) { //half float
-
-					float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
-					float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
-					const T *src = ((const T *)p_src);
-					T *dst = ((T *)p_dst);
+			x_samples[j * 3 + 0] = src_xofs_left * CC;
+			x_samples[j * 3 + 1] = src_xofs_right * CC;
+			x_samples[j * 3 + 2] = src_xofs_frac;
+		}
 
-					float p00 = Math::half_to_float(src[y_ofs_up + src_xofs_left + l]);
-					float p10 = Math::half_to_float(src[y_ofs_up + src_xofs_right + l]);
-					float p01 = Math::half_to_float(src[y_ofs_down + src_xofs_left + l]);
-					float p11 = Math::half_to_float(src[y_ofs_down + src_xofs_right + l]);
+		for (uint32_t i = p_from; i < p_to; i++) {
+			// Add 0.5 in order to interpolate based on pixel center
+			uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
+			// Calculate nearest src pixel center above current, and truncate to get y index
+			uint32_t src_yofs_up = src_yofs_up_fp >= FRAC_HALF ? (src_yofs_up_fp - FRAC_HALF) >> FRAC_BITS : 0;
+			uint32_t src_yofs_down = (src_yofs_up_fp + FRAC_HALF) >> FRAC_BITS;
+			if (src_yofs_down >= p_src_height) {
+				src_yofs_down = p_src_height - 1;
+			}
+			// Calculate distance to pixel center of src_yofs_up
+			uint32_t src_yofs_frac = src_yofs_up_fp & FRAC_MASK;
+			src_yofs_frac = src_yofs_frac >= FRAC_HALF ? src_yofs_frac - FRAC_HALF : src_yofs_frac + FRAC_HALF;
+
+			uint32_t y_ofs_up = src_yofs_up * p_src_width * CC;
+			uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
+
+			for (uint32_t j = 0; j < p_dst_width; j++) {
+				const uint32_t src_xofs_left = x_samples[j * 3 + 0];
+				const uint32_t src_xofs_right = x_samples[j * 3 + 1];
+				const uint32_t src_xofs_frac = x_samples[j * 3 + 2];
+
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+				if constexpr (CC == 4 && sizeof(T) == 4) { //float
+					const float *src = ((const float *)p_src);
+					_interpolate_bilinear_rgbaf(&src[y_ofs_up + src_xofs_left], &src[y_ofs_up + src_xofs_right], &src[y_ofs_down + src_xofs_left], &src[y_ofs_down + src_xofs_right],
+							float(src_xofs_frac) / (1 << FRAC_BITS), float(src_yofs_frac) / (1 << FRAC_BITS), ((float *)p_dst) + (i * p_dst_width + j) * CC);
+					continue;
+				}
+#endif
 
-					float interp_up = p00 + (p10 - p00) * xofs_frac;
-					float interp_down = p01 + (p11 - p01) * xofs_frac;
-					float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
+				for (uint32_t l = 0; l < CC; l++) {
+					if constexpr (sizeof(T) == 1) { //uint8
+						uint32_t p00 = p_src[y_ofs_up + src_xofs_left + l] << FRAC_BITS;
+						uint32_t p10 = p_src[y_ofs_up + src_xofs_right + l] << FRAC_BITS;
+						uint32_t p01 = p_src[y_ofs_down + src_xofs_left + l] << FRAC_BITS;
+						uint32_t p11 = p_src[y_ofs_down + src_xofs_right + l] << FRAC_BITS;
+
+						uint32_t interp_up = p00 + (((p10 - p00) * src_xofs_frac) >> FRAC_BITS);
+						uint32_t interp_down = p01 + (((p11 - p01) * src_xofs_frac) >> FRAC_BITS);
+						uint32_t interp = interp_up + (((interp_down - interp_up) * src_yofs_frac) >> FRAC_BITS);
+						interp >>= FRAC_BITS;
+						p_dst[i * p_dst_width * CC + j * CC + l] = uint8_t(interp);
+					} else if constexpr (sizeof(T) == 2) { //half float
 
-					dst[i * p_dst_width * CC + j * CC + l] = Math::make_half_float(interp);
-				} else if constexpr (sizeof(T) == 4) { //float
+						float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
+						float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
+						const T *src = ((const T *)p_src);
+						T *dst = ((T *)p_dst);
 
-					float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
-					float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
-					const T *src = ((const T *)p_src);
-					T *dst = ((T *)p_dst);
+						float p00 = Math::half_to_float(src[y_ofs_up + src_xofs_left + l]);
+						float p10 = Math::half_to_float(src[y_ofs_up + src_xofs_right + l]);
+						float p01 = Math::half_to_float(src[y_ofs_down + src_xofs_left + l]);
+						float p11 = Math::half_to_float(src[y_ofs_down + src_xofs_right + l]);
 
-					float p00 = src[y_ofs_up + src_xofs_left + l];
-					float p10 = src[y_ofs_up + src_xofs_right + l];
-					float p01 = src[y_ofs_down + src_xofs_left + l];
-					float p11 = src[y_ofs_down + src_xofs_right + l];
+						float interp_up = p00 + (p10 - p00) * xofs_frac;
+						float interp_down = p01 + (p11 - p01) * xofs_frac;
+						float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
 
-					float interp_up = p00 + (p10 - p00) * xofs_frac;
-					float interp_down = p01 + (p11 - p01) * xofs_frac;
-					float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
+						dst[i * p_dst_width * CC + j * CC + l] = Math::make_half_float(interp);
+					} else if constexpr (sizeof(T) == 4) { //float
 
-					dst[i * p_dst_width * CC + j * CC + l] = interp;
+						float xofs_frac = float(src_xofs_frac) / (1 << FRAC_BITS);
+						float yofs_frac = float(src_yofs_frac) / (1 << FRAC_BITS);
+						const T *src = ((const T *)p_src);
+						T *dst = ((T *)p_dst);
+
+						float p00 = src[y_ofs_up + src_xofs_left + l];
+						float p10 = src[y_ofs_up + src_xofs_right + l];
+						float p01 = src[y_ofs_down + src_xofs_left + l];
+						float p11 = src[y_ofs_down + src_xofs_right + l];
+
+						float interp_up = p00 + (p10 - p00) * xofs_frac;
+						float interp_down = p01 + (p11 - p01) * xofs_frac;
+						float interp = interp_up + ((interp_down - interp_up) * yofs_frac);
+
+						dst[i * p_dst_width * CC + j * CC + l] = interp;
+					}
 				}
 			}
 		}
-	}
+	});
 }
 
 template <int CC, typename T>
 static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	for (uint32_t i = 0; i < p_dst_height; i++) {
-		uint32_t src_yofs = i * p_src_height / p_dst_height;
-		uint32_t y_ofs = src_yofs * p_src_width * CC;
+	_process_rows(p_dst_height, p_dst_width, [&](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			uint32_t src_yofs = i * p_src_height / p_dst_height;
+			uint32_t y_ofs = src_yofs * p_src_width * CC;
 
-		for (uint32_t j = 0; j < p_dst_width; j++) {
-			uint32_t src_xofs = j * p_src_width / p_dst_width;
-			src_xofs *= CC;
+			for (uint32_t j = 0; j < p_dst_width; j++) {
+				uint32_t src_xofs = j * p_src_width / p_dst_width;
+				src_xofs *= CC;
 
-			for (uint32_t l = 0; l < CC; l++) {
-				const T *src = ((const T *)p_src);
-				T *dst = ((T *)p_dst);
+				for (uint32_t l = 0; l < CC; l++) {
+					const T *src = ((const T *)p_src);
+					T *dst = ((T *)p_dst);
 
-				T p = src[y_ofs + src_xofs + l];
-				dst[i * p_dst_width * CC + j * CC + l] = p;
+					T p = src[y_ofs + src_xofs + l];
+					dst[i * p_dst_width * CC + j * CC + l] = p;
+				}
 			}
 		}
-	}
+	});
 }
 
 #define LANCZOS_TYPE 3
@@ -900,7 +1038,11 @@ static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict
 		float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
 		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+		// Create the kernels used by all the pixels of each column
+		LocalVector<int32_t> column_ranges;
+		column_ranges.resize(dst_width * 2);
+		LocalVector<float> column_kernels;
+		column_kernels.resize(dst_width * half_kernel * 2);
 
 		for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
 			// The corresponding point on the source image
@@ -908,39 +1050,48 @@ static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict
 			int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
 			int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
 
-			// Create the kernel used by all the pixels of the column
+			float *kernel = &column_kernels[buffer_x * half_kernel * 2];
 			for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
 				kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
 			}
 
-			for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+			column_ranges[buffer_x * 2 + 0] = start_x;
+			column_ranges[buffer_x * 2 + 1] = end_x;
+		}
 
-				for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-					float lanczos_val = kernel[target_x - start_x];
-					weight += lanczos_val;
+		_process_rows(src_height, MAX(src_width, dst_width), [&](uint32_t p_from, uint32_t p_to) {
+			for (int32_t buffer_y = p_from; buffer_y < (int32_t)p_to; buffer_y++) {
+				for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
+					const int32_t start_x = column_ranges[buffer_x * 2 + 0];
+					const int32_t end_x = column_ranges[buffer_x * 2 + 1];
+					const float *kernel = &column_kernels[buffer_x * half_kernel * 2];
 
-					const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
+					float pixel[CC] = { 0 };
+					float weight = 0;
 
-					for (uint32_t i = 0; i < CC; i++) {
-						if constexpr (sizeof(T) == 2) { //half float
-							pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
-						} else {
-							pixel[i] += src_data[i] * lanczos_val;
+					for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
+						float lanczos_val = kernel[target_x - start_x];
+						weight += lanczos_val;
+
+						const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
+
+						for (uint32_t i = 0; i < CC; i++) {
+							if constexpr (sizeof(T) == 2) { //half float
+								pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
+							} else {
+								pixel[i] += src_data[i] * lanczos_val;
+							}
 						}
 					}
-				}
 
-				float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
+					float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
+					for (uint32_t i = 0; i < CC; i++) {
+						dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
+					}
 				}
 			}
-		}
-
-		memdelete_arr(kernel);
+		});
 	} // End of first pass
 
 	{ // SECOND PASS (vertical + result)
@@ -950,49 +1101,51 @@ static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict
 		float scale_factor = MAX(y_scale, 1);
 		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+		_process_rows(dst_height, dst_width, [&](uint32_t p_from, uint32_t p_to) {
+			float *kernel = memnew_arr(float, half_kernel * 2);
 
-		for (int32_t dst_y = 0; dst_y < dst_height; dst_y++) {
-			float buffer_y = (dst_y + 0.5f) * y_scale;
-			int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
-			int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
+			for (int32_t dst_y = p_from; dst_y < (int32_t)p_to; dst_y++) {
+				float buffer_y = (dst_y + 0.5f) * y_scale;
+				int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
+				int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
 
-			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-				kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
-			}
+				for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+					kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
+				}
 
-			for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+				for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
+					float pixel[CC] = { 0 };
+					float weight = 0;
 
-				for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-					float lanczos_val = kernel[target_y - start_y];
-					weight += lanczos_val;
+					for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+						float lanczos_val = kernel[target_y - start_y];
+						weight += lanczos_val;
 
-					float *buffer_data = ((float *)buffer) + (target_y * dst_width + dst_x) * CC;
+						float *buffer_data = ((float *)buffer) + (target_y * dst_width + dst_x) * CC;
 
-					for (uint32_t i = 0; i < CC; i++) {
-						pixel[i] += buffer_data[i] * lanczos_val;
+						for (uint32_t i = 0; i < CC; i++) {
+							pixel[i] += buffer_data[i] * lanczos_val;
+						}
 					}
-				}
 
-				T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
+					T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					pixel[i] /= weight;
-
-					if constexpr (sizeof(T) == 1) { //byte
-						dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
-					} else if constexpr (sizeof(T) == 2) { //half float
-						dst_data[i] = Math::make_half_float(pixel[i]);
-					} else { // float
-						dst_data[i] = pixel[i];
+					for (uint32_t i = 0; i < CC; i++) {
+						pixel[i] /= weight;
+
+						if constexpr (sizeof(T) == 1) { //byte
+							dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
+						} else if constexpr (sizeof(T) == 2) { //half float
+							dst_data[i] = Math::make_half_float(pixel[i]);
+						} else { // float
+							dst_data[i] = pixel[i];
+						}
 					}
 				}
 			}
-		}
 
-		memdelete_arr(kernel);
+			memdelete_arr(kernel);
+		});
 	} // End of second pass
 
 	memdelete_arr(buffer);
@@ -1676,27 +1829,49 @@ static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint3
 	int right_step = (p_width == 1) ? 0 : CC;
 	int down_step = (p_height == 1) ? 0 : (p_width * CC);
 
-	for (uint32_t i = 0; i < dst_h; i++) {
-		const Component *rup_ptr = &p_src[i * 2 * down_step];
-		const Component *rdown_ptr = rup_ptr + down_step;
-		Component *dst_ptr = &p_dst[i * dst_w * CC];
-		uint32_t count = dst_w;
-
-		while (count) {
-			count--;
-			for (int j = 0; j < CC; j++) {
-				average_func(dst_ptr[j], rup_ptr[j], rup_ptr[j + right_step], rdown_ptr[j], rdown_ptr[j + right_step]);
+	_process_rows(dst_h, dst_w, [&](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			const Component *rup_ptr = &p_src[i * 2 * down_step];
+			const Component *rdown_ptr = rup_ptr + down_step;
+			Component *dst_ptr = &p_dst[i * dst_w * CC];
+			uint32_t count = dst_w;
+
+#if defined(SIMD_SSE2) || defined(SIMD_NEON)
+			if constexpr (CC == 4 && !renormalize && std::is_same_v<Component, uint8_t>) {
+				if (right_step) {
+					for (; count >= 4; count -= 4) {
+						_average_2x2_rgba8_x4(rup_ptr, rdown_ptr, dst_ptr);
+						dst_ptr += CC * 4;
+						rup_ptr += CC * 8;
+						rdown_ptr += CC * 8;
+					}
+				}
+			} else if constexpr (CC == 4 && !renormalize && std::is_same_v<Component, float>) {
+				for (; count; count--) {
+					_average_4_rgbaf(rup_ptr, rup_ptr + right_step, rdown_ptr, rdown_ptr + right_step, dst_ptr);
+					dst_ptr += CC;
+					rup_ptr += right_step * 2;
+					rdown_ptr += right_step * 2;
+				}
 			}
+#endif
 
-			if (renormalize) {
-				renormalize_func(dst_ptr);
-			}
+			while (count) {
+				count--;
+				for (int j = 0; j < CC; j++) {
+					average_func(dst_ptr[j], rup_ptr[j], rup_ptr[j + right_step], rdown_ptr[j], rdown_ptr[j + right_step]);
+				}
+
+				if (renormalize) {
+					renormalize_func(dst_ptr);
+				}
 
-			dst_ptr += CC;
-			rup_ptr += right_step * 2;
-			rdown_ptr += right_step * 2;
+				dst_ptr += CC;
+				rup_ptr += right_step * 2;
+				rdown_ptr += right_step * 2;
+			}
 		}
-	}
+	});
 }
 
 void Image::shrink_x2() {
@@ -2615,6 +2790,85 @@ int Image::get_image_mipmap_offset_and_dimensions(int p_width, int p_height, For
 	return _get_dst_image_size(p_width, p_height, p_format, mm, p_mipmap - 1, &r_w, &r_h);
 }
 
+// Bands handed out by compress_block_rows() hold at least this many blocks.
+static constexpr int IMAGE_BLOCK_BAND_MIN_BLOCKS = 4096;
+
+struct ImageBlockBands {
+	Image::BlockRowsFunc func = nullptr;
+	void *userdata = nullptr;
+	LocalVector<Image::BlockRows> bands;
+	SafeNumeric<uint32_t> next_band;
+};
+
+static void _compress_block_bands(void *p_userdata, uint32_t p_slot) {
+	ImageBlockBands *bands = static_cast<ImageBlockBands *>(p_userdata);
+	const uint32_t band_count = bands->bands.size();
+	for (uint32_t i = bands->next_band.postincrement(); i < band_count; i = bands->next_band.postincrement()) {
+		Image::BlockRows rows = bands->bands[i];
+		rows.slot = p_slot;
+		bands->func(bands->userdata, rows);
+	}
+}
+
+uint32_t Image::get_block_rows_slot_count() {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	return pool ? MAX(pool->get_thread_count(), 1) : 1;
+}
+
+// Splits every mipmap level of a p_width x p_height image in p_format into bands of block rows,
+// and calls p_func for each of them on the WorkerThreadPool. Bands are sized from the block count
+// of the whole image so all levels are compressed at once, and slots pick up the next band as soon
+// as they are done with the previous one, so expensive bands don't hold the others back.
+// Bands are compressed inline on pool threads that can't wait for group tasks.
+void Image::compress_block_rows(int p_width, int p_height, bool p_mipmaps, Format p_format, BlockRowsFunc p_func, void *p_userdata) {
+	ERR_FAIL_NULL(p_func);
+	ERR_FAIL_COND(p_width <= 0 || p_height <= 0);
+
+	const int block = get_format_block_size(p_format);
+	const int mipmaps = p_mipmaps ? get_image_required_mipmaps(p_width, p_height, p_format) : 0;
+	const uint32_t slot_count = get_block_rows_slot_count();
+
+	int64_t total_blocks = 0;
+	for (int i = 0; i <= mipmaps; i++) {
+		int w, h;
+		get_image_mipmap_offset_and_dimensions(p_width, p_height, p_format, i, w, h);
+		total_blocks += int64_t((w + block - 1) / block) * ((h + block - 1) / block);
+	}
+	const int64_t band_blocks = MAX(total_blocks / (slot_count * 4), int64_t(IMAGE_BLOCK_BAND_MIN_BLOCKS));
+
+	ImageBlockBands bands;
+	bands.func = p_func;
+	bands.userdata = p_userdata;
+
+	for (int i = 0; i <= mipmaps; i++) {
+		BlockRows rows;
+		rows.mipmap = i;
+		const int ofs = get_image_mipmap_offset_and_dimensions(p_width, p_height, p_format, i, rows.width, rows.height);
+		const int blocks_x = (rows.width + block - 1) / block;
+		const int block_rows = (rows.height + block - 1) / block;
+		const int row_size = get_image_data_size(rows.width, block, p_format);
+		const int band_rows = MAX(int(band_blocks / blocks_x), 1);
+
+		for (int from = 0; from < block_rows; from += band_rows) {
+			rows.block_row_from = from;
+			rows.block_row_to = MIN(from + band_rows, block_rows);
+			rows.dst_offset = ofs + from * row_size;
+			bands.bands.push_back(rows);
+		}
+	}
+
+	// Don't use more slots than there are full bands of work, as compressors may set up state for each slot.
+	const uint32_t task_count = MIN(slot_count, uint32_t((total_blocks + band_blocks - 1) / band_blocks));
+	if (task_count <= 1 || bands.bands.size() <= 1 || !WorkerThreadPool::can_wait_for_group_task()) {
+		_compress_block_bands(&bands, 0);
+		return;
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&_compress_block_bands, &bands, task_count, -1, true, SNAME("ImageCompressBlockRows"));
+	pool->wait_for_group_task_completion(group_task);
+}
+
 bool Image::is_compressed() const {
 	return format > FORMAT_RGBE9995;
 }
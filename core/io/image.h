@@ -357,6 +357,21 @@ public:
 	static int get_image_mipmap_offset(int p_width, int p_height, Format p_format, int p_mipmap);
 	static int get_image_mipmap_offset_and_dimensions(int p_width, int p_height, Format p_format, int p_mipmap, int &r_w, int &r_h);
 
+	// Band of block rows of one mipmap level, as handed to compressors by compress_block_rows().
+	struct BlockRows {
+		uint32_t slot = 0; // Below get_block_rows_slot_count(), never used by two threads at once.
+		int mipmap = 0;
+		int width = 0; // Size of the mipmap in pixels.
+		int height = 0;
+		int block_row_from = 0;
+		int block_row_to = 0;
+		int dst_offset = 0; // Offset in bytes of block_row_from in the compressed data.
+	};
+	typedef void (*BlockRowsFunc)(void *p_userdata, const BlockRows &p_rows);
+
+	static uint32_t get_block_rows_slot_count();
+	static void compress_block_rows(int p_width, int p_height, bool p_mipmaps, Format p_format, BlockRowsFunc p_func, void *p_userdata);
+
 	enum CompressMode {
 		COMPRESS_S3TC,
 		COMPRESS_ETC,
@@ -54,7 +54,7 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 	bool p_exists = points.lookup(p_id, found_pt);
 
 	if (!p_exists) {
-		Point *pt = memnew(Point);
+		Point *pt = point_allocator.alloc();
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
@@ -63,9 +63,12 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 		pt->closed_pass = 0;
 		pt->enabled = true;
 		points.set(p_id, pt);
+		_grid_add_point(pt);
 	} else {
+		_grid_remove_point(found_pt);
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
+		_grid_add_point(found_pt);
 	}
 }
 
@@ -82,7 +85,9 @@ void AStar3D::set_point_position(int64_t p_id, const Vector3 &p_pos) {
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
+	_grid_remove_point(p);
 	p->pos = p_pos;
+	_grid_add_point(p);
 }
 
 real_t AStar3D::get_point_weight_scale(int64_t p_id) const {
@@ -107,25 +112,30 @@ void AStar3D::remove_point(int64_t p_id) {
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't remove point. Point with id: %d doesn't exist.", p_id));
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-		Segment s(p_id, (*it.key));
+	_grid_remove_point(p);
+
+	for (Point *neighbor : p->neighbors) {
+		Segment s(p_id, neighbor->id);
 		segments.erase(s);
 
-		(*it.value)->neighbors.remove(p->id);
-		(*it.value)->unlinked_neighbours.remove(p->id);
+		neighbor->neighbors.erase(p);
+		neighbor->unlinked_neighbours.erase(p);
 	}
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = p->unlinked_neighbours.iter(); it.valid; it = p->unlinked_neighbours.next_iter(it)) {
-		Segment s(p_id, (*it.key));
+	for (Point *neighbor : p->unlinked_neighbours) {
+		Segment s(p_id, neighbor->id);
 		segments.erase(s);
 
-		(*it.value)->neighbors.remove(p->id);
-		(*it.value)->unlinked_neighbours.remove(p->id);
+		neighbor->neighbors.erase(p);
+		neighbor->unlinked_neighbours.erase(p);
 	}
 
-	memdelete(p);
+	point_allocator.free(p);
 	points.remove(p_id);
 	last_free_id = p_id;
+	if (points.get_num_elements() == 0) {
+		_clear_grid();
+	}
 }
 
 void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
@@ -139,16 +149,24 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 	bool to_exists = points.lookup(p_with_id, b);
 	ERR_FAIL_COND_MSG(!to_exists, vformat("Can't connect points. Point with id: %d doesn't exist.", p_with_id));
 
-	a->neighbors.set(b->id, b);
+	_connect_points(a, b, bidirectional);
+}
 
-	if (bidirectional) {
-		b->neighbors.set(a->id, a);
-	} else {
-		b->unlinked_neighbours.set(a->id, a);
+void AStar3D::_connect_points(Point *p_a, Point *p_b, bool p_bidirectional) {
+	if (p_a->neighbors.find(p_b) == -1) {
+		p_a->neighbors.push_back(p_b);
 	}
 
-	Segment s(p_id, p_with_id);
-	if (bidirectional) {
+	if (p_bidirectional) {
+		if (p_b->neighbors.find(p_a) == -1) {
+			p_b->neighbors.push_back(p_a);
+		}
+	} else if (p_b->unlinked_neighbours.find(p_a) == -1) {
+		p_b->unlinked_neighbours.push_back(p_a);
+	}
+
+	Segment s(p_a->id, p_b->id);
+	if (p_bidirectional) {
 		s.direction = Segment::BIDIRECTIONAL;
 	}
 
@@ -157,10 +175,12 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 		s.direction |= element->direction;
 		if (s.direction == Segment::BIDIRECTIONAL) {
 			// Both are neighbors of each other now
-			a->unlinked_neighbours.remove(b->id);
-			b->unlinked_neighbours.remove(a->id);
+			p_a->unlinked_neighbours.erase(p_b);
+			p_b->unlinked_neighbours.erase(p_a);
 		}
 		segments.remove(element);
+	} else {
+		_grid_add_segment(p_a, p_b);
 	}
 
 	segments.insert(s);
@@ -184,24 +204,26 @@ void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectio
 		// Erase the directions to be removed
 		s.direction = (element->direction & ~remove_direction);
 
-		a->neighbors.remove(b->id);
+		a->neighbors.erase(b);
 		if (bidirectional) {
-			b->neighbors.remove(a->id);
+			b->neighbors.erase(a);
 			if (element->direction != Segment::BIDIRECTIONAL) {
-				a->unlinked_neighbours.remove(b->id);
-				b->unlinked_neighbours.remove(a->id);
+				a->unlinked_neighbours.erase(b);
+				b->unlinked_neighbours.erase(a);
 			}
 		} else {
 			if (s.direction == Segment::NONE) {
-				b->unlinked_neighbours.remove(a->id);
-			} else {
-				a->unlinked_neighbours.set(b->id, b);
+				b->unlinked_neighbours.erase(a);
+			} else if (a->unlinked_neighbours.find(b) == -1) {
+				a->unlinked_neighbours.push_back(b);
 			}
 		}
 
 		segments.remove(element);
 		if (s.direction != Segment::NONE) {
 			segments.insert(s);
+		} else {
+			_grid_remove_segment(a, b);
 		}
 	}
 }
@@ -227,8 +249,8 @@ Vector<int64_t> AStar3D::get_point_connections(int64_t p_id) {
 
 	Vector<int64_t> point_list;
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-		point_list.push_back((*it.key));
+	for (const Point *neighbor : p->neighbors) {
+		point_list.push_back(neighbor->id);
 	}
 
 	return point_list;
@@ -245,10 +267,11 @@ bool AStar3D::are_points_connected(int64_t p_id, int64_t p_with_id, bool bidirec
 void AStar3D::clear() {
 	last_free_id = 0;
 	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		memdelete(*(it.value));
+		point_allocator.free(*(it.value));
 	}
 	segments.clear();
 	points.clear();
+	_clear_grid();
 }
 
 int64_t AStar3D::get_point_count() const {
@@ -265,26 +288,385 @@ void AStar3D::reserve_space(int64_t p_num_nodes) {
 	points.reserve(p_num_nodes);
 }
 
+void AStar3D::build_graph(const PackedVector3Array &p_positions, const PackedInt64Array &p_connections, bool p_bidirectional, const PackedFloat32Array &p_weight_scales) {
+	const int64_t point_count = p_positions.size();
+	const int64_t connection_count = p_connections.size() / 2;
+	ERR_FAIL_COND_MSG(p_connections.size() % 2 != 0, vformat("Connections must be pairs of point ids, got %d ids.", p_connections.size()));
+	ERR_FAIL_COND_MSG(!p_weight_scales.is_empty() && p_weight_scales.size() != point_count, vformat("Weight scales must be empty or one per point, got %d for %d points.", p_weight_scales.size(), point_count));
+
+	const int64_t *connections = p_connections.ptr();
+	for (int64_t i = 0; i < connection_count * 2; i += 2) {
+		ERR_FAIL_INDEX_MSG(connections[i], point_count, vformat("Can't connect points. Point with id: %d doesn't exist.", connections[i]));
+		ERR_FAIL_INDEX_MSG(connections[i + 1], point_count, vformat("Can't connect points. Point with id: %d doesn't exist.", connections[i + 1]));
+		ERR_FAIL_COND_MSG(connections[i] == connections[i + 1], vformat("Can't connect point with id: %d to itself.", connections[i]));
+	}
+	const float *weight_scales = p_weight_scales.ptr();
+	for (int64_t i = 0; i < p_weight_scales.size(); i++) {
+		ERR_FAIL_COND_MSG(weight_scales[i] < 0.0, vformat("Can't add a point with weight scale less than 0.0: %f.", weight_scales[i]));
+	}
+
+	clear();
+
+	// Count the connections of every point first, like the offsets of a compressed sparse row layout,
+	// so the neighbor lists are allocated once at their final size.
+	LocalVector<uint32_t> neighbor_counts;
+	LocalVector<uint32_t> unlinked_counts;
+	neighbor_counts.resize(point_count);
+	unlinked_counts.resize(point_count);
+	memset(neighbor_counts.ptr(), 0, sizeof(uint32_t) * point_count);
+	memset(unlinked_counts.ptr(), 0, sizeof(uint32_t) * point_count);
+	for (int64_t i = 0; i < connection_count * 2; i += 2) {
+		neighbor_counts[connections[i]]++;
+		if (p_bidirectional) {
+			neighbor_counts[connections[i + 1]]++;
+		} else {
+			unlinked_counts[connections[i + 1]]++;
+		}
+	}
+
+	if (point_count + point_count / 8 + 1 > points.get_capacity()) {
+		points.reserve(point_count + point_count / 8 + 1);
+	}
+	segments.reserve(connection_count);
+
+	LocalVector<Point *> new_points;
+	new_points.resize(point_count);
+	const Vector3 *positions = p_positions.ptr();
+	for (int64_t i = 0; i < point_count; i++) {
+		Point *pt = point_allocator.alloc();
+		pt->id = i;
+		pt->pos = positions[i];
+		pt->weight_scale = weight_scales ? weight_scales[i] : 1.0;
+		pt->enabled = true;
+		pt->neighbors.reserve(neighbor_counts[i]);
+		pt->unlinked_neighbours.reserve(unlinked_counts[i]);
+		points.set(i, pt);
+		new_points[i] = pt;
+	}
+
+	for (int64_t i = 0; i < connection_count * 2; i += 2) {
+		_connect_points(new_points[connections[i]], new_points[connections[i + 1]], p_bidirectional);
+	}
+
+	last_free_id = point_count;
+	_build_grid();
+}
+
+void AStar3D::_build_grid() {
+	_clear_grid();
+	grid_point_count = points.get_num_elements();
+	if (grid_point_count == 0) {
+		return;
+	}
+
+	bool first = true;
+	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		if (first) {
+			grid_bounds = AABB((*it.value)->pos, Vector3());
+			first = false;
+		} else {
+			grid_bounds.expand_to((*it.value)->pos);
+		}
+	}
+
+	// Size the cells for a few points each, over the axes the points spread along.
+	// Axes thinner than a cell do not spread the points, so they are left out and the cells sized again,
+	// otherwise nearly flat point sets get tiny cells and the queries walk through countless empty ones.
+	bool spread[3] = { true, true, true };
+	int axes = 0;
+	for (int pass = 0; pass < 3; pass++) {
+		real_t volume = 1.0;
+		axes = 0;
+		for (int i = 0; i < 3; i++) {
+			spread[i] = spread[i] && grid_bounds.size[i] > CMP_EPSILON;
+			if (spread[i]) {
+				volume *= grid_bounds.size[i];
+				axes++;
+			}
+		}
+		grid_cell_size = axes > 0 ? Math::pow(volume * GRID_POINTS_PER_CELL / grid_point_count, real_t(1.0) / axes) : 1.0;
+
+		bool thin_axis = false;
+		for (int i = 0; i < 3; i++) {
+			if (spread[i] && grid_bounds.size[i] < grid_cell_size) {
+				spread[i] = false;
+				thin_axis = true;
+			}
+		}
+		if (!thin_axis) {
+			break;
+		}
+	}
+
+	// Rounding up the cells along each axis can still add many more cells than points, keep them in proportion.
+	real_t cell_count = 1.0;
+	for (int i = 0; i < 3; i++) {
+		if (spread[i]) {
+			cell_count *= Math::floor(grid_bounds.size[i] / grid_cell_size) + 1;
+		}
+	}
+	const real_t max_cell_count = MAX(grid_point_count, (int64_t)64) * GRID_MAX_CELLS_PER_POINT;
+	if (axes > 0 && cell_count > max_cell_count) {
+		grid_cell_size *= Math::pow(cell_count / max_cell_count, real_t(1.0) / axes);
+	}
+	grid_cell_size = MAX(grid_cell_size, grid_bounds.get_longest_axis_size() * 2 / GRID_MAX_CELLS);
+	grid_cell_size = MAX(grid_cell_size, (real_t)CMP_EPSILON);
+	grid_origin = grid_bounds.position;
+	grid_max_cell_count = MAX(_get_grid_cell_count(), max_cell_count);
+
+	grid_points.reserve(grid_point_count / GRID_POINTS_PER_CELL);
+	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		Point *p = *(it.value);
+		p->grid_cell = _get_grid_cell(p->pos);
+		grid_points[p->grid_cell].push_back(p);
+	}
+
+	grid_segments.reserve(grid_points.size());
+	for (const Segment &E : segments) {
+		Point *from_point = nullptr, *to_point = nullptr;
+		points.lookup(E.key.first, from_point);
+		points.lookup(E.key.second, to_point);
+		_grid_add_segment(from_point, to_point);
+	}
+}
+
+void AStar3D::_clear_grid() {
+	grid_points.clear();
+	grid_segments.clear();
+	grid_long_segments.clear();
+	grid_cell_size = 0;
+	grid_point_count = 0;
+	grid_max_cell_count = 0;
+}
+
+real_t AStar3D::_get_grid_cell_count() const {
+	real_t cell_count = 1.0;
+	for (int i = 0; i < 3; i++) {
+		cell_count *= Math::floor(grid_bounds.size[i] / grid_cell_size) + 1;
+	}
+	return cell_count;
+}
+
+bool AStar3D::_is_grid_outgrown() const {
+	// Points far outside the bounds the cells were sized for leave the queries walking through many empty cells.
+	return points.get_num_elements() > grid_point_count * 2 + 64 || grid_bounds.get_longest_axis_size() > grid_cell_size * GRID_MAX_CELLS || _get_grid_cell_count() > grid_max_cell_count * 2;
+}
+
+void AStar3D::_grid_add_point(Point *p_point) {
+	if (grid_cell_size == 0) {
+		_build_grid();
+		return;
+	}
+
+	// Size the cells anew once the points outgrew them.
+	grid_bounds.expand_to(p_point->pos);
+	if (_is_grid_outgrown()) {
+		_build_grid();
+		return;
+	}
+
+	p_point->grid_cell = _get_grid_cell(p_point->pos);
+	grid_points[p_point->grid_cell].push_back(p_point);
+	for (Point *neighbor : p_point->neighbors) {
+		_grid_add_segment(p_point, neighbor);
+	}
+	for (Point *neighbor : p_point->unlinked_neighbours) {
+		_grid_add_segment(p_point, neighbor);
+	}
+}
+
+void AStar3D::_grid_remove_point(Point *p_point) {
+	if (grid_cell_size == 0) {
+		return;
+	}
+
+	for (Point *neighbor : p_point->neighbors) {
+		_grid_remove_segment(p_point, neighbor);
+	}
+	for (Point *neighbor : p_point->unlinked_neighbours) {
+		_grid_remove_segment(p_point, neighbor);
+	}
+
+	HashMap<Vector3i, LocalVector<Point *>>::Iterator E = grid_points.find(p_point->grid_cell);
+	ERR_FAIL_COND(!E);
+	const int64_t index = E->value.find(p_point);
+	ERR_FAIL_COND(index == -1);
+	E->value.remove_at_unordered(index);
+	if (E->value.is_empty()) {
+		grid_points.remove(E);
+	}
+}
+
+// Removes the pair p_a, p_b from a list of pairs, without keeping the order of the others.
+template <typename T>
+static bool _remove_pair_unordered(LocalVector<T> &r_pairs, const T &p_a, const T &p_b) {
+	for (uint32_t i = 0; i < r_pairs.size(); i += 2) {
+		if (r_pairs[i] == p_a && r_pairs[i + 1] == p_b) {
+			r_pairs[i] = r_pairs[r_pairs.size() - 2];
+			r_pairs[i + 1] = r_pairs[r_pairs.size() - 1];
+			r_pairs.resize(r_pairs.size() - 2);
+			return true;
+		}
+	}
+	return false;
+}
+
+void AStar3D::_grid_add_segment(Point *p_from, Point *p_to) {
+	if (grid_cell_size == 0) {
+		return;
+	}
+	if (p_from->id > p_to->id) {
+		SWAP(p_from, p_to); // Same order as the segment keys, so it can be found again.
+	}
+
+	const Vector3i cell_begin = p_from->grid_cell.min(p_to->grid_cell);
+	const Vector3i cell_end = p_from->grid_cell.max(p_to->grid_cell);
+	const Vector3i cells = cell_end - cell_begin + Vector3i(1, 1, 1);
+	if (int64_t(cells.x) * cells.y * cells.z > GRID_MAX_SEGMENT_CELLS) {
+		grid_long_segments.push_back(p_from);
+		grid_long_segments.push_back(p_to);
+		return;
+	}
+
+	for (int x = cell_begin.x; x <= cell_end.x; x++) {
+		for (int y = cell_begin.y; y <= cell_end.y; y++) {
+			for (int z = cell_begin.z; z <= cell_end.z; z++) {
+				LocalVector<Point *> &cell = grid_segments[Vector3i(x, y, z)];
+				cell.push_back(p_from);
+				cell.push_back(p_to);
+			}
+		}
+	}
+}
+
+void AStar3D::_grid_remove_segment(Point *p_from, Point *p_to) {
+	if (grid_cell_size == 0) {
+		return;
+	}
+	if (p_from->id > p_to->id) {
+		SWAP(p_from, p_to);
+	}
+
+	const Vector3i cell_begin = p_from->grid_cell.min(p_to->grid_cell);
+	const Vector3i cell_end = p_from->grid_cell.max(p_to->grid_cell);
+	const Vector3i cells = cell_end - cell_begin + Vector3i(1, 1, 1);
+	if (int64_t(cells.x) * cells.y * cells.z > GRID_MAX_SEGMENT_CELLS) {
+		const bool removed = _remove_pair_unordered(grid_long_segments, p_from, p_to);
+		ERR_FAIL_COND(!removed);
+		return;
+	}
+
+	for (int x = cell_begin.x; x <= cell_end.x; x++) {
+		for (int y = cell_begin.y; y <= cell_end.y; y++) {
+			for (int z = cell_begin.z; z <= cell_end.z; z++) {
+				HashMap<Vector3i, LocalVector<Point *>>::Iterator E = grid_segments.find(Vector3i(x, y, z));
+				ERR_FAIL_COND(!E);
+				const bool removed = _remove_pair_unordered(E->value, p_from, p_to);
+				ERR_FAIL_COND(!removed);
+				if (E->value.is_empty()) {
+					grid_segments.remove(E);
+				}
+			}
+		}
+	}
+}
+
+// Returns the range of rings around p_center that hold cells within the given cell bounds.
+static void _get_grid_rings(const Vector3i &p_center, const Vector3i &p_cell_begin, const Vector3i &p_cell_end, int &r_ring_begin, int &r_ring_end) {
+	r_ring_begin = 0;
+	r_ring_end = 0;
+	for (int i = 0; i < 3; i++) {
+		r_ring_begin = MAX(r_ring_begin, MAX(p_cell_begin[i] - p_center[i], p_center[i] - p_cell_end[i]));
+		r_ring_end = MAX(r_ring_end, MAX(p_center[i] - p_cell_begin[i], p_cell_end[i] - p_center[i]));
+	}
+}
+
+// Calls p_callback for the cells at Chebyshev distance p_ring from p_center, within the given cell bounds.
+template <typename F>
+static void _for_each_grid_ring_cell(const Vector3i &p_center, int p_ring, const Vector3i &p_cell_begin, const Vector3i &p_cell_end, F p_callback) {
+	const int x_begin = MAX(p_center.x - p_ring, p_cell_begin.x);
+	const int x_end = MIN(p_center.x + p_ring, p_cell_end.x);
+	const int y_begin = MAX(p_center.y - p_ring, p_cell_begin.y);
+	const int y_end = MIN(p_center.y + p_ring, p_cell_end.y);
+	const int z_begin = MAX(p_center.z - p_ring, p_cell_begin.z);
+	const int z_end = MIN(p_center.z + p_ring, p_cell_end.z);
+
+	for (int x = x_begin; x <= x_end; x++) {
+		const bool x_on_ring = Math::abs(x - p_center.x) == p_ring;
+		for (int y = y_begin; y <= y_end; y++) {
+			if (x_on_ring || Math::abs(y - p_center.y) == p_ring) {
+				for (int z = z_begin; z <= z_end; z++) {
+					p_callback(Vector3i(x, y, z));
+				}
+			} else {
+				// Inside the ring, only its two faces along z.
+				if (p_center.z - p_ring >= p_cell_begin.z) {
+					p_callback(Vector3i(x, y, p_center.z - p_ring));
+				}
+				if (p_ring > 0 && p_center.z + p_ring <= p_cell_end.z) {
+					p_callback(Vector3i(x, y, p_center.z + p_ring));
+				}
+			}
+		}
+	}
+}
+
 int64_t AStar3D::get_closest_point(const Vector3 &p_point, bool p_include_disabled) const {
 	int64_t closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		if (!p_include_disabled && !(*it.value)->enabled) {
-			continue; // Disabled points should not be considered.
+	// Keep the closest point's ID, and in case of multiple closest IDs,
+	// the smallest one (makes it deterministic).
+	auto consider_point = [&](const Point *p_candidate) {
+		if (!p_include_disabled && !p_candidate->enabled) {
+			return; // Disabled points should not be considered.
 		}
 
-		// Keep the closest point's ID, and in case of multiple closest IDs,
-		// the smallest one (makes it deterministic).
-		real_t d = p_point.distance_squared_to((*it.value)->pos);
-		int64_t id = *(it.key);
+		real_t d = p_point.distance_squared_to(p_candidate->pos);
 		if (d <= closest_dist) {
-			if (d == closest_dist && id > closest_id) { // Keep lowest ID.
-				continue;
+			if (d == closest_dist && p_candidate->id > closest_id) { // Keep lowest ID.
+				return;
 			}
 			closest_dist = d;
-			closest_id = id;
+			closest_id = p_candidate->id;
+		}
+	};
+
+	if (grid_cell_size == 0) {
+		return closest_id;
+	}
+
+	// Far from every point, the grid search would visit every cell anyway.
+	const Vector3 outside = (grid_bounds.position - p_point).max(p_point - grid_bounds.get_end()).max(Vector3());
+	if (outside.length() > grid_bounds.get_longest_axis_size()) {
+		for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+			consider_point(*(it.value));
 		}
+		return closest_id;
+	}
+
+	// Visit the cells in rings around the point, until no closer point can be in the next ring.
+	const Vector3i center = _get_grid_cell(p_point);
+	const Vector3i cell_begin = _get_grid_cell(grid_bounds.position);
+	const Vector3i cell_end = _get_grid_cell(grid_bounds.get_end());
+	int ring_begin = 0;
+	int ring_end = 0;
+	_get_grid_rings(center, cell_begin, cell_end, ring_begin, ring_end);
+
+	for (int ring = ring_begin; ring <= ring_end; ring++) {
+		// Every point in this ring or further is more than (ring - 1) cells away.
+		const real_t reach = (ring - 1) * grid_cell_size;
+		if (closest_id != -1 && reach > 0 && closest_dist < reach * reach) {
+			break;
+		}
+		_for_each_grid_ring_cell(center, ring, cell_begin, cell_end, [&](const Vector3i &p_cell) {
+			const LocalVector<Point *> *cell = grid_points.getptr(p_cell);
+			if (cell) {
+				for (const Point *candidate : *cell) {
+					consider_point(candidate);
+				}
+			}
+		});
 	}
 
 	return closest_id;
@@ -294,18 +676,14 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	real_t closest_dist = 1e20;
 	Vector3 closest_point;
 
-	for (const Segment &E : segments) {
-		Point *from_point = nullptr, *to_point = nullptr;
-		points.lookup(E.key.first, from_point);
-		points.lookup(E.key.second, to_point);
-
-		if (!(from_point->enabled && to_point->enabled)) {
-			continue;
+	auto consider_segment = [&](const Point *p_from_point, const Point *p_to_point) {
+		if (!(p_from_point->enabled && p_to_point->enabled)) {
+			return;
 		}
 
 		Vector3 segment[2] = {
-			from_point->pos,
-			to_point->pos,
+			p_from_point->pos,
+			p_to_point->pos,
 		};
 
 		Vector3 p = Geometry3D::get_closest_point_to_segment(p_point, segment);
@@ -314,6 +692,50 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 			closest_point = p;
 			closest_dist = d;
 		}
+	};
+
+	if (grid_cell_size == 0) {
+		return closest_point;
+	}
+
+	// Far from every point, the grid search would visit every cell anyway.
+	const Vector3 outside = (grid_bounds.position - p_point).max(p_point - grid_bounds.get_end()).max(Vector3());
+	if (outside.length() > grid_bounds.get_longest_axis_size()) {
+		for (const Segment &E : segments) {
+			Point *from_point = nullptr, *to_point = nullptr;
+			points.lookup(E.key.first, from_point);
+			points.lookup(E.key.second, to_point);
+			consider_segment(from_point, to_point);
+		}
+		return closest_point;
+	}
+
+	for (uint32_t i = 0; i < grid_long_segments.size(); i += 2) {
+		consider_segment(grid_long_segments[i], grid_long_segments[i + 1]);
+	}
+
+	// Visit the cells in rings around the point, until no closer segment can be in the next ring.
+	const Vector3i center = _get_grid_cell(p_point);
+	const Vector3i cell_begin = _get_grid_cell(grid_bounds.position);
+	const Vector3i cell_end = _get_grid_cell(grid_bounds.get_end());
+	int ring_begin = 0;
+	int ring_end = 0;
+	_get_grid_rings(center, cell_begin, cell_end, ring_begin, ring_end);
+
+	for (int ring = ring_begin; ring <= ring_end; ring++) {
+		// The closest position on every segment only found in this ring or further is more than (ring - 1) cells away.
+		const real_t reach = (ring - 1) * grid_cell_size;
+		if (reach > 0 && closest_dist < reach * reach) {
+			break;
+		}
+		_for_each_grid_ring_cell(center, ring, cell_begin, cell_end, [&](const Vector3i &p_cell) {
+			const LocalVector<Point *> *cell = grid_segments.getptr(p_cell);
+			if (cell) {
+				for (uint32_t i = 0; i < cell->size(); i += 2) {
+					consider_segment((*cell)[i], (*cell)[i + 1]);
+				}
+			}
+		});
 	}
 
 	return closest_point;
@@ -355,8 +777,7 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 		open_list.remove_at(open_list.size() - 1);
 		p->closed_pass = pass; // Mark the point as closed.
 
-		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-			Point *e = *(it.value); // The neighbor point.
+		for (Point *e : p->neighbors) { // The neighbor point.
 
 			if (!e->enabled || e->closed_pass == pass) {
 				continue;
@@ -572,6 +993,7 @@ void AStar3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_capacity"), &AStar3D::get_point_capacity);
 	ClassDB::bind_method(D_METHOD("reserve_space", "num_nodes"), &AStar3D::reserve_space);
 	ClassDB::bind_method(D_METHOD("clear"), &AStar3D::clear);
+	ClassDB::bind_method(D_METHOD("build_graph", "positions", "connections", "bidirectional", "weight_scales"), &AStar3D::build_graph, DEFVAL(true), DEFVAL(PackedFloat32Array()));
 
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_position", "include_disabled"), &AStar3D::get_closest_point, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_position_in_segment", "to_position"), &AStar3D::get_closest_position_in_segment);
@@ -666,6 +1088,17 @@ void AStar2D::reserve_space(int64_t p_num_nodes) {
 	astar.reserve_space(p_num_nodes);
 }
 
+void AStar2D::build_graph(const PackedVector2Array &p_positions, const PackedInt64Array &p_connections, bool p_bidirectional, const PackedFloat32Array &p_weight_scales) {
+	PackedVector3Array positions;
+	positions.resize(p_positions.size());
+	Vector3 *w = positions.ptrw();
+	const Vector2 *r = p_positions.ptr();
+	for (int64_t i = 0; i < p_positions.size(); i++) {
+		w[i] = Vector3(r[i].x, r[i].y, 0);
+	}
+	astar.build_graph(positions, p_connections, p_bidirectional, p_weight_scales);
+}
+
 int64_t AStar2D::get_closest_point(const Vector2 &p_point, bool p_include_disabled) const {
 	return astar.get_closest_point(Vector3(p_point.x, p_point.y, 0), p_include_disabled);
 }
@@ -852,8 +1285,7 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 		open_list.remove_at(open_list.size() - 1);
 		p->closed_pass = astar.pass; // Mark the point as closed.
 
-		for (OAHashMap<int64_t, AStar3D::Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-			AStar3D::Point *e = *(it.value); // The neighbor point.
+		for (AStar3D::Point *e : p->neighbors) { // The neighbor point.
 
 			if (!e->enabled || e->closed_pass == astar.pass) {
 				continue;
@@ -911,6 +1343,7 @@ void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_capacity"), &AStar2D::get_point_capacity);
 	ClassDB::bind_method(D_METHOD("reserve_space", "num_nodes"), &AStar2D::reserve_space);
 	ClassDB::bind_method(D_METHOD("clear"), &AStar2D::clear);
+	ClassDB::bind_method(D_METHOD("build_graph", "positions", "connections", "bidirectional", "weight_scales"), &AStar2D::build_graph, DEFVAL(true), DEFVAL(PackedFloat32Array()));
 
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_position", "include_disabled"), &AStar2D::get_closest_point, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_position_in_segment", "to_position"), &AStar2D::get_closest_position_in_segment);
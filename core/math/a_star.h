@@ -33,7 +33,10 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/paged_allocator.h"
 
 /**
 	A* pathfinding algorithm.
@@ -51,8 +54,11 @@ class AStar3D : public RefCounted {
 		real_t weight_scale = 0;
 		bool enabled = false;
 
-		OAHashMap<int64_t, Point *> neighbors = 4u;
-		OAHashMap<int64_t, Point *> unlinked_neighbours = 4u;
+		LocalVector<Point *> neighbors;
+		LocalVector<Point *> unlinked_neighbours;
+
+		// Cell of the point in the spatial grid.
+		Vector3i grid_cell;
 
 		// Used for pathfinding.
 		Point *prev_point = nullptr;
@@ -111,10 +117,44 @@ class AStar3D : public RefCounted {
 	int64_t last_free_id = 0;
 	uint64_t pass = 1;
 
+	PagedAllocator<Point, false, 256> point_allocator;
 	OAHashMap<int64_t, Point *> points;
 	HashSet<Segment, Segment> segments;
 	Point *last_closest_point = nullptr;
 
+	// Uniform grid over the points and the segments, for the closest point and closest position queries.
+	// Kept up to date as points and connections change, and sized anew once the points outgrow it,
+	// so the queries only read it.
+	static const int GRID_POINTS_PER_CELL = 2;
+	static const int GRID_MAX_CELLS = 1 << 20;
+	static const int GRID_MAX_CELLS_PER_POINT = 4;
+	static const int GRID_MAX_SEGMENT_CELLS = 64;
+
+	real_t grid_cell_size = 0; // Zero while there are no points.
+	Vector3 grid_origin;
+	AABB grid_bounds;
+	int64_t grid_point_count = 0; // Points and cells the grid was sized for.
+	real_t grid_max_cell_count = 0;
+	HashMap<Vector3i, LocalVector<Point *>> grid_points;
+	// End points of the segments, in pairs, in every cell their bounds overlap.
+	HashMap<Vector3i, LocalVector<Point *>> grid_segments;
+	// Segments overlapping too many cells, always checked.
+	LocalVector<Point *> grid_long_segments;
+
+	_FORCE_INLINE_ Vector3i _get_grid_cell(const Vector3 &p_pos) const {
+		const Vector3 cell = ((p_pos - grid_origin) / grid_cell_size).floor();
+		return Vector3i(cell.x, cell.y, cell.z);
+	}
+	void _build_grid();
+	void _clear_grid();
+	real_t _get_grid_cell_count() const;
+	bool _is_grid_outgrown() const;
+	void _grid_add_point(Point *p_point);
+	void _grid_remove_point(Point *p_point);
+	void _grid_add_segment(Point *p_from, Point *p_to);
+	void _grid_remove_segment(Point *p_from, Point *p_to);
+
+	void _connect_points(Point *p_a, Point *p_b, bool p_bidirectional);
 	bool _solve(Point *begin_point, Point *end_point);
 
 protected:
@@ -157,6 +197,8 @@ public:
 	void reserve_space(int64_t p_num_nodes);
 	void clear();
 
+	void build_graph(const PackedVector3Array &p_positions, const PackedInt64Array &p_connections, bool p_bidirectional = true, const PackedFloat32Array &p_weight_scales = PackedFloat32Array());
+
 	int64_t get_closest_point(const Vector3 &p_point, bool p_include_disabled = false) const;
 	Vector3 get_closest_position_in_segment(const Vector3 &p_point) const;
 
@@ -213,6 +255,8 @@ public:
 	void reserve_space(int64_t p_num_nodes);
 	void clear();
 
+	void build_graph(const PackedVector2Array &p_positions, const PackedInt64Array &p_connections, bool p_bidirectional = true, const PackedFloat32Array &p_weight_scales = PackedFloat32Array());
+
 	int64_t get_closest_point(const Vector2 &p_point, bool p_include_disabled = false) const;
 	Vector2 get_closest_position_in_segment(const Vector2 &p_point) const;
 
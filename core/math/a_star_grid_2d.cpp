@@ -31,6 +31,7 @@
 #include "a_star_grid_2d.h"
 #include "a_star_grid_2d.compat.inc"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 
 static real_t heuristic_euclidean(const Vector2i &p_from, const Vector2i &p_to) {
@@ -122,33 +123,19 @@ AStarGrid2D::CellShape AStarGrid2D::get_cell_shape() const {
 }
 
 void AStarGrid2D::update() {
-	points.clear();
+	const uint32_t cell_count = uint32_t(region.size.x) * uint32_t(region.size.y);
 
-	const int32_t end_x = region.get_end().x;
-	const int32_t end_y = region.get_end().y;
-	const Vector2 half_cell_size = cell_size / 2;
-
-	for (int32_t y = region.position.y; y < end_y; y++) {
-		LocalVector<Point> line;
-		for (int32_t x = region.position.x; x < end_x; x++) {
-			Vector2 v = offset;
-			switch (cell_shape) {
-				case CELL_SHAPE_ISOMETRIC_RIGHT:
-					v += half_cell_size + Vector2(x + y, y - x) * half_cell_size;
-					break;
-				case CELL_SHAPE_ISOMETRIC_DOWN:
-					v += half_cell_size + Vector2(x - y, x + y) * half_cell_size;
-					break;
-				case CELL_SHAPE_SQUARE:
-					v += Vector2(x, y) * cell_size;
-					break;
-				default:
-					break;
-			}
-			line.push_back(Point(Vector2i(x, y), v));
-		}
-		points.push_back(line);
+	solid_mask.clear();
+	solid_mask.resize((cell_count + 63) / 64);
+	if (!solid_mask.is_empty()) {
+		memset(solid_mask.ptr(), 0, sizeof(uint64_t) * solid_mask.size());
 	}
+	weight_scales.clear();
+
+	cell_regions.clear();
+	hierarchy_dirty = true;
+
+	_clear_search_states();
 
 	dirty = false;
 }
@@ -173,9 +160,38 @@ bool AStarGrid2D::is_jumping_enabled() const {
 	return jumping_enabled;
 }
 
+void AStarGrid2D::set_hierarchical_enabled(bool p_enabled) {
+	if (hierarchical_enabled == p_enabled) {
+		return;
+	}
+	hierarchical_enabled = p_enabled;
+
+	MutexLock lock(hierarchy_mutex);
+	cell_regions.reset();
+	cluster_region_counts.reset();
+	dirty_clusters.reset();
+	cluster_region_offsets.reset();
+	region_clusters.reset();
+	region_link_offsets.reset();
+	region_links.reset();
+	hierarchy_dirty = true;
+}
+
+bool AStarGrid2D::is_hierarchical_enabled() const {
+	return hierarchical_enabled;
+}
+
 void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
 	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
+	if (diagonal_mode == p_diagonal_mode) {
+		return;
+	}
 	diagonal_mode = p_diagonal_mode;
+
+	// The regions depend on the diagonal moves.
+	MutexLock lock(hierarchy_mutex);
+	cell_regions.clear();
+	hierarchy_dirty = true;
 }
 
 AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
@@ -203,26 +219,26 @@ AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
 void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is disabled. Point %s out of bounds %s.", p_id, region));
-	_get_point_unchecked(p_id)->solid = p_solid;
+	_set_solid_unchecked(p_id.x, p_id.y, p_solid);
 }
 
 bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), false, vformat("Can't get if point is disabled. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->solid;
+	return _is_solid_unchecked(p_id.x, p_id.y);
 }
 
 void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point %s out of bounds %s.", p_id, region));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
-	_get_point_unchecked(p_id)->weight_scale = p_weight_scale;
+	_set_weight_scale_unchecked(p_id.x, p_id.y, p_weight_scale);
 }
 
 real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, 0, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), 0, vformat("Can't get point's weight scale. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->weight_scale;
+	return _get_weight_scale_unchecked(p_id.x, p_id.y);
 }
 
 void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
@@ -234,7 +250,7 @@ void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
 		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_get_point_unchecked(x, y)->solid = p_solid;
+			_set_solid_unchecked(x, y, p_solid);
 		}
 	}
 }
@@ -249,164 +265,546 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
 		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_get_point_unchecked(x, y)->weight_scale = p_weight_scale;
+			_set_weight_scale_unchecked(x, y, p_weight_scale);
 		}
 	}
 }
 
-AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
-	if (!p_to || p_to->solid) {
-		return nullptr;
+void AStarGrid2D::_set_solid_unchecked(int32_t p_x, int32_t p_y, bool p_solid) {
+	const uint32_t index = _get_cell_index(p_x, p_y);
+	const uint64_t bit = uint64_t(1) << (index & 63);
+	if (bool(solid_mask[index >> 6] & bit) == p_solid) {
+		return;
 	}
-	if (p_to == end) {
-		return p_to;
+
+	if (p_solid) {
+		solid_mask[index >> 6] |= bit;
+	} else {
+		solid_mask[index >> 6] &= ~bit;
 	}
 
-	int32_t from_x = p_from->id.x;
-	int32_t from_y = p_from->id.y;
+	if (!cell_regions.is_empty()) {
+		const int32_t cluster_x = (p_x - region.position.x) >> CLUSTER_SHIFT;
+		const int32_t cluster_y = (p_y - region.position.y) >> CLUSTER_SHIFT;
+		dirty_clusters[cluster_y * clusters_per_row + cluster_x] = 1;
+		hierarchy_dirty = true;
+	}
+}
 
-	int32_t to_x = p_to->id.x;
-	int32_t to_y = p_to->id.y;
+void AStarGrid2D::_set_weight_scale_unchecked(int32_t p_x, int32_t p_y, real_t p_weight_scale) {
+	if (weight_scales.is_empty()) {
+		if (p_weight_scale == 1.0) {
+			return;
+		}
+		const uint32_t cell_count = uint32_t(region.size.x) * uint32_t(region.size.y);
+		weight_scales.resize(cell_count);
+		for (uint32_t i = 0; i < cell_count; i++) {
+			weight_scales[i] = 1.0;
+		}
+	}
+	weight_scales[_get_cell_index(p_x, p_y)] = p_weight_scale;
+}
 
-	int32_t dx = to_x - from_x;
-	int32_t dy = to_y - from_y;
+Vector2 AStarGrid2D::_get_point_position_unchecked(const Vector2i &p_id) const {
+	Vector2 v = offset;
+	switch (cell_shape) {
+		case CELL_SHAPE_ISOMETRIC_RIGHT:
+			v += cell_size / 2 + Vector2(p_id.x + p_id.y, p_id.y - p_id.x) * (cell_size / 2);
+			break;
+		case CELL_SHAPE_ISOMETRIC_DOWN:
+			v += cell_size / 2 + Vector2(p_id.x - p_id.y, p_id.x + p_id.y) * (cell_size / 2);
+			break;
+		case CELL_SHAPE_SQUARE:
+			v += Vector2(p_id.x, p_id.y) * cell_size;
+			break;
+		default:
+			break;
+	}
+	return v;
+}
 
-	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
-		if (dx != 0 && dy != 0) {
-			if ((_is_walkable(to_x - dx, to_y + dy) && !_is_walkable(to_x - dx, to_y)) || (_is_walkable(to_x + dx, to_y - dy) && !_is_walkable(to_x, to_y - dy))) {
-				return p_to;
-			}
-			if (_jump(p_to, _get_point(to_x + dx, to_y)) != nullptr) {
-				return p_to;
-			}
-			if (_jump(p_to, _get_point(to_x, to_y + dy)) != nullptr) {
-				return p_to;
+bool AStarGrid2D::_can_move_diagonally(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const {
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS:
+			return true;
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE:
+			return _is_walkable(p_x + p_dx, p_y) || _is_walkable(p_x, p_y + p_dy);
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES:
+			return _is_walkable(p_x + p_dx, p_y) && _is_walkable(p_x, p_y + p_dy);
+		default:
+			return false;
+	}
+}
+
+void AStarGrid2D::_update_cluster_regions(int32_t p_cluster_x, int32_t p_cluster_y) {
+	const int32_t begin_x = region.position.x + (p_cluster_x << CLUSTER_SHIFT);
+	const int32_t begin_y = region.position.y + (p_cluster_y << CLUSTER_SHIFT);
+	const int32_t end_x = MIN(begin_x + CLUSTER_SIZE, region.get_end().x);
+	const int32_t end_y = MIN(begin_y + CLUSTER_SIZE, region.get_end().y);
+
+	for (int32_t y = begin_y; y < end_y; y++) {
+		for (int32_t x = begin_x; x < end_x; x++) {
+			cell_regions[_get_cell_index(x, y)] = REGION_NONE;
+		}
+	}
+
+	// Flood fill the walkable cells, moving between them the same way the search does.
+	Vector2i stack[CLUSTER_SIZE * CLUSTER_SIZE];
+	uint8_t region_count = 0;
+
+	for (int32_t y = begin_y; y < end_y; y++) {
+		for (int32_t x = begin_x; x < end_x; x++) {
+			if (_is_solid_unchecked(x, y) || cell_regions[_get_cell_index(x, y)] != REGION_NONE) {
+				continue;
 			}
-		} else {
-			if (dx != 0) {
-				if ((_is_walkable(to_x + dx, to_y + 1) && !_is_walkable(to_x, to_y + 1)) || (_is_walkable(to_x + dx, to_y - 1) && !_is_walkable(to_x, to_y - 1))) {
-					return p_to;
-				}
-			} else {
-				if ((_is_walkable(to_x + 1, to_y + dy) && !_is_walkable(to_x + 1, to_y)) || (_is_walkable(to_x - 1, to_y + dy) && !_is_walkable(to_x - 1, to_y))) {
-					return p_to;
+
+			int stack_size = 0;
+			stack[stack_size++] = Vector2i(x, y);
+			cell_regions[_get_cell_index(x, y)] = region_count;
+
+			while (stack_size > 0) {
+				const Vector2i cell = stack[--stack_size];
+				for (int32_t dy = -1; dy <= 1; dy++) {
+					for (int32_t dx = -1; dx <= 1; dx++) {
+						const int32_t nx = cell.x + dx;
+						const int32_t ny = cell.y + dy;
+						if ((dx == 0 && dy == 0) || nx < begin_x || nx >= end_x || ny < begin_y || ny >= end_y) {
+							continue;
+						}
+						if (_is_solid_unchecked(nx, ny) || cell_regions[_get_cell_index(nx, ny)] != REGION_NONE) {
+							continue;
+						}
+						if (dx != 0 && dy != 0 && !_can_move_diagonally(cell.x, cell.y, dx, dy)) {
+							continue;
+						}
+						cell_regions[_get_cell_index(nx, ny)] = region_count;
+						stack[stack_size++] = Vector2i(nx, ny);
+					}
 				}
 			}
+
+			region_count++;
 		}
-		if (_is_walkable(to_x + dx, to_y + dy) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || (_is_walkable(to_x + dx, to_y) || _is_walkable(to_x, to_y + dy)))) {
-			return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+	}
+
+	cluster_region_counts[p_cluster_y * clusters_per_row + p_cluster_x] = region_count;
+}
+
+void AStarGrid2D::_update_hierarchy() {
+	MutexLock lock(hierarchy_mutex);
+	if (!hierarchy_dirty) {
+		return;
+	}
+
+	const uint32_t cell_count = uint32_t(region.size.x) * uint32_t(region.size.y);
+	const int32_t cluster_rows = (region.size.y + CLUSTER_SIZE - 1) >> CLUSTER_SHIFT;
+	clusters_per_row = (region.size.x + CLUSTER_SIZE - 1) >> CLUSTER_SHIFT;
+	const uint32_t cluster_count = uint32_t(clusters_per_row) * uint32_t(cluster_rows);
+
+	if (cell_regions.size() != cell_count || dirty_clusters.size() != cluster_count) {
+		cell_regions.resize(cell_count);
+		cluster_region_counts.resize(cluster_count);
+		dirty_clusters.resize(cluster_count);
+		for (uint32_t i = 0; i < cluster_count; i++) {
+			dirty_clusters[i] = 1;
 		}
-	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
-		if (dx != 0 && dy != 0) {
-			if ((_is_walkable(to_x + dx, to_y + dy) && !_is_walkable(to_x, to_y + dy)) || !_is_walkable(to_x + dx, to_y)) {
-				return p_to;
+	}
+
+	for (int32_t cluster_y = 0; cluster_y < cluster_rows; cluster_y++) {
+		for (int32_t cluster_x = 0; cluster_x < clusters_per_row; cluster_x++) {
+			uint8_t &cluster_dirty = dirty_clusters[cluster_y * clusters_per_row + cluster_x];
+			if (cluster_dirty) {
+				_update_cluster_regions(cluster_x, cluster_y);
+				cluster_dirty = 0;
 			}
-			if (_jump(p_to, _get_point(to_x + dx, to_y)) != nullptr) {
-				return p_to;
+		}
+	}
+
+	cluster_region_offsets.resize(cluster_count + 1);
+	region_clusters.clear();
+	uint32_t region_count = 0;
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		cluster_region_offsets[i] = region_count;
+		for (uint32_t j = 0; j < cluster_region_counts[i]; j++) {
+			region_clusters.push_back(i);
+		}
+		region_count += cluster_region_counts[i];
+	}
+	cluster_region_offsets[cluster_count] = region_count;
+
+	// Link the regions of the cells that touch across the borders of the clusters. Going right, down, down right and
+	// down left from every cell visits each pair of neighbor cells once.
+	static const int32_t link_directions[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { -1, 1 } };
+	LocalVector<uint64_t> links;
+	const int32_t end_x = region.get_end().x;
+	const int32_t end_y = region.get_end().y;
+
+	for (int32_t y = region.position.y; y < end_y; y++) {
+		const int32_t local_y = (y - region.position.y) & (CLUSTER_SIZE - 1);
+		for (int32_t x = region.position.x; x < end_x; x++) {
+			const int32_t local_x = (x - region.position.x) & (CLUSTER_SIZE - 1);
+			if (local_x != 0 && local_x != CLUSTER_SIZE - 1 && local_y != CLUSTER_SIZE - 1) {
+				continue;
 			}
-			if (_jump(p_to, _get_point(to_x, to_y + dy)) != nullptr) {
-				return p_to;
+			if (_is_solid_unchecked(x, y)) {
+				continue;
 			}
-		} else {
-			if (dx != 0) {
-				if ((_is_walkable(to_x, to_y + 1) && !_is_walkable(to_x - dx, to_y + 1)) || (_is_walkable(to_x, to_y - 1) && !_is_walkable(to_x - dx, to_y - 1))) {
-					return p_to;
+			const uint32_t cell_region = _get_cell_region(x, y);
+			for (int i = 0; i < 4; i++) {
+				const int32_t dx = link_directions[i][0];
+				const int32_t dy = link_directions[i][1];
+				if (!_is_walkable(x + dx, y + dy) || (dx != 0 && dy != 0 && !_can_move_diagonally(x, y, dx, dy))) {
+					continue;
 				}
-			} else {
-				if ((_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy)) || (_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy))) {
-					return p_to;
+				const uint32_t nbor_region = _get_cell_region(x + dx, y + dy);
+				if (region_clusters[nbor_region] != region_clusters[cell_region]) {
+					links.push_back((uint64_t(cell_region) << 32) | nbor_region);
+					links.push_back((uint64_t(nbor_region) << 32) | cell_region);
 				}
 			}
 		}
-		if (_is_walkable(to_x + dx, to_y + dy) && _is_walkable(to_x + dx, to_y) && _is_walkable(to_x, to_y + dy)) {
-			return _jump(p_to, _get_point(to_x + dx, to_y + dy));
-		}
-	} else { // DIAGONAL_MODE_NEVER
-		if (dx != 0) {
-			if ((_is_walkable(to_x, to_y - 1) && !_is_walkable(to_x - dx, to_y - 1)) || (_is_walkable(to_x, to_y + 1) && !_is_walkable(to_x - dx, to_y + 1))) {
-				return p_to;
-			}
-		} else if (dy != 0) {
-			if ((_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy)) || (_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy))) {
-				return p_to;
+	}
+
+	links.sort();
+
+	region_link_offsets.resize(region_count + 1);
+	region_links.clear();
+	uint32_t link_index = 0;
+	for (uint32_t i = 0; i < region_count; i++) {
+		region_link_offsets[i] = region_links.size();
+		for (; link_index < links.size() && uint32_t(links[link_index] >> 32) == i; link_index++) {
+			const uint32_t nbor_region = uint32_t(links[link_index] & UINT32_MAX);
+			if (region_links.size() == region_link_offsets[i] || region_links[region_links.size() - 1] != nbor_region) {
+				region_links.push_back(nbor_region);
 			}
-			if (_jump(p_to, _get_point(to_x + 1, to_y)) != nullptr) {
-				return p_to;
+		}
+	}
+	region_link_offsets[region_count] = region_links.size();
+
+	hierarchy_dirty = false;
+}
+
+bool AStarGrid2D::_find_corridor(SearchState &p_state, const Vector2i &p_begin, const Vector2i &p_end, bool &r_reachable) {
+	const uint32_t region_count = region_clusters.size();
+	p_state.configure_regions(region_count);
+
+	const uint32_t begin_region = _get_cell_region(p_begin.x, p_begin.y);
+	const uint32_t end_region = _get_cell_region(p_end.x, p_end.y);
+	const uint64_t pass = p_state.pass;
+
+	// Search the regions, from the center of one cluster to the next.
+	const Vector2 end_cluster = Vector2(region_clusters[end_region] % clusters_per_row, region_clusters[end_region] / clusters_per_row);
+	LocalVector<SearchState::RegionEntry> &open_list = p_state.region_open_list;
+	SortArray<SearchState::RegionEntry, SearchState::SortRegionEntries> sorter;
+	open_list.clear();
+
+	SearchState::RegionEntry begin_entry;
+	begin_entry.region = begin_region;
+	begin_entry.f_score = end_cluster.distance_to(Vector2(region_clusters[begin_region] % clusters_per_row, region_clusters[begin_region] / clusters_per_row));
+	open_list.push_back(begin_entry);
+	p_state.region_open_passes[begin_region] = pass;
+	p_state.region_g_scores[begin_region] = 0;
+	p_state.region_prev[begin_region] = SearchState::NODE_NONE;
+
+	bool found_route = false;
+	while (!open_list.is_empty()) {
+		const SearchState::RegionEntry entry = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+
+		if (p_state.region_closed_passes[entry.region] == pass) {
+			continue; // Already reached with a lower score.
+		}
+		p_state.region_closed_passes[entry.region] = pass;
+
+		if (entry.region == end_region) {
+			found_route = true;
+			break;
+		}
+
+		const Vector2 cluster = Vector2(region_clusters[entry.region] % clusters_per_row, region_clusters[entry.region] / clusters_per_row);
+		for (uint32_t i = region_link_offsets[entry.region]; i < region_link_offsets[entry.region + 1]; i++) {
+			const uint32_t nbor_region = region_links[i];
+			if (p_state.region_closed_passes[nbor_region] == pass) {
+				continue;
 			}
-			if (_jump(p_to, _get_point(to_x - 1, to_y)) != nullptr) {
-				return p_to;
+
+			const Vector2 nbor_cluster = Vector2(region_clusters[nbor_region] % clusters_per_row, region_clusters[nbor_region] / clusters_per_row);
+			const real_t tentative_g_score = entry.g_score + cluster.distance_to(nbor_cluster);
+			if (p_state.region_open_passes[nbor_region] == pass && tentative_g_score >= p_state.region_g_scores[nbor_region]) {
+				continue;
 			}
+
+			p_state.region_open_passes[nbor_region] = pass;
+			p_state.region_g_scores[nbor_region] = tentative_g_score;
+			p_state.region_prev[nbor_region] = entry.region;
+
+			SearchState::RegionEntry nbor_entry;
+			nbor_entry.region = nbor_region;
+			nbor_entry.g_score = tentative_g_score;
+			nbor_entry.f_score = tentative_g_score + nbor_cluster.distance_to(end_cluster);
+			open_list.push_back(nbor_entry);
+			sorter.push_heap(0, open_list.size() - 1, 0, nbor_entry, open_list.ptr());
+		}
+	}
+
+	r_reachable = found_route;
+	if (!found_route) {
+		return false;
+	}
+
+	// The corridor holds the regions of the path and the regions around them, so the cells of the path can still
+	// use the diagonal moves along their borders.
+	for (uint32_t r = end_region; r != SearchState::NODE_NONE; r = p_state.region_prev[r]) {
+		p_state.corridor_passes[r] = pass;
+		for (uint32_t i = region_link_offsets[r]; i < region_link_offsets[r + 1]; i++) {
+			p_state.corridor_passes[region_links[i]] = pass;
+		}
+	}
+
+	return true;
+}
+
+void AStarGrid2D::SearchState::configure(const Size2i &p_size) {
+	if (size == p_size && !blocks.is_empty()) {
+		return;
+	}
+
+	for (uint32_t *block : blocks) {
+		if (block) {
+			memfree(block);
+		}
+	}
+
+	size = p_size;
+	blocks_per_row = (p_size.x + BLOCK_SIZE - 1) >> BLOCK_SHIFT;
+	const uint32_t block_count = uint32_t(blocks_per_row) * uint32_t((p_size.y + BLOCK_SIZE - 1) >> BLOCK_SHIFT);
+	blocks.resize(block_count);
+	block_passes.resize(block_count);
+	for (uint32_t i = 0; i < block_count; i++) {
+		blocks[i] = nullptr;
+		block_passes[i] = 0;
+	}
+}
+
+void AStarGrid2D::SearchState::begin_search() {
+	pass++;
+	nodes.clear();
+	open_list.clear();
+	last_closest_node = NODE_NONE;
+	use_corridor = false;
+}
+
+void AStarGrid2D::SearchState::configure_regions(uint32_t p_region_count) {
+	if (corridor_passes.size() == p_region_count) {
+		return;
+	}
+
+	region_open_passes.resize(p_region_count);
+	region_closed_passes.resize(p_region_count);
+	corridor_passes.resize(p_region_count);
+	region_prev.resize(p_region_count);
+	region_g_scores.resize(p_region_count);
+	for (uint32_t i = 0; i < p_region_count; i++) {
+		region_open_passes[i] = 0;
+		region_closed_passes[i] = 0;
+		corridor_passes[i] = 0;
+	}
+}
+
+void AStarGrid2D::SearchState::trim() {
+	// A search through most of the grid allocates most of the blocks, do not keep them all for the next ones.
+	uint32_t kept_blocks = 0;
+	for (uint32_t i = 0; i < blocks.size(); i++) {
+		if (!blocks[i]) {
+			continue;
+		}
+		if (kept_blocks < MAX_KEPT_BLOCKS) {
+			kept_blocks++;
+		} else {
+			memfree(blocks[i]);
+			blocks[i] = nullptr;
+			block_passes[i] = 0;
+		}
+	}
+
+	if (nodes.size() > MAX_KEPT_NODES) {
+		nodes.reset();
+		open_list.reset();
+	}
+}
+
+AStarGrid2D::SearchState::~SearchState() {
+	for (uint32_t *block : blocks) {
+		if (block) {
+			memfree(block);
 		}
-		return _jump(p_to, _get_point(to_x + dx, to_y + dy));
 	}
-	return nullptr;
 }
 
-void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
-	bool ts0 = false, td0 = false,
-		 ts1 = false, td1 = false,
-		 ts2 = false, td2 = false,
-		 ts3 = false, td3 = false;
+AStarGrid2D::SearchState *AStarGrid2D::_acquire_search_state() {
+	SearchState *state = nullptr;
+	{
+		MutexLock lock(search_states_mutex);
+		if (!free_search_states.is_empty()) {
+			state = free_search_states[free_search_states.size() - 1];
+			free_search_states.resize(free_search_states.size() - 1);
+		}
+	}
 
-	Point *left = nullptr;
-	Point *right = nullptr;
-	Point *top = nullptr;
-	Point *bottom = nullptr;
+	if (!state) {
+		state = memnew(SearchState);
+	}
+	state->configure(region.size);
+	return state;
+}
 
-	Point *top_left = nullptr;
-	Point *top_right = nullptr;
-	Point *bottom_left = nullptr;
-	Point *bottom_right = nullptr;
+void AStarGrid2D::_release_search_state(SearchState *p_state) {
+	p_state->trim();
 
 	{
-		bool has_left = false;
-		bool has_right = false;
+		// One state per thread that can search at the same time is enough.
+		MutexLock lock(search_states_mutex);
+		if (free_search_states.size() <= uint32_t(WorkerThreadPool::get_singleton()->get_thread_count())) {
+			free_search_states.push_back(p_state);
+			return;
+		}
+	}
+	memdelete(p_state);
+}
+
+void AStarGrid2D::_clear_search_states() {
+	MutexLock lock(search_states_mutex);
+	for (SearchState *state : free_search_states) {
+		memdelete(state);
+	}
+	free_search_states.clear();
+}
+
+bool AStarGrid2D::_jump(const SearchState &p_state, const Vector2i &p_from, const Vector2i &p_to, Vector2i &r_jump_point) const {
+	const int32_t dx = p_to.x - p_from.x;
+	const int32_t dy = p_to.y - p_from.y;
 
-		if (p_point->id.x - 1 >= region.position.x) {
-			left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y);
-			has_left = true;
+	int32_t to_x = p_to.x;
+	int32_t to_y = p_to.y;
+	Vector2i jump_point;
+
+	// Keeps moving in the same direction until a jump point is found, instead of recursing at every step.
+	while (true) {
+		if (!_is_walkable(p_state, to_x, to_y)) {
+			return false;
 		}
-		if (p_point->id.x + 1 < region.position.x + region.size.width) {
-			right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y);
-			has_right = true;
+		if (to_x == p_state.end.x && to_y == p_state.end.y) {
+			r_jump_point = Vector2i(to_x, to_y);
+			return true;
 		}
-		if (p_point->id.y - 1 >= region.position.y) {
-			top = _get_point_unchecked(p_point->id.x, p_point->id.y - 1);
-			if (has_left) {
-				top_left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y - 1);
+
+		if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
+			if (dx != 0 && dy != 0) {
+				if ((_is_walkable(p_state, to_x - dx, to_y + dy) && !_is_walkable(p_state, to_x - dx, to_y)) || (_is_walkable(p_state, to_x + dx, to_y - dy) && !_is_walkable(p_state, to_x, to_y - dy))) {
+					break;
+				}
+				if (_jump(p_state, Vector2i(to_x, to_y), Vector2i(to_x + dx, to_y), jump_point)) {
+					break;
+				}
+				if (_jump(p_state, Vector2i(to_x, to_y), Vector2i(to_x, to_y + dy), jump_point)) {
+					break;
+				}
+			} else {
+				if (dx != 0) {
+					if ((_is_walkable(p_state, to_x + dx, to_y + 1) && !_is_walkable(p_state, to_x, to_y + 1)) || (_is_walkable(p_state, to_x + dx, to_y - 1) && !_is_walkable(p_state, to_x, to_y - 1))) {
+						break;
+					}
+				} else {
+					if ((_is_walkable(p_state, to_x + 1, to_y + dy) && !_is_walkable(p_state, to_x + 1, to_y)) || (_is_walkable(p_state, to_x - 1, to_y + dy) && !_is_walkable(p_state, to_x - 1, to_y))) {
+						break;
+					}
+				}
 			}
-			if (has_right) {
-				top_right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y - 1);
+			if (_is_walkable(p_state, to_x + dx, to_y + dy) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || (_is_walkable(p_state, to_x + dx, to_y) || _is_walkable(p_state, to_x, to_y + dy)))) {
+				to_x += dx;
+				to_y += dy;
+				continue;
 			}
-		}
-		if (p_point->id.y + 1 < region.position.y + region.size.height) {
-			bottom = _get_point_unchecked(p_point->id.x, p_point->id.y + 1);
-			if (has_left) {
-				bottom_left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y + 1);
+		} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
+			if (dx != 0 && dy != 0) {
+				if ((_is_walkable(p_state, to_x + dx, to_y + dy) && !_is_walkable(p_state, to_x, to_y + dy)) || !_is_walkable(p_state, to_x + dx, to_y)) {
+					break;
+				}
+				if (_jump(p_state, Vector2i(to_x, to_y), Vector2i(to_x + dx, to_y), jump_point)) {
+					break;
+				}
+				if (_jump(p_state, Vector2i(to_x, to_y), Vector2i(to_x, to_y + dy), jump_point)) {
+					break;
+				}
+			} else {
+				if (dx != 0) {
+					if ((_is_walkable(p_state, to_x, to_y + 1) && !_is_walkable(p_state, to_x - dx, to_y + 1)) || (_is_walkable(p_state, to_x, to_y - 1) && !_is_walkable(p_state, to_x - dx, to_y - 1))) {
+						break;
+					}
+				} else {
+					if ((_is_walkable(p_state, to_x + 1, to_y) && !_is_walkable(p_state, to_x + 1, to_y - dy)) || (_is_walkable(p_state, to_x - 1, to_y) && !_is_walkable(p_state, to_x - 1, to_y - dy))) {
+						break;
+					}
+				}
 			}
-			if (has_right) {
-				bottom_right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y + 1);
+			if (_is_walkable(p_state, to_x + dx, to_y + dy) && _is_walkable(p_state, to_x + dx, to_y) && _is_walkable(p_state, to_x, to_y + dy)) {
+				to_x += dx;
+				to_y += dy;
+				continue;
+			}
+		} else { // DIAGONAL_MODE_NEVER
+			if (dx != 0) {
+				if ((_is_walkable(p_state, to_x, to_y - 1) && !_is_walkable(p_state, to_x - dx, to_y - 1)) || (_is_walkable(p_state, to_x, to_y + 1) && !_is_walkable(p_state, to_x - dx, to_y + 1))) {
+					break;
+				}
+			} else if (dy != 0) {
+				if ((_is_walkable(p_state, to_x - 1, to_y) && !_is_walkable(p_state, to_x - 1, to_y - dy)) || (_is_walkable(p_state, to_x + 1, to_y) && !_is_walkable(p_state, to_x + 1, to_y - dy))) {
+					break;
+				}
+				if (_jump(p_state, Vector2i(to_x, to_y), Vector2i(to_x + 1, to_y), jump_point)) {
+					break;
+				}
+				if (_jump(p_state, Vector2i(to_x, to_y), Vector2i(to_x - 1, to_y), jump_point)) {
+					break;
+				}
 			}
+			to_x += dx;
+			to_y += dy;
+			continue;
 		}
+		return false;
 	}
 
-	if (top && !top->solid) {
-		r_nbors.push_back(top);
-		ts0 = true;
+	r_jump_point = Vector2i(to_x, to_y);
+	return true;
+}
+
+int AStarGrid2D::_get_nbors(const SearchState &p_state, const Vector2i &p_point, Vector2i *r_nbors) const {
+	const int32_t x = p_point.x;
+	const int32_t y = p_point.y;
+	int count = 0;
+
+	const bool ts0 = _is_walkable(p_state, x, y - 1);
+	const bool ts1 = _is_walkable(p_state, x + 1, y);
+	const bool ts2 = _is_walkable(p_state, x, y + 1);
+	const bool ts3 = _is_walkable(p_state, x - 1, y);
+
+	if (ts0) {
+		r_nbors[count++] = Vector2i(x, y - 1);
 	}
-	if (right && !right->solid) {
-		r_nbors.push_back(right);
-		ts1 = true;
+	if (ts1) {
+		r_nbors[count++] = Vector2i(x + 1, y);
 	}
-	if (bottom && !bottom->solid) {
-		r_nbors.push_back(bottom);
-		ts2 = true;
+	if (ts2) {
+		r_nbors[count++] = Vector2i(x, y + 1);
 	}
-	if (left && !left->solid) {
-		r_nbors.push_back(left);
-		ts3 = true;
+	if (ts3) {
+		r_nbors[count++] = Vector2i(x - 1, y);
 	}
 
+	bool td0 = false, td1 = false, td2 = false, td3 = false;
+
 	switch (diagonal_mode) {
 		case DIAGONAL_MODE_ALWAYS: {
 			td0 = true;
@@ -432,95 +830,109 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 			break;
 	}
 
-	if (td0 && (top_left && !top_left->solid)) {
-		r_nbors.push_back(top_left);
+	if (td0 && _is_walkable(p_state, x - 1, y - 1)) {
+		r_nbors[count++] = Vector2i(x - 1, y - 1);
 	}
-	if (td1 && (top_right && !top_right->solid)) {
-		r_nbors.push_back(top_right);
+	if (td1 && _is_walkable(p_state, x + 1, y - 1)) {
+		r_nbors[count++] = Vector2i(x + 1, y - 1);
 	}
-	if (td2 && (bottom_right && !bottom_right->solid)) {
-		r_nbors.push_back(bottom_right);
+	if (td2 && _is_walkable(p_state, x + 1, y + 1)) {
+		r_nbors[count++] = Vector2i(x + 1, y + 1);
 	}
-	if (td3 && (bottom_left && !bottom_left->solid)) {
-		r_nbors.push_back(bottom_left);
+	if (td3 && _is_walkable(p_state, x - 1, y + 1)) {
+		r_nbors[count++] = Vector2i(x - 1, y + 1);
 	}
-}
 
-bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
-	last_closest_point = nullptr;
-	pass++;
+	return count;
+}
 
-	if (p_end_point->solid) {
+bool AStarGrid2D::_solve(SearchState &p_state, const Vector2i &p_begin, const Vector2i &p_end) {
+	if (_is_solid_unchecked(p_end.x, p_end.y)) {
 		return false;
 	}
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	LocalVector<SearchState::Node> &nodes = p_state.nodes;
+	LocalVector<uint32_t> &open_list = p_state.open_list;
+	SortArray<uint32_t, SearchState::SortNodes> sorter;
+
+	{
+		SearchState::Node begin_node;
+		begin_node.id = p_begin;
+		begin_node.f_score = _estimate_cost(p_begin, p_end);
+		begin_node.abs_f_score = begin_node.f_score;
+		p_state.get_node_slot(p_begin.x - region.position.x, p_begin.y - region.position.y) = nodes.size();
+		open_list.push_back(nodes.size());
+		nodes.push_back(begin_node);
+	}
+	p_state.end = p_end;
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	p_begin_point->abs_g_score = 0;
-	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
-	end = p_end_point;
+	Vector2i nbors[8];
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		const uint32_t p = open_list[0]; // The currently processed node.
 
-		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		// Find node closer to end_point, or same distance to end_point but closer to begin_point.
+		const uint32_t last_closest_node = p_state.last_closest_node;
+		if (last_closest_node == SearchState::NODE_NONE || nodes[last_closest_node].abs_f_score > nodes[p].abs_f_score || (nodes[last_closest_node].abs_f_score >= nodes[p].abs_f_score && nodes[last_closest_node].abs_g_score > nodes[p].abs_g_score)) {
+			p_state.last_closest_node = p;
 		}
 
-		if (p == p_end_point) {
+		const Vector2i p_id = nodes[p].id;
+		if (p_id == p_end) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
+		sorter.compare.nodes = nodes.ptr();
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current node from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
-
-		LocalVector<Point *> nbors;
-		_get_nbors(p, nbors);
+		nodes[p].closed = true; // Mark the node as closed.
 
-		for (Point *e : nbors) {
+		const int nbor_count = _get_nbors(p_state, p_id, nbors);
+		for (int i = 0; i < nbor_count; i++) {
+			Vector2i e_id = nbors[i];
 			real_t weight_scale = 1.0;
 
 			if (jumping_enabled) {
 				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
-				if (!e || e->closed_pass == pass) {
+				if (!_jump(p_state, p_id, nbors[i], e_id)) {
 					continue;
 				}
 			} else {
-				if (e->solid || e->closed_pass == pass) {
-					continue;
-				}
-				weight_scale = e->weight_scale;
+				weight_scale = _get_weight_scale_unchecked(e_id.x, e_id.y);
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * weight_scale;
-			bool new_point = false;
+			uint32_t &e = p_state.get_node_slot(e_id.x - region.position.x, e_id.y - region.position.y);
+			if (e != SearchState::NODE_NONE && nodes[e].closed) {
+				continue;
+			}
+
+			real_t tentative_g_score = nodes[p].g_score + _compute_cost(p_id, e_id) * weight_scale;
+			bool new_node = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
+			if (e == SearchState::NODE_NONE) { // The node wasn't inside the open list.
+				SearchState::Node node;
+				node.id = e_id;
+				e = nodes.size();
+				nodes.push_back(node);
 				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+				new_node = true;
+			} else if (tentative_g_score >= nodes[e].g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
+			SearchState::Node &node = nodes[e];
+			node.prev_node = p;
+			node.g_score = tentative_g_score;
+			node.f_score = node.g_score + _estimate_cost(e_id, p_end);
 
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			node.abs_g_score = tentative_g_score;
+			node.abs_f_score = node.f_score - node.g_score;
 
-			if (new_point) { // The position of the new points is already known.
+			sorter.compare.nodes = nodes.ptr();
+			if (new_node) { // The position of the new nodes is already known.
 				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
 			} else {
 				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
@@ -531,6 +943,95 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 	return found_route;
 }
 
+void AStarGrid2D::_find_path(SearchState &p_state, const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path, LocalVector<Vector2i> &r_path) {
+	r_path.clear();
+
+	if (p_from == p_to) {
+		r_path.push_back(p_from);
+		return;
+	}
+
+	bool found_route = false;
+	bool searched = false;
+
+	if (hierarchical_enabled && !_is_solid_unchecked(p_from.x, p_from.y) && !_is_solid_unchecked(p_to.x, p_to.y)) {
+		// Only search the cells of the regions the path goes through. When there are no such regions there
+		// is no path at all, so the full search is only needed for the closest point of a partial path.
+		p_state.begin_search();
+		bool reachable = false;
+		if (_find_corridor(p_state, p_from, p_to, reachable)) {
+			p_state.use_corridor = true;
+			found_route = _solve(p_state, p_from, p_to);
+			p_state.use_corridor = false;
+			searched = found_route;
+		} else if (!p_allow_partial_path) {
+			return;
+		}
+	}
+
+	if (!searched) {
+		p_state.begin_search();
+		found_route = _solve(p_state, p_from, p_to);
+	}
+
+	uint32_t end_node = SearchState::NODE_NONE;
+	if (found_route) {
+		end_node = p_state.get_node_slot(p_to.x - region.position.x, p_to.y - region.position.y);
+	} else {
+		if (!p_allow_partial_path || p_state.last_closest_node == SearchState::NODE_NONE) {
+			return;
+		}
+
+		// Use closest point instead.
+		end_node = p_state.last_closest_node;
+	}
+
+	for (uint32_t node = end_node; node != SearchState::NODE_NONE; node = p_state.nodes[node].prev_node) {
+		r_path.push_back(p_state.nodes[node].id);
+	}
+	r_path.invert();
+}
+
+void AStarGrid2D::_find_path_task(uint32_t p_index, PathQueries *p_queries) {
+	SearchState *state = _acquire_search_state();
+	_find_path(*state, p_queries->from_ids[p_index], p_queries->to_ids[p_index], p_queries->allow_partial_path, p_queries->paths[p_index]);
+	_release_search_state(state);
+}
+
+bool AStarGrid2D::_prepare_path_queries(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path, PathQueries &r_queries) {
+	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), false, vformat("Can't get paths. The number of start points %d doesn't match the number of end points %d.", p_from_ids.size(), p_to_ids.size()));
+
+	const uint32_t query_count = p_from_ids.size();
+	r_queries.from_ids.resize(query_count);
+	r_queries.to_ids.resize(query_count);
+	r_queries.paths.resize(query_count);
+	r_queries.allow_partial_path = p_allow_partial_path;
+
+	for (uint32_t i = 0; i < query_count; i++) {
+		r_queries.from_ids[i] = p_from_ids[i];
+		r_queries.to_ids[i] = p_to_ids[i];
+		ERR_FAIL_COND_V_MSG(!is_in_boundsv(r_queries.from_ids[i]), false, vformat("Can't get id path. Point %s out of bounds %s.", r_queries.from_ids[i], region));
+		ERR_FAIL_COND_V_MSG(!is_in_boundsv(r_queries.to_ids[i]), false, vformat("Can't get id path. Point %s out of bounds %s.", r_queries.to_ids[i], region));
+	}
+
+	if (hierarchical_enabled) {
+		_update_hierarchy();
+	}
+
+	// Scripted costs can't be called from several threads at once.
+	if (query_count > 1 && !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost)) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStarGrid2D::_find_path_task, &r_queries, query_count, -1, true, SNAME("AStarGrid2DPaths"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < query_count; i++) {
+			_find_path_task(i, &r_queries);
+		}
+	}
+
+	return true;
+}
+
 real_t AStarGrid2D::_estimate_cost(const Vector2i &p_from_id, const Vector2i &p_to_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_to_id, scost)) {
@@ -548,14 +1049,21 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 }
 
 void AStarGrid2D::clear() {
-	points.clear();
+	solid_mask.clear();
+	weight_scales.clear();
 	region = Rect2i();
+
+	MutexLock lock(hierarchy_mutex);
+	cell_regions.clear();
+	hierarchy_dirty = true;
+
+	_clear_search_states();
 }
 
 Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, Vector2(), "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), Vector2(), vformat("Can't get point's position. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->pos;
+	return _get_point_position_unchecked(p_id);
 }
 
 Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vector2i &p_to_id, bool p_allow_partial_path) {
@@ -563,51 +1071,21 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		Vector<Vector2> ret;
-		ret.push_back(a->pos);
-		return ret;
+	if (hierarchical_enabled) {
+		_update_hierarchy();
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
+	LocalVector<Vector2i> id_path;
+	SearchState *state = _acquire_search_state();
+	_find_path(*state, p_from_id, p_to_id, p_allow_partial_path, id_path);
+	_release_search_state(state);
 
 	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
-		}
-
-		w[0] = p->pos;
+	path.resize(id_path.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < id_path.size(); i++) {
+		w[i] = _get_point_position_unchecked(id_path[i]);
 	}
-
 	return path;
 }
 
@@ -616,50 +1094,66 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		TypedArray<Vector2i> ret;
-		ret.push_back(a->id);
-		return ret;
+	if (hierarchical_enabled) {
+		_update_hierarchy();
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	LocalVector<Vector2i> id_path;
+	SearchState *state = _acquire_search_state();
+	_find_path(*state, p_from_id, p_to_id, p_allow_partial_path, id_path);
+	_release_search_state(state);
 
-	bool found_route = _solve(begin_point, end_point);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return TypedArray<Vector2i>();
-		}
+	TypedArray<Vector2i> path;
+	path.resize(id_path.size());
+	for (uint32_t i = 0; i < id_path.size(); i++) {
+		path[i] = id_path[i];
+	}
+	return path;
+}
 
-		// Use closest point instead.
-		end_point = last_closest_point;
+TypedArray<PackedVector2Array> AStarGrid2D::get_point_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path) {
+	PathQueries queries;
+	if (!_prepare_path_queries(p_from_ids, p_to_ids, p_allow_partial_path, queries)) {
+		return TypedArray<PackedVector2Array>();
 	}
 
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	TypedArray<PackedVector2Array> paths;
+	paths.resize(queries.paths.size());
+	for (uint32_t i = 0; i < queries.paths.size(); i++) {
+		const LocalVector<Vector2i> &id_path = queries.paths[i];
+		PackedVector2Array path;
+		path.resize(id_path.size());
+		Vector2 *w = path.ptrw();
+		for (uint32_t j = 0; j < id_path.size(); j++) {
+			w[j] = _get_point_position_unchecked(id_path[j]);
+		}
+		paths[i] = path;
 	}
+	return paths;
+}
 
-	TypedArray<Vector2i> path;
-	path.resize(pc);
+TypedArray<Array> AStarGrid2D::get_id_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path) {
+	PathQueries queries;
+	if (!_prepare_path_queries(p_from_ids, p_to_ids, p_allow_partial_path, queries)) {
+		return TypedArray<Array>();
+	}
 
-	{
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			path[idx--] = p->id;
-			p = p->prev_point;
+	TypedArray<Array> paths;
+	paths.resize(queries.paths.size());
+	for (uint32_t i = 0; i < queries.paths.size(); i++) {
+		const LocalVector<Vector2i> &id_path = queries.paths[i];
+		TypedArray<Vector2i> path;
+		path.resize(id_path.size());
+		for (uint32_t j = 0; j < id_path.size(); j++) {
+			path[j] = id_path[j];
 		}
-
-		path[0] = p->id;
+		paths[i] = path;
 	}
+	return paths;
+}
 
-	return path;
+AStarGrid2D::~AStarGrid2D() {
+	_clear_search_states();
 }
 
 void AStarGrid2D::_bind_methods() {
@@ -679,6 +1173,8 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("update"), &AStarGrid2D::update);
 	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
 	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_hierarchical_enabled", "enabled"), &AStarGrid2D::set_hierarchical_enabled);
+	ClassDB::bind_method(D_METHOD("is_hierarchical_enabled"), &AStarGrid2D::is_hierarchical_enabled);
 	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("set_default_compute_heuristic", "heuristic"), &AStarGrid2D::set_default_compute_heuristic);
@@ -696,6 +1192,8 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStarGrid2D::get_point_position);
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_point_paths", "from_ids", "to_ids", "allow_partial_path"), &AStarGrid2D::get_point_paths, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids", "allow_partial_path"), &AStarGrid2D::get_id_paths, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "to_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -707,6 +1205,7 @@ void AStarGrid2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_shape", PROPERTY_HINT_ENUM, "Square,IsometricRight,IsometricDown"), "set_cell_shape", "get_cell_shape");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "hierarchical_enabled"), "set_hierarchical_enabled", "is_hierarchical_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_compute_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_compute_heuristic", "get_default_compute_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_estimate_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_estimate_heuristic", "get_default_estimate_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Never,Always,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
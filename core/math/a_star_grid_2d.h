@@ -33,6 +33,7 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
 #include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 
@@ -71,82 +72,191 @@ private:
 	CellShape cell_shape = CELL_SHAPE_SQUARE;
 
 	bool jumping_enabled = false;
+	bool hierarchical_enabled = false;
 	DiagonalMode diagonal_mode = DIAGONAL_MODE_ALWAYS;
 	Heuristic default_compute_heuristic = HEURISTIC_EUCLIDEAN;
 	Heuristic default_estimate_heuristic = HEURISTIC_EUCLIDEAN;
 
-	struct Point {
-		Vector2i id;
-
-		bool solid = false;
-		Vector2 pos;
-		real_t weight_scale = 1.0;
-
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
-
-		// Used for getting last_closest_point.
-		real_t abs_g_score = 0;
-		real_t abs_f_score = 0;
-
-		Point() {}
+	// Solid flag of the cells of the region, one bit per cell, row by row.
+	LocalVector<uint64_t> solid_mask;
+	// Weight scale of the cells of the region, row by row. Empty while every weight scale is 1.
+	LocalVector<real_t> weight_scales;
+
+	// For hierarchical pathfinding, the grid is split in clusters of CLUSTER_SIZE x CLUSTER_SIZE cells. The walkable
+	// cells of a cluster form regions of connected cells, and the regions of neighbor clusters are linked where their cells touch.
+	static const int CLUSTER_SHIFT = 4;
+	static const int CLUSTER_SIZE = 1 << CLUSTER_SHIFT;
+	static const uint8_t REGION_NONE = UINT8_MAX;
+
+	bool hierarchy_dirty = true;
+	int32_t clusters_per_row = 0;
+	// Region of every cell within its cluster, REGION_NONE for solid cells.
+	LocalVector<uint8_t> cell_regions;
+	LocalVector<uint8_t> cluster_region_counts;
+	// Clusters whose cells changed since their regions were found.
+	LocalVector<uint8_t> dirty_clusters;
+	// First region of every cluster, the regions of a cluster are numbered consecutively.
+	LocalVector<uint32_t> cluster_region_offsets;
+	LocalVector<uint32_t> region_clusters;
+	// Linked regions of every region, in compressed rows.
+	LocalVector<uint32_t> region_link_offsets;
+	LocalVector<uint32_t> region_links;
+	Mutex hierarchy_mutex;
+
+	// Search data of one path query, kept out of the grid so several queries can run at the same time.
+	struct SearchState {
+		static const int BLOCK_SHIFT = 5;
+		static const int BLOCK_SIZE = 1 << BLOCK_SHIFT;
+		static const uint32_t NODE_NONE = UINT32_MAX;
+		// Kept between searches, the rest is freed when the state goes back to the pool.
+		static const uint32_t MAX_KEPT_BLOCKS = 64;
+		static const uint32_t MAX_KEPT_NODES = BLOCK_SIZE * BLOCK_SIZE * MAX_KEPT_BLOCKS;
+
+		struct Node {
+			Vector2i id;
+			uint32_t prev_node = NODE_NONE;
+			bool closed = false;
+
+			real_t g_score = 0;
+			real_t f_score = 0;
+
+			// Used for getting the closest point when there is no path.
+			real_t abs_g_score = 0;
+			real_t abs_f_score = 0;
+		};
+
+		struct SortNodes {
+			const Node *nodes = nullptr;
+
+			_FORCE_INLINE_ bool operator()(uint32_t A, uint32_t B) const { // Returns true when the node A is worse than node B.
+				if (nodes[A].f_score > nodes[B].f_score) {
+					return true;
+				} else if (nodes[A].f_score < nodes[B].f_score) {
+					return false;
+				} else {
+					return nodes[A].g_score < nodes[B].g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				}
+			}
+		};
 
-		Point(const Vector2i &p_id, const Vector2 &p_pos) :
-				id(p_id), pos(p_pos) {}
-	};
+		struct RegionEntry {
+			uint32_t region = 0;
+			real_t g_score = 0;
+			real_t f_score = 0;
+		};
 
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
-				return true;
-			} else if (A->f_score < B->f_score) {
-				return false;
-			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+		struct SortRegionEntries {
+			_FORCE_INLINE_ bool operator()(const RegionEntry &A, const RegionEntry &B) const {
+				return A.f_score > B.f_score;
 			}
+		};
+
+		uint64_t pass = 0;
+		LocalVector<Node> nodes;
+		LocalVector<uint32_t> open_list;
+		Vector2i end;
+		uint32_t last_closest_node = NODE_NONE;
+
+		// Node of every visited cell, in blocks of BLOCK_SIZE x BLOCK_SIZE cells allocated on their first visit.
+		Size2i size;
+		int32_t blocks_per_row = 0;
+		LocalVector<uint32_t *> blocks;
+		LocalVector<uint64_t> block_passes;
+
+		// Used for hierarchical pathfinding.
+		bool use_corridor = false;
+		LocalVector<uint64_t> region_open_passes;
+		LocalVector<uint64_t> region_closed_passes;
+		LocalVector<uint64_t> corridor_passes;
+		LocalVector<uint32_t> region_prev;
+		LocalVector<real_t> region_g_scores;
+		LocalVector<RegionEntry> region_open_list;
+
+		void configure(const Size2i &p_size);
+		void begin_search();
+		void configure_regions(uint32_t p_region_count);
+		void trim();
+
+		_FORCE_INLINE_ uint32_t &get_node_slot(int32_t p_local_x, int32_t p_local_y) {
+			const uint32_t block = (p_local_y >> BLOCK_SHIFT) * blocks_per_row + (p_local_x >> BLOCK_SHIFT);
+			if (block_passes[block] != pass) {
+				if (!blocks[block]) {
+					blocks[block] = (uint32_t *)memalloc(sizeof(uint32_t) * BLOCK_SIZE * BLOCK_SIZE);
+				}
+				memset(blocks[block], 0xff, sizeof(uint32_t) * BLOCK_SIZE * BLOCK_SIZE);
+				block_passes[block] = pass;
+			}
+			return blocks[block][((p_local_y & (BLOCK_SIZE - 1)) << BLOCK_SHIFT) | (p_local_x & (BLOCK_SIZE - 1))];
 		}
+
+		~SearchState();
 	};
 
-	LocalVector<LocalVector<Point>> points;
-	Point *end = nullptr;
-	Point *last_closest_point = nullptr;
+	struct PathQueries {
+		LocalVector<Vector2i> from_ids;
+		LocalVector<Vector2i> to_ids;
+		bool allow_partial_path = false;
+		LocalVector<LocalVector<Vector2i>> paths;
+	};
 
-	uint64_t pass = 1;
+	LocalVector<SearchState *> free_search_states;
+	Mutex search_states_mutex;
 
 private: // Internal routines.
+	_FORCE_INLINE_ uint32_t _get_cell_index(int32_t p_x, int32_t p_y) const {
+		return uint32_t(p_y - region.position.y) * uint32_t(region.size.x) + uint32_t(p_x - region.position.x);
+	}
+
+	_FORCE_INLINE_ bool _is_solid_unchecked(int32_t p_x, int32_t p_y) const {
+		const uint32_t index = _get_cell_index(p_x, p_y);
+		return solid_mask[index >> 6] & (uint64_t(1) << (index & 63));
+	}
+
 	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
 		if (region.has_point(Vector2i(p_x, p_y))) {
-			return !points[p_y - region.position.y][p_x - region.position.x].solid;
+			return !_is_solid_unchecked(p_x, p_y);
 		}
 		return false;
 	}
 
-	_FORCE_INLINE_ Point *_get_point(int32_t p_x, int32_t p_y) {
-		if (region.has_point(Vector2i(p_x, p_y))) {
-			return &points[p_y - region.position.y][p_x - region.position.x];
-		}
-		return nullptr;
+	_FORCE_INLINE_ uint32_t _get_cell_region(int32_t p_x, int32_t p_y) const {
+		const int32_t local_x = p_x - region.position.x;
+		const int32_t local_y = p_y - region.position.y;
+		const uint32_t cluster = (local_y >> CLUSTER_SHIFT) * clusters_per_row + (local_x >> CLUSTER_SHIFT);
+		return cluster_region_offsets[cluster] + cell_regions[_get_cell_index(p_x, p_y)];
 	}
 
-	_FORCE_INLINE_ Point *_get_point_unchecked(int32_t p_x, int32_t p_y) {
-		return &points[p_y - region.position.y][p_x - region.position.x];
+	// Walkable for the given search, hierarchical searches only visit the cells of their corridor.
+	_FORCE_INLINE_ bool _is_walkable(const SearchState &p_state, int32_t p_x, int32_t p_y) const {
+		if (!_is_walkable(p_x, p_y)) {
+			return false;
+		}
+		return !p_state.use_corridor || p_state.corridor_passes[_get_cell_region(p_x, p_y)] == p_state.pass;
 	}
 
-	_FORCE_INLINE_ Point *_get_point_unchecked(const Vector2i &p_id) {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
+	_FORCE_INLINE_ real_t _get_weight_scale_unchecked(int32_t p_x, int32_t p_y) const {
+		return weight_scales.is_empty() ? real_t(1.0) : weight_scales[_get_cell_index(p_x, p_y)];
 	}
 
-	_FORCE_INLINE_ const Point *_get_point_unchecked(const Vector2i &p_id) const {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
-	}
+	void _set_solid_unchecked(int32_t p_x, int32_t p_y, bool p_solid);
+	void _set_weight_scale_unchecked(int32_t p_x, int32_t p_y, real_t p_weight_scale);
+	Vector2 _get_point_position_unchecked(const Vector2i &p_id) const;
+	bool _can_move_diagonally(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const;
 
-	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
-	Point *_jump(Point *p_from, Point *p_to);
-	bool _solve(Point *p_begin_point, Point *p_end_point);
+	void _update_hierarchy();
+	void _update_cluster_regions(int32_t p_cluster_x, int32_t p_cluster_y);
+	bool _find_corridor(SearchState &p_state, const Vector2i &p_begin, const Vector2i &p_end, bool &r_reachable);
+
+	SearchState *_acquire_search_state();
+	void _release_search_state(SearchState *p_state);
+	void _clear_search_states();
+
+	int _get_nbors(const SearchState &p_state, const Vector2i &p_point, Vector2i *r_nbors) const;
+	bool _jump(const SearchState &p_state, const Vector2i &p_from, const Vector2i &p_to, Vector2i &r_jump_point) const;
+	bool _solve(SearchState &p_state, const Vector2i &p_begin, const Vector2i &p_end);
+	void _find_path(SearchState &p_state, const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path, LocalVector<Vector2i> &r_path);
+	void _find_path_task(uint32_t p_index, PathQueries *p_queries);
+	bool _prepare_path_queries(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path, PathQueries &r_queries);
 
 protected:
 	static void _bind_methods();
@@ -188,6 +298,9 @@ public:
 	void set_jumping_enabled(bool p_enabled);
 	bool is_jumping_enabled() const;
 
+	void set_hierarchical_enabled(bool p_enabled);
+	bool is_hierarchical_enabled() const;
+
 	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
 	DiagonalMode get_diagonal_mode() const;
 
@@ -211,6 +324,11 @@ public:
 	Vector2 get_point_position(const Vector2i &p_id) const;
 	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
 	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
+
+	TypedArray<PackedVector2Array> get_point_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path = false);
+	TypedArray<Array> get_id_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path = false);
+
+	~AStarGrid2D();
 };
 
 VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
@@ -0,0 +1,322 @@
+/**************************************************************************/
+/*  batch_math.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "batch_math.h"
+
+#include "core/math/simd.h"
+
+#if !defined(REAL_T_IS_DOUBLE)
+#if defined(SIMD_SSE2)
+#define BATCH_MATH_SSE
+#elif defined(SIMD_NEON)
+#define BATCH_MATH_NEON
+#endif
+#endif
+
+#if defined(BATCH_MATH_SSE)
+
+// Four Vector3 stored as structure of arrays.
+struct Vector3x4 {
+	__m128 x;
+	__m128 y;
+	__m128 z;
+};
+
+static _FORCE_INLINE_ Vector3x4 _load(const Vector3 *p_src) {
+	const float *src = &p_src->x;
+	const __m128 a = _mm_loadu_ps(src); // x0 y0 z0 x1
+	const __m128 b = _mm_loadu_ps(src + 4); // y1 z1 x2 y2
+	const __m128 c = _mm_loadu_ps(src + 8); // z2 x3 y3 z3
+
+	Vector3x4 v;
+	v.x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	v.y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	v.z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	return v;
+}
+
+static _FORCE_INLINE_ void _store(const Vector3x4 &p_v, Vector3 *r_dst) {
+	float *dst = &r_dst->x;
+	const __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(p_v.x, p_v.y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(p_v.z, p_v.x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(p_v.y, p_v.z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(p_v.x, p_v.y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+	const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(p_v.z, p_v.x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(p_v.y, p_v.z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	_mm_storeu_ps(dst, a);
+	_mm_storeu_ps(dst + 4, b);
+	_mm_storeu_ps(dst + 8, c);
+}
+
+#define SIMD_FLOAT __m128
+#define SIMD_SET1(m_value) _mm_set1_ps(m_value)
+#define SIMD_ADD(m_a, m_b) _mm_add_ps(m_a, m_b)
+#define SIMD_SUB(m_a, m_b) _mm_sub_ps(m_a, m_b)
+#define SIMD_MUL(m_a, m_b) _mm_mul_ps(m_a, m_b)
+#define SIMD_DIV(m_a, m_b) _mm_div_ps(m_a, m_b)
+#define SIMD_SQRT(m_a) _mm_sqrt_ps(m_a)
+#define SIMD_MIN(m_a, m_b) _mm_min_ps(m_a, m_b)
+#define SIMD_MAX(m_a, m_b) _mm_max_ps(m_a, m_b)
+// Zero where m_mask_zero is zero, m_a elsewhere.
+#define SIMD_ZERO_WHERE_ZERO(m_a, m_mask_zero) _mm_andnot_ps(_mm_cmpeq_ps(m_mask_zero, _mm_setzero_ps()), m_a)
+#define SIMD_STORE(m_dst, m_a) _mm_storeu_ps(m_dst, m_a)
+
+static _FORCE_INLINE_ float _reduce_min(__m128 p_a) {
+	const __m128 reduced = _mm_min_ps(p_a, _mm_shuffle_ps(p_a, p_a, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(_mm_min_ps(reduced, _mm_shuffle_ps(reduced, reduced, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+static _FORCE_INLINE_ float _reduce_max(__m128 p_a) {
+	const __m128 reduced = _mm_max_ps(p_a, _mm_shuffle_ps(p_a, p_a, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(_mm_max_ps(reduced, _mm_shuffle_ps(reduced, reduced, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+#elif defined(BATCH_MATH_NEON)
+
+struct Vector3x4 {
+	float32x4_t x;
+	float32x4_t y;
+	float32x4_t z;
+};
+
+static _FORCE_INLINE_ Vector3x4 _load(const Vector3 *p_src) {
+	const float32x4x3_t v = vld3q_f32(&p_src->x);
+	return Vector3x4{ v.val[0], v.val[1], v.val[2] };
+}
+
+static _FORCE_INLINE_ void _store(const Vector3x4 &p_v, Vector3 *r_dst) {
+	float32x4x3_t v;
+	v.val[0] = p_v.x;
+	v.val[1] = p_v.y;
+	v.val[2] = p_v.z;
+	vst3q_f32(&r_dst->x, v);
+}
+
+// Same as _mm_min_ps()/_mm_max_ps(): the second operand is returned when either is NaN, unlike vminq_f32()/vmaxq_f32().
+static _FORCE_INLINE_ float32x4_t _min(float32x4_t p_a, float32x4_t p_b) {
+	return vbslq_f32(vcltq_f32(p_a, p_b), p_a, p_b);
+}
+
+static _FORCE_INLINE_ float32x4_t _max(float32x4_t p_a, float32x4_t p_b) {
+	return vbslq_f32(vcgtq_f32(p_a, p_b), p_a, p_b);
+}
+
+#define SIMD_FLOAT float32x4_t
+#define SIMD_SET1(m_value) vdupq_n_f32(m_value)
+#define SIMD_ADD(m_a, m_b) vaddq_f32(m_a, m_b)
+#define SIMD_SUB(m_a, m_b) vsubq_f32(m_a, m_b)
+#define SIMD_MUL(m_a, m_b) vmulq_f32(m_a, m_b)
+#define SIMD_DIV(m_a, m_b) vdivq_f32(m_a, m_b)
+#define SIMD_SQRT(m_a) vsqrtq_f32(m_a)
+#define SIMD_MIN(m_a, m_b) _min(m_a, m_b)
+#define SIMD_MAX(m_a, m_b) _max(m_a, m_b)
+#define SIMD_ZERO_WHERE_ZERO(m_a, m_mask_zero) vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(m_a), vceqq_f32(m_mask_zero, vdupq_n_f32(0.0f))))
+#define SIMD_STORE(m_dst, m_a) vst1q_f32(m_dst, m_a)
+
+static _FORCE_INLINE_ float _reduce_min(float32x4_t p_a) {
+	const float32x4_t reduced = _min(p_a, vextq_f32(p_a, p_a, 2));
+	return vgetq_lane_f32(_min(reduced, vextq_f32(reduced, reduced, 1)), 0);
+}
+
+static _FORCE_INLINE_ float _reduce_max(float32x4_t p_a) {
+	const float32x4_t reduced = _max(p_a, vextq_f32(p_a, p_a, 2));
+	return vgetq_lane_f32(_max(reduced, vextq_f32(reduced, reduced, 1)), 0);
+}
+
+#endif
+
+#ifdef SIMD_FLOAT
+
+// out[k] = m[k].dot(v - p_pre) + p_post[k], skipping the subtraction and the addition when unused so results match the scalar methods exactly.
+template <bool SUBTRACT, bool ADD>
+static void _transform(const Vector3 p_rows[3], const Vector3 &p_pre, const Vector3 &p_post, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	const SIMD_FLOAT m00 = SIMD_SET1(p_rows[0].x), m01 = SIMD_SET1(p_rows[0].y), m02 = SIMD_SET1(p_rows[0].z);
+	const SIMD_FLOAT m10 = SIMD_SET1(p_rows[1].x), m11 = SIMD_SET1(p_rows[1].y), m12 = SIMD_SET1(p_rows[1].z);
+	const SIMD_FLOAT m20 = SIMD_SET1(p_rows[2].x), m21 = SIMD_SET1(p_rows[2].y), m22 = SIMD_SET1(p_rows[2].z);
+	const SIMD_FLOAT pre_x = SIMD_SET1(p_pre.x), pre_y = SIMD_SET1(p_pre.y), pre_z = SIMD_SET1(p_pre.z);
+	const SIMD_FLOAT post_x = SIMD_SET1(p_post.x), post_y = SIMD_SET1(p_post.y), post_z = SIMD_SET1(p_post.z);
+
+	int64_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		Vector3x4 v = _load(p_src + i);
+		if (SUBTRACT) {
+			v.x = SIMD_SUB(v.x, pre_x);
+			v.y = SIMD_SUB(v.y, pre_y);
+			v.z = SIMD_SUB(v.z, pre_z);
+		}
+		Vector3x4 r;
+		r.x = SIMD_ADD(SIMD_ADD(SIMD_MUL(m00, v.x), SIMD_MUL(m01, v.y)), SIMD_MUL(m02, v.z));
+		r.y = SIMD_ADD(SIMD_ADD(SIMD_MUL(m10, v.x), SIMD_MUL(m11, v.y)), SIMD_MUL(m12, v.z));
+		r.z = SIMD_ADD(SIMD_ADD(SIMD_MUL(m20, v.x), SIMD_MUL(m21, v.y)), SIMD_MUL(m22, v.z));
+		if (ADD) {
+			r.x = SIMD_ADD(r.x, post_x);
+			r.y = SIMD_ADD(r.y, post_y);
+			r.z = SIMD_ADD(r.z, post_z);
+		}
+		_store(r, r_dst + i);
+	}
+
+	for (; i < p_count; i++) {
+		Vector3 v = p_src[i];
+		if (SUBTRACT) {
+			v -= p_pre;
+		}
+		Vector3 r = Vector3(p_rows[0].dot(v), p_rows[1].dot(v), p_rows[2].dot(v));
+		if (ADD) {
+			r += p_post;
+		}
+		r_dst[i] = r;
+	}
+}
+
+void BatchMath::transform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	_transform<false, true>(p_transform.basis.rows, Vector3(), p_transform.origin, p_src, r_dst, p_count);
+}
+
+void BatchMath::transform_inv(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	const Basis transposed = p_transform.basis.transposed();
+	_transform<true, false>(transposed.rows, p_transform.origin, Vector3(), p_src, r_dst, p_count);
+}
+
+void BatchMath::transform(const Basis &p_basis, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	_transform<false, false>(p_basis.rows, Vector3(), Vector3(), p_src, r_dst, p_count);
+}
+
+void BatchMath::normalize(const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	int64_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		Vector3x4 v = _load(p_src + i);
+		const SIMD_FLOAT length_squared = SIMD_ADD(SIMD_ADD(SIMD_MUL(v.x, v.x), SIMD_MUL(v.y, v.y)), SIMD_MUL(v.z, v.z));
+		const SIMD_FLOAT length = SIMD_SQRT(length_squared);
+		// Zero length vectors become zero, like Vector3::normalize().
+		v.x = SIMD_ZERO_WHERE_ZERO(SIMD_DIV(v.x, length), length_squared);
+		v.y = SIMD_ZERO_WHERE_ZERO(SIMD_DIV(v.y, length), length_squared);
+		v.z = SIMD_ZERO_WHERE_ZERO(SIMD_DIV(v.z, length), length_squared);
+		_store(v, r_dst + i);
+	}
+
+	for (; i < p_count; i++) {
+		r_dst[i] = p_src[i].normalized();
+	}
+}
+
+void BatchMath::dot(const Vector3 *p_a, const Vector3 *p_b, real_t *r_dst, int64_t p_count) {
+	int64_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		const Vector3x4 a = _load(p_a + i);
+		const Vector3x4 b = _load(p_b + i);
+		SIMD_STORE(r_dst + i, SIMD_ADD(SIMD_ADD(SIMD_MUL(a.x, b.x), SIMD_MUL(a.y, b.y)), SIMD_MUL(a.z, b.z)));
+	}
+
+	for (; i < p_count; i++) {
+		r_dst[i] = p_a[i].dot(p_b[i]);
+	}
+}
+
+AABB BatchMath::get_aabb(const Vector3 *p_points, int64_t p_count) {
+	if (p_count <= 0) {
+		return AABB();
+	}
+
+	Vector3 begin = p_points[0];
+	Vector3 end = p_points[0];
+	int64_t i = 0;
+	if (p_count >= 4) {
+		const Vector3x4 first = _load(p_points);
+		Vector3x4 min = first;
+		Vector3x4 max = first;
+		for (i = 4; i + 4 <= p_count; i += 4) {
+			const Vector3x4 v = _load(p_points + i);
+			min.x = SIMD_MIN(min.x, v.x);
+			min.y = SIMD_MIN(min.y, v.y);
+			min.z = SIMD_MIN(min.z, v.z);
+			max.x = SIMD_MAX(max.x, v.x);
+			max.y = SIMD_MAX(max.y, v.y);
+			max.z = SIMD_MAX(max.z, v.z);
+		}
+		begin.x = _reduce_min(min.x);
+		begin.y = _reduce_min(min.y);
+		begin.z = _reduce_min(min.z);
+		end.x = _reduce_max(max.x);
+		end.y = _reduce_max(max.y);
+		end.z = _reduce_max(max.z);
+	}
+
+	for (; i < p_count; i++) {
+		begin = begin.min(p_points[i]);
+		end = end.max(p_points[i]);
+	}
+	return AABB(begin, end - begin);
+}
+
+#else
+
+void BatchMath::transform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	for (int64_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_transform.xform(p_src[i]);
+	}
+}
+
+void BatchMath::transform_inv(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	for (int64_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_transform.xform_inv(p_src[i]);
+	}
+}
+
+void BatchMath::transform(const Basis &p_basis, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	for (int64_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_basis.xform(p_src[i]);
+	}
+}
+
+void BatchMath::normalize(const Vector3 *p_src, Vector3 *r_dst, int64_t p_count) {
+	for (int64_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_src[i].normalized();
+	}
+}
+
+void BatchMath::dot(const Vector3 *p_a, const Vector3 *p_b, real_t *r_dst, int64_t p_count) {
+	for (int64_t i = 0; i < p_count; i++) {
+		r_dst[i] = p_a[i].dot(p_b[i]);
+	}
+}
+
+AABB BatchMath::get_aabb(const Vector3 *p_points, int64_t p_count) {
+	if (p_count <= 0) {
+		return AABB();
+	}
+
+	Vector3 begin = p_points[0];
+	Vector3 end = p_points[0];
+	for (int64_t i = 1; i < p_count; i++) {
+		begin = begin.min(p_points[i]);
+		end = end.max(p_points[i]);
+	}
+	return AABB(begin, end - begin);
+}
+
+#endif
@@ -0,0 +1,50 @@
+/**************************************************************************/
+/*  batch_math.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BATCH_MATH_H
+#define BATCH_MATH_H
+
+#include "core/math/aabb.h"
+#include "core/math/transform_3d.h"
+
+// Operations over arrays of Vector3, vectorized with SSE2 or NEON when real_t is float.
+// Results match the per-element Transform3D, Basis and Vector3 methods. Source and destination may be the same array.
+class BatchMath {
+public:
+	static void transform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count);
+	static void transform_inv(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count);
+	static void transform(const Basis &p_basis, const Vector3 *p_src, Vector3 *r_dst, int64_t p_count);
+	static void normalize(const Vector3 *p_src, Vector3 *r_dst, int64_t p_count);
+	static void dot(const Vector3 *p_a, const Vector3 *p_b, real_t *r_dst, int64_t p_count);
+	// Returns an empty AABB when there are no points.
+	static AABB get_aabb(const Vector3 *p_points, int64_t p_count);
+};
+
+#endif // BATCH_MATH_H
@@ -88,6 +88,18 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// Minimum number of items before the refit, and number of changed items before the pairing,
+	// are spread over the WorkerThreadPool. 0 keeps everything on the calling thread.
+	void params_set_parallel_refit_threshold(uint32_t p_num_items) {
+		BVH_LOCKED_FUNCTION
+		tree._parallel_refit_threshold = p_num_items;
+	}
+
+	void params_set_parallel_pairing_threshold(uint32_t p_num_items) {
+		BVH_LOCKED_FUNCTION
+		tree._parallel_pairing_threshold = p_num_items;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -435,6 +447,12 @@ private:
 			return;
 		}
 
+		// with many changed items the culls are done up front in parallel
+		if (USE_PAIRS && tree.find_pair_candidates(changed_items.ptr(), changed_items.size())) {
+			_check_for_collisions_from_candidates(p_full_check);
+			return;
+		}
+
 		BOUNDS bb;
 
 		typename BVHTREE_CLASS::CullParams params;
@@ -480,6 +498,37 @@ private:
 		_reset();
 	}
 
+	// Same as _check_for_collisions, using the hits already found by tree.find_pair_candidates().
+	// The callbacks are sent in the same order as the single threaded version.
+	void _check_for_collisions_from_candidates(bool p_full_check) {
+		for (uint32_t n = 0; n < changed_items.size(); n++) {
+			const BVHHandle &h = changed_items[n];
+
+			BVHABB_CLASS abb;
+			abb.from(tree._pairs[h.id()].expanded_aabb);
+
+			// find all the existing paired aabbs that are no longer
+			// paired, and send callbacks
+			_find_leavers(h, abb, p_full_check);
+
+			uint32_t changed_item_ref_id = h.id();
+
+			for (const uint32_t ref_id : tree._pair_candidate_hits[n]) {
+				// don't collide against ourself
+				if (ref_id == changed_item_ref_id) {
+					continue;
+				}
+
+				BVHHandle h_collidee;
+				h_collidee.set_id(ref_id);
+
+				// find NEW enterers, and send callbacks for them only
+				_collide(h, h_collidee);
+			}
+		}
+		_reset();
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
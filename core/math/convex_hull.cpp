@@ -39,7 +39,10 @@
  * - integrated patch db0d6c92927f5a1358b887f2645c11f3014f0e8a from Bullet (CWE-190 integer overflow in btConvexHullComputer)
  * - adapted to Godot's code style
  * - replaced Bullet's types (e.g. vectors) with Godot's
- * - replaced custom Pool implementation with PagedAllocator
+ * - replaced custom Pool implementation with ConvexHullPool, which keeps its pages between hulls
+ * - bounds and quantization of the input are vectorized, and points strictly inside the hull of the extreme points are culled before sorting
+ * - duplicate points are removed after sorting
+ * - added ConvexHullComputer::convex_hull_batch()
  */
 
 /*
@@ -61,11 +64,22 @@ subject to the following restrictions:
 #include "core/error/error_macros.h"
 #include "core/math/aabb.h"
 #include "core/math/math_defs.h"
+#include "core/math/simd.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/memory.h"
 #include "core/templates/oa_hash_map.h"
-#include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
 
 #include <string.h>
+#include <type_traits>
+
+#if !defined(REAL_T_IS_DOUBLE)
+#if defined(SIMD_SSE2)
+#define CONVEX_HULL_SSE
+#elif defined(SIMD_NEON)
+#define CONVEX_HULL_NEON
+#endif
+#endif
 
 //#define DEBUG_CONVEX_HULL
 //#define SHOW_ITERATIONS
@@ -94,6 +108,68 @@ subject to the following restrictions:
 #include <stdio.h>
 #endif
 
+// Arena for the vertices, edges and faces of a hull. Pages grow geometrically so small hulls
+// only touch a few cache lines, and reset() keeps them so a ConvexHullInternal that is reused
+// for many hulls stops allocating once it has seen the largest one.
+template <typename T>
+class ConvexHullPool {
+	static_assert(std::is_trivially_destructible<T>::value, "ConvexHullPool elements are never destroyed.");
+	static_assert(sizeof(T) >= sizeof(void *), "ConvexHullPool elements must fit a free list link.");
+
+	static constexpr uint32_t MIN_PAGE_SIZE = 64;
+	static constexpr uint32_t MAX_PAGE_SIZE = 65536;
+
+	struct Page {
+		T *elements = nullptr;
+		uint32_t size = 0;
+	};
+
+	LocalVector<Page> pages;
+	uint32_t page = 0; // Page elements are currently taken from.
+	uint32_t used = 0; // Elements taken from that page.
+	T *free_list = nullptr;
+
+public:
+	T *alloc() {
+		if (free_list) {
+			T *element = free_list;
+			free_list = *reinterpret_cast<T **>(element);
+			return memnew_placement(element, T);
+		}
+		if (page == pages.size() || used == pages[page].size) {
+			if (page < pages.size()) {
+				page++;
+			}
+			if (page == pages.size()) {
+				Page new_page;
+				new_page.size = pages.is_empty() ? MIN_PAGE_SIZE : MIN(pages[pages.size() - 1].size * 2, MAX_PAGE_SIZE);
+				new_page.elements = static_cast<T *>(Memory::alloc_static(sizeof(T) * new_page.size));
+				pages.push_back(new_page);
+			}
+			used = 0;
+		}
+		return memnew_placement(&pages[page].elements[used++], T);
+	}
+
+	void free(T *p_element) {
+		*reinterpret_cast<T **>(p_element) = free_list;
+		free_list = p_element;
+	}
+
+	// Makes all elements available again, keeping the pages.
+	void reset() {
+		page = 0;
+		used = 0;
+		free_list = nullptr;
+	}
+
+	~ConvexHullPool() {
+		for (const Page &p : pages) {
+			Memory::free_static(p.elements);
+		}
+	}
+};
+
 // Convex hull implementation based on Preparata and Hong
 // Ole Kniemeyer, MAXON Computer GmbH
 class ConvexHullInternal {
@@ -604,9 +680,10 @@ private:
 
 	Vector3 scaling;
 	Vector3 center;
-	PagedAllocator<Vertex> vertex_pool;
-	PagedAllocator<Edge> edge_pool;
-	PagedAllocator<Face> face_pool;
+	ConvexHullPool<Vertex> vertex_pool;
+	ConvexHullPool<Edge> edge_pool;
+	ConvexHullPool<Face> face_pool;
+	LocalVector<Point32> points;
 	LocalVector<Vertex *> original_vertices;
 	int32_t merge_stamp = 0;
 	Vector3::Axis min_axis = Vector3::Axis::AXIS_X;
@@ -662,15 +739,12 @@ private:
 
 	bool shift_face(Face *p_face, real_t p_amount, LocalVector<Vertex *> &p_stack);
 
-public:
-	~ConvexHullInternal() {
-		vertex_pool.reset(true);
-		edge_pool.reset(true);
-		face_pool.reset(true);
-	}
+	void cull_interior_points();
 
+public:
 	Vertex *vertex_list = nullptr;
 
+	// Can be called repeatedly; memory is reused between hulls.
 	void compute(const Vector3 *p_coords, int32_t p_count);
 
 	Vector3 get_coordinates(const Vertex *p_v);
@@ -1576,18 +1650,257 @@ struct PointComparator {
 	}
 };
 
-void ConvexHullInternal::compute(const Vector3 *p_coords, int32_t p_count) {
-	AABB aabb;
-	for (int32_t i = 0; i < p_count; i++) {
-		Vector3 p = p_coords[i];
-		if (i == 0) {
-			aabb.position = p;
-		} else {
-			aabb.expand_to(p);
+// Points strictly inside the hull of the extreme points along the axes and the diagonals can't be
+// on the final hull. As this works on the quantized coordinates the hull is built from, and all the
+// arithmetic is exact, culling them doesn't change the result, but saves sorting and merging them.
+#if defined(CONVEX_HULL_SSE)
+
+#define HULL_INT4 __m128i
+#define HULL_INT4_SET1(m_value) _mm_set1_epi32(m_value)
+#define HULL_INT4_LOAD(m_src) _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_src))
+#define HULL_INT4_ADD(m_a, m_b) _mm_add_epi32(m_a, m_b)
+#define HULL_INT4_SUB(m_a, m_b) _mm_sub_epi32(m_a, m_b)
+#define HULL_INT4_LESS(m_a, m_b) _mm_cmplt_epi32(m_a, m_b)
+// m_a where m_mask is set, m_b elsewhere.
+#define HULL_INT4_SELECT(m_mask, m_a, m_b) _mm_or_si128(_mm_and_si128(m_mask, m_a), _mm_andnot_si128(m_mask, m_b))
+#define HULL_INT4_STORE(m_dst, m_a) _mm_storeu_si128(reinterpret_cast<__m128i *>(m_dst), m_a)
+
+// Coordinates of four points stored as structure of arrays.
+static _FORCE_INLINE_ void _load_points(const int32_t *p_src, __m128i &r_x, __m128i &r_y, __m128i &r_z) {
+	const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src)); // x0 y0 z0 i0
+	const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src + 4)); // x1 y1 z1 i1
+	const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src + 8)); // x2 y2 z2 i2
+	const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src + 12)); // x3 y3 z3 i3
+	const __m128i xy_01 = _mm_unpacklo_epi32(a, b); // x0 x1 y0 y1
+	const __m128i xy_23 = _mm_unpacklo_epi32(c, d); // x2 x3 y2 y3
+	const __m128i zi_01 = _mm_unpackhi_epi32(a, b); // z0 z1 i0 i1
+	const __m128i zi_23 = _mm_unpackhi_epi32(c, d); // z2 z3 i2 i3
+	r_x = _mm_unpacklo_epi64(xy_01, xy_23);
+	r_y = _mm_unpackhi_epi64(xy_01, xy_23);
+	r_z = _mm_unpacklo_epi64(zi_01, zi_23);
+}
+
+#elif defined(CONVEX_HULL_NEON)
+
+#define HULL_INT4 int32x4_t
+#define HULL_INT4_SET1(m_value) vdupq_n_s32(m_value)
+#define HULL_INT4_LOAD(m_src) vld1q_s32(m_src)
+#define HULL_INT4_ADD(m_a, m_b) vaddq_s32(m_a, m_b)
+#define HULL_INT4_SUB(m_a, m_b) vsubq_s32(m_a, m_b)
+#define HULL_INT4_LESS(m_a, m_b) vcltq_s32(m_a, m_b)
+#define HULL_INT4_SELECT(m_mask, m_a, m_b) vbslq_s32(m_mask, m_a, m_b)
+#define HULL_INT4_STORE(m_dst, m_a) vst1q_s32(m_dst, m_a)
+
+static _FORCE_INLINE_ void _load_points(const int32_t *p_src, int32x4_t &r_x, int32x4_t &r_y, int32x4_t &r_z) {
+	const int32x4x4_t v = vld4q_s32(p_src);
+	r_x = v.val[0];
+	r_y = v.val[1];
+	r_z = v.val[2];
+}
+
+#endif
+
+void ConvexHullInternal::cull_interior_points() {
+	const uint32_t count = points.size();
+	if (count < 32) {
+		return; // Not worth it.
+	}
+
+	// Extremes along the 3 axes and the 4 diagonals, in both directions.
+	const int32_t directions[7][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { -1, 1, 1 } };
+	uint32_t extremes[14] = {};
+	int64_t extreme_values[14];
+	for (int d = 0; d < 7; d++) {
+		extreme_values[d * 2] = (int64_t)points[0].x * directions[d][0] + (int64_t)points[0].y * directions[d][1] + (int64_t)points[0].z * directions[d][2];
+		extreme_values[d * 2 + 1] = extreme_values[d * 2];
+	}
+
+	uint32_t scanned = 1;
+#ifdef HULL_INT4
+	// Four points at a time, every lane keeps the first extremes of the points it sees. The quantized
+	// coordinates are within +-10216, so the projections on the diagonals fit in 32 bits.
+	static_assert(sizeof(Point32) == 4 * sizeof(int32_t));
+	HULL_INT4 lows[7];
+	HULL_INT4 highs[7];
+	HULL_INT4 low_ids[7];
+	HULL_INT4 high_ids[7];
+	for (int d = 0; d < 7; d++) {
+		lows[d] = HULL_INT4_SET1((int32_t)extreme_values[d * 2]);
+		highs[d] = lows[d];
+		low_ids[d] = HULL_INT4_SET1(0);
+		high_ids[d] = low_ids[d];
+	}
+
+	const int32_t first_ids[4] = { 1, 2, 3, 4 };
+	HULL_INT4 ids = HULL_INT4_LOAD(first_ids);
+	const HULL_INT4 four = HULL_INT4_SET1(4);
+	for (; scanned + 4 <= count; scanned += 4) {
+		HULL_INT4 x, y, z;
+		_load_points(&points[scanned].x, x, y, z);
+		const HULL_INT4 v[7] = {
+			x,
+			y,
+			z,
+			HULL_INT4_ADD(HULL_INT4_ADD(x, y), z),
+			HULL_INT4_SUB(HULL_INT4_ADD(x, y), z),
+			HULL_INT4_ADD(HULL_INT4_SUB(x, y), z),
+			HULL_INT4_SUB(HULL_INT4_ADD(y, z), x),
+		};
+		for (int d = 0; d < 7; d++) {
+			low_ids[d] = HULL_INT4_SELECT(HULL_INT4_LESS(v[d], lows[d]), ids, low_ids[d]);
+			lows[d] = HULL_INT4_SELECT(HULL_INT4_LESS(v[d], lows[d]), v[d], lows[d]);
+			high_ids[d] = HULL_INT4_SELECT(HULL_INT4_LESS(highs[d], v[d]), ids, high_ids[d]);
+			highs[d] = HULL_INT4_SELECT(HULL_INT4_LESS(highs[d], v[d]), v[d], highs[d]);
+		}
+		ids = HULL_INT4_ADD(ids, four);
+	}
+
+	// Same extremes as the scalar search: among equal values, the point that comes first.
+	for (int d = 0; d < 7; d++) {
+		int32_t values[4];
+		int32_t value_ids[4];
+		HULL_INT4_STORE(values, lows[d]);
+		HULL_INT4_STORE(value_ids, low_ids[d]);
+		for (int lane = 0; lane < 4; lane++) {
+			if (values[lane] < extreme_values[d * 2] || (values[lane] == extreme_values[d * 2] && uint32_t(value_ids[lane]) < extremes[d * 2])) {
+				extreme_values[d * 2] = values[lane];
+				extremes[d * 2] = value_ids[lane];
+			}
+		}
+		HULL_INT4_STORE(values, highs[d]);
+		HULL_INT4_STORE(value_ids, high_ids[d]);
+		for (int lane = 0; lane < 4; lane++) {
+			if (values[lane] > extreme_values[d * 2 + 1] || (values[lane] == extreme_values[d * 2 + 1] && uint32_t(value_ids[lane]) < extremes[d * 2 + 1])) {
+				extreme_values[d * 2 + 1] = values[lane];
+				extremes[d * 2 + 1] = value_ids[lane];
+			}
+		}
+	}
+#endif
+	for (; scanned < count; scanned++) {
+		const Point32 &p = points[scanned];
+		for (int d = 0; d < 7; d++) {
+			const int64_t v = (int64_t)p.x * directions[d][0] + (int64_t)p.y * directions[d][1] + (int64_t)p.z * directions[d][2];
+			if (v < extreme_values[d * 2]) {
+				extreme_values[d * 2] = v;
+				extremes[d * 2] = scanned;
+			}
+			if (v > extreme_values[d * 2 + 1]) {
+				extreme_values[d * 2 + 1] = v;
+				extremes[d * 2 + 1] = scanned;
+			}
 		}
 	}
 
-	Vector3 s = aabb.size;
+	Point32 extreme_points[14];
+	int32_t extreme_count = 0;
+	for (int i = 0; i < 14; i++) {
+		const Point32 &p = points[extremes[i]];
+		bool duplicate = false;
+		for (int j = 0; j < extreme_count; j++) {
+			if (extreme_points[j] == p) {
+				duplicate = true;
+				break;
+			}
+		}
+		if (!duplicate) {
+			extreme_points[extreme_count++] = p;
+		}
+	}
+	if (extreme_count < 4) {
+		return;
+	}
+
+	// Supporting planes through every triple of extreme points. If the extreme points are coplanar,
+	// the plane is added with both orientations and nothing is culled.
+	struct CullPlane {
+		int64_t x = 0;
+		int64_t y = 0;
+		int64_t z = 0;
+		int64_t dist = 0;
+	};
+	LocalVector<CullPlane> planes;
+	for (int32_t a = 0; a < extreme_count; a++) {
+		for (int32_t b = a + 1; b < extreme_count; b++) {
+			for (int32_t c = b + 1; c < extreme_count; c++) {
+				Point64 normal = (extreme_points[b] - extreme_points[a]).cross(extreme_points[c] - extreme_points[a]);
+				if (normal.is_zero()) {
+					continue;
+				}
+				const int64_t dist = extreme_points[a].dot(normal);
+				bool above = false;
+				bool below = false;
+				for (int32_t i = 0; i < extreme_count; i++) {
+					const int64_t side = extreme_points[i].dot(normal) - dist;
+					above = above || side > 0;
+					below = below || side < 0;
+				}
+				if (!above) {
+					planes.push_back({ normal.x, normal.y, normal.z, dist });
+				}
+				if (!below) {
+					planes.push_back({ -normal.x, -normal.y, -normal.z, -dist });
+				}
+			}
+		}
+	}
+
+	uint32_t kept = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		const Point32 &p = points[i];
+		bool inside = true;
+		for (const CullPlane &plane : planes) {
+			if (p.x * plane.x + p.y * plane.y + p.z * plane.z >= plane.dist) {
+				inside = false;
+				break;
+			}
+		}
+		if (!inside) {
+			points[kept++] = p;
+		}
+	}
+	points.resize(kept);
+}
+
+void ConvexHullInternal::compute(const Vector3 *p_coords, int32_t p_count) {
+	Vector3 begin = p_coords[0];
+	Vector3 end = p_coords[0];
+	int32_t i = 0;
+	// The 4th lane reads the x coordinate of the next point and is ignored, so the last point is left to the scalar loop.
+#if defined(CONVEX_HULL_SSE)
+	if (p_count > 1) {
+		__m128 min = _mm_loadu_ps(&p_coords[0].x);
+		__m128 max = min;
+		for (i = 1; i < p_count - 1; i++) {
+			const __m128 p = _mm_loadu_ps(&p_coords[i].x);
+			min = _mm_min_ps(min, p);
+			max = _mm_max_ps(max, p);
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, min);
+		begin = Vector3(lanes[0], lanes[1], lanes[2]);
+		_mm_storeu_ps(lanes, max);
+		end = Vector3(lanes[0], lanes[1], lanes[2]);
+	}
+#elif defined(CONVEX_HULL_NEON)
+	if (p_count > 1) {
+		float32x4_t min = vld1q_f32(&p_coords[0].x);
+		float32x4_t max = min;
+		for (i = 1; i < p_count - 1; i++) {
+			const float32x4_t p = vld1q_f32(&p_coords[i].x);
+			min = vminq_f32(min, p);
+			max = vmaxq_f32(max, p);
+		}
+		begin = Vector3(vgetq_lane_f32(min, 0), vgetq_lane_f32(min, 1), vgetq_lane_f32(min, 2));
+		end = Vector3(vgetq_lane_f32(max, 0), vgetq_lane_f32(max, 1), vgetq_lane_f32(max, 2));
+	}
+#endif
+	for (; i < p_count; i++) {
+		begin = begin.min(p_coords[i]);
+		end = end.max(p_coords[i]);
+	}
+
+	Vector3 s = end - begin;
 	max_axis = s.max_axis_index();
 	min_axis = s.min_axis_index();
 	if (min_axis == max_axis) {
@@ -1611,11 +1924,37 @@ void ConvexHullInternal::compute(const Vector3 *p_coords, int32_t p_count) {
 		s[2] = real_t(1) / s[2];
 	}
 
-	center = aabb.position;
+	center = begin;
 
-	LocalVector<Point32> points;
 	points.resize(p_count);
-	for (int32_t i = 0; i < p_count; i++) {
+	i = 0;
+	// Same operations as the scalar loop, so both give the same coordinates.
+#if defined(CONVEX_HULL_SSE)
+	const __m128 center_4 = _mm_setr_ps(center.x, center.y, center.z, 0);
+	const __m128 s_4 = _mm_setr_ps(s.x, s.y, s.z, 0);
+	for (; i < p_count - 1; i++) {
+		int32_t q[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(q), _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&p_coords[i].x), center_4), s_4)));
+		points[i].x = q[med_axis];
+		points[i].y = q[max_axis];
+		points[i].z = q[min_axis];
+		points[i].index = i;
+	}
+#elif defined(CONVEX_HULL_NEON)
+	const float center_lanes[4] = { center.x, center.y, center.z, 0 };
+	const float s_lanes[4] = { s.x, s.y, s.z, 0 };
+	const float32x4_t center_4 = vld1q_f32(center_lanes);
+	const float32x4_t s_4 = vld1q_f32(s_lanes);
+	for (; i < p_count - 1; i++) {
+		int32_t q[4];
+		vst1q_s32(q, vcvtq_s32_f32(vmulq_f32(vsubq_f32(vld1q_f32(&p_coords[i].x), center_4), s_4)));
+		points[i].x = q[med_axis];
+		points[i].y = q[max_axis];
+		points[i].z = q[min_axis];
+		points[i].index = i;
+	}
+#endif
+	for (; i < p_count; i++) {
 		Vector3 p = p_coords[i];
 		p = (p - center) * s;
 		points[i].x = (int32_t)p[med_axis];
@@ -1624,29 +1963,39 @@ void ConvexHullInternal::compute(const Vector3 *p_coords, int32_t p_count) {
 		points[i].index = i;
 	}
 
+	cull_interior_points();
+
 	points.sort_custom<PointComparator>();
 
-	vertex_pool.reset(true);
-	original_vertices.resize(p_count);
-	for (int32_t i = 0; i < p_count; i++) {
+	// Duplicates end up next to each other once sorted, and only one of them can be a hull vertex.
+	uint32_t unique_count = points.is_empty() ? 0 : 1;
+	for (uint32_t j = 1; j < points.size(); j++) {
+		if (points[j] != points[unique_count - 1]) {
+			points[unique_count++] = points[j];
+		}
+	}
+	points.resize(unique_count);
+
+	vertex_pool.reset();
+	edge_pool.reset();
+	face_pool.reset();
+
+	original_vertices.resize(unique_count);
+	for (uint32_t j = 0; j < unique_count; j++) {
 		Vertex *v = vertex_pool.alloc();
 		v->edges = nullptr;
-		v->point = points[i];
+		v->point = points[j];
 		v->copy = -1;
-		original_vertices[i] = v;
+		original_vertices[j] = v;
 	}
 
-	points.clear();
-
-	edge_pool.reset(true);
-
 	used_edge_pairs = 0;
 	max_used_edge_pairs = 0;
 
 	merge_stamp = -3;
 
 	IntermediateHull hull;
-	compute_internal(0, p_count, hull);
+	compute_internal(0, unique_count, hull);
 	vertex_list = hull.min_xy;
 #ifdef DEBUG_CONVEX_HULL
 	printf("max. edges %d (3v = %d)", max_used_edge_pairs, 3 * p_count);
@@ -2152,6 +2501,11 @@ static int32_t get_vertex_copy(ConvexHullInternal::Vertex *p_vertex, LocalVector
 }
 
 real_t ConvexHullComputer::compute(const Vector3 *p_coords, int32_t p_count, real_t p_shrink, real_t p_shrink_clamp) {
+	ConvexHullInternal hull;
+	return _compute(hull, p_coords, p_count, p_shrink, p_shrink_clamp);
+}
+
+real_t ConvexHullComputer::_compute(ConvexHullInternal &p_hull, const Vector3 *p_coords, int32_t p_count, real_t p_shrink, real_t p_shrink_clamp) {
 	if (p_count <= 0) {
 		vertices.clear();
 		edges.clear();
@@ -2159,7 +2513,7 @@ real_t ConvexHullComputer::compute(const Vector3 *p_coords, int32_t p_count, rea
 		return 0;
 	}
 
-	ConvexHullInternal hull;
+	ConvexHullInternal &hull = p_hull;
 	hull.compute(p_coords, p_count);
 
 	real_t shift = 0;
@@ -2244,14 +2598,20 @@ real_t ConvexHullComputer::compute(const Vector3 *p_coords, int32_t p_count, rea
 }
 
 Error ConvexHullComputer::convex_hull(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_mesh) {
+	ConvexHullInternal hull;
+	ConvexHullComputer ch;
+	return _convex_hull(hull, ch, p_points, r_mesh);
+}
+
+Error ConvexHullComputer::_convex_hull(ConvexHullInternal &p_hull, ConvexHullComputer &p_computer, const Vector<Vector3> &p_points, Geometry3D::MeshData &r_mesh) {
 	r_mesh = Geometry3D::MeshData(); // clear
 
 	if (p_points.size() == 0) {
 		return FAILED; // matches QuickHull
 	}
 
-	ConvexHullComputer ch;
-	ch.compute(p_points.ptr(), p_points.size(), -1.0, -1.0);
+	ConvexHullComputer &ch = p_computer;
+	ch._compute(p_hull, p_points.ptr(), p_points.size(), -1.0, -1.0);
 
 	r_mesh.vertices = ch.vertices;
 
@@ -2345,3 +2705,58 @@ Error ConvexHullComputer::convex_hull(const Vector<Vector3> &p_points, Geometry3
 
 	return OK;
 }
+
+struct ConvexHullBatch {
+	const Vector<Vector3> *point_sets = nullptr;
+	Geometry3D::MeshData *meshes = nullptr;
+	Error *errors = nullptr;
+	uint32_t count = 0;
+	SafeNumeric<uint32_t> next_hull;
+};
+
+void ConvexHullComputer::_convex_hull_batch_slot(void *p_userdata, uint32_t p_slot) {
+	ConvexHullBatch *batch = static_cast<ConvexHullBatch *>(p_userdata);
+	// Each slot reuses its pools and output arrays for all the hulls it builds.
+	ConvexHullInternal hull;
+	ConvexHullComputer ch;
+	for (uint32_t i = batch->next_hull.postincrement(); i < batch->count; i = batch->next_hull.postincrement()) {
+		batch->errors[i] = _convex_hull(hull, ch, batch->point_sets[i], batch->meshes[i]);
+	}
+}
+
+// Builds the hulls of all p_point_sets, on the WorkerThreadPool if there is more than one.
+// Slots pick up the next hull as soon as they are done with the previous one, so a few large
+// hulls don't hold the others back. Hulls are built inline on pool threads that can't wait for
+// group tasks.
+Error ConvexHullComputer::convex_hull_batch(const Vector<Vector<Vector3>> &p_point_sets, Vector<Geometry3D::MeshData> &r_meshes) {
+	const uint32_t count = p_point_sets.size();
+	r_meshes.resize(count);
+	if (count == 0) {
+		return OK;
+	}
+
+	LocalVector<Error> errors;
+	errors.resize(count);
+
+	ConvexHullBatch batch;
+	batch.point_sets = p_point_sets.ptr();
+	batch.meshes = r_meshes.ptrw();
+	batch.errors = errors.ptr();
+	batch.count = count;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const uint32_t task_count = pool ? MIN(uint32_t(MAX(pool->get_thread_count(), 1)), count) : 1;
+	if (task_count <= 1 || !WorkerThreadPool::can_wait_for_group_task()) {
+		_convex_hull_batch_slot(&batch, 0);
+	} else {
+		WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&_convex_hull_batch_slot, &batch, task_count, -1, true, SNAME("ConvexHullBatch"));
+		pool->wait_for_group_task_completion(group_task);
+	}
+
+	for (const Error err : errors) {
+		if (err != OK) {
+			return err;
+		}
+	}
+	return OK;
+}
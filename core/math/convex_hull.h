@@ -48,6 +48,8 @@ subject to the following restrictions:
 #include "core/templates/local_vector.h"
 #include "core/templates/vector.h"
 
+class ConvexHullInternal;
+
 /// Convex hull implementation based on Preparata and Hong
 /// See https://code.google.com/archive/p/bullet/issues/275
 /// Ole Kniemeyer, MAXON Computer GmbH
@@ -111,6 +113,15 @@ public:
 	real_t compute(const Vector3 *p_coords, int32_t p_count, real_t p_shrink, real_t p_shrink_clamp);
 
 	static Error convex_hull(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_mesh);
+
+	// Builds the convex hull of each point set into the matching entry of r_meshes, in parallel.
+	// Returns the first error in the order of p_point_sets, or OK.
+	static Error convex_hull_batch(const Vector<Vector<Vector3>> &p_point_sets, Vector<Geometry3D::MeshData> &r_meshes);
+
+private:
+	real_t _compute(ConvexHullInternal &p_hull, const Vector3 *p_coords, int32_t p_count, real_t p_shrink, real_t p_shrink_clamp);
+	static Error _convex_hull(ConvexHullInternal &p_hull, ConvexHullComputer &p_computer, const Vector<Vector3> &p_points, Geometry3D::MeshData &r_mesh);
+	static void _convex_hull_batch_slot(void *p_userdata, uint32_t p_slot);
 };
 
 #endif // CONVEX_HULL_H
@@ -31,36 +31,23 @@
 #ifndef DELAUNAY_3D_H
 #define DELAUNAY_3D_H
 
-#include "core/io/file_access.h"
 #include "core/math/aabb.h"
-#include "core/math/projection.h"
+#include "core/math/random_pcg.h"
 #include "core/math/vector3.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
-#include "core/templates/oa_hash_map.h"
+#include "core/templates/sort_array.h"
 #include "core/templates/vector.h"
-#include "core/variant/variant.h"
 
 #include "thirdparty/misc/r128.h"
 
 class Delaunay3D {
-	struct Simplex;
-
-	enum {
-		ACCEL_GRID_SIZE = 16
-	};
-	struct GridPos {
-		Vector3i pos;
-		List<Simplex *>::Element *E = nullptr;
-	};
-
 	struct Simplex {
 		uint32_t points[4];
 		R128 circum_center_x;
 		R128 circum_center_y;
 		R128 circum_center_z;
 		R128 circum_r2;
-		LocalVector<GridPos> grid_positions;
-		List<Simplex *>::Element *SE = nullptr;
 
 		_FORCE_INLINE_ Simplex() {}
 		_FORCE_INLINE_ Simplex(uint32_t p_a, uint32_t p_b, uint32_t p_c, uint32_t p_d) {
@@ -71,39 +58,6 @@ class Delaunay3D {
 		}
 	};
 
-	struct Triangle {
-		uint32_t triangle[3];
-		bool bad = false;
-		_FORCE_INLINE_ bool operator==(const Triangle &p_triangle) const {
-			return triangle[0] == p_triangle.triangle[0] && triangle[1] == p_triangle.triangle[1] && triangle[2] == p_triangle.triangle[2];
-		}
-
-		_FORCE_INLINE_ Triangle() {}
-		_FORCE_INLINE_ Triangle(uint32_t p_a, uint32_t p_b, uint32_t p_c) {
-			if (p_a > p_b) {
-				SWAP(p_a, p_b);
-			}
-			if (p_b > p_c) {
-				SWAP(p_b, p_c);
-			}
-			if (p_a > p_b) {
-				SWAP(p_a, p_b);
-			}
-
-			triangle[0] = p_a;
-			triangle[1] = p_b;
-			triangle[2] = p_c;
-		}
-	};
-
-	struct TriangleHasher {
-		_FORCE_INLINE_ static uint32_t hash(const Triangle &p_triangle) {
-			uint32_t h = hash_djb2_one_32(p_triangle.triangle[0]);
-			h = hash_djb2_one_32(p_triangle.triangle[1], h);
-			return hash_fmix32(hash_djb2_one_32(p_triangle.triangle[2], h));
-		}
-	};
-
 	_FORCE_INLINE_ static void circum_sphere_compute(const Vector3 *p_points, Simplex *p_simplex) {
 		// The only part in the algorithm where there may be precision errors is this one,
 		// so ensure that we do it with the maximum precision possible.
@@ -176,35 +130,212 @@ class Delaunay3D {
 		return radius2 < (p_simplex.circum_r2 - R128(0.00001));
 	}
 
-	static bool simplex_is_coplanar(const Vector3 *p_points, const Simplex &p_simplex) {
-		Plane p(p_points[p_simplex.points[0]], p_points[p_simplex.points[1]], p_points[p_simplex.points[2]]);
-		if (ABS(p.distance_to(p_points[p_simplex.points[3]])) < CMP_EPSILON) {
-			return true;
+	enum {
+		INVALID_TETRAHEDRON = 0xFFFFFFFF,
+		HILBERT_BITS = 10,
+		BRIO_MIN_ROUND_SIZE = 64,
+	};
+
+	// Tetrahedra of the walk-based triangulation are positively oriented,
+	// and neighbors[i] is the tetrahedron sharing the face opposite to points[i].
+	struct Tetrahedron {
+		uint32_t points[4];
+		uint32_t neighbors[4];
+		uint32_t cavity_pass = 0;
+		bool removed = false;
+		double circum_center[3] = {};
+		double circum_r2 = 0.0;
+		// Bound of the rounding errors of the circumsphere test, which falls back to simplex_contains() below it.
+		double circum_tolerance = 0.0;
+	};
+
+	struct CavityFace {
+		uint32_t points[4];
+		uint32_t face = 0;
+		uint32_t neighbor = INVALID_TETRAHEDRON;
+		uint32_t neighbor_face = 0;
+	};
+
+	// Face of a new tetrahedron containing the inserted point, identified by its two other points.
+	struct OpenFace {
+		uint64_t edge = 0;
+		uint32_t tetrahedron = 0;
+		uint32_t face = 0;
+	};
+
+	struct SortPoint {
+		uint32_t hilbert_index = 0;
+		uint32_t point = 0;
+		_FORCE_INLINE_ bool operator<(const SortPoint &p_other) const {
+			return hilbert_index < p_other.hilbert_index;
 		}
+	};
 
-		Projection cm;
+	// Position along a 3D Hilbert curve, from coordinates in the [0, 1] range.
+	static uint32_t hilbert_index(const Vector3 &p_point) {
+		const uint32_t max_coord = (1 << HILBERT_BITS) - 1;
+		uint32_t x[3];
+		for (int i = 0; i < 3; i++) {
+			x[i] = CLAMP(int64_t(p_point[i] * max_coord), 0, max_coord);
+		}
 
-		cm.columns[0][0] = p_points[p_simplex.points[0]].x;
-		cm.columns[0][1] = p_points[p_simplex.points[1]].x;
-		cm.columns[0][2] = p_points[p_simplex.points[2]].x;
-		cm.columns[0][3] = p_points[p_simplex.points[3]].x;
+		// Convert the coordinates to the transposed Hilbert index (J. Skilling, "Programming the Hilbert curve").
+		for (uint32_t q = 1 << (HILBERT_BITS - 1); q > 1; q >>= 1) {
+			const uint32_t p = q - 1;
+			for (int i = 0; i < 3; i++) {
+				if (x[i] & q) {
+					x[0] ^= p;
+				} else {
+					const uint32_t t = (x[0] ^ x[i]) & p;
+					x[0] ^= t;
+					x[i] ^= t;
+				}
+			}
+		}
+		x[1] ^= x[0];
+		x[2] ^= x[1];
+		uint32_t t = 0;
+		for (uint32_t q = 1 << (HILBERT_BITS - 1); q > 1; q >>= 1) {
+			if (x[2] & q) {
+				t ^= q - 1;
+			}
+		}
+		for (int i = 0; i < 3; i++) {
+			x[i] ^= t;
+		}
 
-		cm.columns[1][0] = p_points[p_simplex.points[0]].y;
-		cm.columns[1][1] = p_points[p_simplex.points[1]].y;
-		cm.columns[1][2] = p_points[p_simplex.points[2]].y;
-		cm.columns[1][3] = p_points[p_simplex.points[3]].y;
+		uint32_t index = 0;
+		for (int bit = HILBERT_BITS - 1; bit >= 0; bit--) {
+			for (int i = 0; i < 3; i++) {
+				index = (index << 1) | ((x[i] >> bit) & 1);
+			}
+		}
+		return index;
+	}
 
-		cm.columns[2][0] = p_points[p_simplex.points[0]].z;
-		cm.columns[2][1] = p_points[p_simplex.points[1]].z;
-		cm.columns[2][2] = p_points[p_simplex.points[2]].z;
-		cm.columns[2][3] = p_points[p_simplex.points[3]].z;
+	// Six times the signed volume of the tetrahedron.
+	_FORCE_INLINE_ static double orientation(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c, const Vector3 &p_d) {
+		const double ax = double(p_a.x) - p_d.x;
+		const double ay = double(p_a.y) - p_d.y;
+		const double az = double(p_a.z) - p_d.z;
+		const double bx = double(p_b.x) - p_d.x;
+		const double by = double(p_b.y) - p_d.y;
+		const double bz = double(p_b.z) - p_d.z;
+		const double cx = double(p_c.x) - p_d.x;
+		const double cy = double(p_c.y) - p_d.y;
+		const double cz = double(p_c.z) - p_d.z;
+		return ax * (by * cz - bz * cy) - ay * (bx * cz - bz * cx) + az * (bx * cy - by * cx);
+	}
 
-		cm.columns[3][0] = 1.0;
-		cm.columns[3][1] = 1.0;
-		cm.columns[3][2] = 1.0;
-		cm.columns[3][3] = 1.0;
+	// Orientation of the tetrahedron with its point p_index replaced by p_point, negative when the point is beyond the face opposite to p_index.
+	_FORCE_INLINE_ static double face_orientation(const Vector3 *p_points, const Tetrahedron &p_tetrahedron, uint32_t p_index, const Vector3 &p_point) {
+		Vector3 v[4];
+		for (uint32_t i = 0; i < 4; i++) {
+			v[i] = i == p_index ? p_point : p_points[p_tetrahedron.points[i]];
+		}
+		return orientation(v[0], v[1], v[2], v[3]);
+	}
 
-		return ABS(cm.determinant()) <= CMP_EPSILON;
+	// Relative to the size of the tetrahedron, so that small tetrahedra of dense point sets are kept.
+	static bool tetrahedron_is_flat(const Vector3 *p_points, const Tetrahedron &p_tetrahedron) {
+		const Vector3 &a = p_points[p_tetrahedron.points[0]];
+		const Vector3 &b = p_points[p_tetrahedron.points[1]];
+		const Vector3 &c = p_points[p_tetrahedron.points[2]];
+		const Vector3 &d = p_points[p_tetrahedron.points[3]];
+		const double longest_edge = Math::sqrt(MAX(MAX(MAX(a.distance_squared_to(b), a.distance_squared_to(c)), MAX(a.distance_squared_to(d), b.distance_squared_to(c))), MAX(b.distance_squared_to(d), c.distance_squared_to(d))));
+		return ABS(orientation(a, b, c, d)) <= CMP_EPSILON * longest_edge * longest_edge * longest_edge;
+	}
+
+	static void tetrahedron_circum_sphere_compute(const Vector3 *p_points, Tetrahedron &r_tetrahedron) {
+		const Vector3 &v0 = p_points[r_tetrahedron.points[0]];
+		double rows[3][3];
+		double sq_lengths[3];
+		double longest_sq_length = 0.0;
+		for (int i = 0; i < 3; i++) {
+			const Vector3 &v = p_points[r_tetrahedron.points[i + 1]];
+			rows[i][0] = double(v.x) - v0.x;
+			rows[i][1] = double(v.y) - v0.y;
+			rows[i][2] = double(v.z) - v0.z;
+			sq_lengths[i] = rows[i][0] * rows[i][0] + rows[i][1] * rows[i][1] + rows[i][2] * rows[i][2];
+			longest_sq_length = MAX(longest_sq_length, sq_lengths[i]);
+		}
+
+		const double cross_23[3] = { rows[1][1] * rows[2][2] - rows[2][1] * rows[1][2], rows[1][2] * rows[2][0] - rows[2][2] * rows[1][0], rows[1][0] * rows[2][1] - rows[2][0] * rows[1][1] };
+		const double cross_31[3] = { rows[2][1] * rows[0][2] - rows[0][1] * rows[2][2], rows[2][2] * rows[0][0] - rows[0][2] * rows[2][0], rows[2][0] * rows[0][1] - rows[0][0] * rows[2][1] };
+		const double cross_12[3] = { rows[0][1] * rows[1][2] - rows[1][1] * rows[0][2], rows[0][2] * rows[1][0] - rows[1][2] * rows[0][0], rows[0][0] * rows[1][1] - rows[1][0] * rows[0][1] };
+		const double determinant = rows[0][0] * cross_23[0] + rows[0][1] * cross_23[1] + rows[0][2] * cross_23[2];
+
+		if (determinant == 0.0) {
+			r_tetrahedron.circum_tolerance = INFINITY;
+			return;
+		}
+
+		double relative_center[3];
+		for (int i = 0; i < 3; i++) {
+			relative_center[i] = (cross_23[i] * sq_lengths[0] + cross_31[i] * sq_lengths[1] + cross_12[i] * sq_lengths[2]) / (2.0 * determinant);
+		}
+		r_tetrahedron.circum_center[0] = v0.x + relative_center[0];
+		r_tetrahedron.circum_center[1] = v0.y + relative_center[1];
+		r_tetrahedron.circum_center[2] = v0.z + relative_center[2];
+		r_tetrahedron.circum_r2 = relative_center[0] * relative_center[0] + relative_center[1] * relative_center[1] + relative_center[2] * relative_center[2];
+
+		// Rounding errors grow as the tetrahedron gets flatter.
+		const double condition = longest_sq_length * Math::sqrt(longest_sq_length) / ABS(determinant);
+		r_tetrahedron.circum_tolerance = 1e-12 * condition * (r_tetrahedron.circum_r2 + 1.0);
+	}
+
+	_FORCE_INLINE_ static bool tetrahedron_contains(const Vector3 *p_points, const Tetrahedron &p_tetrahedron, uint32_t p_vertex) {
+		const Vector3 &v = p_points[p_vertex];
+		const double rel_x = p_tetrahedron.circum_center[0] - v.x;
+		const double rel_y = p_tetrahedron.circum_center[1] - v.y;
+		const double rel_z = p_tetrahedron.circum_center[2] - v.z;
+		// Same threshold as simplex_contains().
+		const double difference = rel_x * rel_x + rel_y * rel_y + rel_z * rel_z - (p_tetrahedron.circum_r2 - 0.00001);
+		if (difference < -p_tetrahedron.circum_tolerance) {
+			return true;
+		}
+		if (difference > p_tetrahedron.circum_tolerance) {
+			return false;
+		}
+
+		Simplex simplex(p_tetrahedron.points[0], p_tetrahedron.points[1], p_tetrahedron.points[2], p_tetrahedron.points[3]);
+		circum_sphere_compute(p_points, &simplex);
+		return simplex_contains(p_points, simplex, p_vertex);
+	}
+
+	// Walks from p_start towards the tetrahedron containing the point, crossing a face the point is beyond at each step.
+	static uint32_t locate_point(const Vector3 *p_points, const LocalVector<Tetrahedron> &p_tetrahedra, uint32_t p_start, uint32_t p_vertex, uint32_t &r_random) {
+		const Vector3 &point = p_points[p_vertex];
+		uint32_t current = p_start;
+		for (uint32_t step = 0; step < p_tetrahedra.size(); step++) {
+			const Tetrahedron &tetrahedron = p_tetrahedra[current];
+			// Start from a random face, so the walk can't cycle on degenerate configurations.
+			r_random = r_random * 1664525 + 1013904223;
+			const uint32_t first_face = r_random >> 30;
+			uint32_t next = current;
+			for (uint32_t i = 0; i < 4; i++) {
+				const uint32_t face = (first_face + i) & 3;
+				if (face_orientation(p_points, tetrahedron, face, point) < 0.0) {
+					next = tetrahedron.neighbors[face];
+					break;
+				}
+			}
+			if (next == current) {
+				return current;
+			}
+			if (next == INVALID_TETRAHEDRON) {
+				break;
+			}
+			current = next;
+		}
+
+		// The walk failed because of precision issues, look for a tetrahedron in conflict with the point instead.
+		for (uint32_t i = 0; i < p_tetrahedra.size(); i++) {
+			if (!p_tetrahedra[i].removed && tetrahedron_contains(p_points, p_tetrahedra[i], p_vertex)) {
+				return i;
+			}
+		}
+		return current;
 	}
 
 public:
@@ -212,25 +343,33 @@ public:
 		uint32_t points[4];
 	};
 
+	// Incremental Bowyer-Watson tetrahedralization. Points are inserted in a
+	// biased randomized order sorted along a Hilbert curve, and each one is
+	// located by walking the tetrahedra adjacency from the last inserted one,
+	// so the whole process runs in about O(n log n).
 	static Vector<OutputSimplex> tetrahedralize(const Vector<Vector3> &p_points) {
-		uint32_t point_count = p_points.size();
-		Vector3 *points = (Vector3 *)memalloc(sizeof(Vector3) * (point_count + 4));
+		const uint32_t point_count = p_points.size();
+		LocalVector<Vector3> points;
+		points.resize(point_count + 4);
 
 		{
 			const Vector3 *src_points = p_points.ptr();
 			AABB rect;
 			for (uint32_t i = 0; i < point_count; i++) {
-				Vector3 point = src_points[i];
 				if (i == 0) {
-					rect.position = point;
+					rect.position = src_points[i];
 				} else {
-					rect.expand_to(point);
+					rect.expand_to(src_points[i]);
 				}
-				points[i] = point;
+			}
+
+			if (point_count < 4 || rect.size.x == 0 || rect.size.y == 0 || rect.size.z == 0) {
+				// Flat point sets can't produce any tetrahedron.
+				return Vector<OutputSimplex>();
 			}
 
 			for (uint32_t i = 0; i < point_count; i++) {
-				points[i] = (points[i] - rect.position) / rect.size;
+				points[i] = (src_points[i] - rect.position) / rect.size;
 			}
 
 			const real_t delta_max = Math::sqrt(2.0) * 20.0;
@@ -243,150 +382,223 @@ public:
 			points[point_count + 3] = center + Vector3(-1, -1, -1) * delta_max;
 		}
 
-		List<Simplex *> acceleration_grid[ACCEL_GRID_SIZE][ACCEL_GRID_SIZE][ACCEL_GRID_SIZE];
-
-		List<Simplex *> simplex_list;
+		// Skip duplicated points, keeping the last one like the previous implementation did.
+		// Points closer than the approximate equality tolerance fall in the same or adjacent cells.
+		LocalVector<SortPoint> insertion_order;
 		{
-			//create root simplex
-			Simplex *root = memnew(Simplex(point_count + 0, point_count + 1, point_count + 2, point_count + 3));
-			root->SE = simplex_list.push_back(root);
-
-			for (uint32_t i = 0; i < ACCEL_GRID_SIZE; i++) {
-				for (uint32_t j = 0; j < ACCEL_GRID_SIZE; j++) {
-					for (uint32_t k = 0; k < ACCEL_GRID_SIZE; k++) {
-						GridPos gp;
-						gp.E = acceleration_grid[i][j][k].push_back(root);
-						gp.pos = Vector3i(i, j, k);
-						root->grid_positions.push_back(gp);
+			HashMap<Vector3i, uint32_t> cells;
+			const real_t cell_size = CMP_EPSILON;
+			for (int64_t i = int64_t(point_count) - 1; i >= 0; i--) {
+				const Vector3i cell = Vector3i((points[i] / cell_size).floor());
+				bool unique = true;
+				for (int x = -1; x <= 1 && unique; x++) {
+					for (int y = -1; y <= 1 && unique; y++) {
+						for (int z = -1; z <= 1 && unique; z++) {
+							const uint32_t *other = cells.getptr(cell + Vector3i(x, y, z));
+							if (other && points[i].is_equal_approx(points[*other])) {
+								unique = false;
+							}
+						}
 					}
 				}
+				if (unique) {
+					cells.insert(cell, i);
+					SortPoint sort_point;
+					sort_point.point = i;
+					sort_point.hilbert_index = hilbert_index(points[i]);
+					insertion_order.push_back(sort_point);
+				}
 			}
-
-			circum_sphere_compute(points, root);
 		}
 
-		OAHashMap<Triangle, uint32_t, TriangleHasher> triangles_inserted;
-		LocalVector<Triangle> triangles;
-
-		for (uint32_t i = 0; i < point_count; i++) {
-			bool unique = true;
-			for (uint32_t j = i + 1; j < point_count; j++) {
-				if (points[i].is_equal_approx(points[j])) {
-					unique = false;
-					break;
-				}
-			}
-			if (!unique) {
-				continue;
+		// Biased randomized insertion order: shuffle the points, split them in rounds
+		// of doubling size, and sort each round along the Hilbert curve.
+		{
+			RandomPCG rng(0x44656c61); // Keep the output stable across runs.
+			for (uint32_t i = insertion_order.size(); i > 1; i--) {
+				SWAP(insertion_order[i - 1], insertion_order[rng.rand(i)]);
 			}
 
-			Vector3i grid_pos = Vector3i(points[i] * ACCEL_GRID_SIZE);
-			grid_pos = grid_pos.clamp(Vector3i(), Vector3i(ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1));
-
-			for (List<Simplex *>::Element *E = acceleration_grid[grid_pos.x][grid_pos.y][grid_pos.z].front(); E;) {
-				List<Simplex *>::Element *N = E->next(); //may be deleted
+			SortArray<SortPoint> sorter;
+			uint32_t round_end = insertion_order.size();
+			while (round_end > 0) {
+				const uint32_t round_begin = round_end > BRIO_MIN_ROUND_SIZE ? round_end / 2 : 0;
+				sorter.sort(insertion_order.ptr() + round_begin, round_end - round_begin);
+				round_end = round_begin;
+			}
+		}
 
-				Simplex *simplex = E->get();
+		LocalVector<Tetrahedron> tetrahedra;
+		LocalVector<uint32_t> free_tetrahedra;
+		{
+			//create root simplex
+			Tetrahedron root;
+			root.points[0] = point_count + 0;
+			root.points[1] = point_count + 1;
+			root.points[2] = point_count + 2;
+			root.points[3] = point_count + 3;
+			if (orientation(points[root.points[0]], points[root.points[1]], points[root.points[2]], points[root.points[3]]) < 0.0) {
+				SWAP(root.points[0], root.points[1]);
+			}
+			for (uint32_t i = 0; i < 4; i++) {
+				root.neighbors[i] = INVALID_TETRAHEDRON;
+			}
+			tetrahedron_circum_sphere_compute(points.ptr(), root);
+			tetrahedra.push_back(root);
+		}
 
-				if (simplex_contains(points, *simplex, i)) {
-					static const uint32_t triangle_order[4][3] = {
-						{ 0, 1, 2 },
-						{ 0, 1, 3 },
-						{ 0, 2, 3 },
-						{ 1, 2, 3 },
-					};
+		LocalVector<uint32_t> cavity;
+		LocalVector<CavityFace> cavity_faces;
+		LocalVector<OpenFace> open_faces;
+		uint32_t last_tetrahedron = 0;
+		uint32_t walk_random = 1;
+
+		for (uint32_t insertion = 0; insertion < insertion_order.size(); insertion++) {
+			const uint32_t vertex = insertion_order[insertion].point;
+			const Vector3 &point = points[vertex];
+			const uint32_t cavity_pass = insertion + 1;
+
+			// Grow the cavity from the tetrahedron containing the point, through the tetrahedra whose circumsphere
+			// contains it. Tetrahedra are also added when a face is not strictly visible from the point, so that
+			// the cavity is star-shaped and can be filled with positively oriented tetrahedra.
+			const uint32_t containing = locate_point(points.ptr(), tetrahedra, last_tetrahedron, vertex, walk_random);
+			cavity.clear();
+			cavity.push_back(containing);
+			tetrahedra[containing].cavity_pass = cavity_pass;
+
+			for (uint32_t i = 0; i < cavity.size(); i++) {
+				const Tetrahedron &tetrahedron = tetrahedra[cavity[i]];
+				for (uint32_t j = 0; j < 4; j++) {
+					const uint32_t neighbor = tetrahedron.neighbors[j];
+					if (neighbor == INVALID_TETRAHEDRON || tetrahedra[neighbor].cavity_pass == cavity_pass) {
+						continue;
+					}
+					if (tetrahedron_contains(points.ptr(), tetrahedra[neighbor], vertex) || face_orientation(points.ptr(), tetrahedron, j, point) <= 0.0) {
+						tetrahedra[neighbor].cavity_pass = cavity_pass;
+						cavity.push_back(neighbor);
+					}
+				}
+			}
 
+			cavity_faces.clear();
+			for (uint32_t tetrahedron_index : cavity) {
+				Tetrahedron &tetrahedron = tetrahedra[tetrahedron_index];
+				for (uint32_t j = 0; j < 4; j++) {
+					const uint32_t neighbor = tetrahedron.neighbors[j];
+					if (neighbor != INVALID_TETRAHEDRON && tetrahedra[neighbor].cavity_pass == cavity_pass) {
+						continue;
+					}
+					CavityFace face;
 					for (uint32_t k = 0; k < 4; k++) {
-						Triangle t = Triangle(simplex->points[triangle_order[k][0]], simplex->points[triangle_order[k][1]], simplex->points[triangle_order[k][2]]);
-						uint32_t *p = triangles_inserted.lookup_ptr(t);
-						if (p) {
-							triangles[*p].bad = true;
-						} else {
-							triangles_inserted.insert(t, triangles.size());
-							triangles.push_back(t);
+						face.points[k] = k == j ? vertex : tetrahedron.points[k];
+					}
+					face.face = j;
+					face.neighbor = neighbor;
+					if (neighbor != INVALID_TETRAHEDRON) {
+						const Tetrahedron &outside = tetrahedra[neighbor];
+						for (uint32_t k = 0; k < 4; k++) {
+							if (outside.neighbors[k] == tetrahedron_index) {
+								face.neighbor_face = k;
+								break;
+							}
 						}
 					}
+					cavity_faces.push_back(face);
+				}
+				tetrahedron.removed = true;
+				free_tetrahedra.push_back(tetrahedron_index);
+			}
 
-					//remove simplex and continue
-					simplex_list.erase(simplex->SE);
+			// Fill the cavity by connecting its boundary faces to the point.
+			open_faces.clear();
+			for (const CavityFace &face : cavity_faces) {
+				uint32_t index;
+				if (free_tetrahedra.size()) {
+					index = free_tetrahedra[free_tetrahedra.size() - 1];
+					free_tetrahedra.resize(free_tetrahedra.size() - 1);
+				} else {
+					index = tetrahedra.size();
+					tetrahedra.push_back(Tetrahedron());
+				}
 
-					for (const GridPos &gp : simplex->grid_positions) {
-						Vector3i p = gp.pos;
-						acceleration_grid[p.x][p.y][p.z].erase(gp.E);
-					}
-					memdelete(simplex);
+				Tetrahedron &tetrahedron = tetrahedra[index];
+				tetrahedron.removed = false;
+				tetrahedron.cavity_pass = 0;
+				for (uint32_t k = 0; k < 4; k++) {
+					tetrahedron.points[k] = face.points[k];
+					tetrahedron.neighbors[k] = INVALID_TETRAHEDRON;
 				}
-				E = N;
-			}
+				tetrahedron.neighbors[face.face] = face.neighbor;
+				tetrahedron_circum_sphere_compute(points.ptr(), tetrahedron);
 
-			for (const Triangle &triangle : triangles) {
-				if (triangle.bad) {
-					continue;
+				if (face.neighbor != INVALID_TETRAHEDRON) {
+					tetrahedra[face.neighbor].neighbors[face.neighbor_face] = index;
 				}
-				Simplex *new_simplex = memnew(Simplex(triangle.triangle[0], triangle.triangle[1], triangle.triangle[2], i));
-				circum_sphere_compute(points, new_simplex);
-				new_simplex->SE = simplex_list.push_back(new_simplex);
-				{
-					Vector3 center;
-					center.x = double(new_simplex->circum_center_x);
-					center.y = double(new_simplex->circum_center_y);
-					center.z = double(new_simplex->circum_center_z);
-
-					const real_t radius2 = Math::sqrt(double(new_simplex->circum_r2)) + 0.0001;
-					Vector3 extents = Vector3(radius2, radius2, radius2);
-					Vector3i from = Vector3i((center - extents) * ACCEL_GRID_SIZE);
-					Vector3i to = Vector3i((center + extents) * ACCEL_GRID_SIZE);
-					from = from.clamp(Vector3i(), Vector3i(ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1));
-					to = to.clamp(Vector3i(), Vector3i(ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1));
-
-					for (int32_t x = from.x; x <= to.x; x++) {
-						for (int32_t y = from.y; y <= to.y; y++) {
-							for (int32_t z = from.z; z <= to.z; z++) {
-								GridPos gp;
-								gp.pos = Vector3(x, y, z);
-								gp.E = acceleration_grid[x][y][z].push_back(new_simplex);
-								new_simplex->grid_positions.push_back(gp);
-							}
+
+				// The new tetrahedra are adjacent to each other through the faces containing the point.
+				for (uint32_t k = 0; k < 4; k++) {
+					if (k == face.face) {
+						continue;
+					}
+					uint32_t edge[2];
+					uint32_t edge_size = 0;
+					for (uint32_t l = 0; l < 4; l++) {
+						if (l != k && l != face.face) {
+							edge[edge_size++] = face.points[l];
 						}
 					}
+					OpenFace open_face;
+					open_face.edge = (uint64_t(MIN(edge[0], edge[1])) << 32) | MAX(edge[0], edge[1]);
+					open_face.tetrahedron = index;
+					open_face.face = k;
+
+					bool matched = false;
+					for (uint32_t l = 0; l < open_faces.size(); l++) {
+						if (open_faces[l].edge == open_face.edge) {
+							tetrahedron.neighbors[k] = open_faces[l].tetrahedron;
+							tetrahedra[open_faces[l].tetrahedron].neighbors[open_faces[l].face] = index;
+							open_faces.remove_at_unordered(l);
+							matched = true;
+							break;
+						}
+					}
+					if (!matched) {
+						open_faces.push_back(open_face);
+					}
 				}
-			}
 
-			triangles.clear();
-			triangles_inserted.clear();
+				last_tetrahedron = index;
+			}
 		}
 
-		//print_line("end with simplices: " + itos(simplex_list.size()));
 		Vector<OutputSimplex> ret_simplices;
-		ret_simplices.resize(simplex_list.size());
+		ret_simplices.resize(tetrahedra.size());
 		OutputSimplex *ret_simplicesw = ret_simplices.ptrw();
 		uint32_t simplices_written = 0;
 
-		for (Simplex *simplex : simplex_list) {
+		for (const Tetrahedron &tetrahedron : tetrahedra) {
+			if (tetrahedron.removed) {
+				continue;
+			}
 			bool invalid = false;
 			for (int j = 0; j < 4; j++) {
-				if (simplex->points[j] >= point_count) {
+				if (tetrahedron.points[j] >= point_count) {
 					invalid = true;
 					break;
 				}
 			}
-			if (invalid || simplex_is_coplanar(points, *simplex)) {
-				memdelete(simplex);
+			if (invalid || tetrahedron_is_flat(points.ptr(), tetrahedron)) {
 				continue;
 			}
 
-			ret_simplicesw[simplices_written].points[0] = simplex->points[0];
-			ret_simplicesw[simplices_written].points[1] = simplex->points[1];
-			ret_simplicesw[simplices_written].points[2] = simplex->points[2];
-			ret_simplicesw[simplices_written].points[3] = simplex->points[3];
+			for (int j = 0; j < 4; j++) {
+				ret_simplicesw[simplices_written].points[j] = tetrahedron.points[j];
+			}
 			simplices_written++;
-			memdelete(simplex);
 		}
 
 		ret_simplices.resize(simplices_written);
 
-		memfree(points);
-
 		return ret_simplices;
 	}
 };
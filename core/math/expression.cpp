@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/ref_counted.h"
 #include "core/os/os.h"
+#include "core/variant/variant_internal.h"
 #include "core/variant/variant_parser.h"
 
 Error Expression::_get_token(Token &r_token) {
@@ -1239,231 +1240,289 @@ bool Expression::_compile_expression() {
 	return false;
 }
 
-bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
+int Expression::_add_constant(const Variant &p_value) {
+	bytecode_constants.push_back(p_value);
+	return (ADDRESS_TYPE_CONSTANT << ADDRESS_BITS) | (bytecode_constants.size() - 1);
+}
+
+int Expression::_add_instruction(const Instruction &p_instruction) {
+	bytecode.push_back(p_instruction);
+	return (ADDRESS_TYPE_STACK << ADDRESS_BITS) | (bytecode.size() - 1);
+}
+
+int Expression::_compile_node(ENode *p_node) {
 	switch (p_node->type) {
 		case Expression::ENode::TYPE_INPUT: {
 			const Expression::InputNode *in = static_cast<const Expression::InputNode *>(p_node);
-			if (in->index < 0 || in->index >= p_inputs.size()) {
-				r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), in->index);
-				return true;
+			if (bytecode_inputs.find(in->index) < 0) {
+				bytecode_inputs.push_back(in->index);
 			}
-			r_ret = p_inputs[in->index];
-		} break;
+			return (ADDRESS_TYPE_INPUT << ADDRESS_BITS) | in->index;
+		}
 		case Expression::ENode::TYPE_CONSTANT: {
 			const Expression::ConstantNode *c = static_cast<const Expression::ConstantNode *>(p_node);
-			r_ret = c->value;
-
-		} break;
+			return _add_constant(c->value);
+		}
 		case Expression::ENode::TYPE_SELF: {
-			if (!p_instance) {
-				r_error_str = RTR("self can't be used because instance is null (not passed)");
-				return true;
-			}
-			r_ret = p_instance;
-		} break;
+			Instruction instruction;
+			instruction.opcode = OPCODE_SELF;
+			return _add_instruction(instruction);
+		}
 		case Expression::ENode::TYPE_OPERATOR: {
 			const Expression::OperatorNode *op = static_cast<const Expression::OperatorNode *>(p_node);
 
-			Variant a;
-			bool ret = _execute(p_inputs, p_instance, op->nodes[0], a, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
-
-			Variant b;
+			Instruction instruction;
+			instruction.opcode = OPCODE_OPERATOR;
+			instruction.op = op->op;
+			instruction.operand_a = _compile_node(op->nodes[0]);
+			instruction.operand_b = op->nodes[1] ? _compile_node(op->nodes[1]) : _add_constant(Variant());
 
-			if (op->nodes[1]) {
-				ret = _execute(p_inputs, p_instance, op->nodes[1], b, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
+			// Fold operators on constants, unless they fail so the error is reported on execution.
+			if ((instruction.operand_a >> ADDRESS_BITS) == ADDRESS_TYPE_CONSTANT && (instruction.operand_b >> ADDRESS_BITS) == ADDRESS_TYPE_CONSTANT) {
+				bool valid = true;
+				Variant value;
+				Variant::evaluate(op->op, bytecode_constants[instruction.operand_a & ADDRESS_MASK], bytecode_constants[instruction.operand_b & ADDRESS_MASK], value, valid);
+				if (valid) {
+					return _add_constant(value);
 				}
 			}
 
-			bool valid = true;
-			Variant::evaluate(op->op, a, b, r_ret, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(op->op), Variant::get_type_name(a.get_type()), Variant::get_type_name(b.get_type()));
-				return true;
-			}
-
-		} break;
+			return _add_instruction(instruction);
+		}
 		case Expression::ENode::TYPE_INDEX: {
 			const Expression::IndexNode *index = static_cast<const Expression::IndexNode *>(p_node);
 
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
-
-			Variant idx;
+			Instruction instruction;
+			instruction.opcode = OPCODE_INDEX;
+			instruction.operand_a = _compile_node(index->base);
+			instruction.operand_b = _compile_node(index->index);
+			return _add_instruction(instruction);
+		}
+		case Expression::ENode::TYPE_NAMED_INDEX: {
+			const Expression::NamedIndexNode *index = static_cast<const Expression::NamedIndexNode *>(p_node);
 
-			ret = _execute(p_inputs, p_instance, index->index, idx, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+			Instruction instruction;
+			instruction.opcode = OPCODE_NAMED_INDEX;
+			instruction.name = index->name;
+			instruction.operand_a = _compile_node(index->base);
+			return _add_instruction(instruction);
+		}
+		default: {
+			// Nodes with a list of arguments.
+			Instruction instruction;
+			const Vector<ENode *> *arguments = nullptr;
+			switch (p_node->type) {
+				case Expression::ENode::TYPE_ARRAY: {
+					instruction.opcode = OPCODE_ARRAY;
+					arguments = &static_cast<const Expression::ArrayNode *>(p_node)->array;
+				} break;
+				case Expression::ENode::TYPE_DICTIONARY: {
+					instruction.opcode = OPCODE_DICTIONARY;
+					arguments = &static_cast<const Expression::DictionaryNode *>(p_node)->dict;
+				} break;
+				case Expression::ENode::TYPE_CONSTRUCTOR: {
+					const Expression::ConstructorNode *constructor = static_cast<const Expression::ConstructorNode *>(p_node);
+					instruction.opcode = OPCODE_CONSTRUCT;
+					instruction.data_type = constructor->data_type;
+					arguments = &constructor->arguments;
+				} break;
+				case Expression::ENode::TYPE_BUILTIN_FUNC: {
+					const Expression::BuiltinFuncNode *bifunc = static_cast<const Expression::BuiltinFuncNode *>(p_node);
+					instruction.opcode = OPCODE_CALL_BUILTIN;
+					instruction.name = bifunc->func;
+					arguments = &bifunc->arguments;
+				} break;
+				case Expression::ENode::TYPE_CALL: {
+					const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
+					instruction.opcode = OPCODE_CALL;
+					instruction.name = call->method;
+					instruction.operand_a = _compile_node(call->base);
+					arguments = &call->arguments;
+				} break;
+				default: {
+					ERR_FAIL_V_MSG(_add_constant(Variant()), "Unknown expression node type.");
+				}
 			}
 
-			bool valid;
-			r_ret = base.get(idx, &valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx.get_type()), Variant::get_type_name(base.get_type()));
-				return true;
+			LocalVector<int> argument_addresses;
+			argument_addresses.resize(arguments->size());
+			for (int i = 0; i < arguments->size(); i++) {
+				argument_addresses[i] = _compile_node((*arguments)[i]);
 			}
 
-		} break;
-		case Expression::ENode::TYPE_NAMED_INDEX: {
-			const Expression::NamedIndexNode *index = static_cast<const Expression::NamedIndexNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+			instruction.argument_offset = bytecode_arguments.size();
+			instruction.argument_count = argument_addresses.size();
+			for (const int &address : argument_addresses) {
+				bytecode_arguments.push_back(address);
 			}
+			bytecode_max_arguments = MAX(bytecode_max_arguments, instruction.argument_count);
+			return _add_instruction(instruction);
+		}
+	}
+}
 
-			bool valid;
-			r_ret = base.get_named(index->name, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(index->name), Variant::get_type_name(base.get_type()));
-				return true;
-			}
+void Expression::_compile_bytecode() {
+	bytecode.clear();
+	bytecode_arguments.clear();
+	bytecode_constants.clear();
+	bytecode_inputs.clear();
+	bytecode_max_arguments = 0;
 
-		} break;
-		case Expression::ENode::TYPE_ARRAY: {
-			const Expression::ArrayNode *array = static_cast<const Expression::ArrayNode *>(p_node);
+	bytecode_result = _compile_node(root);
+}
 
-			Array arr;
-			arr.resize(array->array.size());
-			for (int i = 0; i < array->array.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, array->array[i], value, p_const_calls_only, r_error_str);
+const Variant *Expression::_get_operand(int p_address, const Array &p_inputs, const Variant *p_stack) const {
+	switch (p_address >> ADDRESS_BITS) {
+		case ADDRESS_TYPE_STACK:
+			return &p_stack[p_address & ADDRESS_MASK];
+		case ADDRESS_TYPE_CONSTANT:
+			return &bytecode_constants[p_address & ADDRESS_MASK];
+		default:
+			return &p_inputs[p_address & ADDRESS_MASK];
+	}
+}
 
-				if (ret) {
-					return true;
-				}
-				arr[i] = value;
-			}
+bool Expression::_execute(const Array &p_inputs, Object *p_instance, Variant *p_stack, const Variant **p_arguments, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
+	for (const int &index : bytecode_inputs) {
+		if (index < 0 || index >= p_inputs.size()) {
+			r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), index);
+			return true;
+		}
+	}
 
-			r_ret = arr;
+	for (uint32_t ip = 0; ip < bytecode.size(); ip++) {
+		Instruction &instruction = bytecode[ip];
+		Variant &result = p_stack[ip];
 
-		} break;
-		case Expression::ENode::TYPE_DICTIONARY: {
-			const Expression::DictionaryNode *dictionary = static_cast<const Expression::DictionaryNode *>(p_node);
+		for (int i = 0; i < instruction.argument_count; i++) {
+			p_arguments[i] = _get_operand(bytecode_arguments[instruction.argument_offset + i], p_inputs, p_stack);
+		}
 
-			Dictionary d;
-			for (int i = 0; i < dictionary->dict.size(); i += 2) {
-				Variant key;
-				bool ret = _execute(p_inputs, p_instance, dictionary->dict[i + 0], key, p_const_calls_only, r_error_str);
+		switch (instruction.opcode) {
+			case OPCODE_OPERATOR: {
+				const Variant *a = _get_operand(instruction.operand_a, p_inputs, p_stack);
+				const Variant *b = _get_operand(instruction.operand_b, p_inputs, p_stack);
 
-				if (ret) {
-					return true;
+				const uint32_t signature = (a->get_type() << 8) | b->get_type();
+				if (likely(signature == instruction.cached_signature)) {
+					VariantInternal::initialize(&result, instruction.cached_return_type);
+					instruction.cached_evaluator(a, b, &result);
+					break;
 				}
 
-				Variant value;
-				ret = _execute(p_inputs, p_instance, dictionary->dict[i + 1], value, p_const_calls_only, r_error_str);
-				if (ret) {
+				bool valid = true;
+				Variant::evaluate(instruction.op, *a, *b, result, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(instruction.op), Variant::get_type_name(a->get_type()), Variant::get_type_name(b->get_type()));
 					return true;
 				}
 
-				d[key] = value;
-			}
-
-			r_ret = d;
-		} break;
-		case Expression::ENode::TYPE_CONSTRUCTOR: {
-			const Expression::ConstructorNode *constructor = static_cast<const Expression::ConstructorNode *>(p_node);
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(constructor->arguments.size());
-			argp.resize(constructor->arguments.size());
-
-			for (int i = 0; i < constructor->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, constructor->arguments[i], value, p_const_calls_only, r_error_str);
-
-				if (ret) {
+				// Validated evaluators skip the checks that can make evaluate() fail: division by zero,
+				// negative bit shifts, and 'in' on a freed object.
+				bool checked = false;
+				switch (instruction.op) {
+					case Variant::OP_DIVIDE:
+					case Variant::OP_MODULE:
+					case Variant::OP_SHIFT_LEFT:
+					case Variant::OP_SHIFT_RIGHT:
+						checked = true;
+						break;
+					case Variant::OP_IN:
+						checked = b->get_type() == Variant::OBJECT;
+						break;
+					default:
+						break;
+				}
+				if (!checked) {
+					Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(instruction.op, a->get_type(), b->get_type());
+					if (evaluator) {
+						instruction.cached_signature = signature;
+						instruction.cached_return_type = Variant::get_operator_return_type(instruction.op, a->get_type(), b->get_type());
+						instruction.cached_evaluator = evaluator;
+					}
+				}
+			} break;
+			case OPCODE_SELF: {
+				if (!p_instance) {
+					r_error_str = RTR("self can't be used because instance is null (not passed)");
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
-
-			Callable::CallError ce;
-			Variant::construct(constructor->data_type, r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(constructor->data_type));
-				return true;
-			}
-
-		} break;
-		case Expression::ENode::TYPE_BUILTIN_FUNC: {
-			const Expression::BuiltinFuncNode *bifunc = static_cast<const Expression::BuiltinFuncNode *>(p_node);
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(bifunc->arguments.size());
-			argp.resize(bifunc->arguments.size());
-
-			for (int i = 0; i < bifunc->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, bifunc->arguments[i], value, p_const_calls_only, r_error_str);
-				if (ret) {
+				result = p_instance;
+			} break;
+			case OPCODE_INDEX: {
+				const Variant *base = _get_operand(instruction.operand_a, p_inputs, p_stack);
+				const Variant *idx = _get_operand(instruction.operand_b, p_inputs, p_stack);
+
+				bool valid;
+				result = base->get(*idx, &valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx->get_type()), Variant::get_type_name(base->get_type()));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
-
-			r_ret = Variant(); //may not return anything
-			Callable::CallError ce;
-			Variant::call_utility_function(bifunc->func, &r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = "Builtin call failed: " + Variant::get_call_error_text(bifunc->func, (const Variant **)argp.ptr(), argp.size(), ce);
-				return true;
-			}
-
-		} break;
-		case Expression::ENode::TYPE_CALL: {
-			const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, call->base, base, p_const_calls_only, r_error_str);
-
-			if (ret) {
-				return true;
-			}
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(call->arguments.size());
-			argp.resize(call->arguments.size());
-
-			for (int i = 0; i < call->arguments.size(); i++) {
-				Variant value;
-				ret = _execute(p_inputs, p_instance, call->arguments[i], value, p_const_calls_only, r_error_str);
+			} break;
+			case OPCODE_NAMED_INDEX: {
+				const Variant *base = _get_operand(instruction.operand_a, p_inputs, p_stack);
 
-				if (ret) {
+				bool valid;
+				result = base->get_named(instruction.name, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(instruction.name), Variant::get_type_name(base->get_type()));
 					return true;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
+			} break;
+			case OPCODE_ARRAY: {
+				Array arr;
+				arr.resize(instruction.argument_count);
+				for (int i = 0; i < instruction.argument_count; i++) {
+					arr[i] = *p_arguments[i];
+				}
+				result = arr;
+			} break;
+			case OPCODE_DICTIONARY: {
+				Dictionary d;
+				for (int i = 0; i < instruction.argument_count; i += 2) {
+					d[*p_arguments[i + 0]] = *p_arguments[i + 1];
+				}
+				result = d;
+			} break;
+			case OPCODE_CONSTRUCT: {
+				Callable::CallError ce;
+				Variant::construct(instruction.data_type, result, p_arguments, instruction.argument_count, ce);
 
-			Callable::CallError ce;
-			if (p_const_calls_only) {
-				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
-			} else {
-				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
-			}
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(instruction.data_type));
+					return true;
+				}
+			} break;
+			case OPCODE_CALL_BUILTIN: {
+				result = Variant(); //may not return anything
+				Callable::CallError ce;
+				Variant::call_utility_function(instruction.name, &result, p_arguments, instruction.argument_count, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = "Builtin call failed: " + Variant::get_call_error_text(instruction.name, p_arguments, instruction.argument_count, ce);
+					return true;
+				}
+			} break;
+			case OPCODE_CALL: {
+				// Methods can modify their base, so they're called on a copy to keep the inputs and constants intact.
+				Variant base = *_get_operand(instruction.operand_a, p_inputs, p_stack);
 
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("On call to '%s':"), String(call->method));
-				return true;
-			}
+				Callable::CallError ce;
+				if (p_const_calls_only) {
+					base.call_const(instruction.name, p_arguments, instruction.argument_count, result, ce);
+				} else {
+					base.callp(instruction.name, p_arguments, instruction.argument_count, result, ce);
+				}
 
-		} break;
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("On call to '%s':"), String(instruction.name));
+					return true;
+				}
+			} break;
+		}
 	}
+
+	r_ret = *_get_operand(bytecode_result, p_inputs, p_stack);
 	return false;
 }
 
@@ -1491,16 +1550,40 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 		return ERR_INVALID_PARAMETER;
 	}
 
+	_compile_bytecode();
+
+	// Only the bytecode is executed.
+	memdelete(nodes);
+	nodes = nullptr;
+	root = nullptr;
+
 	return OK;
 }
 
 Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_error, bool p_const_calls_only) {
 	ERR_FAIL_COND_V_MSG(error_set, Variant(), "There was previously a parse error: " + error_str + ".");
 
+	const size_t stack_size = sizeof(Variant) * bytecode.size() + sizeof(const Variant *) * bytecode_max_arguments;
+	const bool heap_stack = stack_size > MAX_ALLOCA_STACK_SIZE;
+	uint8_t *stack_memory = (uint8_t *)(heap_stack ? memalloc(stack_size) : alloca(stack_size));
+	Variant *stack = (Variant *)stack_memory;
+	for (uint32_t i = 0; i < bytecode.size(); i++) {
+		memnew_placement(&stack[i], Variant);
+	}
+	const Variant **arguments = (const Variant **)(stack_memory + sizeof(Variant) * bytecode.size());
+
 	execution_error = false;
 	Variant output;
 	String error_txt;
-	bool err = _execute(p_inputs, p_base, root, output, p_const_calls_only, error_txt);
+	bool err = _execute(p_inputs, p_base, stack, arguments, output, p_const_calls_only, error_txt);
+
+	for (uint32_t i = 0; i < bytecode.size(); i++) {
+		stack[i].~Variant();
+	}
+	if (heap_stack) {
+		memfree(stack_memory);
+	}
+
 	if (err) {
 		execution_error = true;
 		error_str = error_txt;
@@ -1510,6 +1593,53 @@ Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_e
 	return output;
 }
 
+Array Expression::execute_batch(const Array &p_input_rows, Object *p_base, bool p_show_error, bool p_const_calls_only) {
+	ERR_FAIL_COND_V_MSG(error_set, Array(), "There was previously a parse error: " + error_str + ".");
+
+	// The stack is shared by all the rows.
+	const size_t stack_size = sizeof(Variant) * bytecode.size() + sizeof(const Variant *) * bytecode_max_arguments;
+	const bool heap_stack = stack_size > MAX_ALLOCA_STACK_SIZE;
+	uint8_t *stack_memory = (uint8_t *)(heap_stack ? memalloc(stack_size) : alloca(stack_size));
+	Variant *stack = (Variant *)stack_memory;
+	for (uint32_t i = 0; i < bytecode.size(); i++) {
+		memnew_placement(&stack[i], Variant);
+	}
+	const Variant **arguments = (const Variant **)(stack_memory + sizeof(Variant) * bytecode.size());
+
+	execution_error = false;
+	Array outputs;
+	outputs.resize(p_input_rows.size());
+	for (int i = 0; i < p_input_rows.size(); i++) {
+		const Variant &row = p_input_rows[i];
+		String error_txt;
+		bool err;
+		if (row.get_type() == Variant::ARRAY) {
+			err = _execute(*VariantInternal::get_array(&row), p_base, stack, arguments, outputs[i], p_const_calls_only, error_txt);
+		} else {
+			error_txt = vformat(RTR("Input row %d is not an Array"), i);
+			err = true;
+		}
+
+		// Only the first error is kept, the other rows are still executed.
+		if (err && !execution_error) {
+			execution_error = true;
+			error_str = error_txt;
+			if (p_show_error) {
+				ERR_PRINT(error_str);
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < bytecode.size(); i++) {
+		stack[i].~Variant();
+	}
+	if (heap_stack) {
+		memfree(stack_memory);
+	}
+
+	return outputs;
+}
+
 bool Expression::has_execute_failed() const {
 	return execution_error;
 }
@@ -1521,6 +1651,7 @@ String Expression::get_error_text() const {
 void Expression::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("parse", "expression", "input_names"), &Expression::parse, DEFVAL(Vector<String>()));
 	ClassDB::bind_method(D_METHOD("execute", "inputs", "base_instance", "show_error", "const_calls_only"), &Expression::execute, DEFVAL(Array()), DEFVAL(Variant()), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("execute_batch", "input_rows", "base_instance", "show_error", "const_calls_only"), &Expression::execute_batch, DEFVAL(Variant()), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("has_execute_failed"), &Expression::has_execute_failed);
 	ClassDB::bind_method(D_METHOD("get_error_text"), &Expression::get_error_text);
 }
@@ -32,6 +32,7 @@
 #define EXPRESSION_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 
 class Expression : public RefCounted {
 	GDCLASS(Expression, RefCounted);
@@ -256,8 +257,66 @@ private:
 
 	Vector<String> input_names;
 
+	// The parsed tree is compiled to a flat list of instructions, each writing its result to its own
+	// slot of the stack. Operands are addresses of stack slots, constants or inputs, so constants and
+	// inputs are never copied.
+	enum Opcode {
+		OPCODE_OPERATOR,
+		OPCODE_SELF,
+		OPCODE_INDEX,
+		OPCODE_NAMED_INDEX,
+		OPCODE_ARRAY,
+		OPCODE_DICTIONARY,
+		OPCODE_CONSTRUCT,
+		OPCODE_CALL_BUILTIN,
+		OPCODE_CALL,
+	};
+
+	enum {
+		ADDRESS_BITS = 24,
+		ADDRESS_MASK = (1 << ADDRESS_BITS) - 1,
+		ADDRESS_TYPE_STACK = 0,
+		ADDRESS_TYPE_CONSTANT = 1,
+		ADDRESS_TYPE_INPUT = 2,
+	};
+
+	struct Instruction {
+		Opcode opcode = OPCODE_OPERATOR;
+		Variant::Operator op = Variant::OP_ADD;
+		Variant::Type data_type = Variant::NIL;
+		StringName name;
+
+		int operand_a = 0;
+		int operand_b = 0;
+		int argument_offset = 0;
+		int argument_count = 0;
+
+		// Operators cache the validated evaluator of the last operand types they were executed with.
+		uint32_t cached_signature = UINT32_MAX;
+		Variant::Type cached_return_type = Variant::NIL;
+		Variant::ValidatedOperatorEvaluator cached_evaluator = nullptr;
+	};
+
+	LocalVector<Instruction> bytecode;
+	LocalVector<int> bytecode_arguments;
+	LocalVector<Variant> bytecode_constants;
+	// Inputs read by the expression, in the order they are first read.
+	LocalVector<int> bytecode_inputs;
+	int bytecode_result = 0;
+	int bytecode_max_arguments = 0;
+
+	// Execution stacks larger than this many bytes are allocated on the heap instead of with alloca().
+	static const uint32_t MAX_ALLOCA_STACK_SIZE = 8192;
+
+	int _add_constant(const Variant &p_value);
+	int _add_instruction(const Instruction &p_instruction);
+	int _compile_node(ENode *p_node);
+	void _compile_bytecode();
+
+	_FORCE_INLINE_ const Variant *_get_operand(int p_address, const Array &p_inputs, const Variant *p_stack) const;
+
 	bool execution_error = false;
-	bool _execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
+	bool _execute(const Array &p_inputs, Object *p_instance, Variant *p_stack, const Variant **p_arguments, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
 
 protected:
 	static void _bind_methods();
@@ -265,6 +324,7 @@ protected:
 public:
 	Error parse(const String &p_expression, const Vector<String> &p_input_names = Vector<String>());
 	Variant execute(const Array &p_inputs = Array(), Object *p_base = nullptr, bool p_show_error = true, bool p_const_calls_only = false);
+	Array execute_batch(const Array &p_input_rows, Object *p_base = nullptr, bool p_show_error = true, bool p_const_calls_only = false);
 	bool has_execute_failed() const;
 	String get_error_text() const;
 
@@ -30,10 +30,104 @@
 
 #include "quick_hull.h"
 
+#include "core/templates/oa_hash_map.h"
 #include "core/templates/rb_map.h"
+#include "core/templates/sort_array.h"
 
 uint32_t QuickHull::debug_stop_after = 0xFFFFFFFF;
 
+struct QuickHullFacePtrComparator {
+	_FORCE_INLINE_ bool operator()(const QuickHull::Face *p_a, const QuickHull::Face *p_b) const {
+		return *p_a < *p_b;
+	}
+};
+
+// Faces of the hull being built. They live in an arena and are linked through indices, so the main
+// loop doesn't allocate list nodes, and erased faces are recycled along with their points_over buffers.
+// Indices stay valid when the arena grows, but references into it don't.
+struct QuickHullFaces {
+	LocalVector<QuickHull::Face> arena;
+	LocalVector<int> unused;
+	int first = -1;
+	int last = -1;
+
+	int push_back() {
+		int index;
+		if (unused.size()) {
+			index = unused[unused.size() - 1];
+			unused.remove_at(unused.size() - 1);
+			arena[index].points_over.clear();
+		} else {
+			index = arena.size();
+			arena.push_back(QuickHull::Face());
+		}
+		_link_back(index);
+		return index;
+	}
+
+	void erase(int p_index) {
+		_unlink(p_index);
+		unused.push_back(p_index);
+	}
+
+	void move_to_front(int p_index) {
+		_unlink(p_index);
+		QuickHull::Face &f = arena[p_index];
+		f.prev = -1;
+		f.next = first;
+		if (first >= 0) {
+			arena[first].prev = p_index;
+		} else {
+			last = p_index;
+		}
+		first = p_index;
+	}
+
+	// Same as List::sort(), so faces end up in the same order.
+	void sort() {
+		LocalVector<QuickHull::Face *> sorted;
+		for (int i = first; i >= 0; i = arena[i].next) {
+			sorted.push_back(&arena[i]);
+		}
+		if (sorted.size() < 2) {
+			return;
+		}
+		SortArray<QuickHull::Face *, QuickHullFacePtrComparator> sort;
+		sort.sort(sorted.ptr(), sorted.size());
+		first = -1;
+		last = -1;
+		for (QuickHull::Face *f : sorted) {
+			_link_back(f - arena.ptr());
+		}
+	}
+
+	void _link_back(int p_index) {
+		QuickHull::Face &f = arena[p_index];
+		f.prev = last;
+		f.next = -1;
+		if (last >= 0) {
+			arena[last].next = p_index;
+		} else {
+			first = p_index;
+		}
+		last = p_index;
+	}
+
+	void _unlink(int p_index) {
+		QuickHull::Face &f = arena[p_index];
+		if (f.prev >= 0) {
+			arena[f.prev].next = f.next;
+		} else {
+			first = f.next;
+		}
+		if (f.next >= 0) {
+			arena[f.next].prev = f.prev;
+		} else {
+			last = f.prev;
+		}
+	}
+};
+
 Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_mesh) {
 	/* CREATE AABB VOLUME */
 
@@ -143,7 +237,7 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 
 	//add faces
 
-	List<Face> faces;
+	QuickHullFaces faces;
 
 	for (int i = 0; i < 4; i++) {
 		static const int face_order[4][3] = {
@@ -153,7 +247,7 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 			{ 1, 2, 3 }
 		};
 
-		Face f;
+		Face &f = faces.arena[faces.push_back()];
 		for (int j = 0; j < 3; j++) {
 			f.vertices[j] = simplex[face_order[i][j]];
 		}
@@ -167,8 +261,6 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 		}
 
 		f.plane = p;
-
-		faces.push_back(f);
 	}
 
 	real_t over_tolerance = 3 * UNIT_EPSILON * (aabb.size.x + aabb.size.y + aabb.size.z);
@@ -192,9 +284,9 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 			continue;
 		}
 
-		for (Face &E : faces) {
-			if (E.plane.distance_to(p_points[i]) > over_tolerance) {
-				E.points_over.push_back(i);
+		for (int E = faces.first; E >= 0; E = faces.arena[E].next) {
+			if (faces.arena[E].plane.distance_to(p_points[i]) > over_tolerance) {
+				faces.arena[E].points_over.push_back(i);
 				break;
 			}
 		}
@@ -213,70 +305,84 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 
 	uint32_t debug_stop = debug_stop_after;
 
-	while (debug_stop > 0 && faces.back()->get().points_over.size()) {
+	// Reused between iterations, lit edges are kept in the order they are found.
+	LocalVector<int> lit_faces; //lit face is a death sentence
+	LocalVector<int> new_faces;
+	LocalVector<Pair<Edge, FaceConnect>> lit_edges;
+	OAHashMap<Edge, uint32_t, Edge> lit_edge_indices;
+
+	while (debug_stop > 0 && faces.arena[faces.last].points_over.size()) {
 		debug_stop--;
-		Face &f = faces.back()->get();
+		const int f = faces.last;
 
 		//find vertex most outside
 		int next = -1;
 		real_t next_d = 0;
 
-		for (int i = 0; i < f.points_over.size(); i++) {
-			real_t d = f.plane.distance_to(p_points[f.points_over[i]]);
+		{
+			const Face &face = faces.arena[f];
+			for (uint32_t i = 0; i < face.points_over.size(); i++) {
+				real_t d = face.plane.distance_to(p_points[face.points_over[i]]);
 
-			if (d > next_d) {
-				next_d = d;
-				next = i;
+				if (d > next_d) {
+					next_d = d;
+					next = i;
+				}
 			}
 		}
 
 		ERR_FAIL_COND_V(next == -1, ERR_BUG);
 
-		Vector3 v = p_points[f.points_over[next]];
+		const int next_point = faces.arena[f].points_over[next];
+		Vector3 v = p_points[next_point];
 
 		//find lit faces and lit edges
-		List<List<Face>::Element *> lit_faces; //lit face is a death sentence
-
-		HashMap<Edge, FaceConnect, Edge> lit_edges; //create this on the flight, should not be that bad for performance and simplifies code a lot
+		lit_faces.clear();
+		lit_edges.clear();
+		lit_edge_indices.clear();
 
-		for (List<Face>::Element *E = faces.front(); E; E = E->next()) {
-			if (E->get().plane.distance_to(v) > 0) {
+		for (int E = faces.first; E >= 0; E = faces.arena[E].next) {
+			const Face &face = faces.arena[E];
+			if (face.plane.distance_to(v) > 0) {
 				lit_faces.push_back(E);
 
 				for (int i = 0; i < 3; i++) {
-					uint32_t a = E->get().vertices[i];
-					uint32_t b = E->get().vertices[(i + 1) % 3];
+					uint32_t a = face.vertices[i];
+					uint32_t b = face.vertices[(i + 1) % 3];
 					Edge e(a, b);
 
-					HashMap<Edge, FaceConnect, Edge>::Iterator F = lit_edges.find(e);
+					uint32_t *F = lit_edge_indices.lookup_ptr(e);
 					if (!F) {
-						F = lit_edges.insert(e, FaceConnect());
+						lit_edge_indices.insert(e, lit_edges.size());
+						lit_edges.push_back(Pair<Edge, FaceConnect>(e, FaceConnect()));
+						F = lit_edge_indices.lookup_ptr(e);
 					}
 					if (e.vertices[0] == a) {
 						//left
-						F->value.left = E;
+						lit_edges[*F].second.left = E;
 					} else {
-						F->value.right = E;
+						lit_edges[*F].second.right = E;
 					}
 				}
 			}
 		}
 
 		//create new faces from horizon edges
-		List<List<Face>::Element *> new_faces; //new faces
+		new_faces.clear();
 
-		for (KeyValue<Edge, FaceConnect> &E : lit_edges) {
-			FaceConnect &fc = E.value;
-			if (fc.left && fc.right) {
+		for (const Pair<Edge, FaceConnect> &E : lit_edges) {
+			const FaceConnect &fc = E.second;
+			if (fc.left >= 0 && fc.right >= 0) {
 				continue; //edge is uninteresting, not on horizon
 			}
 
 			//create new face!
 
-			Face face;
-			face.vertices[0] = f.points_over[next];
-			face.vertices[1] = E.key.vertices[0];
-			face.vertices[2] = E.key.vertices[1];
+			const int new_face = faces.push_back();
+			Face &face = faces.arena[new_face];
+			face.vertices[0] = next_point;
+			face.vertices[1] = E.first.vertices[0];
+			face.vertices[2] = E.first.vertices[1];
 
 			Plane p(p_points[face.vertices[0]], p_points[face.vertices[1]], p_points[face.vertices[2]]);
 
@@ -287,22 +393,22 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 			}
 
 			face.plane = p;
-			new_faces.push_back(faces.push_back(face));
+			new_faces.push_back(new_face);
 		}
 
 		//distribute points into new faces
 
-		for (List<Face>::Element *&F : lit_faces) {
-			Face &lf = F->get();
+		for (const int F : lit_faces) {
+			const Face &lf = faces.arena[F];
 
-			for (int i = 0; i < lf.points_over.size(); i++) {
-				if (lf.points_over[i] == f.points_over[next]) { //do not add current one
+			for (uint32_t i = 0; i < lf.points_over.size(); i++) {
+				if (lf.points_over[i] == next_point) { //do not add current one
 					continue;
 				}
 
 				Vector3 p = p_points[lf.points_over[i]];
-				for (List<Face>::Element *&E : new_faces) {
-					Face &f2 = E->get();
+				for (const int E : new_faces) {
+					Face &f2 = faces.arena[E];
 					if (f2.plane.distance_to(p) > over_tolerance) {
 						f2.points_over.push_back(lf.points_over[i]);
 						break;
@@ -313,16 +419,14 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 
 		//erase lit faces
 
-		while (lit_faces.size()) {
-			faces.erase(lit_faces.front()->get());
-			lit_faces.pop_front();
+		for (const int F : lit_faces) {
+			faces.erase(F);
 		}
 
 		//put faces that contain no points on the front
 
-		for (List<Face>::Element *&E : new_faces) {
-			Face &f2 = E->get();
-			if (f2.points_over.size() == 0) {
+		for (const int E : new_faces) {
+			if (faces.arena[E].points_over.size() == 0) {
 				faces.move_to_front(E);
 			}
 		}
@@ -336,7 +440,8 @@ Error QuickHull::build(const Vector<Vector3> &p_points, Geometry3D::MeshData &r_
 	HashMap<Edge, RetFaceConnect, Edge> ret_edges;
 	List<Geometry3D::MeshData::Face> ret_faces;
 
-	for (const Face &E : faces) {
+	for (int face_index = faces.first; face_index >= 0; face_index = faces.arena[face_index].next) {
+		const Face &E = faces.arena[face_index];
 		Geometry3D::MeshData::Face f;
 		f.plane = E.plane;
 
@@ -35,6 +35,7 @@
 #include "core/math/geometry_3d.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 
 class QuickHull {
 public:
@@ -68,7 +69,11 @@ public:
 	struct Face {
 		Plane plane;
 		uint32_t vertices[3] = { 0 };
-		Vector<int> points_over;
+		LocalVector<int> points_over;
+
+		// Neighbors in the face list, as indices into the face arena.
+		int prev = -1;
+		int next = -1;
 
 		bool operator<(const Face &p_face) const {
 			return points_over.size() < p_face.points_over.size();
@@ -77,8 +82,8 @@ public:
 
 private:
 	struct FaceConnect {
-		List<Face>::Element *left = nullptr;
-		List<Face>::Element *right = nullptr;
+		int left = -1;
+		int right = -1;
 		FaceConnect() {}
 	};
 	struct RetFaceConnect {
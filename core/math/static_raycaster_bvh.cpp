@@ -0,0 +1,291 @@
+/**************************************************************************/
+/*  static_raycaster_bvh.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "static_raycaster_bvh.h"
+
+#include "core/math/wide_bvh_simd.h"
+
+static _FORCE_INLINE_ uint32_t _get_direction_octant(const Vector3 &p_dir) {
+	return (p_dir.x < 0.0 ? 1 : 0) | (p_dir.y < 0.0 ? 2 : 0) | (p_dir.z < 0.0 ? 4 : 0);
+}
+
+StaticRaycaster *StaticRaycasterBVH::create_bvh_raycaster() {
+	return memnew(StaticRaycasterBVH);
+}
+
+void StaticRaycasterBVH::_intersect_triangles(uint32_t p_first, uint32_t p_count, Ray &r_ray) const {
+	// Möller-Trumbore, hitting both faces like Embree does.
+	for (uint32_t i = p_first; i < p_first + p_count; i++) {
+		const Triangle &triangle = triangles[i];
+		if (filtered_meshes[triangle.mesh]) {
+			continue;
+		}
+
+		const Vector3 p = r_ray.dir.cross(triangle.edge2);
+		const real_t det = triangle.edge1.dot(p);
+		if (det == 0.0) {
+			continue; // Parallel to the triangle.
+		}
+		const real_t inv_det = 1.0 / det;
+
+		const Vector3 s = r_ray.org - triangle.v0;
+		const real_t u = s.dot(p) * inv_det;
+		if (u < 0.0 || u > 1.0) {
+			continue;
+		}
+
+		const Vector3 q = s.cross(triangle.edge1);
+		const real_t v = r_ray.dir.dot(q) * inv_det;
+		if (v < 0.0 || u + v > 1.0) {
+			continue;
+		}
+
+		const real_t t = triangle.edge2.dot(q) * inv_det;
+		if (t < r_ray.tnear || t > r_ray.tfar) {
+			continue;
+		}
+
+		r_ray.tfar = t;
+		r_ray.u = u;
+		r_ray.v = v;
+		r_ray.normal = triangle.edge1.cross(triangle.edge2);
+		r_ray.primID = triangle.primitive;
+		r_ray.geomID = meshes[triangle.mesh].id;
+		r_ray.instID = Ray::INVALID_GEOMETRY_ID;
+	}
+}
+
+void StaticRaycasterBVH::_intersect_packet(Ray *r_rays, uint32_t p_count) const {
+	PacketRay packet[PACKET_SIZE];
+	uint32_t active_rays = 0;
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		const Ray &ray = r_rays[i];
+		if (!(ray.tnear <= ray.tfar)) {
+			continue;
+		}
+
+		PacketRay &packet_ray = packet[i];
+		packet_ray.set(ray.org, ray.dir);
+		packet_ray.tnear = ray.tnear;
+		active_rays |= 1 << i;
+	}
+
+	if (active_rays == 0 || nodes.is_empty()) {
+		return;
+	}
+
+	struct StackEntry {
+		uint32_t child;
+		uint32_t triangle_count;
+		uint32_t rays;
+	};
+
+	StackEntry stack[WideBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
+
+	stack[stack_size++] = { 0, 0, active_rays };
+
+	while (stack_size > 0) {
+		const StackEntry entry = stack[--stack_size];
+
+		if (entry.triangle_count > 0) {
+			for (uint32_t i = 0; i < p_count; i++) {
+				if (entry.rays & (1 << i)) {
+					_intersect_triangles(entry.child, entry.triangle_count, r_rays[i]);
+				}
+			}
+			continue;
+		}
+
+		const Node &node = nodes[entry.child];
+		uint32_t child_rays[4] = { 0, 0, 0, 0 };
+		float child_near[4] = { INFINITY, INFINITY, INFINITY, INFINITY };
+
+		for (uint32_t ray_index = 0; ray_index < p_count; ray_index++) {
+			if (!(entry.rays & (1 << ray_index))) {
+				continue;
+			}
+			float near[4];
+			const uint32_t mask = wide_bvh_intersect_children(node, packet[ray_index], packet[ray_index].tnear, float(r_rays[ray_index].tfar), near);
+			for (uint32_t i = 0; i < 4; i++) {
+				if (mask & (1 << i)) {
+					child_rays[i] |= 1 << ray_index;
+					child_near[i] = MIN(child_near[i], near[i]);
+				}
+			}
+		}
+
+		// Push the farthest children first, so the nearest ones are visited first and shorten the rays early.
+		uint32_t order[4] = { 0, 1, 2, 3 };
+		for (uint32_t i = 1; i < 4; i++) {
+			for (uint32_t j = i; j > 0 && child_near[order[j - 1]] < child_near[order[j]]; j--) {
+				SWAP(order[j - 1], order[j]);
+			}
+		}
+
+		for (uint32_t i = 0; i < 4; i++) {
+			const uint32_t child = order[i];
+			if (child_rays[child] != 0) {
+				stack[stack_size++] = { node.children[child], node.item_counts[child], child_rays[child] };
+			}
+		}
+	}
+}
+
+bool StaticRaycasterBVH::intersect(Ray &r_ray) {
+	_intersect_packet(&r_ray, 1);
+	return r_ray.geomID != Ray::INVALID_GEOMETRY_ID;
+}
+
+void StaticRaycasterBVH::intersect(Vector<Ray> &r_rays) {
+	Ray *rays = r_rays.ptrw();
+	const uint32_t ray_count = r_rays.size();
+	for (uint32_t i = 0; i < ray_count; i += PACKET_SIZE) {
+		const uint32_t count = MIN(PACKET_SIZE, ray_count - i);
+
+		// Packets only pay off when their rays visit the nodes in the same order, so incoherent
+		// rays are traced one by one.
+		bool coherent = true;
+		const uint32_t octant = _get_direction_octant(rays[i].dir);
+		for (uint32_t j = 1; j < count && coherent; j++) {
+			coherent = _get_direction_octant(rays[i + j].dir) == octant;
+		}
+
+		if (coherent) {
+			_intersect_packet(rays + i, count);
+		} else {
+			for (uint32_t j = 0; j < count; j++) {
+				_intersect_packet(rays + i + j, 1);
+			}
+		}
+	}
+}
+
+void StaticRaycasterBVH::add_mesh(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, unsigned int p_id) {
+	ERR_FAIL_COND_MSG(mesh_indices.has(p_id), vformat("A mesh with ID %d was already added.", p_id));
+	const int vertex_count = p_vertices.size();
+	if (p_indices.is_empty()) {
+		ERR_FAIL_COND(vertex_count % 3 != 0);
+	} else {
+		ERR_FAIL_COND(p_indices.size() % 3 != 0);
+	}
+
+	Mesh mesh;
+	mesh.id = p_id;
+	mesh.vertices.resize(vertex_count);
+	const Vector3 *vertices = p_vertices.ptr();
+	for (int i = 0; i < vertex_count; i++) {
+		mesh.vertices[i] = vertices[i];
+	}
+
+	if (p_indices.is_empty()) {
+		mesh.indices.resize(vertex_count);
+		for (int i = 0; i < vertex_count; i++) {
+			mesh.indices[i] = i;
+		}
+	} else {
+		const int index_count = p_indices.size();
+		const int32_t *indices = p_indices.ptr();
+		mesh.indices.resize(index_count);
+		for (int i = 0; i < index_count; i++) {
+			ERR_FAIL_INDEX(indices[i], vertex_count);
+			mesh.indices[i] = indices[i];
+		}
+	}
+
+	mesh_indices.insert(p_id, meshes.size());
+	meshes.push_back(mesh);
+	filtered_meshes.push_back(filter_meshes.has(p_id));
+}
+
+void StaticRaycasterBVH::commit() {
+	nodes.clear();
+	triangles.clear();
+
+	uint32_t triangle_count = 0;
+	for (const Mesh &mesh : meshes) {
+		triangle_count += mesh.indices.size() / 3;
+	}
+	if (triangle_count == 0) {
+		return;
+	}
+
+	LocalVector<Triangle> unsorted_triangles;
+	unsorted_triangles.resize(triangle_count);
+	WideBVH builder;
+	builder.resize(triangle_count);
+
+	uint32_t triangle_index = 0;
+	for (uint32_t i = 0; i < meshes.size(); i++) {
+		const Mesh &mesh = meshes[i];
+		for (uint32_t j = 0; j < mesh.indices.size(); j += 3) {
+			const Vector3 &v0 = mesh.vertices[mesh.indices[j + 0]];
+			const Vector3 &v1 = mesh.vertices[mesh.indices[j + 1]];
+			const Vector3 &v2 = mesh.vertices[mesh.indices[j + 2]];
+
+			Triangle &triangle = unsorted_triangles[triangle_index];
+			triangle.v0 = v0;
+			triangle.edge1 = v1 - v0;
+			triangle.edge2 = v2 - v0;
+			triangle.mesh = i;
+			triangle.primitive = j / 3;
+
+			builder.set_item_bounds(triangle_index, v0.min(v1).min(v2), v0.max(v1).max(v2));
+			triangle_index++;
+		}
+	}
+
+	builder.build(nodes);
+
+	// Store the triangles in the order of the leaves, so each leaf reads consecutive triangles.
+	const LocalVector<uint32_t> &order = builder.get_item_order();
+	triangles.resize(triangle_count);
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		triangles[i] = unsorted_triangles[order[i]];
+	}
+}
+
+void StaticRaycasterBVH::set_mesh_filter(const HashSet<int> &p_mesh_ids) {
+	for (const int &E : p_mesh_ids) {
+		const uint32_t *mesh_index = mesh_indices.getptr(E);
+		if (mesh_index) {
+			filtered_meshes[*mesh_index] = 1;
+		}
+		filter_meshes.insert(E);
+	}
+}
+
+void StaticRaycasterBVH::clear_mesh_filter() {
+	for (uint32_t i = 0; i < filtered_meshes.size(); i++) {
+		filtered_meshes[i] = 0;
+	}
+	filter_meshes.clear();
+}
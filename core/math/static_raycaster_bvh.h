@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  static_raycaster_bvh.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef STATIC_RAYCASTER_BVH_H
+#define STATIC_RAYCASTER_BVH_H
+
+#include "core/math/static_raycaster.h"
+#include "core/math/vector3.h"
+#include "core/math/wide_bvh.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Portable StaticRaycaster, used when no other implementation (like Embree) is available.
+// The triangles are kept in a WideBVH. Batches of rays are traversed in packets.
+class StaticRaycasterBVH : public StaticRaycaster {
+	GDCLASS(StaticRaycasterBVH, StaticRaycaster);
+
+public:
+	static const uint32_t PACKET_SIZE = 8;
+
+private:
+	struct Mesh {
+		unsigned int id = 0;
+		LocalVector<Vector3> vertices;
+		LocalVector<uint32_t> indices;
+	};
+
+	// Triangle with its precomputed edges, in the order of the leaves of the tree.
+	struct Triangle {
+		Vector3 v0;
+		Vector3 edge1;
+		Vector3 edge2;
+		uint32_t mesh = 0;
+		uint32_t primitive = 0;
+	};
+
+	typedef WideBVH::Node<float> Node;
+
+	struct PacketRay : public WideBVH::Ray<float> {
+		float tnear;
+	};
+
+	LocalVector<Mesh> meshes;
+	HashMap<unsigned int, uint32_t> mesh_indices;
+	// Meshes ignored by the intersections, indexed as meshes.
+	LocalVector<uint8_t> filtered_meshes;
+	HashSet<int> filter_meshes;
+
+	LocalVector<Node> nodes;
+	LocalVector<Triangle> triangles;
+
+	_FORCE_INLINE_ void _intersect_triangles(uint32_t p_first, uint32_t p_count, Ray &r_ray) const;
+	void _intersect_packet(Ray *r_rays, uint32_t p_count) const;
+
+public:
+	virtual bool intersect(Ray &p_ray) override;
+	virtual void intersect(Vector<Ray> &r_rays) override;
+
+	virtual void add_mesh(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, unsigned int p_id) override;
+	virtual void commit() override;
+
+	virtual void set_mesh_filter(const HashSet<int> &p_mesh_ids) override;
+	virtual void clear_mesh_filter() override;
+
+	static StaticRaycaster *create_bvh_raycaster();
+};
+
+#endif // STATIC_RAYCASTER_BVH_H
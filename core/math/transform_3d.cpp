@@ -30,6 +30,7 @@
 
 #include "transform_3d.h"
 
+#include "core/math/batch_math.h"
 #include "core/math/math_funcs.h"
 #include "core/string/ustring.h"
 
@@ -202,6 +203,20 @@ void Transform3D::operator*=(real_t p_val) {
 	basis *= p_val;
 }
 
+Vector<Vector3> Transform3D::xform(const Vector<Vector3> &p_array) const {
+	Vector<Vector3> array;
+	array.resize(p_array.size());
+	BatchMath::transform(*this, p_array.ptr(), array.ptrw(), p_array.size());
+	return array;
+}
+
+Vector<Vector3> Transform3D::xform_inv(const Vector<Vector3> &p_array) const {
+	Vector<Vector3> array;
+	array.resize(p_array.size());
+	BatchMath::transform_inv(*this, p_array.ptr(), array.ptrw(), p_array.size());
+	return array;
+}
+
 Transform3D Transform3D::operator*(real_t p_val) const {
 	Transform3D ret(*this);
 	ret *= p_val;
@@ -30,59 +30,8 @@
 
 #include "triangle_mesh.h"
 
-#include "core/templates/sort_array.h"
-
-int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &r_max_depth, int &r_max_alloc) {
-	if (p_depth > r_max_depth) {
-		r_max_depth = p_depth;
-	}
-
-	if (p_size == 1) {
-		return p_bb[p_from] - p_bvh;
-	} else if (p_size == 0) {
-		return -1;
-	}
-
-	AABB aabb;
-	aabb = p_bb[p_from]->aabb;
-	for (int i = 1; i < p_size; i++) {
-		aabb.merge_with(p_bb[p_from + i]->aabb);
-	}
-
-	int li = aabb.get_longest_axis_index();
-
-	switch (li) {
-		case Vector3::AXIS_X: {
-			SortArray<BVH *, BVHCmpX> sort_x;
-			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_x.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Y: {
-			SortArray<BVH *, BVHCmpY> sort_y;
-			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_y.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Z: {
-			SortArray<BVH *, BVHCmpZ> sort_z;
-			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_z.sort(&p_bb[p_from],p_size);
-
-		} break;
-	}
-
-	int left = _create_bvh(p_bvh, p_bb, p_from, p_size / 2, p_depth + 1, r_max_depth, r_max_alloc);
-	int right = _create_bvh(p_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, p_depth + 1, r_max_depth, r_max_alloc);
-
-	int index = r_max_alloc++;
-	BVH *_new = &p_bvh[index];
-	_new->aabb = aabb;
-	_new->center = aabb.get_center();
-	_new->face_index = -1;
-	_new->left = left;
-	_new->right = right;
-
-	return index;
-}
+#include "core/math/wide_bvh_simd.h"
+#include "core/object/worker_thread_pool.h"
 
 void TriangleMesh::get_indices(Vector<int> *r_triangles_indices) const {
 	if (!valid) {
@@ -114,11 +63,11 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 	fc /= 3;
 	triangles.resize(fc);
 
-	bvh.resize(fc * 3); //will never be larger than this (todo make better)
-	BVH *bw = bvh.ptrw();
+	WideBVH builder;
+	builder.resize(fc);
 
 	{
-		//create faces and indices and base bvh
+		//create faces and indices and the bounds of the faces
 		//except for the Set for repeated triangles, everything
 		//goes in-place.
 
@@ -130,6 +79,8 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 		for (int i = 0; i < fc; i++) {
 			Triangle &f = w[i];
 			const Vector3 *v = &r[i * 3];
+			Vector3 min;
+			Vector3 max;
 
 			for (int j = 0; j < 3; j++) {
 				int vidx = -1;
@@ -144,19 +95,18 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 
 				f.indices[j] = vidx;
 				if (j == 0) {
-					bw[i].aabb.position = vs;
+					min = vs;
+					max = vs;
 				} else {
-					bw[i].aabb.expand_to(vs);
+					min = min.min(vs);
+					max = max.max(vs);
 				}
 			}
 
 			f.normal = Face3(r[i * 3 + 0], r[i * 3 + 1], r[i * 3 + 2]).get_plane().get_normal();
 			f.surface_index = si ? si[i] : 0;
 
-			bw[i].left = -1;
-			bw[i].right = -1;
-			bw[i].face_index = i;
-			bw[i].center = bw[i].aabb.get_center();
+			builder.set_item_bounds(i, min, max);
 		}
 
 		vertices.resize(db.size());
@@ -166,312 +116,260 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 		}
 	}
 
-	Vector<BVH *> bwptrs;
-	bwptrs.resize(fc);
-	BVH **bwp = bwptrs.ptrw();
+	// Pad the node bounds, as the face tests are imprecise for grazing rays and can hit slightly outside
+	// of the faces.
+	builder.build(bvh, 0.0001);
+
+	// Store the faces in the order of the leaves, so each leaf reads consecutive faces.
+	const LocalVector<uint32_t> &order = builder.get_item_order();
+	bvh_faces.resize(fc);
+	bvh_face_triangles.resize(fc);
+	const Triangle *r = triangles.ptr();
+	const Vector3 *rv = vertices.ptr();
 	for (int i = 0; i < fc; i++) {
-		bwp[i] = &bw[i];
+		const Triangle &t = r[order[i]];
+		bvh_faces[i] = Face3(rv[t.indices[0]], rv[t.indices[1]], rv[t.indices[2]]);
+		bvh_face_triangles[i] = order[i];
 	}
 
-	max_depth = 0;
-	int max_alloc = fc;
-	_create_bvh(bw, bwp, 0, fc, 1, max_depth, max_alloc);
+	valid = true;
+}
 
-	bvh.resize(max_alloc); //resize back
+void TriangleMesh::_init_ray(BVHRay &r_ray, const Vector3 &p_begin, const Vector3 &p_end, bool p_segment) {
+	const Vector3 dir = p_segment ? p_end - p_begin : p_end;
 
-	valid = true;
+	r_ray.begin = p_begin;
+	r_ray.end = p_end;
+	r_ray.segment = p_segment;
+	r_ray.n = p_segment ? dir.normalized() : dir;
+
+	r_ray.set(p_begin, dir);
+	r_ray.tfar = p_segment ? 1.0 : INFINITY;
+
+	r_ray.d = p_segment ? 1e10 : 1e20;
+	r_ray.face = WideBVH::INVALID_CHILD;
 }
 
-bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
+void TriangleMesh::_intersect_faces(uint32_t p_first, uint32_t p_count, BVHRay &r_ray) const {
+	const Face3 *faces = bvh_faces.ptr();
+	for (uint32_t i = p_first; i < p_first + p_count; i++) {
+		Vector3 res;
+		const bool hit = r_ray.segment ? faces[i].intersects_segment(r_ray.begin, r_ray.end, &res) : faces[i].intersects_ray(r_ray.begin, r_ray.end, &res);
+		if (!hit) {
+			continue;
+		}
 
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
+		const real_t nd = r_ray.n.dot(res);
+		if (nd < r_ray.d) {
+			r_ray.d = nd;
+			r_ray.point = res;
+			r_ray.face = i;
+
+			// Nodes farther than the hit can't contain a closer one. Keep a margin, as the face tests
+			// don't round like the node tests.
+			const Vector3 dir = r_ray.segment ? r_ray.end - r_ray.begin : r_ray.end;
+			const real_t t = (res - r_ray.begin).dot(dir) / dir.length_squared();
+			r_ray.tfar = MIN(r_ray.tfar, t + (Math::abs(t) + 1.0) * CMP_EPSILON);
+		}
+	}
+}
 
+void TriangleMesh::_intersect_ray(BVHRay &r_ray) const {
+	struct StackEntry {
+		uint32_t child;
+		uint32_t face_count;
+		real_t near;
 	};
 
-	Vector3 n = (p_end - p_begin).normalized();
-	real_t d = 1e10;
-	bool inters = false;
-
-	int level = 0;
+	StackEntry stack[WideBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
 
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
+	stack[stack_size++] = { 0, 0, 0.0 };
 
-	int pos = bvh.size() - 1;
+	while (stack_size > 0) {
+		const StackEntry entry = stack[--stack_size];
 
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+		// A hit closer than the child may have been found since it was pushed.
+		if (entry.near > r_ray.tfar) {
+			continue;
+		}
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				if (!b.aabb.intersects_segment(p_begin, p_end)) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
-
-						Vector3 res;
-
-						if (f3.intersects_segment(p_begin, p_end, &res)) {
-							real_t nd = n.dot(res);
-							if (nd < d) {
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								if (r_surf_index) {
-									*r_surf_index = s.surface_index;
-								}
-								inters = true;
-							}
-						}
+		if (entry.face_count > 0) {
+			_intersect_faces(entry.child, entry.face_count, r_ray);
+			continue;
+		}
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+		const BVH &node = bvh[entry.child];
+		real_t near[4];
+		const uint32_t mask = wide_bvh_intersect_children(node, r_ray, real_t(0.0), r_ray.tfar, near);
+		if (mask == 0) {
+			continue;
+		}
 
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.left | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.right | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
+		// Push the farthest children first, so the nearest ones are visited first and shorten the ray early.
+		uint32_t order[4] = { 0, 1, 2, 3 };
+		for (uint32_t i = 1; i < 4; i++) {
+			for (uint32_t j = i; j > 0 && near[order[j - 1]] < near[order[j]]; j--) {
+				SWAP(order[j - 1], order[j]);
 			}
 		}
 
-		if (done) {
-			break;
+		for (uint32_t i = 0; i < 4; i++) {
+			const uint32_t child = order[i];
+			if (mask & (1 << child)) {
+				stack[stack_size++] = { node.children[child], node.item_counts[child], near[child] };
+			}
 		}
 	}
+}
 
-	if (inters) {
-		if (n.dot(r_normal) > 0) {
-			r_normal = -r_normal;
-		}
+bool TriangleMesh::_get_ray_result(const BVHRay &p_ray, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index) const {
+	if (p_ray.face == WideBVH::INVALID_CHILD) {
+		return false;
 	}
 
-	return inters;
+	r_point = p_ray.point;
+	r_normal = bvh_faces[p_ray.face].get_plane().get_normal();
+	if (p_ray.n.dot(r_normal) > 0) {
+		r_normal = -r_normal;
+	}
+	if (r_surf_index) {
+		*r_surf_index = triangles[bvh_face_triangles[p_ray.face]].surface_index;
+	}
+	return true;
 }
 
-bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	Vector3 n = p_dir;
-	real_t d = 1e20;
-	bool inters = false;
-
-	int level = 0;
+bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index) const {
+	if (!valid) {
+		return false;
+	}
 
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
+	BVHRay ray;
+	_init_ray(ray, p_begin, p_end, true);
+	_intersect_ray(ray);
+	return _get_ray_result(ray, r_point, r_normal, r_surf_index);
+}
 
-	int pos = bvh.size() - 1;
+bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index) const {
+	if (!valid) {
+		return false;
+	}
 
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+	BVHRay ray;
+	_init_ray(ray, p_begin, p_dir, false);
+	_intersect_ray(ray);
+	return _get_ray_result(ray, r_point, r_normal, r_surf_index);
+}
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				if (!b.aabb.intersects_ray(p_begin, p_dir)) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
-
-						Vector3 res;
-
-						if (f3.intersects_ray(p_begin, p_dir, &res)) {
-							real_t nd = n.dot(res);
-							if (nd < d) {
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								if (r_surf_index) {
-									*r_surf_index = s.surface_index;
-								}
-								inters = true;
-							}
-						}
+void TriangleMesh::_intersect_batch_chunk(uint32_t p_chunk, RayBatch *p_batch) const {
+	const int from = p_chunk * BATCH_CHUNK_SIZE;
+	const int to = MIN(from + int(BATCH_CHUNK_SIZE), p_batch->count);
+	for (int i = from; i < to; i++) {
+		BVHRay ray;
+		_init_ray(ray, p_batch->begins[i], p_batch->ends[i], p_batch->segments);
+		_intersect_ray(ray);
+		p_batch->hits[i] = _get_ray_result(ray, p_batch->points[i], p_batch->normals[i], p_batch->surf_indices ? &p_batch->surf_indices[i] : nullptr);
+	}
+}
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+int TriangleMesh::_intersect_batch(const Vector3 *p_begins, const Vector3 *p_ends, int p_count, bool p_segments, bool *r_hits, Vector3 *r_points, Vector3 *r_normals, int32_t *r_surf_indices) const {
+	if (p_count <= 0) {
+		return 0;
+	}
+	ERR_FAIL_COND_V(!p_begins || !p_ends || !r_hits || !r_points || !r_normals, 0);
 
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.left | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.right | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
-			}
+	if (!valid) {
+		for (int i = 0; i < p_count; i++) {
+			r_hits[i] = false;
 		}
+		return 0;
+	}
 
-		if (done) {
-			break;
-		}
+	RayBatch batch;
+	batch.begins = p_begins;
+	batch.ends = p_ends;
+	batch.segments = p_segments;
+	batch.count = p_count;
+	batch.hits = r_hits;
+	batch.points = r_points;
+	batch.normals = r_normals;
+	batch.surf_indices = r_surf_indices;
+
+	const uint32_t chunk_count = (p_count + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+	if (chunk_count == 1) {
+		_intersect_batch_chunk(0, &batch);
+	} else {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &TriangleMesh::_intersect_batch_chunk, &batch, chunk_count, -1, true, SNAME("TriangleMeshRayBatch"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 	}
 
-	if (inters) {
-		if (n.dot(r_normal) > 0) {
-			r_normal = -r_normal;
+	int hit_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_hits[i]) {
+			hit_count++;
 		}
 	}
-
-	return inters;
+	return hit_count;
 }
 
-bool TriangleMesh::inside_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, Vector3 p_scale) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
+int TriangleMesh::intersect_segments(const Vector3 *p_begins, const Vector3 *p_ends, int p_count, bool *r_hits, Vector3 *r_points, Vector3 *r_normals, int32_t *r_surf_indices) const {
+	return _intersect_batch(p_begins, p_ends, p_count, true, r_hits, r_points, r_normals, r_surf_indices);
+}
 
-	};
+int TriangleMesh::intersect_rays(const Vector3 *p_begins, const Vector3 *p_dirs, int p_count, bool *r_hits, Vector3 *r_points, Vector3 *r_normals, int32_t *r_surf_indices) const {
+	return _intersect_batch(p_begins, p_dirs, p_count, false, r_hits, r_points, r_normals, r_surf_indices);
+}
 
-	int level = 0;
+bool TriangleMesh::inside_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, Vector3 p_scale) const {
+	if (!valid) {
+		return false;
+	}
 
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
+	const Face3 *faces = bvh_faces.ptr();
 
 	Transform3D scale(Basis().scaled(p_scale));
 
-	int pos = bvh.size() - 1;
-
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+	uint32_t stack[WideBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool intersects = scale.xform(b.aabb).intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count);
-				if (!intersects) {
-					return false;
-				}
-
-				bool inside = scale.xform(b.aabb).inside_convex_shape(p_planes, p_plane_count);
-				if (inside) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+	while (stack_size > 0) {
+		const BVH &node = bvh[stack[--stack_size]];
 
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						for (int j = 0; j < 3; ++j) {
-							Vector3 point = scale.xform(vertexptr[s.indices[j]]);
-							for (int i = 0; i < p_plane_count; i++) {
-								const Plane &p = p_planes[i];
-								if (p.is_point_over(point)) {
-									return false;
-								}
-							}
-						}
+		for (uint32_t i = 0; i < 4; i++) {
+			if (node.children[i] == WideBVH::INVALID_CHILD) {
+				continue;
+			}
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+			const Vector3 min(node.bounds[0][i], node.bounds[1][i], node.bounds[2][i]);
+			const Vector3 max(node.bounds[3][i], node.bounds[4][i], node.bounds[5][i]);
+			const AABB aabb = scale.xform(AABB(min, max - min));
 
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
+			if (!aabb.intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count)) {
+				return false;
 			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.left | TEST_AABB_BIT;
+
+			if (aabb.inside_convex_shape(p_planes, p_plane_count)) {
 				continue;
 			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.right | TEST_AABB_BIT;
+
+			if (node.item_counts[i] == 0) {
+				stack[stack_size++] = node.children[i];
 				continue;
 			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
+
+			for (uint32_t face = node.children[i]; face < node.children[i] + node.item_counts[i]; face++) {
+				for (int j = 0; j < 3; ++j) {
+					Vector3 point = scale.xform(faces[face].vertex[j]);
+					for (int k = 0; k < p_plane_count; k++) {
+						const Plane &p = p_planes[k];
+						if (p.is_point_over(point)) {
+							return false;
+						}
+					}
 				}
-				continue;
 			}
 		}
-
-		if (done) {
-			break;
-		}
 	}
 
 	return true;
@@ -502,8 +400,3 @@ Vector<Face3> TriangleMesh::get_faces() const {
 
 	return faces;
 }
-
-TriangleMesh::TriangleMesh() {
-	valid = false;
-	max_depth = 0;
-}
@@ -32,7 +32,9 @@
 #define TRIANGLE_MESH_H
 
 #include "core/math/face3.h"
+#include "core/math/wide_bvh.h"
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 
 class TriangleMesh : public RefCounted {
 	GDCLASS(TriangleMesh, RefCounted);
@@ -45,46 +47,67 @@ public:
 	};
 
 private:
+	static const uint32_t BATCH_CHUNK_SIZE = 256;
+
 	Vector<Triangle> triangles;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		Vector3 center; //used for sorting
-		int left;
-		int right;
+	// Node of the 4-wide BVH of the faces.
+	typedef WideBVH::Node<real_t> BVH;
 
-		int face_index;
-	};
+	// Segment or ray being traversed, along with its closest hit.
+	struct BVHRay : public WideBVH::Ray<real_t> {
+		Vector3 begin;
+		// End of segments, direction of rays.
+		Vector3 end;
+		bool segment = false;
+		// Hits are sorted by their distance along this vector.
+		Vector3 n;
 
-	struct BVHCmpX {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.x < p_right->center.x;
-		}
-	};
+		real_t tfar = INFINITY;
 
-	struct BVHCmpY {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.y < p_right->center.y;
-		}
+		real_t d = 0.0;
+		uint32_t face = WideBVH::INVALID_CHILD;
+		Vector3 point;
 	};
-	struct BVHCmpZ {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.z < p_right->center.z;
-		}
+
+	struct RayBatch {
+		const Vector3 *begins = nullptr;
+		const Vector3 *ends = nullptr;
+		bool segments = false;
+		int count = 0;
+		bool *hits = nullptr;
+		Vector3 *points = nullptr;
+		Vector3 *normals = nullptr;
+		int32_t *surf_indices = nullptr;
 	};
 
-	int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc);
+	LocalVector<BVH> bvh;
+	// Faces in the order of the leaves of the tree, so each leaf reads consecutive faces.
+	LocalVector<Face3> bvh_faces;
+	// Index in triangles of each face of bvh_faces.
+	LocalVector<uint32_t> bvh_face_triangles;
+	bool valid = false;
 
-	Vector<BVH> bvh;
-	int max_depth;
-	bool valid;
+	_FORCE_INLINE_ static void _init_ray(BVHRay &r_ray, const Vector3 &p_begin, const Vector3 &p_end, bool p_segment);
+	_FORCE_INLINE_ void _intersect_faces(uint32_t p_first, uint32_t p_count, BVHRay &r_ray) const;
+	void _intersect_ray(BVHRay &r_ray) const;
+	bool _get_ray_result(const BVHRay &p_ray, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index) const;
+	void _intersect_batch_chunk(uint32_t p_chunk, RayBatch *p_batch) const;
+	int _intersect_batch(const Vector3 *p_begins, const Vector3 *p_ends, int p_count, bool p_segments, bool *r_hits, Vector3 *r_points, Vector3 *r_normals, int32_t *r_surf_indices) const;
 
 public:
 	bool is_valid() const;
 	bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index = nullptr) const;
 	bool intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index = nullptr) const;
 	bool inside_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, Vector3 p_scale = Vector3(1, 1, 1)) const;
+
+	// Batched versions of intersect_segment() and intersect_ray(), large batches are split across the
+	// worker threads. r_hits is set for all the rays, the other results only for the rays that hit.
+	// Returns the number of hits.
+	int intersect_segments(const Vector3 *p_begins, const Vector3 *p_ends, int p_count, bool *r_hits, Vector3 *r_points, Vector3 *r_normals, int32_t *r_surf_indices = nullptr) const;
+	int intersect_rays(const Vector3 *p_begins, const Vector3 *p_dirs, int p_count, bool *r_hits, Vector3 *r_points, Vector3 *r_normals, int32_t *r_surf_indices = nullptr) const;
+
 	Vector<Face3> get_faces() const;
 
 	const Vector<Triangle> &get_triangles() const { return triangles; }
@@ -92,7 +115,6 @@ public:
 	void get_indices(Vector<int> *r_triangles_indices) const;
 
 	void create(const Vector<Vector3> &p_faces, const Vector<int32_t> &p_surface_indices = Vector<int32_t>());
-	TriangleMesh();
 };
 
 #endif // TRIANGLE_MESH_H
@@ -0,0 +1,202 @@
+/**************************************************************************/
+/*  wide_bvh.cpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "wide_bvh.h"
+
+#include "core/templates/sort_array.h"
+
+void WideBVH::resize(uint32_t p_item_count) {
+	items.resize(p_item_count);
+	item_bounds.resize(p_item_count);
+	item_centers.resize(p_item_count);
+	for (uint32_t i = 0; i < p_item_count; i++) {
+		items[i] = i;
+	}
+}
+
+WideBVH::Bounds WideBVH::_get_range_bounds(uint32_t p_begin, uint32_t p_end) const {
+	const uint32_t *item_indices = items.ptr();
+	const Bounds *bounds = item_bounds.ptr();
+	Bounds range_bounds;
+	for (uint32_t i = p_begin; i < p_end; i++) {
+		range_bounds.merge_with(bounds[item_indices[i]]);
+	}
+	return range_bounds;
+}
+
+uint32_t WideBVH::_split_range(const BuildRange &p_range) {
+	uint32_t *item_indices = items.ptr();
+	const Bounds *bounds = item_bounds.ptr();
+	const Vector3 *centers = item_centers.ptr();
+
+	const uint32_t middle = p_range.begin + (p_range.end - p_range.begin) / 2;
+
+	Bounds center_bounds;
+	for (uint32_t i = p_range.begin; i < p_range.end; i++) {
+		center_bounds.min = center_bounds.min.min(centers[item_indices[i]]);
+		center_bounds.max = center_bounds.max.max(centers[item_indices[i]]);
+	}
+	const Vector3 center_size = center_bounds.max - center_bounds.min;
+	const int longest_axis = center_size.max_axis_index();
+
+	if (center_size[longest_axis] <= 0.0) {
+		// All centers are at the same position, any split is as good.
+		return middle;
+	}
+
+	if (p_range.depth >= MAX_SAH_DEPTH) {
+		struct CenterCompare {
+			const Vector3 *centers = nullptr;
+			int axis = 0;
+			_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+				return centers[p_a][axis] < centers[p_b][axis];
+			}
+		};
+		SortArray<uint32_t, CenterCompare> sorter;
+		sorter.compare.centers = centers;
+		sorter.compare.axis = longest_axis;
+		sorter.nth_element(p_range.begin, p_range.end, middle, item_indices);
+		return middle;
+	}
+
+	// Bin the items by their centers on the 3 axes at once, and find the split with the lowest surface area cost.
+	struct Bin {
+		Bounds bounds;
+		uint32_t count = 0;
+	};
+
+	Bin bins[3][SAH_BIN_COUNT];
+	Vector3 bin_scale;
+	for (int axis = 0; axis < 3; axis++) {
+		bin_scale[axis] = center_size[axis] > 0.0 ? SAH_BIN_COUNT / center_size[axis] : 0.0;
+	}
+
+	for (uint32_t i = p_range.begin; i < p_range.end; i++) {
+		const uint32_t item = item_indices[i];
+		const Vector3 bin_position = (centers[item] - center_bounds.min) * bin_scale;
+		for (int axis = 0; axis < 3; axis++) {
+			Bin &bin = bins[axis][MIN(uint32_t(bin_position[axis]), SAH_BIN_COUNT - 1)];
+			bin.bounds.merge_with(bounds[item]);
+			bin.count++;
+		}
+	}
+
+	real_t best_cost = INFINITY;
+	int best_axis = -1;
+	uint32_t best_bin = 0;
+
+	for (int axis = 0; axis < 3; axis++) {
+		if (center_size[axis] <= 0.0) {
+			continue;
+		}
+
+		// Surface area and count of the items left of each split.
+		real_t left_areas[SAH_BIN_COUNT];
+		uint32_t left_counts[SAH_BIN_COUNT];
+		Bounds left_bounds;
+		uint32_t left_count = 0;
+		for (uint32_t i = 0; i < SAH_BIN_COUNT - 1; i++) {
+			left_bounds.merge_with(bins[axis][i].bounds);
+			left_count += bins[axis][i].count;
+			left_areas[i] = left_count > 0 ? left_bounds.get_surface_area() : 0.0;
+			left_counts[i] = left_count;
+		}
+
+		Bounds right_bounds;
+		uint32_t right_count = 0;
+		for (uint32_t i = SAH_BIN_COUNT - 1; i > 0; i--) {
+			right_bounds.merge_with(bins[axis][i].bounds);
+			right_count += bins[axis][i].count;
+			if (left_counts[i - 1] == 0 || right_count == 0) {
+				continue;
+			}
+			const real_t cost = left_areas[i - 1] * left_counts[i - 1] + right_bounds.get_surface_area() * right_count;
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = i;
+			}
+		}
+	}
+
+	if (best_axis < 0) {
+		return middle;
+	}
+
+	uint32_t split = p_range.begin;
+	for (uint32_t i = p_range.begin; i < p_range.end; i++) {
+		const uint32_t item = item_indices[i];
+		const uint32_t bin_index = MIN(uint32_t((centers[item][best_axis] - center_bounds.min[best_axis]) * bin_scale[best_axis]), SAH_BIN_COUNT - 1);
+		if (bin_index < best_bin) {
+			SWAP(item_indices[i], item_indices[split]);
+			split++;
+		}
+	}
+
+	if (split == p_range.begin || split == p_range.end) {
+		return middle;
+	}
+	return split;
+}
+
+uint32_t WideBVH::_split_node(const BuildRange &p_range, BuildRange r_ranges[4]) {
+	// Split the largest child until there are 4 of them, so every node of the tree is as wide as possible.
+	r_ranges[0] = p_range;
+	uint32_t range_count = 1;
+
+	while (range_count < 4) {
+		int largest = -1;
+		real_t largest_area = -1.0;
+		for (uint32_t i = 0; i < range_count; i++) {
+			if (r_ranges[i].end - r_ranges[i].begin > MAX_LEAF_ITEMS && r_ranges[i].bounds.get_surface_area() > largest_area) {
+				largest = i;
+				largest_area = r_ranges[i].bounds.get_surface_area();
+			}
+		}
+		if (largest < 0) {
+			break;
+		}
+
+		const BuildRange range = r_ranges[largest];
+		const uint32_t split = _split_range(range);
+
+		r_ranges[largest].end = split;
+		r_ranges[largest].depth = range.depth + 1;
+		r_ranges[largest].bounds = _get_range_bounds(range.begin, split);
+
+		r_ranges[range_count].begin = split;
+		r_ranges[range_count].end = range.end;
+		r_ranges[range_count].depth = range.depth + 1;
+		r_ranges[range_count].bounds = _get_range_bounds(split, range.end);
+		range_count++;
+	}
+
+	return range_count;
+}
@@ -0,0 +1,189 @@
+/**************************************************************************/
+/*  wide_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef WIDE_BVH_H
+#define WIDE_BVH_H
+
+#include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
+
+// Builds flattened 4-wide BVHs with the surface area heuristic, used by TriangleMesh, StaticRaycasterBVH and
+// GodotConcavePolygonShape3D.
+// Items are given by their bounds. After build(), get_item_order() lists the items in the order of the leaves,
+// and the leaves refer to ranges of that list, so each leaf reads consecutive items once they are sorted.
+// The child box tests live in wide_bvh_simd.h, which is only included by source files.
+class WideBVH {
+public:
+	static const uint32_t MAX_LEAF_ITEMS = 4;
+	static const uint32_t SAH_BIN_COUNT = 16;
+	// Past this depth, nodes are split in two halves instead of using the surface area heuristic, which
+	// bounds the depth of the tree and the traversal stack.
+	static const uint32_t MAX_SAH_DEPTH = 48;
+	static const uint32_t STACK_SIZE = 3 * (MAX_SAH_DEPTH + 32) + 1;
+	static const uint32_t INVALID_CHILD = UINT32_MAX;
+
+	// Bounds of the 4 children as minimum x, y, z then maximum x, y, z, for each child, so they are tested
+	// at once with SSE or NEON when T is float.
+	template <typename T>
+	struct Node {
+		T bounds[6][4];
+		// Index of the child node, or of the first item of a leaf.
+		uint32_t children[4];
+		// Item count of the leaves, 0 for nodes.
+		uint8_t item_counts[4];
+	};
+
+	template <typename T>
+	struct Ray {
+		T origin[3];
+		T inv_dir[3];
+		// Index in the node bounds of the nearest and farthest plane on each axis.
+		uint8_t near_plane[3];
+		uint8_t far_plane[3];
+
+		_FORCE_INLINE_ void set(const Vector3 &p_origin, const Vector3 &p_dir) {
+			for (int axis = 0; axis < 3; axis++) {
+				origin[axis] = p_origin[axis];
+				inv_dir[axis] = T(1.0) / T(p_dir[axis]);
+				near_plane[axis] = inv_dir[axis] < T(0.0) ? axis + 3 : axis;
+				far_plane[axis] = inv_dir[axis] < T(0.0) ? axis : axis + 3;
+			}
+		}
+	};
+
+	struct Bounds {
+		Vector3 min = Vector3(INFINITY, INFINITY, INFINITY);
+		Vector3 max = Vector3(-INFINITY, -INFINITY, -INFINITY);
+
+		_FORCE_INLINE_ void merge_with(const Bounds &p_bounds) {
+			min = min.min(p_bounds.min);
+			max = max.max(p_bounds.max);
+		}
+
+		_FORCE_INLINE_ real_t get_surface_area() const {
+			const Vector3 size = max - min;
+			return 2.0 * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+	};
+
+private:
+	struct BuildRange {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		uint32_t depth = 0;
+		Bounds bounds;
+	};
+
+	LocalVector<uint32_t> items;
+	LocalVector<Bounds> item_bounds;
+	LocalVector<Vector3> item_centers;
+
+	Bounds _get_range_bounds(uint32_t p_begin, uint32_t p_end) const;
+	uint32_t _split_range(const BuildRange &p_range);
+	uint32_t _split_node(const BuildRange &p_range, BuildRange r_ranges[4]);
+
+	template <typename T>
+	uint32_t _build_node(const BuildRange &p_range, real_t p_padding, LocalVector<Node<T>> &r_nodes);
+
+public:
+	void resize(uint32_t p_item_count);
+	_FORCE_INLINE_ void set_item_bounds(uint32_t p_item, const Vector3 &p_min, const Vector3 &p_max) {
+		item_bounds[p_item].min = p_min;
+		item_bounds[p_item].max = p_max;
+		item_centers[p_item] = (p_min + p_max) * 0.5;
+	}
+
+	// Replaces r_nodes with the tree, the root being the first node. The node bounds are grown by p_padding
+	// times their distance to the origin plus one, for item tests that can hit slightly outside of the items.
+	template <typename T>
+	void build(LocalVector<Node<T>> &r_nodes, real_t p_padding = 0.0);
+
+	const LocalVector<uint32_t> &get_item_order() const { return items; }
+};
+
+template <typename T>
+uint32_t WideBVH::_build_node(const BuildRange &p_range, real_t p_padding, LocalVector<Node<T>> &r_nodes) {
+	BuildRange ranges[4];
+	const uint32_t range_count = _split_node(p_range, ranges);
+
+	const uint32_t node_index = r_nodes.size();
+	r_nodes.push_back(Node<T>());
+
+	uint32_t children[4];
+	uint8_t item_counts[4];
+	for (uint32_t i = 0; i < 4; i++) {
+		if (i >= range_count) {
+			children[i] = INVALID_CHILD;
+			item_counts[i] = 0;
+		} else if (ranges[i].end - ranges[i].begin <= MAX_LEAF_ITEMS) {
+			children[i] = ranges[i].begin;
+			item_counts[i] = ranges[i].end - ranges[i].begin;
+		} else {
+			children[i] = _build_node(ranges[i], p_padding, r_nodes);
+			item_counts[i] = 0;
+		}
+	}
+
+	Node<T> &node = r_nodes[node_index];
+	for (uint32_t i = 0; i < 4; i++) {
+		node.children[i] = children[i];
+		node.item_counts[i] = item_counts[i];
+		for (int axis = 0; axis < 3; axis++) {
+			if (i < range_count) {
+				const real_t min = ranges[i].bounds.min[axis];
+				const real_t max = ranges[i].bounds.max[axis];
+				node.bounds[axis][i] = min - (Math::abs(min) + 1.0) * p_padding;
+				node.bounds[axis + 3][i] = max + (Math::abs(max) + 1.0) * p_padding;
+			} else {
+				// Empty children can't be hit.
+				node.bounds[axis][i] = INFINITY;
+				node.bounds[axis + 3][i] = -INFINITY;
+			}
+		}
+	}
+
+	return node_index;
+}
+
+template <typename T>
+void WideBVH::build(LocalVector<Node<T>> &r_nodes, real_t p_padding) {
+	r_nodes.clear();
+	if (items.is_empty()) {
+		return;
+	}
+
+	BuildRange range;
+	range.begin = 0;
+	range.end = items.size();
+	range.bounds = _get_range_bounds(0, items.size());
+	_build_node(range, p_padding, r_nodes);
+}
+
+#endif // WIDE_BVH_H
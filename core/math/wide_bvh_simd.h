@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*  wide_bvh_simd.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef WIDE_BVH_SIMD_H
+#define WIDE_BVH_SIMD_H
+
+// Ray tests against the 4 children of a WideBVH node. This includes core/math/simd.h, so only include it
+// from source files.
+
+#include "core/math/simd.h"
+#include "core/math/wide_bvh.h"
+
+// Returns the mask of the children hit between p_tnear and p_tfar, and the distance at which the ray enters each of them.
+template <typename T>
+static _FORCE_INLINE_ uint32_t wide_bvh_intersect_children(const WideBVH::Node<T> &p_node, const WideBVH::Ray<T> &p_ray, T p_tnear, T p_tfar, T *r_near) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		const T tmin = MAX(MAX((p_node.bounds[p_ray.near_plane[0]][i] - p_ray.origin[0]) * p_ray.inv_dir[0], (p_node.bounds[p_ray.near_plane[1]][i] - p_ray.origin[1]) * p_ray.inv_dir[1]), MAX((p_node.bounds[p_ray.near_plane[2]][i] - p_ray.origin[2]) * p_ray.inv_dir[2], p_tnear));
+		const T tmax = MIN(MIN((p_node.bounds[p_ray.far_plane[0]][i] - p_ray.origin[0]) * p_ray.inv_dir[0], (p_node.bounds[p_ray.far_plane[1]][i] - p_ray.origin[1]) * p_ray.inv_dir[1]), MIN((p_node.bounds[p_ray.far_plane[2]][i] - p_ray.origin[2]) * p_ray.inv_dir[2], p_tfar));
+		r_near[i] = tmin;
+		if (tmin <= tmax) {
+			mask |= 1 << i;
+		}
+	}
+	return mask;
+}
+
+#if defined(SIMD_SSE2)
+
+static _FORCE_INLINE_ uint32_t wide_bvh_intersect_children(const WideBVH::Node<float> &p_node, const WideBVH::Ray<float> &p_ray, float p_tnear, float p_tfar, float *r_near) {
+	const __m128 near_x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_node.bounds[p_ray.near_plane[0]]), _mm_set1_ps(p_ray.origin[0])), _mm_set1_ps(p_ray.inv_dir[0]));
+	const __m128 near_y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_node.bounds[p_ray.near_plane[1]]), _mm_set1_ps(p_ray.origin[1])), _mm_set1_ps(p_ray.inv_dir[1]));
+	const __m128 near_z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_node.bounds[p_ray.near_plane[2]]), _mm_set1_ps(p_ray.origin[2])), _mm_set1_ps(p_ray.inv_dir[2]));
+	const __m128 far_x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_node.bounds[p_ray.far_plane[0]]), _mm_set1_ps(p_ray.origin[0])), _mm_set1_ps(p_ray.inv_dir[0]));
+	const __m128 far_y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_node.bounds[p_ray.far_plane[1]]), _mm_set1_ps(p_ray.origin[1])), _mm_set1_ps(p_ray.inv_dir[1]));
+	const __m128 far_z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p_node.bounds[p_ray.far_plane[2]]), _mm_set1_ps(p_ray.origin[2])), _mm_set1_ps(p_ray.inv_dir[2]));
+	const __m128 tmin = _mm_max_ps(_mm_max_ps(near_x, near_y), _mm_max_ps(near_z, _mm_set1_ps(p_tnear)));
+	const __m128 tmax = _mm_min_ps(_mm_min_ps(far_x, far_y), _mm_min_ps(far_z, _mm_set1_ps(p_tfar)));
+	_mm_storeu_ps(r_near, tmin);
+	return _mm_movemask_ps(_mm_cmple_ps(tmin, tmax));
+}
+
+#elif defined(SIMD_NEON)
+
+// vmaxq_f32()/vminq_f32() return NaN when either value is NaN, while _mm_max_ps()/_mm_min_ps() and the
+// scalar MAX()/MIN() return the second value. Axis aligned rays starting on a bound plane compute 0 * inf = NaN,
+// so select like SSE does to get the same hits on every platform.
+static _FORCE_INLINE_ float32x4_t _wide_bvh_max(float32x4_t p_a, float32x4_t p_b) {
+	return vbslq_f32(vcgtq_f32(p_a, p_b), p_a, p_b);
+}
+
+static _FORCE_INLINE_ float32x4_t _wide_bvh_min(float32x4_t p_a, float32x4_t p_b) {
+	return vbslq_f32(vcltq_f32(p_a, p_b), p_a, p_b);
+}
+
+static _FORCE_INLINE_ uint32_t wide_bvh_intersect_children(const WideBVH::Node<float> &p_node, const WideBVH::Ray<float> &p_ray, float p_tnear, float p_tfar, float *r_near) {
+	const float32x4_t near_x = vmulq_n_f32(vsubq_f32(vld1q_f32(p_node.bounds[p_ray.near_plane[0]]), vdupq_n_f32(p_ray.origin[0])), p_ray.inv_dir[0]);
+	const float32x4_t near_y = vmulq_n_f32(vsubq_f32(vld1q_f32(p_node.bounds[p_ray.near_plane[1]]), vdupq_n_f32(p_ray.origin[1])), p_ray.inv_dir[1]);
+	const float32x4_t near_z = vmulq_n_f32(vsubq_f32(vld1q_f32(p_node.bounds[p_ray.near_plane[2]]), vdupq_n_f32(p_ray.origin[2])), p_ray.inv_dir[2]);
+	const float32x4_t far_x = vmulq_n_f32(vsubq_f32(vld1q_f32(p_node.bounds[p_ray.far_plane[0]]), vdupq_n_f32(p_ray.origin[0])), p_ray.inv_dir[0]);
+	const float32x4_t far_y = vmulq_n_f32(vsubq_f32(vld1q_f32(p_node.bounds[p_ray.far_plane[1]]), vdupq_n_f32(p_ray.origin[1])), p_ray.inv_dir[1]);
+	const float32x4_t far_z = vmulq_n_f32(vsubq_f32(vld1q_f32(p_node.bounds[p_ray.far_plane[2]]), vdupq_n_f32(p_ray.origin[2])), p_ray.inv_dir[2]);
+	const float32x4_t tmin = _wide_bvh_max(_wide_bvh_max(near_x, near_y), _wide_bvh_max(near_z, vdupq_n_f32(p_tnear)));
+	const float32x4_t tmax = _wide_bvh_min(_wide_bvh_min(far_x, far_y), _wide_bvh_min(far_z, vdupq_n_f32(p_tfar)));
+	vst1q_f32(r_near, tmin);
+	static const uint32_t child_bits[4] = { 1, 2, 4, 8 };
+	return vaddvq_u32(vandq_u32(vcleq_f32(tmin, tmax), vld1q_u32(child_bits)));
+}
+
+#endif
+
+#endif // WIDE_BVH_SIMD_H
@@ -630,6 +630,16 @@ int WorkerThreadPool::get_thread_index() {
 	return singleton->thread_ids.has(tid) ? singleton->thread_ids[tid] : -1;
 }
 
+bool WorkerThreadPool::can_wait_for_group_task() {
+	const int thread_index = get_thread_index();
+	if (thread_index == -1) {
+		return true;
+	}
+	// Low priority tasks never take all the threads, so there are always threads left for the group.
+	const Task *task = singleton->threads[thread_index].current_task;
+	return task && task->low_priority;
+}
+
 void WorkerThreadPool::thread_enter_command_queue_mt_flush(CommandQueueMT *p_queue) {
 	ERR_FAIL_COND(flushing_cmd_queue != nullptr);
 	flushing_cmd_queue = p_queue;
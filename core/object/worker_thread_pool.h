@@ -231,6 +231,9 @@ public:
 
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	static int get_thread_index();
+	// Whether the calling thread can wait for a high priority group task. Pool threads running high priority
+	// tasks can't, as the pool could deadlock once all of its threads wait.
+	static bool can_wait_for_group_task();
 
 	static void thread_enter_command_queue_mt_flush(CommandQueueMT *p_queue);
 	static void thread_exit_command_queue_mt_flush();
@@ -35,6 +35,7 @@
 #include "core/debugger/engine_debugger.h"
 #include "core/io/compression.h"
 #include "core/io/marshalls.h"
+#include "core/math/batch_math.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
 #include "core/templates/local_vector.h"
@@ -1019,6 +1020,35 @@ struct _VariantCall {
 		return len;
 	}
 
+	static PackedVector3Array func_PackedVector3Array_normalized(PackedVector3Array *p_instance) {
+		PackedVector3Array dest;
+		dest.resize(p_instance->size());
+		BatchMath::normalize(p_instance->ptr(), dest.ptrw(), p_instance->size());
+		return dest;
+	}
+
+	static PackedFloat32Array func_PackedVector3Array_dot(PackedVector3Array *p_instance, const PackedVector3Array &p_with) {
+		PackedFloat32Array dest;
+		ERR_FAIL_COND_V_MSG(p_instance->size() != p_with.size(), dest, "Both arrays must have the same size.");
+		dest.resize(p_instance->size());
+#ifdef REAL_T_IS_DOUBLE
+		LocalVector<real_t> dots;
+		dots.resize(p_instance->size());
+		BatchMath::dot(p_instance->ptr(), p_with.ptr(), dots.ptr(), p_instance->size());
+		float *w = dest.ptrw();
+		for (uint32_t i = 0; i < dots.size(); i++) {
+			w[i] = dots[i];
+		}
+#else
+		BatchMath::dot(p_instance->ptr(), p_with.ptr(), dest.ptrw(), p_instance->size());
+#endif
+		return dest;
+	}
+
+	static AABB func_PackedVector3Array_get_aabb(PackedVector3Array *p_instance) {
+		return BatchMath::get_aabb(p_instance->ptr(), p_instance->size());
+	}
+
 	static void func_Callable_call(Variant *v, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
 		Callable *callable = VariantGetInternalPtr<Callable>::get_ptr(v);
 		callable->callp(p_args, p_argcount, r_ret, r_error);
@@ -2507,6 +2537,9 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedVector3Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedVector3Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedVector3Array, count, sarray("value"), varray());
+	bind_function(PackedVector3Array, normalized, _VariantCall::func_PackedVector3Array_normalized, sarray(), varray());
+	bind_function(PackedVector3Array, dot, _VariantCall::func_PackedVector3Array_dot, sarray("with"), varray());
+	bind_function(PackedVector3Array, get_aabb, _VariantCall::func_PackedVector3Array_get_aabb, sarray(), varray());
 
 	/* Color Array */
 
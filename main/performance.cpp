@@ -80,6 +80,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLANDS_REBUILT);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_AREAS_PROCESSED);
 #endif // _3D_DISABLED
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
 	BIND_ENUM_CONSTANT(NAVIGATION_ACTIVE_MAPS);
@@ -141,6 +143,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"physics_3d/islands_rebuilt",
+		"physics_3d/areas_processed",
 
 	};
 
@@ -225,6 +229,17 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+#ifdef _3D_DISABLED
+		case PHYSICS_3D_ISLANDS_REBUILT:
+			return 0;
+		case PHYSICS_3D_AREAS_PROCESSED:
+			return 0;
+#else
+		case PHYSICS_3D_ISLANDS_REBUILT:
+			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLANDS_REBUILT);
+		case PHYSICS_3D_AREAS_PROCESSED:
+			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_AREAS_PROCESSED);
+#endif // _3D_DISABLED
 
 		default: {
 		}
@@ -272,6 +287,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
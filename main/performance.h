@@ -100,6 +100,8 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		PHYSICS_3D_ISLANDS_REBUILT,
+		PHYSICS_3D_AREAS_PROCESSED,
 		MONITOR_MAX
 	};
 
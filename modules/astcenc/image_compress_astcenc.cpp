@@ -32,9 +32,73 @@
 
 #include "core/os/os.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 
 #include <astcenc.h>
 
+struct ASTCEncodeJob {
+	const astcenc_config *config = nullptr;
+	LocalVector<astcenc_context *> contexts; // One per block rows slot.
+	LocalVector<const uint8_t *> mip_src;
+	bool is_hdr = false;
+	int pixel_size = 0;
+	unsigned int block_x = 0;
+	unsigned int block_y = 0;
+	uint8_t *dst = nullptr;
+	SafeFlag failed; // Set by the first rows which fail, the others are skipped.
+};
+
+static void _compress_astc_rows(void *p_job, const Image::BlockRows &p_rows) {
+	ASTCEncodeJob *job = static_cast<ASTCEncodeJob *>(p_job);
+	if (job->failed.is_set()) {
+		return;
+	}
+
+	astcenc_context *&context = job->contexts[p_rows.slot];
+	if (!context) {
+		const unsigned int thread_count = 1; // Rows are already spread over the worker threads.
+		astcenc_error status = astcenc_context_alloc(job->config, thread_count, &context);
+		if (status != ASTCENC_SUCCESS) {
+			job->failed.set();
+			ERR_FAIL_MSG(vformat("astcenc: Context allocation failed: %s.", astcenc_get_error_string(status)));
+		}
+	}
+
+	// Compress the rows as an image of their own, blocks don't depend on each other.
+
+	const unsigned int y_from = p_rows.block_row_from * job->block_y;
+	const unsigned int y_to = MIN(p_rows.block_row_to * job->block_y, (unsigned int)p_rows.height);
+	const uint8_t *slices = job->mip_src[p_rows.mipmap] + y_from * p_rows.width * job->pixel_size;
+
+	astcenc_image image;
+	image.dim_x = p_rows.width;
+	image.dim_y = y_to - y_from;
+	image.dim_z = 1;
+	image.data_type = ASTCENC_TYPE_U8;
+	if (job->is_hdr) {
+		image.data_type = ASTCENC_TYPE_F32;
+	}
+	image.data = (void **)(&slices);
+
+	// Compute the number of ASTC blocks in each dimension.
+	unsigned int block_count_x = (p_rows.width + job->block_x - 1) / job->block_x;
+	unsigned int block_count_y = p_rows.block_row_to - p_rows.block_row_from;
+	size_t comp_len = block_count_x * block_count_y * 16;
+
+	const astcenc_swizzle swizzle = {
+		ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A
+	};
+
+	astcenc_error status = astcenc_compress_image(context, &image, &swizzle, &job->dst[p_rows.dst_offset], comp_len, 0);
+	astcenc_compress_reset(context);
+
+	if (status != ASTCENC_SUCCESS) {
+		job->failed.set();
+		ERR_FAIL_MSG(vformat("astcenc: ASTC image compression failed: %s.", astcenc_get_error_string(status)));
+	}
+}
+
 void _compress_astc(Image *r_img, Image::ASTCFormat p_format) {
 	uint64_t start_time = OS::get_singleton()->get_ticks_msec();
 
@@ -112,13 +176,20 @@ void _compress_astc(Image *r_img, Image::ASTCFormat p_format) {
 	ERR_FAIL_COND_MSG(status != ASTCENC_SUCCESS,
 			vformat("astcenc: Configuration initialization failed: %s.", astcenc_get_error_string(status)));
 
-	// Context allocation.
+	// Context allocation. Each slot of the block rows driver gets its own single threaded context,
+	// allocated the first time it picks up some rows, so small images keep using a single one.
 
-	astcenc_context *context;
-	const unsigned int thread_count = 1; // Godot compresses multiple images each on a thread, which is more efficient for large amount of images imported.
-	status = astcenc_context_alloc(&config, thread_count, &context);
-	ERR_FAIL_COND_MSG(status != ASTCENC_SUCCESS,
-			vformat("astcenc: Context allocation failed: %s.", astcenc_get_error_string(status)));
+	ASTCEncodeJob job;
+	job.config = &config;
+	job.contexts.resize(Image::get_block_rows_slot_count());
+	for (uint32_t i = 0; i < job.contexts.size(); i++) {
+		job.contexts[i] = nullptr;
+	}
+	job.is_hdr = is_hdr;
+	job.pixel_size = Image::get_format_pixel_size(r_img->get_format());
+	job.block_x = block_x;
+	job.block_y = block_y;
+	job.dst = dest_write;
 
 	Vector<uint8_t> image_data = r_img->get_data();
 
@@ -126,44 +197,20 @@ void _compress_astc(Image *r_img, Image::ASTCFormat p_format) {
 	for (int i = 0; i < mip_count + 1; i++) {
 		int src_mip_w, src_mip_h;
 		int src_ofs = Image::get_image_mipmap_offset_and_dimensions(width, height, r_img->get_format(), i, src_mip_w, src_mip_h);
+		job.mip_src.push_back(&image_data.ptr()[src_ofs]);
+	}
 
-		const uint8_t *slices = &image_data.ptr()[src_ofs];
-
-		int dst_mip_w, dst_mip_h;
-		int dst_ofs = Image::get_image_mipmap_offset_and_dimensions(width, height, target_format, i, dst_mip_w, dst_mip_h);
-		// Ensure that mip offset is a multiple of 8 (etcpak expects uint64_t pointer).
-		ERR_FAIL_COND(dst_ofs % 8 != 0);
-		uint8_t *dest_mip_write = (uint8_t *)&dest_write[dst_ofs];
-
-		// Compress image.
+	Image::compress_block_rows(width, height, mipmaps, target_format, &_compress_astc_rows, &job);
 
-		astcenc_image image;
-		image.dim_x = src_mip_w;
-		image.dim_y = src_mip_h;
-		image.dim_z = 1;
-		image.data_type = ASTCENC_TYPE_U8;
-		if (is_hdr) {
-			image.data_type = ASTCENC_TYPE_F32;
+	for (astcenc_context *context : job.contexts) {
+		if (context) {
+			astcenc_context_free(context);
 		}
-		image.data = (void **)(&slices);
-
-		// Compute the number of ASTC blocks in each dimension.
-		unsigned int block_count_x = (src_mip_w + block_x - 1) / block_x;
-		unsigned int block_count_y = (src_mip_h + block_y - 1) / block_y;
-		size_t comp_len = block_count_x * block_count_y * 16;
-
-		const astcenc_swizzle swizzle = {
-			ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A
-		};
-
-		status = astcenc_compress_image(context, &image, &swizzle, dest_mip_write, comp_len, 0);
-
-		ERR_BREAK_MSG(status != ASTCENC_SUCCESS,
-				vformat("astcenc: ASTC image compression failed: %s.", astcenc_get_error_string(status)));
-		astcenc_compress_reset(context);
 	}
 
-	astcenc_context_free(context);
+	if (job.failed.is_set()) {
+		return; // The error was already printed, leave the image untouched.
+	}
 
 	// Replace original image with compressed one.
 
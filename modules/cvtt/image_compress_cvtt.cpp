@@ -30,10 +30,9 @@
 
 #include "image_compress_cvtt.h"
 
-#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
-#include "core/templates/safe_refcount.h"
+#include "core/templates/local_vector.h"
 
 #include <ConvectionKernels.h>
 
@@ -53,11 +52,11 @@ struct CVTTCompressionRowTask {
 	int height = 0;
 };
 
-struct CVTTCompressionJobQueue {
+struct CVTTCompressionJob {
 	CVTTCompressionJobParams job_params;
-	const CVTTCompressionRowTask *job_tasks = nullptr;
-	uint32_t num_tasks = 0;
-	SafeNumeric<uint32_t> current_task;
+	const uint8_t *in_bytes = nullptr;
+	LocalVector<int> in_mm_offsets;
+	uint8_t *out_bytes = nullptr;
 };
 
 static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const CVTTCompressionRowTask &p_row_task) {
@@ -129,15 +128,20 @@ static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const
 	}
 }
 
-static void _digest_job_queue(void *p_job_queue, uint32_t p_index) {
-	CVTTCompressionJobQueue *job_queue = static_cast<CVTTCompressionJobQueue *>(p_job_queue);
-	uint32_t num_tasks = job_queue->num_tasks;
-	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
-	uint32_t start = p_index * num_tasks / total_threads;
-	uint32_t end = (p_index + 1 == total_threads) ? num_tasks : ((p_index + 1) * num_tasks / total_threads);
+static void _digest_block_rows(void *p_job, const Image::BlockRows &p_rows) {
+	const CVTTCompressionJob *job = static_cast<const CVTTCompressionJob *>(p_job);
 
-	for (uint32_t i = start; i < end; i++) {
-		_digest_row_task(job_queue->job_params, job_queue->job_tasks[i]);
+	CVTTCompressionRowTask row_task;
+	row_task.width = p_rows.width;
+	row_task.height = p_rows.height;
+	row_task.in_mm_bytes = &job->in_bytes[job->in_mm_offsets[p_rows.mipmap]];
+	row_task.out_mm_bytes = &job->out_bytes[p_rows.dst_offset];
+
+	int bw = p_rows.width % 4 != 0 ? p_rows.width + (4 - p_rows.width % 4) : p_rows.width;
+	for (int y = p_rows.block_row_from; y < p_rows.block_row_to; y++) {
+		row_task.y_start = y * 4;
+		_digest_row_task(job->job_params, row_task);
+		row_task.out_mm_bytes += 16 * (bw / 4);
 	}
 }
 
@@ -193,61 +197,22 @@ void image_compress_cvtt(Image *p_image, Image::UsedChannels p_channels) {
 	int target_size = Image::get_image_data_size(w, h, target_format, p_image->has_mipmaps());
 	int mm_count = p_image->has_mipmaps() ? Image::get_image_required_mipmaps(w, h, target_format) : 0;
 	data.resize(target_size);
-	int shift = Image::get_format_pixel_rshift(target_format);
 
 	uint8_t *wb = data.ptrw();
 
-	int dst_ofs = 0;
-
-	CVTTCompressionJobQueue job_queue;
-	job_queue.job_params.is_hdr = is_hdr;
-	job_queue.job_params.is_signed = is_signed;
-	job_queue.job_params.options = options;
-	job_queue.job_params.bytes_per_pixel = is_hdr ? 6 : 4;
-	cvtt::Kernels::ConfigureBC7EncodingPlanFromQuality(job_queue.job_params.bc7_plan, 5);
-
-	// Amdahl's law (Wikipedia)
-	// If a program needs 20 hours to complete using a single thread, but a one-hour portion of the program cannot be parallelized,
-	// therefore only the remaining 19 hours (p = 0.95) of execution time can be parallelized, then regardless of how many threads are devoted
-	// to a parallelized execution of this program, the minimum execution time cannot be less than one hour.
-	//
-	// The number of executions with different inputs can be increased while the latency is the same.
-
-	Vector<CVTTCompressionRowTask> tasks;
-
+	CVTTCompressionJob job;
+	job.job_params.is_hdr = is_hdr;
+	job.job_params.is_signed = is_signed;
+	job.job_params.options = options;
+	job.job_params.bytes_per_pixel = is_hdr ? 6 : 4;
+	cvtt::Kernels::ConfigureBC7EncodingPlanFromQuality(job.job_params.bc7_plan, 5);
+	job.in_bytes = rb;
+	job.out_bytes = wb;
 	for (int i = 0; i <= mm_count; i++) {
-		int bw = w % 4 != 0 ? w + (4 - w % 4) : w;
-		int bh = h % 4 != 0 ? h + (4 - h % 4) : h;
-
-		int src_ofs = p_image->get_mipmap_offset(i);
-
-		const uint8_t *in_bytes = &rb[src_ofs];
-		uint8_t *out_bytes = &wb[dst_ofs];
-
-		for (int y_start = 0; y_start < h; y_start += 4) {
-			CVTTCompressionRowTask row_task;
-			row_task.width = w;
-			row_task.height = h;
-			row_task.y_start = y_start;
-			row_task.in_mm_bytes = in_bytes;
-			row_task.out_mm_bytes = out_bytes;
-
-			tasks.push_back(row_task);
-
-			out_bytes += 16 * (bw / 4);
-		}
-
-		dst_ofs += (MAX(4, bw) * MAX(4, bh)) >> shift;
-		w = MAX(w / 2, 1);
-		h = MAX(h / 2, 1);
+		job.in_mm_offsets.push_back(p_image->get_mipmap_offset(i));
 	}
 
-	const CVTTCompressionRowTask *tasks_rb = tasks.ptr();
-
-	job_queue.job_tasks = &tasks_rb[0];
-	job_queue.num_tasks = static_cast<uint32_t>(tasks.size());
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_digest_job_queue, &job_queue, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("CVTT Compress"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	Image::compress_block_rows(w, h, p_image->has_mipmaps(), target_format, &_digest_block_rows, &job);
 
 	p_image->set_data(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
 }
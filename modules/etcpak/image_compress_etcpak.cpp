@@ -32,6 +32,7 @@
 
 #include "core/os/os.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 
 #include <ProcessDxtc.hpp>
 #include <ProcessRGB.hpp>
@@ -88,6 +89,67 @@ void _compress_bc(Image *r_img, Image::UsedChannels p_channels) {
 	_compress_etcpak(type, r_img);
 }
 
+struct EtcpakCompressJob {
+	EtcpakType type = EtcpakType::ETCPAK_TYPE_ETC1;
+	LocalVector<const uint32_t *> mip_src; // Padded to whole blocks.
+	LocalVector<Vector<uint32_t>> padded_src;
+	uint8_t *dst = nullptr;
+};
+
+static void _compress_etcpak_rows(void *p_job, const Image::BlockRows &p_rows) {
+	const EtcpakCompressJob *job = static_cast<const EtcpakCompressJob *>(p_job);
+
+	// Block size. Align stride to multiple of 4 (RGBA8).
+	const int mip_w = (p_rows.width + 3) & ~3;
+	const uint32_t blocks = (p_rows.block_row_to - p_rows.block_row_from) * (mip_w / 4);
+	const uint32_t *src_read = job->mip_src[p_rows.mipmap] + p_rows.block_row_from * 4 * mip_w;
+	uint64_t *dest_write = (uint64_t *)&job->dst[p_rows.dst_offset];
+
+	switch (job->type) {
+		case EtcpakType::ETCPAK_TYPE_ETC1:
+			CompressEtc1RgbDither(src_read, dest_write, blocks, mip_w);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2:
+			CompressEtc2Rgb(src_read, dest_write, blocks, mip_w, true);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2_ALPHA:
+		case EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG:
+			CompressEtc2Rgba(src_read, dest_write, blocks, mip_w, true);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2_R:
+			CompressEacR(src_read, dest_write, blocks, mip_w);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_ETC2_RG:
+			CompressEacRg(src_read, dest_write, blocks, mip_w);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_DXT1:
+			CompressDxt1Dither(src_read, dest_write, blocks, mip_w);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_DXT5:
+		case EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG:
+			CompressDxt5(src_read, dest_write, blocks, mip_w);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_RGTC_R:
+			CompressBc4(src_read, dest_write, blocks, mip_w);
+			break;
+
+		case EtcpakType::ETCPAK_TYPE_RGTC_RG:
+			CompressBc5(src_read, dest_write, blocks, mip_w);
+			break;
+
+		default:
+			ERR_FAIL_MSG("etcpak: Invalid or unsupported compression format.");
+			break;
+	}
+}
+
 void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 	uint64_t start_time = OS::get_singleton()->get_ticks_msec();
 
@@ -187,7 +249,12 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 	uint8_t *dest_write = dest_data.ptrw();
 
 	int mip_count = mipmaps ? Image::get_image_required_mipmaps(width, height, target_format) : 0;
-	Vector<uint32_t> padded_src;
+
+	EtcpakCompressJob job;
+	job.type = p_compresstype;
+	job.dst = dest_write;
+	job.mip_src.resize(mip_count + 1);
+	job.padded_src.resize(mip_count + 1);
 
 	for (int i = 0; i < mip_count + 1; i++) {
 		// Get write mip metrics for target image.
@@ -195,12 +262,10 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 		int mip_ofs = Image::get_image_mipmap_offset_and_dimensions(width, height, target_format, i, orig_mip_w, orig_mip_h);
 		// Ensure that mip offset is a multiple of 8 (etcpak expects uint64_t pointer).
 		ERR_FAIL_COND(mip_ofs % 8 != 0);
-		uint64_t *dest_mip_write = (uint64_t *)&dest_write[mip_ofs];
 
 		// Block size. Align stride to multiple of 4 (RGBA8).
 		int mip_w = (orig_mip_w + 3) & ~3;
 		int mip_h = (orig_mip_h + 3) & ~3;
-		const uint32_t blocks = mip_w * mip_h / 16;
 
 		// Get mip data from source image for reading.
 		int src_mip_ofs = r_img->get_mipmap_offset(i);
@@ -208,6 +273,7 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 
 		// Pad textures to nearest block by smearing.
 		if (mip_w != orig_mip_w || mip_h != orig_mip_h) {
+			Vector<uint32_t> &padded_src = job.padded_src[i];
 			padded_src.resize(mip_w * mip_h);
 			uint32_t *ptrw = padded_src.ptrw();
 			int x = 0, y = 0;
@@ -230,51 +296,12 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 			src_mip_read = padded_src.ptr();
 		}
 
-		switch (p_compresstype) {
-			case EtcpakType::ETCPAK_TYPE_ETC1:
-				CompressEtc1RgbDither(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2:
-				CompressEtc2Rgb(src_mip_read, dest_mip_write, blocks, mip_w, true);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2_ALPHA:
-			case EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG:
-				CompressEtc2Rgba(src_mip_read, dest_mip_write, blocks, mip_w, true);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2_R:
-				CompressEacR(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_ETC2_RG:
-				CompressEacRg(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_DXT1:
-				CompressDxt1Dither(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_DXT5:
-			case EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG:
-				CompressDxt5(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_RGTC_R:
-				CompressBc4(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			case EtcpakType::ETCPAK_TYPE_RGTC_RG:
-				CompressBc5(src_mip_read, dest_mip_write, blocks, mip_w);
-				break;
-
-			default:
-				ERR_FAIL_MSG("etcpak: Invalid or unsupported compression format.");
-				break;
-		}
+		job.mip_src[i] = src_mip_read;
 	}
 
+	// Blocks are independent, so the mips are compressed concurrently in bands of block rows.
+	Image::compress_block_rows(width, height, mipmaps, target_format, &_compress_etcpak_rows, &job);
+
 	// Replace original image with compressed one.
 	r_img->set_data(width, height, mipmaps, target_format, dest_data);
 
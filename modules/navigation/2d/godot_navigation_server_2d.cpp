@@ -271,6 +271,12 @@ real_t FORWARD_1_C(map_get_cell_size, RID, p_map, rid_to_rid);
 void FORWARD_2(map_set_use_edge_connections, RID, p_map, bool, p_enabled, rid_to_rid, bool_to_bool);
 bool FORWARD_1_C(map_get_use_edge_connections, RID, p_map, rid_to_rid);
 
+void FORWARD_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled, rid_to_rid, bool_to_bool);
+bool FORWARD_1_C(map_get_use_hierarchical_pathfinding, RID, p_map, rid_to_rid);
+
+void FORWARD_2(map_set_use_path_corridor_cache, RID, p_map, bool, p_enabled, rid_to_rid, bool_to_bool);
+bool FORWARD_1_C(map_get_use_path_corridor_cache, RID, p_map, rid_to_rid);
+
 void FORWARD_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin, rid_to_rid, real_to_real);
 real_t FORWARD_1_C(map_get_edge_connection_margin, RID, p_map, rid_to_rid);
 
@@ -279,6 +285,15 @@ real_t FORWARD_1_C(map_get_link_connection_radius, RID, p_map, rid_to_rid);
 
 Vector<Vector2> FORWARD_5_R_C(vector_v3_to_v2, map_get_path, RID, p_map, Vector2, p_origin, Vector2, p_destination, bool, p_optimize, uint32_t, p_layers, rid_to_rid, v2_to_v3, v2_to_v3, bool_to_bool, uint32_to_uint32);
 
+Vector2 GodotNavigationServer2D::map_get_flow_field_next_position(RID p_map, const Vector2 &p_destination, const Vector2 &p_position, uint32_t p_navigation_layers) const {
+	Vector3 result = NavigationServer3D::get_singleton()->map_get_flow_field_next_position(p_map, v2_to_v3(p_destination), v2_to_v3(p_position), p_navigation_layers);
+	return v3_to_v2(result);
+}
+
+real_t GodotNavigationServer2D::map_get_flow_field_distance(RID p_map, const Vector2 &p_destination, const Vector2 &p_position, uint32_t p_navigation_layers) const {
+	return NavigationServer3D::get_singleton()->map_get_flow_field_distance(p_map, v2_to_v3(p_destination), v2_to_v3(p_position), p_navigation_layers);
+}
+
 Vector2 FORWARD_2_R_C(v3_to_v2, map_get_closest_point, RID, p_map, const Vector2 &, p_point, rid_to_rid, v2_to_v3);
 RID FORWARD_2_C(map_get_closest_point_owner, RID, p_map, const Vector2 &, p_point, rid_to_rid, v2_to_v3);
 
@@ -463,6 +478,43 @@ void GodotNavigationServer2D::query_path(const Ref<NavigationPathQueryParameters
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
 }
 
+struct PathQueryBatch2D : public NavigationUtilities::PathQueryBatch {
+	LocalVector<Ref<NavigationPathQueryResult2D>> results;
+
+	virtual void set_result(uint32_t p_index, const NavigationUtilities::PathQueryResult &p_result) override {
+		const Ref<NavigationPathQueryResult2D> &query_result = results[p_index];
+		query_result->set_path(vector_v3_to_v2(p_result.path));
+		query_result->set_path_types(p_result.path_types);
+		query_result->set_path_rids(p_result.path_rids);
+		query_result->set_path_owner_ids(p_result.path_owner_ids);
+	}
+};
+
+int64_t GodotNavigationServer2D::query_path_batch(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_V_MSG(p_query_parameters.size() != p_query_results.size(), 0, "The number of query parameters and query results must match.");
+
+	PathQueryBatch2D *batch = memnew(PathQueryBatch2D);
+	batch->parameters.resize(p_query_parameters.size());
+	batch->results.resize(p_query_results.size());
+	for (int i = 0; i < p_query_parameters.size(); i++) {
+		const Ref<NavigationPathQueryParameters2D> query_parameters = p_query_parameters[i];
+		const Ref<NavigationPathQueryResult2D> query_result = p_query_results[i];
+		if (unlikely(query_parameters.is_null() || query_result.is_null())) {
+			memdelete(batch);
+			ERR_FAIL_V_MSG(0, vformat("Invalid query parameters or query result at index %d.", i));
+		}
+		batch->parameters[i] = query_parameters->get_parameters();
+		batch->results[i] = query_result;
+	}
+	batch->callback = p_callback;
+
+	return NavigationServer3D::get_singleton()->_query_path_batch(batch);
+}
+
+bool GodotNavigationServer2D::is_path_query_batch_completed(int64_t p_batch_id) const {
+	return NavigationServer3D::get_singleton()->is_path_query_batch_completed(p_batch_id);
+}
+
 RID GodotNavigationServer2D::source_geometry_parser_create() {
 #ifdef CLIPPER2_ENABLED
 	if (navmesh_generator_2d) {
@@ -64,11 +64,17 @@ public:
 	virtual real_t map_get_cell_size(RID p_map) const override;
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) override;
 	virtual bool map_get_use_edge_connections(RID p_map) const override;
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) override;
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+	virtual void map_set_use_path_corridor_cache(RID p_map, bool p_enabled) override;
+	virtual bool map_get_use_path_corridor_cache(RID p_map) const override;
 	virtual void map_set_edge_connection_margin(RID p_map, real_t p_connection_margin) override;
 	virtual real_t map_get_edge_connection_margin(RID p_map) const override;
 	virtual void map_set_link_connection_radius(RID p_map, real_t p_connection_radius) override;
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
+	virtual Vector2 map_get_flow_field_next_position(RID p_map, const Vector2 &p_destination, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const override;
+	virtual real_t map_get_flow_field_distance(RID p_map, const Vector2 &p_destination, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const override;
 	virtual Vector2 map_get_closest_point(RID p_map, const Vector2 &p_point) const override;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector2 &p_point) const override;
 	virtual TypedArray<RID> map_get_links(RID p_map) const override;
@@ -242,6 +248,8 @@ public:
 	virtual uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const override;
 
 	virtual void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const override;
+	virtual int64_t query_path_batch(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) override;
+	virtual bool is_path_query_batch_completed(int64_t p_batch_id) const override;
 
 	virtual void init() override;
 	virtual void sync() override;
@@ -209,6 +209,34 @@ bool GodotNavigationServer3D::map_get_use_edge_connections(RID p_map) const {
 	return map->get_use_edge_connections();
 }
 
+COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_hierarchical_pathfinding(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_hierarchical_pathfinding(RID p_map) const {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_hierarchical_pathfinding();
+}
+
+COMMAND_2(map_set_use_path_corridor_cache, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_path_corridor_cache(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_path_corridor_cache(RID p_map) const {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_path_corridor_cache();
+}
+
 COMMAND_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin) {
 	NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL(map);
@@ -244,6 +272,20 @@ Vector<Vector3> GodotNavigationServer3D::map_get_path(RID p_map, Vector3 p_origi
 	return map->get_path(p_origin, p_destination, p_optimize, p_navigation_layers, nullptr, nullptr, nullptr);
 }
 
+Vector3 GodotNavigationServer3D::map_get_flow_field_next_position(RID p_map, const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Vector3());
+
+	return map->get_flow_field_next_position(p_destination, p_position, p_navigation_layers);
+}
+
+real_t GodotNavigationServer3D::map_get_flow_field_distance(RID p_map, const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, -1.0);
+
+	return map->get_flow_field_distance(p_destination, p_position, p_navigation_layers);
+}
+
 Vector3 GodotNavigationServer3D::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL_V(map, Vector3());
@@ -1131,6 +1173,26 @@ void GodotNavigationServer3D::bake_from_source_geometry_data_async(const Ref<Nav
 #endif // _3D_DISABLED
 }
 
+void GodotNavigationServer3D::rebake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const AABB &p_area, const Callable &p_callback) {
+#ifndef _3D_DISABLED
+	ERR_FAIL_COND_MSG(!p_navigation_mesh.is_valid(), "Invalid navigation mesh.");
+	ERR_FAIL_COND_MSG(!p_source_geometry_data.is_valid(), "Invalid NavigationMeshSourceGeometryData3D.");
+
+	ERR_FAIL_NULL(NavMeshGenerator3D::get_singleton());
+	NavMeshGenerator3D::get_singleton()->rebake_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, p_area, p_callback);
+#endif // _3D_DISABLED
+}
+
+void GodotNavigationServer3D::rebake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const AABB &p_area, const Callable &p_callback) {
+#ifndef _3D_DISABLED
+	ERR_FAIL_COND_MSG(!p_navigation_mesh.is_valid(), "Invalid navigation mesh.");
+	ERR_FAIL_COND_MSG(!p_source_geometry_data.is_valid(), "Invalid NavigationMeshSourceGeometryData3D.");
+
+	ERR_FAIL_NULL(NavMeshGenerator3D::get_singleton());
+	NavMeshGenerator3D::get_singleton()->rebake_from_source_geometry_data_async(p_navigation_mesh, p_source_geometry_data, p_area, p_callback);
+#endif // _3D_DISABLED
+}
+
 bool GodotNavigationServer3D::is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const {
 #ifdef _3D_DISABLED
 	return false;
@@ -1263,6 +1325,7 @@ void GodotNavigationServer3D::map_force_update(RID p_map) {
 	NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL(map);
 
+	_complete_path_query_batches();
 	flush_queries();
 
 	map->sync();
@@ -1284,6 +1347,8 @@ void GodotNavigationServer3D::sync() {
 }
 
 void GodotNavigationServer3D::process(real_t p_delta_time) {
+	// The batches use the maps as they were when submitted, complete them before the maps change.
+	_complete_path_query_batches();
 	flush_queries();
 
 	if (!active) {
@@ -1341,6 +1406,7 @@ void GodotNavigationServer3D::init() {
 }
 
 void GodotNavigationServer3D::finish() {
+	_complete_path_query_batches();
 	flush_queries();
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
@@ -1351,6 +1417,57 @@ void GodotNavigationServer3D::finish() {
 #endif // _3D_DISABLED
 }
 
+bool GodotNavigationServer3D::is_path_query_batch_completed(int64_t p_batch_id) const {
+	MutexLock lock(path_query_batches_mutex);
+	const PathQueryBatchTask *task = path_query_batches.getptr(p_batch_id);
+	if (!task) {
+		// Already completed, or never submitted.
+		return true;
+	}
+	return task->group_task == -1 || WorkerThreadPool::get_singleton()->is_group_task_completed(task->group_task);
+}
+
+int64_t GodotNavigationServer3D::_query_path_batch(NavigationUtilities::PathQueryBatch *p_batch) {
+	ERR_FAIL_NULL_V(p_batch, 0);
+
+	PathQueryBatchTask task;
+	task.batch = p_batch;
+	if (!p_batch->parameters.is_empty()) {
+		task.group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer3D::_solve_path_query_batch, p_batch, p_batch->parameters.size(), -1, true, SNAME("NavigationPathQueryBatch"));
+	}
+
+	MutexLock lock(path_query_batches_mutex);
+	last_path_query_batch_id++;
+	path_query_batches.insert(last_path_query_batch_id, task);
+	return last_path_query_batch_id;
+}
+
+void GodotNavigationServer3D::_solve_path_query_batch(uint32_t p_index, NavigationUtilities::PathQueryBatch *p_batch) {
+	p_batch->set_result(p_index, _query_path(p_batch->parameters[p_index]));
+}
+
+void GodotNavigationServer3D::_complete_path_query_batches() {
+	LocalVector<NavigationUtilities::PathQueryBatch *> completed_batches;
+	{
+		MutexLock lock(path_query_batches_mutex);
+		for (const KeyValue<int64_t, PathQueryBatchTask> &E : path_query_batches) {
+			if (E.value.group_task != -1) {
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(E.value.group_task);
+			}
+			completed_batches.push_back(E.value.batch);
+		}
+		path_query_batches.clear();
+	}
+
+	// The callbacks may submit new batches.
+	for (NavigationUtilities::PathQueryBatch *batch : completed_batches) {
+		if (batch->callback.is_valid()) {
+			batch->callback.call();
+		}
+		memdelete(batch);
+	}
+}
+
 PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &p_parameters) const {
 	PathQueryResult r_query_result;
 
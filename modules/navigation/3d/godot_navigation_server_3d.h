@@ -37,6 +37,7 @@
 #include "../nav_obstacle.h"
 #include "../nav_region.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
@@ -82,6 +83,15 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_iteration_id;
 
+	struct PathQueryBatchTask {
+		NavigationUtilities::PathQueryBatch *batch = nullptr;
+		WorkerThreadPool::GroupID group_task = -1;
+	};
+	/// The batches are completed before the maps change, so all their queries see the same maps.
+	mutable Mutex path_query_batches_mutex;
+	HashMap<int64_t, PathQueryBatchTask> path_query_batches;
+	int64_t last_path_query_batch_id = 0;
+
 #ifndef _3D_DISABLED
 	NavMeshGenerator3D *navmesh_generator_3d = nullptr;
 #endif // _3D_DISABLED
@@ -123,6 +133,11 @@ public:
 	COMMAND_2(map_set_use_edge_connections, RID, p_map, bool, p_enabled);
 	virtual bool map_get_use_edge_connections(RID p_map) const override;
 
+	COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+	COMMAND_2(map_set_use_path_corridor_cache, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_path_corridor_cache(RID p_map) const override;
+
 	COMMAND_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin);
 	virtual real_t map_get_edge_connection_margin(RID p_map) const override;
 
@@ -130,6 +145,8 @@ public:
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
 
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
+	virtual Vector3 map_get_flow_field_next_position(RID p_map, const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const override;
+	virtual real_t map_get_flow_field_distance(RID p_map, const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const override;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const override;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override;
@@ -262,6 +279,8 @@ public:
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
+	virtual void rebake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const AABB &p_area, const Callable &p_callback = Callable()) override;
+	virtual void rebake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const AABB &p_area, const Callable &p_callback = Callable()) override;
 	virtual bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const override;
 
 	virtual RID source_geometry_parser_create() override;
@@ -286,9 +305,15 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
 
+	virtual bool is_path_query_batch_completed(int64_t p_batch_id) const override;
+	virtual int64_t _query_path_batch(NavigationUtilities::PathQueryBatch *p_batch) override;
+
 	int get_process_info(ProcessInfo p_info) const override;
 
 private:
+	void _solve_path_query_batch(uint32_t p_index, NavigationUtilities::PathQueryBatch *p_batch);
+	void _complete_path_query_batches();
+
 	void internal_free_agent(RID p_object);
 	void internal_free_obstacle(RID p_object);
 };
@@ -70,6 +70,9 @@ RWLock NavMeshGenerator3D::generator_rid_rwlock;
 bool NavMeshGenerator3D::use_threads = true;
 bool NavMeshGenerator3D::baking_use_multiple_threads = true;
 bool NavMeshGenerator3D::baking_use_high_priority_threads = true;
+bool NavMeshGenerator3D::parsing_use_multiple_threads = false;
+Mutex NavMeshGenerator3D::generator_mesh_cache_mutex;
+HashMap<ObjectID, NavMeshGenerator3D::NavMeshCachedGeometry3D> NavMeshGenerator3D::generator_mesh_cache;
 HashSet<Ref<NavigationMesh>> NavMeshGenerator3D::baking_navmeshes;
 HashMap<WorkerThreadPool::TaskID, NavMeshGenerator3D::NavMeshGeneratorTask3D *> NavMeshGenerator3D::generator_tasks;
 RID_Owner<NavMeshGenerator3D::NavMeshGeometryParser3D> NavMeshGenerator3D::generator_parser_owner;
@@ -85,6 +88,7 @@ NavMeshGenerator3D::NavMeshGenerator3D() {
 
 	baking_use_multiple_threads = GLOBAL_GET("navigation/baking/thread_model/baking_use_multiple_threads");
 	baking_use_high_priority_threads = GLOBAL_GET("navigation/baking/thread_model/baking_use_high_priority_threads");
+	parsing_use_multiple_threads = GLOBAL_GET("navigation/baking/thread_model/parsing_use_multiple_threads");
 
 	// Using threads might cause problems on certain exports or with the Editor on certain devices.
 	// This is the main switch to turn threaded navmesh baking off should the need arise.
@@ -149,6 +153,10 @@ void NavMeshGenerator3D::cleanup() {
 	generator_parsers.clear();
 	generator_rid_rwlock.write_unlock();
 
+	generator_mesh_cache_mutex.lock();
+	generator_mesh_cache.clear();
+	generator_mesh_cache_mutex.unlock();
+
 	generator_task_mutex.unlock();
 	baking_navmesh_mutex.unlock();
 }
@@ -172,10 +180,29 @@ void NavMeshGenerator3D::parse_source_geometry_data(Ref<NavigationMesh> p_naviga
 }
 
 void NavMeshGenerator3D::bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback) {
+	generator_bake(p_navigation_mesh, p_source_geometry_data, false, AABB(), p_callback, false);
+}
+
+void NavMeshGenerator3D::bake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback) {
+	generator_bake(p_navigation_mesh, p_source_geometry_data, false, AABB(), p_callback, true);
+}
+
+void NavMeshGenerator3D::rebake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const AABB &p_area, const Callable &p_callback) {
+	generator_bake(p_navigation_mesh, p_source_geometry_data, true, p_area, p_callback, false);
+}
+
+void NavMeshGenerator3D::rebake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const AABB &p_area, const Callable &p_callback) {
+	generator_bake(p_navigation_mesh, p_source_geometry_data, true, p_area, p_callback, true);
+}
+
+void NavMeshGenerator3D::generator_bake(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, bool p_rebake_tiles, const AABB &p_rebake_area, const Callable &p_callback, bool p_async) {
 	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
 	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
 
-	if (!p_source_geometry_data->has_data()) {
+	// Rebaking tiles without source geometry still has to clear the rebaked tiles, so only a full bake can skip it.
+	const bool rebake_tiles = p_rebake_tiles && p_navigation_mesh->get_tile_size() > 0.0;
+
+	if (!rebake_tiles && !p_source_geometry_data->has_data()) {
 		p_navigation_mesh->clear();
 		if (p_callback.is_valid()) {
 			generator_emit_callback(p_callback);
@@ -190,7 +217,22 @@ void NavMeshGenerator3D::bake_from_source_geometry_data(Ref<NavigationMesh> p_na
 	baking_navmeshes.insert(p_navigation_mesh);
 	baking_navmesh_mutex.unlock();
 
-	generator_bake_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data);
+	if (p_async && use_threads) {
+		generator_task_mutex.lock();
+		NavMeshGeneratorTask3D *generator_task = memnew(NavMeshGeneratorTask3D);
+		generator_task->navigation_mesh = p_navigation_mesh;
+		generator_task->source_geometry_data = p_source_geometry_data;
+		generator_task->callback = p_callback;
+		generator_task->rebake_tiles = rebake_tiles;
+		generator_task->rebake_area = p_rebake_area;
+		generator_task->status = NavMeshGeneratorTask3D::TaskStatus::BAKING_STARTED;
+		generator_task->thread_task_id = WorkerThreadPool::get_singleton()->add_native_task(&NavMeshGenerator3D::generator_thread_bake, generator_task, NavMeshGenerator3D::baking_use_high_priority_threads, SNAME("NavMeshGeneratorBake3D"));
+		generator_tasks.insert(generator_task->thread_task_id, generator_task);
+		generator_task_mutex.unlock();
+		return;
+	}
+
+	generator_bake_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, rebake_tiles, p_rebake_area);
 
 	baking_navmesh_mutex.lock();
 	baking_navmeshes.erase(p_navigation_mesh);
@@ -201,42 +243,6 @@ void NavMeshGenerator3D::bake_from_source_geometry_data(Ref<NavigationMesh> p_na
 	}
 }
 
-void NavMeshGenerator3D::bake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback) {
-	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
-	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
-
-	if (!p_source_geometry_data->has_data()) {
-		p_navigation_mesh->clear();
-		if (p_callback.is_valid()) {
-			generator_emit_callback(p_callback);
-		}
-		return;
-	}
-
-	if (!use_threads) {
-		bake_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, p_callback);
-		return;
-	}
-
-	if (is_baking(p_navigation_mesh)) {
-		ERR_FAIL_MSG("NavigationMesh is already baking. Wait for current bake to finish.");
-		return;
-	}
-	baking_navmesh_mutex.lock();
-	baking_navmeshes.insert(p_navigation_mesh);
-	baking_navmesh_mutex.unlock();
-
-	generator_task_mutex.lock();
-	NavMeshGeneratorTask3D *generator_task = memnew(NavMeshGeneratorTask3D);
-	generator_task->navigation_mesh = p_navigation_mesh;
-	generator_task->source_geometry_data = p_source_geometry_data;
-	generator_task->callback = p_callback;
-	generator_task->status = NavMeshGeneratorTask3D::TaskStatus::BAKING_STARTED;
-	generator_task->thread_task_id = WorkerThreadPool::get_singleton()->add_native_task(&NavMeshGenerator3D::generator_thread_bake, generator_task, NavMeshGenerator3D::baking_use_high_priority_threads, SNAME("NavMeshGeneratorBake3D"));
-	generator_tasks.insert(generator_task->thread_task_id, generator_task);
-	generator_task_mutex.unlock();
-}
-
 bool NavMeshGenerator3D::is_baking(Ref<NavigationMesh> p_navigation_mesh) {
 	baking_navmesh_mutex.lock();
 	bool baking = baking_navmeshes.has(p_navigation_mesh);
@@ -247,7 +253,7 @@ bool NavMeshGenerator3D::is_baking(Ref<NavigationMesh> p_navigation_mesh) {
 void NavMeshGenerator3D::generator_thread_bake(void *p_arg) {
 	NavMeshGeneratorTask3D *generator_task = static_cast<NavMeshGeneratorTask3D *>(p_arg);
 
-	generator_bake_from_source_geometry_data(generator_task->navigation_mesh, generator_task->source_geometry_data);
+	generator_bake_from_source_geometry_data(generator_task->navigation_mesh, generator_task->source_geometry_data, generator_task->rebake_tiles, generator_task->rebake_area);
 
 	generator_task->status = NavMeshGeneratorTask3D::TaskStatus::BAKING_FINISHED;
 }
@@ -280,6 +286,186 @@ void NavMeshGenerator3D::generator_parse_geometry_node(const Ref<NavigationMesh>
 	}
 }
 
+void NavMeshGenerator3D::generator_thread_extract_mesh_geometry(void *p_arg, uint32_t p_index) {
+	NavMeshGeometryExtraction3D *extraction = static_cast<NavMeshGeometryExtraction3D *>(p_arg);
+	generator_extract_mesh_geometry(extraction->meshes[p_index], extraction->geometries[p_index]);
+}
+
+void NavMeshGenerator3D::generator_extract_mesh_geometry(const Ref<Mesh> &p_mesh, NavMeshCachedGeometry3D &r_geometry) {
+	r_geometry.surface_count = p_mesh->get_surface_count();
+	r_geometry.vertices.clear();
+	r_geometry.indices.clear();
+
+	for (int i = 0; i < r_geometry.surface_count; i++) {
+		if (p_mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
+			continue;
+		}
+
+		const bool has_indices = p_mesh->surface_get_format(i) & Mesh::ARRAY_FORMAT_INDEX;
+		const int index_count = has_indices ? p_mesh->surface_get_array_index_len(i) : p_mesh->surface_get_array_len(i);
+
+		ERR_CONTINUE((index_count == 0 || (index_count % 3) != 0));
+
+		Array a = p_mesh->surface_get_arrays(i);
+		ERR_CONTINUE(a.is_empty() || (a.size() != Mesh::ARRAY_MAX));
+
+		Vector<Vector3> mesh_vertices = a[Mesh::ARRAY_VERTEX];
+		ERR_CONTINUE(mesh_vertices.is_empty());
+
+		Vector<int> mesh_indices;
+		if (has_indices) {
+			mesh_indices = a[Mesh::ARRAY_INDEX];
+			ERR_CONTINUE(mesh_indices.is_empty() || (mesh_indices.size() != index_count));
+		} else {
+			ERR_CONTINUE(mesh_vertices.size() != index_count);
+		}
+
+		const int vertex_offset = r_geometry.vertices.size();
+		const int index_offset = r_geometry.indices.size();
+		r_geometry.vertices.append_array(mesh_vertices);
+		r_geometry.indices.resize(index_offset + index_count);
+
+		int *indices_ptrw = r_geometry.indices.ptrw() + index_offset;
+		if (has_indices) {
+			const int *ir = mesh_indices.ptr();
+			for (int j = 0; j < index_count; j++) {
+				indices_ptrw[j] = vertex_offset + ir[j];
+			}
+		} else {
+			for (int j = 0; j < index_count; j++) {
+				indices_ptrw[j] = vertex_offset + j;
+			}
+		}
+	}
+}
+
+bool NavMeshGenerator3D::generator_is_mesh_cacheable(const Ref<Mesh> &p_mesh) {
+	// Only these emit changed for every edit of their geometry, including surface_update_*_region().
+	// Other meshes, like ImmediateMesh, are extracted again on every parse.
+	return Object::cast_to<ArrayMesh>(p_mesh.ptr()) || Object::cast_to<PrimitiveMesh>(p_mesh.ptr());
+}
+
+void NavMeshGenerator3D::generator_cache_mesh_geometry(const Ref<Mesh> &p_mesh, const NavMeshCachedGeometry3D &p_geometry) {
+	const ObjectID mesh_id = p_mesh->get_instance_id();
+
+	generator_mesh_cache_mutex.lock();
+	generator_mesh_cache.insert(mesh_id, p_geometry);
+	generator_mesh_cache_mutex.unlock();
+
+	p_mesh->connect_changed(callable_mp_static(&NavMeshGenerator3D::generator_mesh_changed).bind(mesh_id));
+}
+
+void NavMeshGenerator3D::generator_mesh_changed(ObjectID p_mesh_id) {
+	MutexLock mesh_cache_lock(generator_mesh_cache_mutex);
+	generator_mesh_cache.erase(p_mesh_id);
+}
+
+void NavMeshGenerator3D::generator_add_mesh(Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Ref<Mesh> &p_mesh, const Transform3D &p_xform) {
+	NavMeshCachedGeometry3D geometry;
+
+	if (generator_is_mesh_cacheable(p_mesh)) {
+		bool cached = false;
+
+		// Querying the surface count can update the mesh and invalidate the cache entry, so it is done before the lookup.
+		const int surface_count = p_mesh->get_surface_count();
+
+		generator_mesh_cache_mutex.lock();
+		const NavMeshCachedGeometry3D *cached_geometry = generator_mesh_cache.getptr(p_mesh->get_instance_id());
+		if (cached_geometry && cached_geometry->surface_count == surface_count) {
+			geometry = *cached_geometry;
+			cached = true;
+		}
+		generator_mesh_cache_mutex.unlock();
+
+		if (!cached) {
+			generator_extract_mesh_geometry(p_mesh, geometry);
+			generator_cache_mesh_geometry(p_mesh, geometry);
+		}
+	} else {
+		generator_extract_mesh_geometry(p_mesh, geometry);
+	}
+
+	if (geometry.vertices.is_empty() || geometry.indices.is_empty()) {
+		return;
+	}
+
+	Array arr;
+	arr.resize(Mesh::ARRAY_MAX);
+	arr[Mesh::ARRAY_VERTEX] = geometry.vertices;
+	arr[Mesh::ARRAY_INDEX] = geometry.indices;
+	p_source_geometry_data->add_mesh_array(arr, p_xform);
+}
+
+void NavMeshGenerator3D::generator_collect_meshes(Node *p_node, bool p_recurse_children, HashSet<Ref<Mesh>> &r_meshes) {
+	MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(p_node);
+	if (mesh_instance && mesh_instance->get_mesh().is_valid()) {
+		r_meshes.insert(mesh_instance->get_mesh());
+	}
+
+	MultiMeshInstance3D *multimesh_instance = Object::cast_to<MultiMeshInstance3D>(p_node);
+	if (multimesh_instance && multimesh_instance->get_multimesh().is_valid() && multimesh_instance->get_multimesh()->get_mesh().is_valid()) {
+		r_meshes.insert(multimesh_instance->get_multimesh()->get_mesh());
+	}
+
+	if (p_recurse_children) {
+		for (int i = 0; i < p_node->get_child_count(); i++) {
+			generator_collect_meshes(p_node->get_child(i), p_recurse_children, r_meshes);
+		}
+	}
+}
+
+void NavMeshGenerator3D::generator_prefetch_meshes(const Ref<NavigationMesh> &p_navigation_mesh, const List<Node *> &p_parse_nodes, bool p_recurse_children) {
+	// Drop the geometry of meshes that no longer exist.
+	generator_mesh_cache_mutex.lock();
+	LocalVector<ObjectID> freed_mesh_ids;
+	for (const KeyValue<ObjectID, NavMeshCachedGeometry3D> &E : generator_mesh_cache) {
+		if (!ObjectDB::get_instance(E.key)) {
+			freed_mesh_ids.push_back(E.key);
+		}
+	}
+	for (const ObjectID &freed_mesh_id : freed_mesh_ids) {
+		generator_mesh_cache.erase(freed_mesh_id);
+	}
+	generator_mesh_cache_mutex.unlock();
+
+	NavigationMesh::ParsedGeometryType parsed_geometry_type = p_navigation_mesh->get_parsed_geometry_type();
+	if (!parsing_use_multiple_threads || parsed_geometry_type == NavigationMesh::PARSED_GEOMETRY_STATIC_COLLIDERS) {
+		return;
+	}
+
+	HashSet<Ref<Mesh>> meshes;
+	for (Node *parse_node : p_parse_nodes) {
+		generator_collect_meshes(parse_node, p_recurse_children, meshes);
+	}
+
+	NavMeshGeometryExtraction3D extraction;
+	for (const Ref<Mesh> &mesh : meshes) {
+		if (!generator_is_mesh_cacheable(mesh)) {
+			continue;
+		}
+		const int surface_count = mesh->get_surface_count();
+
+		MutexLock mesh_cache_lock(generator_mesh_cache_mutex);
+		const NavMeshCachedGeometry3D *cached_geometry = generator_mesh_cache.getptr(mesh->get_instance_id());
+		if (!cached_geometry || cached_geometry->surface_count != surface_count) {
+			extraction.meshes.push_back(mesh);
+		}
+	}
+
+	if (extraction.meshes.size() < 2) {
+		return;
+	}
+
+	// Only the surface extraction runs on the worker threads, the signal connections for the cache are made here on the main thread.
+	extraction.geometries.resize(extraction.meshes.size());
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&NavMeshGenerator3D::generator_thread_extract_mesh_geometry, &extraction, extraction.meshes.size(), -1, true, SNAME("NavMeshGeneratorExtractMeshes3D"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (uint32_t i = 0; i < extraction.meshes.size(); i++) {
+		generator_cache_mesh_geometry(extraction.meshes[i], extraction.geometries[i]);
+	}
+}
+
 void NavMeshGenerator3D::generator_parse_meshinstance3d_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node) {
 	MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(p_node);
 
@@ -289,7 +475,7 @@ void NavMeshGenerator3D::generator_parse_meshinstance3d_node(const Ref<Navigatio
 		if (parsed_geometry_type == NavigationMesh::PARSED_GEOMETRY_MESH_INSTANCES || parsed_geometry_type == NavigationMesh::PARSED_GEOMETRY_BOTH) {
 			Ref<Mesh> mesh = mesh_instance->get_mesh();
 			if (mesh.is_valid()) {
-				p_source_geometry_data->add_mesh(mesh, mesh_instance->get_global_transform());
+				generator_add_mesh(p_source_geometry_data, mesh, mesh_instance->get_global_transform());
 			}
 		}
 	}
@@ -311,7 +497,7 @@ void NavMeshGenerator3D::generator_parse_multimeshinstance3d_node(const Ref<Navi
 						n = multimesh->get_instance_count();
 					}
 					for (int i = 0; i < n; i++) {
-						p_source_geometry_data->add_mesh(mesh, multimesh_instance->get_global_transform() * multimesh->get_instance_transform(i));
+						generator_add_mesh(p_source_geometry_data, mesh, multimesh_instance->get_global_transform() * multimesh->get_instance_transform(i));
 					}
 				}
 			}
@@ -454,7 +640,7 @@ void NavMeshGenerator3D::generator_parse_csgshape3d_node(const Ref<NavigationMes
 			if (!meshes.is_empty()) {
 				Ref<Mesh> mesh = meshes[1];
 				if (mesh.is_valid()) {
-					p_source_geometry_data->add_mesh(mesh, csg_shape->get_global_transform());
+					generator_add_mesh(p_source_geometry_data, mesh, csg_shape->get_global_transform());
 				}
 			}
 		}
@@ -476,7 +662,7 @@ void NavMeshGenerator3D::generator_parse_gridmap_node(const Ref<NavigationMesh>
 			for (int i = 0; i < meshes.size(); i += 2) {
 				Ref<Mesh> mesh = meshes[i + 1];
 				if (mesh.is_valid()) {
-					p_source_geometry_data->add_mesh(mesh, xform * (Transform3D)meshes[i]);
+					generator_add_mesh(p_source_geometry_data, mesh, xform * (Transform3D)meshes[i]);
 				}
 			}
 		}
@@ -662,29 +848,218 @@ void NavMeshGenerator3D::generator_parse_source_geometry_data(const Ref<Navigati
 
 	bool recurse_children = p_navigation_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
 
+	generator_prefetch_meshes(p_navigation_mesh, parse_nodes, recurse_children);
+
 	for (Node *parse_node : parse_nodes) {
 		generator_parse_geometry_node(p_navigation_mesh, p_source_geometry_data, parse_node, recurse_children);
 	}
 };
 
-void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data) {
-	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
-		return;
-	}
+struct NavMeshBakeSettings3D {
+	NavigationMesh::SamplePartitionType partition_type = NavigationMesh::SAMPLE_PARTITION_WATERSHED;
+	bool filter_low_hanging_obstacles = false;
+	bool filter_ledge_spans = false;
+	bool filter_walkable_low_height_spans = false;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+};
 
-	const Vector<float> &vertices = p_source_geometry_data->get_vertices();
-	const Vector<int> &indices = p_source_geometry_data->get_indices();
+struct NavMeshBakeTile3D {
+	Vector2i coords;
+	rcConfig cfg;
+	LocalVector<int> triangles;
+	Vector<Vector3> vertices;
+	Vector<Vector<int>> polygons;
+};
 
-	if (vertices.size() < 3 || indices.size() < 3) {
-		return;
-	}
+struct NavMeshTiledBake3D {
+	const NavMeshBakeSettings3D *settings = nullptr;
+	const float *verts = nullptr;
+	int nverts = 0;
+	LocalVector<NavMeshBakeTile3D *> tiles;
+};
 
+// Frees whatever Recast allocated when a bake step fails halfway.
+struct NavMeshRecastData3D {
 	rcHeightfield *hf = nullptr;
 	rcCompactHeightfield *chf = nullptr;
 	rcContourSet *cset = nullptr;
 	rcPolyMesh *poly_mesh = nullptr;
 	rcPolyMeshDetail *detail_mesh = nullptr;
+
+	~NavMeshRecastData3D() {
+		rcFreeHeightField(hf);
+		rcFreeCompactHeightfield(chf);
+		rcFreeContourSet(cset);
+		rcFreePolyMesh(poly_mesh);
+		rcFreePolyMeshDetail(detail_mesh);
+	}
+};
+
+static void _mark_projected_obstructions(rcContext *p_ctx, const NavMeshBakeSettings3D &p_settings, bool p_carve, rcCompactHeightfield &p_chf) {
+	for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_settings.projected_obstructions) {
+		if (projected_obstruction.carve != p_carve) {
+			continue;
+		}
+		if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
+			continue;
+		}
+
+		const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
+		const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
+
+		rcMarkConvexPolyArea(p_ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, p_chf);
+	}
+}
+
+// Runs the Recast pipeline for a single bake area and appends the resulting detail mesh to the output arrays.
+static bool _bake_recast_polygons(const NavMeshBakeSettings3D &p_settings, const rcConfig &p_cfg, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, Vector<Vector3> &r_vertices, Vector<Vector<int>> &r_polygons) {
+	NavMeshRecastData3D data;
 	rcContext ctx;
+	rcConfig cfg = p_cfg;
+
+	// added to keep track of steps, no functionality right now
+	String bake_state = "";
+
+	bake_state = "Creating heightfield..."; // step #3
+	data.hf = rcAllocHeightfield();
+
+	ERR_FAIL_NULL_V(data.hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&ctx, *data.hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch), false);
+
+	bake_state = "Marking walkable triangles..."; // step #4
+	{
+		Vector<unsigned char> tri_areas;
+		tri_areas.resize(p_ntris);
+
+		ERR_FAIL_COND_V(tri_areas.is_empty(), false);
+
+		memset(tri_areas.ptrw(), 0, p_ntris * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, p_verts, p_nverts, p_tris, p_ntris, tri_areas.ptrw());
+
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&ctx, p_verts, p_nverts, p_tris, tri_areas.ptr(), p_ntris, *data.hf, cfg.walkableClimb), false);
+	}
+
+	if (p_settings.filter_low_hanging_obstacles) {
+		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *data.hf);
+	}
+	if (p_settings.filter_ledge_spans) {
+		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *data.hf);
+	}
+	if (p_settings.filter_walkable_low_height_spans) {
+		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *data.hf);
+	}
+
+	bake_state = "Constructing compact heightfield..."; // step #5
+
+	data.chf = rcAllocCompactHeightfield();
+
+	ERR_FAIL_NULL_V(data.chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *data.hf, *data.chf), false);
+
+	rcFreeHeightField(data.hf);
+	data.hf = nullptr;
+
+	// Add obstacles to the source geometry. Those will be affected by e.g. agent_radius.
+	_mark_projected_obstructions(&ctx, p_settings, false, *data.chf);
+
+	bake_state = "Eroding walkable area..."; // step #6
+
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *data.chf), false);
+
+	// Carve obstacles to the eroded geometry. Those will NOT be affected by e.g. agent_radius because that step is already done.
+	_mark_projected_obstructions(&ctx, p_settings, true, *data.chf);
+
+	bake_state = "Partitioning..."; // step #7
+
+	if (p_settings.partition_type == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&ctx, *data.chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&ctx, *data.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
+	} else if (p_settings.partition_type == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&ctx, *data.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
+	} else {
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&ctx, *data.chf, cfg.borderSize, cfg.minRegionArea), false);
+	}
+
+	bake_state = "Creating contours..."; // step #8
+
+	data.cset = rcAllocContourSet();
+
+	ERR_FAIL_NULL_V(data.cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&ctx, *data.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *data.cset), false);
+
+	bake_state = "Creating polymesh..."; // step #9
+
+	data.poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_NULL_V(data.poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&ctx, *data.cset, cfg.maxVertsPerPoly, *data.poly_mesh), false);
+
+	data.detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_NULL_V(data.detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&ctx, *data.poly_mesh, *data.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *data.detail_mesh), false);
+
+	rcFreeCompactHeightfield(data.chf);
+	data.chf = nullptr;
+	rcFreeContourSet(data.cset);
+	data.cset = nullptr;
+
+	bake_state = "Converting to native navigation mesh..."; // step #10
+
+	const rcPolyMeshDetail *detail_mesh = data.detail_mesh;
+	const int vertex_offset = r_vertices.size();
+
+	for (int i = 0; i < detail_mesh->nverts; i++) {
+		const float *v = &detail_mesh->verts[i * 3];
+		r_vertices.push_back(Vector3(v[0], v[1], v[2]));
+	}
+
+	for (int i = 0; i < detail_mesh->nmeshes; i++) {
+		const unsigned int *detail_mesh_m = &detail_mesh->meshes[i * 4];
+		const unsigned int detail_mesh_bverts = detail_mesh_m[0];
+		const unsigned int detail_mesh_m_btris = detail_mesh_m[2];
+		const unsigned int detail_mesh_ntris = detail_mesh_m[3];
+		const unsigned char *detail_mesh_tris = &detail_mesh->tris[detail_mesh_m_btris * 4];
+		for (unsigned int j = 0; j < detail_mesh_ntris; j++) {
+			Vector<int> nav_indices;
+			nav_indices.resize(3);
+			// Polygon order in recast is opposite than godot's
+			nav_indices.write[0] = vertex_offset + ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 0]));
+			nav_indices.write[1] = vertex_offset + ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 2]));
+			nav_indices.write[2] = vertex_offset + ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 1]));
+			r_polygons.push_back(nav_indices);
+		}
+	}
+
+	bake_state = "Baking finished."; // step #11
+
+	return true;
+}
+
+static void _bake_recast_tile(void *p_userdata, uint32_t p_index) {
+	NavMeshTiledBake3D *tiled_bake = static_cast<NavMeshTiledBake3D *>(p_userdata);
+	NavMeshBakeTile3D *tile = tiled_bake->tiles[p_index];
+
+	if (!_bake_recast_polygons(*tiled_bake->settings, tile->cfg, tiled_bake->verts, tiled_bake->nverts, tile->triangles.ptr(), tile->triangles.size() / 3, tile->vertices, tile->polygons)) {
+		// Drop anything a failed tile may have produced so far so the other tiles stay usable.
+		tile->vertices.clear();
+		tile->polygons.clear();
+	}
+}
+
+void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, bool p_rebake_tiles, const AABB &p_rebake_area) {
+	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
+		return;
+	}
+
+	const Vector<float> &vertices = p_source_geometry_data->get_vertices();
+	const Vector<int> &indices = p_source_geometry_data->get_indices();
+
+	const bool has_geometry = vertices.size() >= 3 && indices.size() >= 3;
+	const bool tiled = p_navigation_mesh->get_tile_size() > 0.0;
+
+	// Rebaking tiles without any source geometry left in them still needs to clear those tiles.
+	if (!has_geometry && !(tiled && p_rebake_tiles)) {
+		return;
+	}
 
 	// added to keep track of steps, no functionality right now
 	String bake_state = "";
@@ -692,12 +1067,15 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	bake_state = "Setting up Configuration..."; // step #1
 
 	const float *verts = vertices.ptr();
-	const int nverts = vertices.size() / 3;
+	const int nverts = has_geometry ? vertices.size() / 3 : 0;
 	const int *tris = indices.ptr();
-	const int ntris = indices.size() / 3;
+	const int ntris = has_geometry ? indices.size() / 3 : 0;
 
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
+	float bmin[3] = { 0.0f, 0.0f, 0.0f };
+	float bmax[3] = { 0.0f, 0.0f, 0.0f };
+	if (has_geometry) {
+		rcCalcBounds(verts, nverts, bmin, bmax);
+	}
 
 	rcConfig cfg;
 	memset(&cfg, 0, sizeof(cfg));
@@ -722,6 +1100,9 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	if (p_navigation_mesh->get_border_size() > 0.0 && Math::fmod(p_navigation_mesh->get_border_size(), p_navigation_mesh->get_cell_size()) != 0.0) {
 		WARN_PRINT("Property border_size is ceiled to cell_size voxel units and loses precision.");
 	}
+	if (tiled && Math::fmod(p_navigation_mesh->get_tile_size(), p_navigation_mesh->get_cell_size()) != 0.0) {
+		WARN_PRINT("Property tile_size is ceiled to cell_size voxel units and loses precision.");
+	}
 	if (!Math::is_equal_approx((float)cfg.walkableHeight * cfg.ch, p_navigation_mesh->get_agent_height())) {
 		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
 	}
@@ -765,6 +1146,18 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
 	}
 
+	NavMeshBakeSettings3D settings;
+	settings.partition_type = p_navigation_mesh->get_sample_partition_type();
+	settings.filter_low_hanging_obstacles = p_navigation_mesh->get_filter_low_hanging_obstacles();
+	settings.filter_ledge_spans = p_navigation_mesh->get_filter_ledge_spans();
+	settings.filter_walkable_low_height_spans = p_navigation_mesh->get_filter_walkable_low_height_spans();
+	settings.projected_obstructions = p_source_geometry_data->_get_projected_obstructions();
+
+	if (tiled) {
+		generator_bake_tiles(p_navigation_mesh, settings, cfg, verts, nverts, tris, ntris, p_rebake_tiles, p_rebake_area);
+		return;
+	}
+
 	bake_state = "Calculating grid size..."; // step #2
 	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 
@@ -779,154 +1172,185 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		return;
 	}
 
-	bake_state = "Creating heightfield..."; // step #3
-	hf = rcAllocHeightfield();
-
-	ERR_FAIL_NULL(hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
-
-	bake_state = "Marking walkable triangles..."; // step #4
-	{
-		Vector<unsigned char> tri_areas;
-		tri_areas.resize(ntris);
-
-		ERR_FAIL_COND(tri_areas.is_empty());
-
-		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
-		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
-
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	if (!_bake_recast_polygons(settings, cfg, verts, nverts, tris, ntris, nav_vertices, nav_polygons)) {
+		return;
 	}
 
-	if (p_navigation_mesh->get_filter_low_hanging_obstacles()) {
-		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *hf);
-	}
-	if (p_navigation_mesh->get_filter_ledge_spans()) {
-		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf);
-	}
-	if (p_navigation_mesh->get_filter_walkable_low_height_spans()) {
-		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *hf);
+	p_navigation_mesh->set_vertices(nav_vertices);
+	p_navigation_mesh->clear_polygons();
+	for (const Vector<int> &nav_polygon : nav_polygons) {
+		p_navigation_mesh->add_polygon(nav_polygon);
 	}
+}
 
-	bake_state = "Constructing compact heightfield..."; // step #5
+void NavMeshGenerator3D::generator_bake_tiles(Ref<NavigationMesh> p_navigation_mesh, const NavMeshBakeSettings3D &p_settings, const rcConfig &p_cfg, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, bool p_rebake_tiles, const AABB &p_rebake_area) {
+	// Tiles are aligned to a world-space grid so that rebaking a single tile reproduces the same voxelization
+	// and the same edge vertices as its neighbors, which lets the navigation map connect them.
+	const int tile_cells = (int)Math::ceil(p_navigation_mesh->get_tile_size() / p_cfg.cs);
+	const float tile_world_size = tile_cells * p_cfg.cs;
+
+	// Each tile is padded with enough voxels for the erosion by agent_radius to see the geometry of the neighboring tiles.
+	const int tile_border = MAX(p_cfg.borderSize, p_cfg.walkableRadius + 3);
+	const float tile_border_size = tile_border * p_cfg.cs;
+
+	Rect2i tile_range;
+	if (p_rebake_tiles) {
+		const Vector2i from = Vector2i(Math::floor(p_rebake_area.position.x / tile_world_size), Math::floor(p_rebake_area.position.z / tile_world_size));
+		const Vector2i to = Vector2i(Math::floor((p_rebake_area.position.x + p_rebake_area.size.x) / tile_world_size), Math::floor((p_rebake_area.position.z + p_rebake_area.size.z) / tile_world_size));
+		tile_range = Rect2i(from, to - from + Vector2i(1, 1));
+	} else {
+		const Vector2i from = Vector2i(Math::floor(p_cfg.bmin[0] / tile_world_size), Math::floor(p_cfg.bmin[2] / tile_world_size));
+		const Vector2i to = Vector2i(Math::floor(p_cfg.bmax[0] / tile_world_size), Math::floor(p_cfg.bmax[2] / tile_world_size));
+		tile_range = Rect2i(from, to - from + Vector2i(1, 1));
+	}
 
-	chf = rcAllocCompactHeightfield();
+	if ((int64_t)tile_range.size.x * tile_range.size.y > 1048576 && GLOBAL_GET("navigation/baking/use_crash_prevention_checks")) {
+		ERR_FAIL_MSG("Baking interrupted."
+					 "\nNavigationMesh tile_size is suspiciously small for the size of the source geometry and would create more than a million tiles."
+					 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.");
+		return;
+	}
 
-	ERR_FAIL_NULL(chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	LocalVector<NavMeshBakeTile3D> tiles;
+	tiles.resize(tile_range.size.x * tile_range.size.y);
+
+	// Sort the source triangles into every tile that they overlap including the tile borders.
+	for (int i = 0; i < p_ntris; i++) {
+		const int *tri = &p_tris[i * 3];
+		float tri_min_x = p_verts[tri[0] * 3 + 0];
+		float tri_max_x = tri_min_x;
+		float tri_min_z = p_verts[tri[0] * 3 + 2];
+		float tri_max_z = tri_min_z;
+		for (int j = 1; j < 3; j++) {
+			const float *v = &p_verts[tri[j] * 3];
+			tri_min_x = MIN(tri_min_x, v[0]);
+			tri_max_x = MAX(tri_max_x, v[0]);
+			tri_min_z = MIN(tri_min_z, v[2]);
+			tri_max_z = MAX(tri_max_z, v[2]);
+		}
 
-	rcFreeHeightField(hf);
-	hf = nullptr;
+		const int x_from = MAX(tile_range.position.x, (int)Math::floor((tri_min_x - tile_border_size) / tile_world_size));
+		const int x_to = MIN(tile_range.position.x + tile_range.size.x - 1, (int)Math::floor((tri_max_x + tile_border_size) / tile_world_size));
+		const int z_from = MAX(tile_range.position.y, (int)Math::floor((tri_min_z - tile_border_size) / tile_world_size));
+		const int z_to = MIN(tile_range.position.y + tile_range.size.y - 1, (int)Math::floor((tri_max_z + tile_border_size) / tile_world_size));
+
+		for (int z = z_from; z <= z_to; z++) {
+			for (int x = x_from; x <= x_to; x++) {
+				LocalVector<int> &tile_triangles = tiles[(z - tile_range.position.y) * tile_range.size.x + (x - tile_range.position.x)].triangles;
+				tile_triangles.push_back(tri[0]);
+				tile_triangles.push_back(tri[1]);
+				tile_triangles.push_back(tri[2]);
+			}
+		}
+	}
 
-	const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &projected_obstructions = p_source_geometry_data->_get_projected_obstructions();
+	NavMeshTiledBake3D tiled_bake;
+	tiled_bake.settings = &p_settings;
+	tiled_bake.verts = p_verts;
+	tiled_bake.nverts = p_nverts;
 
-	// Add obstacles to the source geometry. Those will be affected by e.g. agent_radius.
-	if (!projected_obstructions.is_empty()) {
-		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
-			if (projected_obstruction.carve) {
-				continue;
-			}
-			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
+	for (int z = 0; z < tile_range.size.y; z++) {
+		for (int x = 0; x < tile_range.size.x; x++) {
+			NavMeshBakeTile3D &tile = tiles[z * tile_range.size.x + x];
+			if (tile.triangles.is_empty()) {
 				continue;
 			}
-
-			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
-			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
-
-			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
+			tile.coords = tile_range.position + Vector2i(x, z);
+
+			tile.cfg = p_cfg;
+			tile.cfg.borderSize = tile_border;
+			tile.cfg.width = tile_cells + tile_border * 2;
+			tile.cfg.height = tile_cells + tile_border * 2;
+			tile.cfg.bmin[0] = tile.coords.x * tile_world_size - tile_border_size;
+			tile.cfg.bmin[2] = tile.coords.y * tile_world_size - tile_border_size;
+			tile.cfg.bmax[0] = (tile.coords.x + 1) * tile_world_size + tile_border_size;
+			tile.cfg.bmax[2] = (tile.coords.y + 1) * tile_world_size + tile_border_size;
+
+			tiled_bake.tiles.push_back(&tile);
 		}
 	}
 
-	bake_state = "Eroding walkable area..."; // step #6
+	if (use_threads && tiled_bake.tiles.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_bake_recast_tile, &tiled_bake, tiled_bake.tiles.size(), -1, baking_use_high_priority_threads, SNAME("NavMeshGeneratorBakeTiles3D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < tiled_bake.tiles.size(); i++) {
+			_bake_recast_tile(&tiled_bake, i);
+		}
+	}
 
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+
+	if (p_rebake_tiles) {
+		// Keep the polygons of all tiles outside the rebaked area. Every baked polygon lies inside the bounds
+		// of its tile, so the tile that owns a polygon is found from its center.
+		const Vector<Vector3> old_vertices = p_navigation_mesh->get_vertices();
+		LocalVector<int> vertex_remap;
+		vertex_remap.resize(old_vertices.size());
+		for (int &index : vertex_remap) {
+			index = -1;
+		}
 
-	// Carve obstacles to the eroded geometry. Those will NOT be affected by e.g. agent_radius because that step is already done.
-	if (!projected_obstructions.is_empty()) {
-		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
-			if (!projected_obstruction.carve) {
+		const int polygon_count = p_navigation_mesh->get_polygon_count();
+		for (int i = 0; i < polygon_count; i++) {
+			Vector<int> polygon = p_navigation_mesh->get_polygon(i);
+			if (polygon.is_empty()) {
 				continue;
 			}
-			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
+
+			Vector3 center;
+			bool valid = true;
+			for (int index : polygon) {
+				if (index < 0 || index >= old_vertices.size()) {
+					valid = false;
+					break;
+				}
+				center += old_vertices[index];
+			}
+			if (!valid) {
 				continue;
 			}
+			center /= polygon.size();
 
-			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
-			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
+			const Vector2i coords = Vector2i(Math::floor(center.x / tile_world_size), Math::floor(center.z / tile_world_size));
+			if (tile_range.has_point(coords)) {
+				continue;
+			}
 
-			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
+			int *polygon_ptrw = polygon.ptrw();
+			for (int j = 0; j < polygon.size(); j++) {
+				int &remapped = vertex_remap[polygon_ptrw[j]];
+				if (remapped == -1) {
+					remapped = nav_vertices.size();
+					nav_vertices.push_back(old_vertices[polygon_ptrw[j]]);
+				}
+				polygon_ptrw[j] = remapped;
+			}
+			nav_polygons.push_back(polygon);
 		}
 	}
 
-	bake_state = "Partitioning..."; // step #7
-
-	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea));
+	for (const NavMeshBakeTile3D *tile : tiled_bake.tiles) {
+		const int vertex_offset = nav_vertices.size();
+		nav_vertices.append_array(tile->vertices);
+		for (const Vector<int> &tile_polygon : tile->polygons) {
+			Vector<int> polygon = tile_polygon;
+			int *polygon_ptrw = polygon.ptrw();
+			for (int j = 0; j < polygon.size(); j++) {
+				polygon_ptrw[j] += vertex_offset;
+			}
+			nav_polygons.push_back(polygon);
+		}
 	}
 
-	bake_state = "Creating contours..."; // step #8
-
-	cset = rcAllocContourSet();
-
-	ERR_FAIL_NULL(cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
-
-	bake_state = "Creating polymesh..."; // step #9
-
-	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_NULL(poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
-
-	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_NULL(detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
-
-	rcFreeCompactHeightfield(chf);
-	chf = nullptr;
-	rcFreeContourSet(cset);
-	cset = nullptr;
-
-	bake_state = "Converting to native navigation mesh..."; // step #10
-
-	Vector<Vector3> nav_vertices;
-
-	for (int i = 0; i < detail_mesh->nverts; i++) {
-		const float *v = &detail_mesh->verts[i * 3];
-		nav_vertices.push_back(Vector3(v[0], v[1], v[2]));
-	}
 	p_navigation_mesh->set_vertices(nav_vertices);
 	p_navigation_mesh->clear_polygons();
-
-	for (int i = 0; i < detail_mesh->nmeshes; i++) {
-		const unsigned int *detail_mesh_m = &detail_mesh->meshes[i * 4];
-		const unsigned int detail_mesh_bverts = detail_mesh_m[0];
-		const unsigned int detail_mesh_m_btris = detail_mesh_m[2];
-		const unsigned int detail_mesh_ntris = detail_mesh_m[3];
-		const unsigned char *detail_mesh_tris = &detail_mesh->tris[detail_mesh_m_btris * 4];
-		for (unsigned int j = 0; j < detail_mesh_ntris; j++) {
-			Vector<int> nav_indices;
-			nav_indices.resize(3);
-			// Polygon order in recast is opposite than godot's
-			nav_indices.write[0] = ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 0]));
-			nav_indices.write[1] = ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 2]));
-			nav_indices.write[2] = ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 1]));
-			p_navigation_mesh->add_polygon(nav_indices);
-		}
+	for (const Vector<int> &nav_polygon : nav_polygons) {
+		p_navigation_mesh->add_polygon(nav_polygon);
 	}
-
-	bake_state = "Cleanup..."; // step #11
-
-	rcFreePolyMesh(poly_mesh);
-	poly_mesh = nullptr;
-	rcFreePolyMeshDetail(detail_mesh);
-	detail_mesh = nullptr;
-
-	bake_state = "Baking finished."; // step #12
 }
 
 bool NavMeshGenerator3D::generator_emit_callback(const Callable &p_callback) {
@@ -38,9 +38,12 @@
 #include "core/templates/rid_owner.h"
 #include "modules/modules_enabled.gen.h" // For csg, gridmap.
 
+class Mesh;
 class Node;
 class NavigationMesh;
 class NavigationMeshSourceGeometryData3D;
+struct NavMeshBakeSettings3D;
+struct rcConfig;
 
 class NavMeshGenerator3D : public Object {
 	static NavMeshGenerator3D *singleton;
@@ -59,6 +62,22 @@ class NavMeshGenerator3D : public Object {
 	static bool use_threads;
 	static bool baking_use_multiple_threads;
 	static bool baking_use_high_priority_threads;
+	static bool parsing_use_multiple_threads;
+
+	// Triangle geometry extracted from mesh resources in mesh space, reused as long as the mesh does not emit changed.
+	struct NavMeshCachedGeometry3D {
+		int surface_count = 0;
+		Vector<Vector3> vertices;
+		Vector<int> indices;
+	};
+
+	struct NavMeshGeometryExtraction3D {
+		LocalVector<Ref<Mesh>> meshes;
+		LocalVector<NavMeshCachedGeometry3D> geometries;
+	};
+
+	static Mutex generator_mesh_cache_mutex;
+	static HashMap<ObjectID, NavMeshCachedGeometry3D> generator_mesh_cache;
 
 	struct NavMeshGeneratorTask3D {
 		enum TaskStatus {
@@ -72,6 +91,8 @@ class NavMeshGenerator3D : public Object {
 		Ref<NavigationMesh> navigation_mesh;
 		Ref<NavigationMeshSourceGeometryData3D> source_geometry_data;
 		Callable callback;
+		bool rebake_tiles = false;
+		AABB rebake_area;
 		WorkerThreadPool::TaskID thread_task_id = WorkerThreadPool::INVALID_TASK_ID;
 		NavMeshGeneratorTask3D::TaskStatus status = NavMeshGeneratorTask3D::TaskStatus::BAKING_STARTED;
 	};
@@ -79,12 +100,23 @@ class NavMeshGenerator3D : public Object {
 	static HashMap<WorkerThreadPool::TaskID, NavMeshGeneratorTask3D *> generator_tasks;
 
 	static void generator_thread_bake(void *p_arg);
+	static void generator_thread_extract_mesh_geometry(void *p_arg, uint32_t p_index);
 
 	static HashSet<Ref<NavigationMesh>> baking_navmeshes;
 
 	static void generator_parse_geometry_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node, bool p_recurse_children);
 	static void generator_parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_root_node);
-	static void generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data);
+	static void generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, bool p_rebake_tiles = false, const AABB &p_rebake_area = AABB());
+	static void generator_bake_tiles(Ref<NavigationMesh> p_navigation_mesh, const NavMeshBakeSettings3D &p_settings, const rcConfig &p_cfg, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, bool p_rebake_tiles, const AABB &p_rebake_area);
+	static void generator_bake(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, bool p_rebake_tiles, const AABB &p_rebake_area, const Callable &p_callback, bool p_async);
+
+	static void generator_extract_mesh_geometry(const Ref<Mesh> &p_mesh, NavMeshCachedGeometry3D &r_geometry);
+	static bool generator_is_mesh_cacheable(const Ref<Mesh> &p_mesh);
+	static void generator_cache_mesh_geometry(const Ref<Mesh> &p_mesh, const NavMeshCachedGeometry3D &p_geometry);
+	static void generator_add_mesh(Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Ref<Mesh> &p_mesh, const Transform3D &p_xform);
+	static void generator_mesh_changed(ObjectID p_mesh_id);
+	static void generator_collect_meshes(Node *p_node, bool p_recurse_children, HashSet<Ref<Mesh>> &r_meshes);
+	static void generator_prefetch_meshes(const Ref<NavigationMesh> &p_navigation_mesh, const List<Node *> &p_parse_nodes, bool p_recurse_children);
 
 	static void generator_parse_meshinstance3d_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node);
 	static void generator_parse_multimeshinstance3d_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node);
@@ -109,6 +141,8 @@ public:
 	static void parse_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable());
 	static void bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback = Callable());
 	static void bake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback = Callable());
+	static void rebake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const AABB &p_area, const Callable &p_callback = Callable());
+	static void rebake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const AABB &p_area, const Callable &p_callback = Callable());
 	static bool is_baking(Ref<NavigationMesh> p_navigation_mesh);
 
 	static RID source_geometry_parser_create();
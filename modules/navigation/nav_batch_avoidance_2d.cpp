@@ -0,0 +1,1272 @@
+/**************************************************************************/
+/*  nav_batch_avoidance_2d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_batch_avoidance_2d.h"
+
+#include "core/math/simd.h"
+#include "core/object/worker_thread_pool.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(SIMD_SSE2)
+
+#define SIMD_FLOAT __m128
+#define SIMD_MASK __m128
+#define SIMD_SET1(m_value) _mm_set1_ps(m_value)
+#define SIMD_LOAD(m_src) _mm_loadu_ps(m_src)
+#define SIMD_STORE(m_dst, m_a) _mm_storeu_ps(m_dst, m_a)
+#define SIMD_ADD(m_a, m_b) _mm_add_ps(m_a, m_b)
+#define SIMD_SUB(m_a, m_b) _mm_sub_ps(m_a, m_b)
+#define SIMD_MUL(m_a, m_b) _mm_mul_ps(m_a, m_b)
+#define SIMD_DIV(m_a, m_b) _mm_div_ps(m_a, m_b)
+#define SIMD_SQRT(m_a) _mm_sqrt_ps(m_a)
+#define SIMD_NEG(m_a) _mm_xor_ps(m_a, _mm_set1_ps(-0.0f))
+#define SIMD_ABS(m_a) _mm_andnot_ps(_mm_set1_ps(-0.0f), m_a)
+#define SIMD_MIN(m_a, m_b) _mm_min_ps(m_a, m_b)
+#define SIMD_MAX(m_a, m_b) _mm_max_ps(m_a, m_b)
+#define SIMD_LESS(m_a, m_b) _mm_cmplt_ps(m_a, m_b)
+#define SIMD_LESS_EQUAL(m_a, m_b) _mm_cmple_ps(m_a, m_b)
+#define SIMD_GREATER(m_a, m_b) _mm_cmpgt_ps(m_a, m_b)
+#define SIMD_GREATER_EQUAL(m_a, m_b) _mm_cmpge_ps(m_a, m_b)
+#define SIMD_NO_LANES _mm_setzero_ps()
+#define SIMD_AND(m_a, m_b) _mm_and_ps(m_a, m_b)
+#define SIMD_OR(m_a, m_b) _mm_or_ps(m_a, m_b)
+// Lanes of m_a that are not in m_b.
+#define SIMD_AND_NOT(m_a, m_b) _mm_andnot_ps(m_b, m_a)
+// m_a in the lanes of m_mask, m_b elsewhere.
+#define SIMD_SELECT(m_mask, m_a, m_b) _mm_or_ps(_mm_and_ps(m_mask, m_a), _mm_andnot_ps(m_mask, m_b))
+// One bit per lane of m_mask.
+#define SIMD_MASK_BITS(m_mask) _mm_movemask_ps(m_mask)
+
+#elif defined(SIMD_NEON)
+
+// Same as _mm_min_ps()/_mm_max_ps(): the second operand is returned when either is NaN, unlike vminq_f32()/vmaxq_f32().
+static _FORCE_INLINE_ float32x4_t _min(float32x4_t p_a, float32x4_t p_b) {
+	return vbslq_f32(vcltq_f32(p_a, p_b), p_a, p_b);
+}
+
+static _FORCE_INLINE_ float32x4_t _max(float32x4_t p_a, float32x4_t p_b) {
+	return vbslq_f32(vcgtq_f32(p_a, p_b), p_a, p_b);
+}
+
+static _FORCE_INLINE_ int _mask_bits(uint32x4_t p_mask) {
+	static const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+	return vaddvq_u32(vandq_u32(p_mask, vld1q_u32(lane_bits)));
+}
+
+#define SIMD_FLOAT float32x4_t
+#define SIMD_MASK uint32x4_t
+#define SIMD_SET1(m_value) vdupq_n_f32(m_value)
+#define SIMD_LOAD(m_src) vld1q_f32(m_src)
+#define SIMD_STORE(m_dst, m_a) vst1q_f32(m_dst, m_a)
+#define SIMD_ADD(m_a, m_b) vaddq_f32(m_a, m_b)
+#define SIMD_SUB(m_a, m_b) vsubq_f32(m_a, m_b)
+#define SIMD_MUL(m_a, m_b) vmulq_f32(m_a, m_b)
+#define SIMD_DIV(m_a, m_b) vdivq_f32(m_a, m_b)
+#define SIMD_SQRT(m_a) vsqrtq_f32(m_a)
+#define SIMD_NEG(m_a) vnegq_f32(m_a)
+#define SIMD_ABS(m_a) vabsq_f32(m_a)
+#define SIMD_MIN(m_a, m_b) _min(m_a, m_b)
+#define SIMD_MAX(m_a, m_b) _max(m_a, m_b)
+#define SIMD_LESS(m_a, m_b) vcltq_f32(m_a, m_b)
+#define SIMD_LESS_EQUAL(m_a, m_b) vcleq_f32(m_a, m_b)
+#define SIMD_GREATER(m_a, m_b) vcgtq_f32(m_a, m_b)
+#define SIMD_GREATER_EQUAL(m_a, m_b) vcgeq_f32(m_a, m_b)
+#define SIMD_NO_LANES vdupq_n_u32(0)
+#define SIMD_AND(m_a, m_b) vandq_u32(m_a, m_b)
+#define SIMD_OR(m_a, m_b) vorrq_u32(m_a, m_b)
+#define SIMD_AND_NOT(m_a, m_b) vbicq_u32(m_a, m_b)
+#define SIMD_SELECT(m_mask, m_a, m_b) vbslq_f32(m_mask, m_a, m_b)
+#define SIMD_MASK_BITS(m_mask) _mask_bits(m_mask)
+
+#endif
+
+#ifdef SIMD_FLOAT
+
+// The linear programs below solve the ones of NavBatchAvoidance2D for four agents at once, one agent per SIMD lane.
+// Every lane takes the same decisions as the scalar version would for its agent. Where the scalar version returns early,
+// the lane is masked instead, and the other lanes go on.
+
+static const float lane_ids[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+
+// The lines of four agents, with line i of lane l at i * 4 + l.
+struct LaneLines {
+	float *point_x = nullptr;
+	float *point_y = nullptr;
+	float *direction_x = nullptr;
+	float *direction_y = nullptr;
+	uint32_t count = 0;
+};
+
+// Returns the lanes that fail.
+static SIMD_MASK _linear_program_1_x4(const LaneLines &p_lines, uint32_t p_line, SIMD_FLOAT p_radius, SIMD_FLOAT p_opt_x, SIMD_FLOAT p_opt_y, bool p_direction_opt, SIMD_FLOAT &r_x, SIMD_FLOAT &r_y) {
+	const SIMD_FLOAT zero = SIMD_SET1(0.0f);
+	const SIMD_FLOAT epsilon = SIMD_SET1(RVO_EPSILON);
+
+	const SIMD_FLOAT point_x = SIMD_LOAD(p_lines.point_x + p_line * 4);
+	const SIMD_FLOAT point_y = SIMD_LOAD(p_lines.point_y + p_line * 4);
+	const SIMD_FLOAT direction_x = SIMD_LOAD(p_lines.direction_x + p_line * 4);
+	const SIMD_FLOAT direction_y = SIMD_LOAD(p_lines.direction_y + p_line * 4);
+
+	const SIMD_FLOAT dot_product = SIMD_ADD(SIMD_MUL(point_x, direction_x), SIMD_MUL(point_y, direction_y));
+	const SIMD_FLOAT discriminant = SIMD_SUB(SIMD_ADD(SIMD_MUL(dot_product, dot_product), SIMD_MUL(p_radius, p_radius)), SIMD_ADD(SIMD_MUL(point_x, point_x), SIMD_MUL(point_y, point_y)));
+
+	// Max speed circle fully invalidates line.
+	SIMD_MASK failed = SIMD_LESS(discriminant, zero);
+
+	const SIMD_FLOAT sqrt_discriminant = SIMD_SQRT(discriminant);
+	SIMD_FLOAT t_left = SIMD_SUB(SIMD_NEG(dot_product), sqrt_discriminant);
+	SIMD_FLOAT t_right = SIMD_ADD(SIMD_NEG(dot_product), sqrt_discriminant);
+
+	for (uint32_t i = 0; i < p_line; i++) {
+		const SIMD_FLOAT other_point_x = SIMD_LOAD(p_lines.point_x + i * 4);
+		const SIMD_FLOAT other_point_y = SIMD_LOAD(p_lines.point_y + i * 4);
+		const SIMD_FLOAT other_direction_x = SIMD_LOAD(p_lines.direction_x + i * 4);
+		const SIMD_FLOAT other_direction_y = SIMD_LOAD(p_lines.direction_y + i * 4);
+
+		const SIMD_FLOAT denominator = SIMD_SUB(SIMD_MUL(direction_x, other_direction_y), SIMD_MUL(direction_y, other_direction_x));
+		const SIMD_FLOAT numerator = SIMD_SUB(SIMD_MUL(other_direction_x, SIMD_SUB(point_y, other_point_y)), SIMD_MUL(other_direction_y, SIMD_SUB(point_x, other_point_x)));
+
+		// Lines are (almost) parallel.
+		const SIMD_MASK parallel = SIMD_LESS_EQUAL(SIMD_ABS(denominator), epsilon);
+		failed = SIMD_OR(failed, SIMD_AND(parallel, SIMD_LESS(numerator, zero)));
+
+		// The bounds only ever narrow, so checking them once after the loop fails the same lanes as checking them after every line.
+		const SIMD_FLOAT t = SIMD_DIV(numerator, denominator);
+		const SIMD_MASK bounds_right = SIMD_GREATER_EQUAL(denominator, zero);
+		t_right = SIMD_SELECT(SIMD_AND_NOT(bounds_right, parallel), SIMD_MIN(t_right, t), t_right);
+		t_left = SIMD_SELECT(SIMD_OR(bounds_right, parallel), t_left, SIMD_MAX(t_left, t));
+	}
+	failed = SIMD_OR(failed, SIMD_GREATER(t_left, t_right));
+
+	SIMD_FLOAT t;
+	if (p_direction_opt) {
+		// Optimize direction.
+		t = SIMD_SELECT(SIMD_GREATER(SIMD_ADD(SIMD_MUL(p_opt_x, direction_x), SIMD_MUL(p_opt_y, direction_y)), zero), t_right, t_left);
+	} else {
+		// Optimize closest point.
+		t = SIMD_ADD(SIMD_MUL(direction_x, SIMD_SUB(p_opt_x, point_x)), SIMD_MUL(direction_y, SIMD_SUB(p_opt_y, point_y)));
+		t = SIMD_SELECT(SIMD_LESS(t, t_left), t_left, SIMD_SELECT(SIMD_GREATER(t, t_right), t_right, t));
+	}
+
+	r_x = SIMD_ADD(point_x, SIMD_MUL(t, direction_x));
+	r_y = SIMD_ADD(point_y, SIMD_MUL(t, direction_y));
+	return failed;
+}
+
+// Solves the lanes in p_lanes. Returns the lanes that fail, and writes the line they fail on to r_line_fail.
+static SIMD_MASK _linear_program_2_x4(const LaneLines &p_lines, SIMD_MASK p_lanes, SIMD_FLOAT p_radius, SIMD_FLOAT p_opt_x, SIMD_FLOAT p_opt_y, bool p_direction_opt, SIMD_FLOAT &r_x, SIMD_FLOAT &r_y, SIMD_FLOAT &r_line_fail) {
+	const SIMD_FLOAT zero = SIMD_SET1(0.0f);
+
+	if (p_direction_opt) {
+		// Optimize direction. Note that the optimization velocity is of unit length in this case.
+		r_x = SIMD_MUL(p_opt_x, p_radius);
+		r_y = SIMD_MUL(p_opt_y, p_radius);
+	} else {
+		// Optimize closest point, projected on the circle if outside of it.
+		const SIMD_FLOAT opt_length_squared = SIMD_ADD(SIMD_MUL(p_opt_x, p_opt_x), SIMD_MUL(p_opt_y, p_opt_y));
+		const SIMD_MASK outside = SIMD_GREATER(opt_length_squared, SIMD_MUL(p_radius, p_radius));
+		const SIMD_FLOAT opt_length = SIMD_SQRT(opt_length_squared);
+		r_x = SIMD_SELECT(outside, SIMD_MUL(SIMD_DIV(p_opt_x, opt_length), p_radius), p_opt_x);
+		r_y = SIMD_SELECT(outside, SIMD_MUL(SIMD_DIV(p_opt_y, opt_length), p_radius), p_opt_y);
+	}
+
+	SIMD_MASK lanes = p_lanes;
+	SIMD_MASK failed = SIMD_NO_LANES;
+	r_line_fail = SIMD_SET1(float(p_lines.count));
+
+	for (uint32_t i = 0; i < p_lines.count; i++) {
+		const SIMD_FLOAT point_x = SIMD_LOAD(p_lines.point_x + i * 4);
+		const SIMD_FLOAT point_y = SIMD_LOAD(p_lines.point_y + i * 4);
+		const SIMD_FLOAT direction_x = SIMD_LOAD(p_lines.direction_x + i * 4);
+		const SIMD_FLOAT direction_y = SIMD_LOAD(p_lines.direction_y + i * 4);
+
+		const SIMD_MASK violated = SIMD_AND(lanes, SIMD_GREATER(SIMD_SUB(SIMD_MUL(direction_x, SIMD_SUB(point_y, r_y)), SIMD_MUL(direction_y, SIMD_SUB(point_x, r_x))), zero));
+		if (SIMD_MASK_BITS(violated) == 0) {
+			continue;
+		}
+
+		// Result does not satisfy constraint i. Compute new optimal result.
+		SIMD_FLOAT x;
+		SIMD_FLOAT y;
+		const SIMD_MASK line_failed = SIMD_AND(violated, _linear_program_1_x4(p_lines, i, p_radius, p_opt_x, p_opt_y, p_direction_opt, x, y));
+		const SIMD_MASK solved = SIMD_AND_NOT(violated, line_failed);
+		r_x = SIMD_SELECT(solved, x, r_x);
+		r_y = SIMD_SELECT(solved, y, r_y);
+
+		if (SIMD_MASK_BITS(line_failed) != 0) {
+			// The failed lanes keep their previous result.
+			failed = SIMD_OR(failed, line_failed);
+			r_line_fail = SIMD_SELECT(line_failed, SIMD_SET1(float(i)), r_line_fail);
+			lanes = SIMD_AND_NOT(lanes, line_failed);
+			if (SIMD_MASK_BITS(lanes) == 0) {
+				break;
+			}
+		}
+	}
+
+	return failed;
+}
+
+// Solves the lanes in p_lanes, from the line in p_begin_line on. p_max_obstacle_line_count is the highest of p_obstacle_line_count.
+static void _linear_program_3_x4(const LaneLines &p_lines, SIMD_FLOAT p_obstacle_line_count, uint32_t p_max_obstacle_line_count, SIMD_MASK p_lanes, SIMD_FLOAT p_begin_line, SIMD_FLOAT p_radius, LaneLines p_projected_lines, SIMD_FLOAT &r_x, SIMD_FLOAT &r_y) {
+	const SIMD_FLOAT zero = SIMD_SET1(0.0f);
+	const SIMD_FLOAT half = SIMD_SET1(0.5f);
+	const SIMD_FLOAT epsilon = SIMD_SET1(RVO_EPSILON);
+
+	float begin_lines[4];
+	SIMD_STORE(begin_lines, SIMD_SELECT(p_lanes, p_begin_line, SIMD_SET1(float(p_lines.count))));
+	const uint32_t begin_line = uint32_t(MIN(MIN(begin_lines[0], begin_lines[1]), MIN(begin_lines[2], begin_lines[3])));
+
+	SIMD_FLOAT distance = zero;
+
+	for (uint32_t i = begin_line; i < p_lines.count; i++) {
+		const SIMD_FLOAT point_x = SIMD_LOAD(p_lines.point_x + i * 4);
+		const SIMD_FLOAT point_y = SIMD_LOAD(p_lines.point_y + i * 4);
+		const SIMD_FLOAT direction_x = SIMD_LOAD(p_lines.direction_x + i * 4);
+		const SIMD_FLOAT direction_y = SIMD_LOAD(p_lines.direction_y + i * 4);
+
+		const SIMD_MASK lanes = SIMD_AND(p_lanes, SIMD_LESS_EQUAL(p_begin_line, SIMD_SET1(float(i))));
+		const SIMD_MASK violated = SIMD_AND(lanes, SIMD_GREATER(SIMD_SUB(SIMD_MUL(direction_x, SIMD_SUB(point_y, r_y)), SIMD_MUL(direction_y, SIMD_SUB(point_x, r_x))), distance));
+		if (SIMD_MASK_BITS(violated) == 0) {
+			continue;
+		}
+
+		// Result does not satisfy constraint of line i.
+		// Projected line j is stored at j, lines that the scalar version skips are left as zero lines.
+		const uint32_t projected_line_count = MAX(p_max_obstacle_line_count, i);
+		for (uint32_t j = 0; j < projected_line_count; j++) {
+			const SIMD_FLOAT other_point_x = SIMD_LOAD(p_lines.point_x + j * 4);
+			const SIMD_FLOAT other_point_y = SIMD_LOAD(p_lines.point_y + j * 4);
+			const SIMD_FLOAT other_direction_x = SIMD_LOAD(p_lines.direction_x + j * 4);
+			const SIMD_FLOAT other_direction_y = SIMD_LOAD(p_lines.direction_y + j * 4);
+
+			const SIMD_MASK obstacle = SIMD_LESS(SIMD_SET1(float(j)), p_obstacle_line_count);
+
+			SIMD_FLOAT projected_point_x = zero;
+			SIMD_FLOAT projected_point_y = zero;
+			SIMD_FLOAT projected_direction_x = zero;
+			SIMD_FLOAT projected_direction_y = zero;
+
+			if (j < i) {
+				const SIMD_FLOAT determinant = SIMD_SUB(SIMD_MUL(direction_x, other_direction_y), SIMD_MUL(direction_y, other_direction_x));
+				const SIMD_MASK parallel = SIMD_LESS_EQUAL(SIMD_ABS(determinant), epsilon);
+				// Line i and line j point in the same direction.
+				const SIMD_MASK same_direction = SIMD_AND(parallel, SIMD_GREATER(SIMD_ADD(SIMD_MUL(direction_x, other_direction_x), SIMD_MUL(direction_y, other_direction_y)), zero));
+
+				const SIMD_FLOAT t = SIMD_DIV(SIMD_SUB(SIMD_MUL(other_direction_x, SIMD_SUB(point_y, other_point_y)), SIMD_MUL(other_direction_y, SIMD_SUB(point_x, other_point_x))), determinant);
+				projected_point_x = SIMD_SELECT(parallel, SIMD_MUL(half, SIMD_ADD(point_x, other_point_x)), SIMD_ADD(point_x, SIMD_MUL(t, direction_x)));
+				projected_point_y = SIMD_SELECT(parallel, SIMD_MUL(half, SIMD_ADD(point_y, other_point_y)), SIMD_ADD(point_y, SIMD_MUL(t, direction_y)));
+
+				const SIMD_FLOAT delta_x = SIMD_SUB(other_direction_x, direction_x);
+				const SIMD_FLOAT delta_y = SIMD_SUB(other_direction_y, direction_y);
+				// Same as RVO2D::normalize(), which multiplies with the inverse length.
+				const SIMD_FLOAT inv_delta_length = SIMD_DIV(SIMD_SET1(1.0f), SIMD_SQRT(SIMD_ADD(SIMD_MUL(delta_x, delta_x), SIMD_MUL(delta_y, delta_y))));
+				projected_direction_x = SIMD_MUL(delta_x, inv_delta_length);
+				projected_direction_y = SIMD_MUL(delta_y, inv_delta_length);
+
+				projected_point_x = SIMD_SELECT(same_direction, zero, projected_point_x);
+				projected_point_y = SIMD_SELECT(same_direction, zero, projected_point_y);
+				projected_direction_x = SIMD_SELECT(same_direction, zero, projected_direction_x);
+				projected_direction_y = SIMD_SELECT(same_direction, zero, projected_direction_y);
+			}
+
+			SIMD_STORE(p_projected_lines.point_x + j * 4, SIMD_SELECT(obstacle, other_point_x, projected_point_x));
+			SIMD_STORE(p_projected_lines.point_y + j * 4, SIMD_SELECT(obstacle, other_point_y, projected_point_y));
+			SIMD_STORE(p_projected_lines.direction_x + j * 4, SIMD_SELECT(obstacle, other_direction_x, projected_direction_x));
+			SIMD_STORE(p_projected_lines.direction_y + j * 4, SIMD_SELECT(obstacle, other_direction_y, projected_direction_y));
+		}
+		p_projected_lines.count = projected_line_count;
+
+		SIMD_FLOAT x;
+		SIMD_FLOAT y;
+		SIMD_FLOAT line_fail;
+		const SIMD_MASK failed = _linear_program_2_x4(p_projected_lines, violated, p_radius, SIMD_NEG(direction_y), direction_x, true, x, y, line_fail);
+
+		// This should in principle not fail. The result is by definition already in the feasible region of this linear program. If it fails, it is due to small floating point error, and the current result is kept.
+		const SIMD_MASK solved = SIMD_AND_NOT(violated, failed);
+		r_x = SIMD_SELECT(solved, x, r_x);
+		r_y = SIMD_SELECT(solved, y, r_y);
+
+		distance = SIMD_SELECT(violated, SIMD_SUB(SIMD_MUL(direction_x, SIMD_SUB(point_y, r_y)), SIMD_MUL(direction_y, SIMD_SUB(point_x, r_x))), distance);
+	}
+}
+
+#endif // SIMD_FLOAT
+
+void NavBatchAvoidance2D::Lines::clear() {
+	point_x.clear();
+	point_y.clear();
+	direction_x.clear();
+	direction_y.clear();
+}
+
+void NavBatchAvoidance2D::Lines::resize(uint32_t p_size) {
+	point_x.resize(p_size);
+	point_y.resize(p_size);
+	direction_x.resize(p_size);
+	direction_y.resize(p_size);
+}
+
+void NavBatchAvoidance2D::Lines::push_back(float p_point_x, float p_point_y, float p_direction_x, float p_direction_y) {
+	point_x.push_back(p_point_x);
+	point_y.push_back(p_point_y);
+	direction_x.push_back(p_direction_x);
+	direction_y.push_back(p_direction_y);
+}
+
+void NavBatchAvoidance2D::Grid::setup(float p_min_x, float p_min_y, float p_max_x, float p_max_y, float p_cell_size) {
+	const float extent = MAX(p_max_x - p_min_x, p_max_y - p_min_y);
+
+	min_x = p_min_x;
+	min_y = p_min_y;
+	cell_size = MAX(p_cell_size, extent / MAX_GRID_DIMENSION);
+	if (!(cell_size > 0.0f)) {
+		cell_size = 1.0f;
+	}
+	width = MIN(uint32_t((p_max_x - p_min_x) / cell_size) + 1, MAX_GRID_DIMENSION);
+	height = MIN(uint32_t((p_max_y - p_min_y) / cell_size) + 1, MAX_GRID_DIMENSION);
+
+	cell_starts.resize(width * height + 1);
+	for (uint32_t &cell_start : cell_starts) {
+		cell_start = 0;
+	}
+}
+
+uint32_t NavBatchAvoidance2D::Grid::get_cell_x(float p_x) const {
+	const float cell = (p_x - min_x) / cell_size;
+	return cell <= 0.0f ? 0 : MIN(uint32_t(cell), width - 1);
+}
+
+uint32_t NavBatchAvoidance2D::Grid::get_cell_y(float p_y) const {
+	const float cell = (p_y - min_y) / cell_size;
+	return cell <= 0.0f ? 0 : MIN(uint32_t(cell), height - 1);
+}
+
+void NavBatchAvoidance2D::set_obstacles(const std::vector<RVO2D::Obstacle2D *> &p_obstacles) {
+	obstacle_cell_entries.clear();
+
+	if (p_obstacles.empty()) {
+		obstacle_grid = Grid();
+		return;
+	}
+
+	float min_x = FLT_MAX;
+	float min_y = FLT_MAX;
+	float max_x = -FLT_MAX;
+	float max_y = -FLT_MAX;
+	float total_length = 0.0f;
+	for (const RVO2D::Obstacle2D *obstacle : p_obstacles) {
+		const RVO2D::Vector2 &point = obstacle->point_;
+		min_x = MIN(min_x, point.x());
+		min_y = MIN(min_y, point.y());
+		max_x = MAX(max_x, point.x());
+		max_y = MAX(max_y, point.y());
+		total_length += RVO2D::abs(obstacle->nextObstacle_->point_ - point);
+	}
+
+	obstacle_grid.setup(min_x, min_y, max_x, max_y, total_length / p_obstacles.size());
+
+	// Every obstacle stands for the segment to its next obstacle and is stored in all cells that the segment bounds touch.
+	LocalVector<uint32_t> &cell_starts = obstacle_grid.cell_starts;
+	for (int pass = 0; pass < 2; pass++) {
+		for (const RVO2D::Obstacle2D *obstacle : p_obstacles) {
+			const RVO2D::Vector2 &point_1 = obstacle->point_;
+			const RVO2D::Vector2 &point_2 = obstacle->nextObstacle_->point_;
+			const uint32_t from_x = obstacle_grid.get_cell_x(MIN(point_1.x(), point_2.x()));
+			const uint32_t to_x = obstacle_grid.get_cell_x(MAX(point_1.x(), point_2.x()));
+			const uint32_t from_y = obstacle_grid.get_cell_y(MIN(point_1.y(), point_2.y()));
+			const uint32_t to_y = obstacle_grid.get_cell_y(MAX(point_1.y(), point_2.y()));
+
+			for (uint32_t y = from_y; y <= to_y; y++) {
+				for (uint32_t x = from_x; x <= to_x; x++) {
+					const uint32_t cell = y * obstacle_grid.width + x;
+					if (pass == 0) {
+						cell_starts[cell + 1]++;
+					} else {
+						obstacle_cell_entries[cell_starts[cell]++] = obstacle;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (uint32_t i = 1; i < cell_starts.size(); i++) {
+				cell_starts[i] += cell_starts[i - 1];
+			}
+			obstacle_cell_entries.resize(cell_starts[cell_starts.size() - 1]);
+		} else {
+			// Filling advanced every start to the start of the next cell.
+			for (uint32_t i = cell_starts.size() - 1; i > 0; i--) {
+				cell_starts[i] = cell_starts[i - 1];
+			}
+			cell_starts[0] = 0;
+		}
+	}
+}
+
+void NavBatchAvoidance2D::_compute_agent_cell(uint32_t p_index, RVO2D::Agent2D *const *p_agents) {
+	const RVO2D::Vector2 &position = p_agents[p_index]->position_;
+	const uint32_t cell = agent_grid.get_cell_y(position.y()) * agent_grid.width + agent_grid.get_cell_x(position.x());
+	agent_cells[p_index] = cell;
+	agent_cell_slots[p_index] = agent_cell_counts[cell].postincrement();
+}
+
+void NavBatchAvoidance2D::_scatter_agent(uint32_t p_index, void *p_unused) {
+	agent_indices[agent_grid.cell_starts[agent_cells[p_index]] + agent_cell_slots[p_index]] = p_index;
+}
+
+void NavBatchAvoidance2D::_sort_agent_row(uint32_t p_row, void *p_unused) {
+	// The slots within a cell depend on the order in which the threads counted the agents.
+	// Sorting the cells by input index makes the order, and so the result, the same on every run.
+	const uint32_t *cell_starts = agent_grid.cell_starts.ptr() + p_row * agent_grid.width;
+	for (uint32_t x = 0; x < agent_grid.width; x++) {
+		for (uint32_t i = cell_starts[x] + 1; i < cell_starts[x + 1]; i++) {
+			const uint32_t index = agent_indices[i];
+			uint32_t slot = i;
+			while (slot > cell_starts[x] && agent_indices[slot - 1] > index) {
+				agent_indices[slot] = agent_indices[slot - 1];
+				slot--;
+			}
+			agent_indices[slot] = index;
+		}
+	}
+}
+
+void NavBatchAvoidance2D::_gather_agent(uint32_t p_index, RVO2D::Agent2D *const *p_agents) {
+	RVO2D::Agent2D *agent = p_agents[agent_indices[p_index]];
+	agents[p_index] = agent;
+
+	position_x[p_index] = agent->position_.x();
+	position_y[p_index] = agent->position_.y();
+	velocity_x[p_index] = agent->velocity_.x();
+	velocity_y[p_index] = agent->velocity_.y();
+	preferred_velocity_x[p_index] = agent->prefVelocity_.x();
+	preferred_velocity_y[p_index] = agent->prefVelocity_.y();
+	radius[p_index] = agent->radius_;
+	max_speed[p_index] = agent->maxSpeed_;
+	neighbor_distance[p_index] = agent->neighborDist_;
+	time_horizon[p_index] = agent->timeHorizon_;
+	time_horizon_obstacles[p_index] = agent->timeHorizonObst_;
+	elevation[p_index] = agent->elevation_;
+	height[p_index] = agent->height_;
+	priority[p_index] = agent->avoidance_priority_;
+	max_neighbors[p_index] = agent->maxNeighbors_;
+	layers[p_index] = agent->avoidance_layers_;
+	mask[p_index] = agent->avoidance_mask_;
+}
+
+void NavBatchAvoidance2D::solve(RVO2D::Agent2D *const *p_agents, uint32_t p_agent_count, float p_time_step, bool p_use_threads, bool p_use_high_priority_threads) {
+	time_step = p_time_step;
+
+	if (p_agent_count == 0) {
+		return;
+	}
+
+	// Size the neighbor grid after the average neighbor distance, so most agents only visit the 3x3 cells around them.
+	float min_x = FLT_MAX;
+	float min_y = FLT_MAX;
+	float max_x = -FLT_MAX;
+	float max_y = -FLT_MAX;
+	float total_neighbor_distance = 0.0f;
+	uint32_t agents_with_neighbors = 0;
+	for (uint32_t i = 0; i < p_agent_count; i++) {
+		const RVO2D::Agent2D *agent = p_agents[i];
+		min_x = MIN(min_x, agent->position_.x());
+		min_y = MIN(min_y, agent->position_.y());
+		max_x = MAX(max_x, agent->position_.x());
+		max_y = MAX(max_y, agent->position_.y());
+		if (agent->maxNeighbors_ > 0) {
+			total_neighbor_distance += agent->neighborDist_;
+			agents_with_neighbors++;
+		}
+	}
+	agent_grid.setup(min_x, min_y, max_x, max_y, agents_with_neighbors > 0 ? 0.5f * total_neighbor_distance / agents_with_neighbors : 0.0f);
+
+	// Counting sort of the agents by cell. The agents are counted and scattered in parallel, only the prefix sum over the cells is serial.
+	const uint32_t cell_count = agent_grid.width * agent_grid.height;
+	agent_cell_counts.resize(cell_count);
+	for (uint32_t i = 0; i < cell_count; i++) {
+		agent_cell_counts[i].set(0);
+	}
+	agent_cells.resize(p_agent_count);
+	agent_cell_slots.resize(p_agent_count);
+
+	if (p_use_threads) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavBatchAvoidance2D::_compute_agent_cell, p_agents, p_agent_count, -1, p_use_high_priority_threads, SNAME("BatchAvoidanceGrid2D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < p_agent_count; i++) {
+			_compute_agent_cell(i, p_agents);
+		}
+	}
+
+	LocalVector<uint32_t> &cell_starts = agent_grid.cell_starts;
+	for (uint32_t i = 0; i < cell_count; i++) {
+		cell_starts[i + 1] = cell_starts[i] + agent_cell_counts[i].get();
+	}
+
+	agents.resize(p_agent_count);
+	agent_indices.resize(p_agent_count);
+	position_x.resize(p_agent_count);
+	position_y.resize(p_agent_count);
+	velocity_x.resize(p_agent_count);
+	velocity_y.resize(p_agent_count);
+	preferred_velocity_x.resize(p_agent_count);
+	preferred_velocity_y.resize(p_agent_count);
+	radius.resize(p_agent_count);
+	max_speed.resize(p_agent_count);
+	neighbor_distance.resize(p_agent_count);
+	time_horizon.resize(p_agent_count);
+	time_horizon_obstacles.resize(p_agent_count);
+	elevation.resize(p_agent_count);
+	height.resize(p_agent_count);
+	priority.resize(p_agent_count);
+	max_neighbors.resize(p_agent_count);
+	layers.resize(p_agent_count);
+	mask.resize(p_agent_count);
+
+	const uint32_t block_count = (p_agent_count + AGENT_BLOCK_SIZE - 1) / AGENT_BLOCK_SIZE;
+
+	if (p_use_threads) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavBatchAvoidance2D::_scatter_agent, (void *)nullptr, p_agent_count, -1, p_use_high_priority_threads, SNAME("BatchAvoidanceScatter2D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavBatchAvoidance2D::_sort_agent_row, (void *)nullptr, agent_grid.height, -1, p_use_high_priority_threads, SNAME("BatchAvoidanceSort2D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavBatchAvoidance2D::_gather_agent, p_agents, p_agent_count, -1, p_use_high_priority_threads, SNAME("BatchAvoidanceGather2D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavBatchAvoidance2D::_solve_agent_block, (void *)nullptr, block_count, -1, p_use_high_priority_threads, SNAME("BatchAvoidanceAgents2D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < p_agent_count; i++) {
+			_scatter_agent(i, nullptr);
+		}
+		for (uint32_t i = 0; i < agent_grid.height; i++) {
+			_sort_agent_row(i, nullptr);
+		}
+		for (uint32_t i = 0; i < p_agent_count; i++) {
+			_gather_agent(i, p_agents);
+		}
+		for (uint32_t i = 0; i < block_count; i++) {
+			_solve_agent_block(i, nullptr);
+		}
+	}
+}
+
+void NavBatchAvoidance2D::_solve_agent_block(uint32_t p_block, void *p_unused) {
+	Scratch scratch;
+	float new_velocity_x[SOLVER_LANES];
+	float new_velocity_y[SOLVER_LANES];
+
+	const uint32_t from = p_block * AGENT_BLOCK_SIZE;
+	const uint32_t to = MIN(from + AGENT_BLOCK_SIZE, agents.size());
+	for (uint32_t i = from; i < to; i += SOLVER_LANES) {
+		const uint32_t lane_count = MIN(SOLVER_LANES, to - i);
+		_compute_new_velocities(i, lane_count, scratch, new_velocity_x, new_velocity_y);
+
+		for (uint32_t lane = 0; lane < lane_count; lane++) {
+			// Same as RVO2D::Agent2D::update().
+			RVO2D::Agent2D *agent = agents[i + lane];
+			agent->newVelocity_ = RVO2D::Vector2(new_velocity_x[lane], new_velocity_y[lane]);
+			agent->velocity_ = agent->newVelocity_;
+			agent->position_ += agent->velocity_ * time_step;
+		}
+	}
+}
+
+void NavBatchAvoidance2D::_compute_agent_neighbors(uint32_t p_agent, Scratch &r_scratch) const {
+	LocalVector<AgentNeighbor> &neighbors = r_scratch.agent_neighbors;
+	neighbors.clear();
+
+	const uint32_t neighbor_count = max_neighbors[p_agent];
+	if (neighbor_count == 0) {
+		return;
+	}
+
+	const float agent_x = position_x[p_agent];
+	const float agent_y = position_y[p_agent];
+	const float agent_elevation = elevation[p_agent];
+	const float agent_height = height[p_agent];
+	const float agent_priority = priority[p_agent];
+	const uint32_t agent_mask = mask[p_agent];
+	const float range = neighbor_distance[p_agent];
+	float range_squared = range * range;
+
+	auto insert_neighbor = [&](uint32_t p_other, float p_distance_squared) {
+		if (p_distance_squared >= range_squared || p_other == p_agent) {
+			return;
+		}
+		// Same filters as RVO2D::Agent2D::insertAgentNeighbor().
+		if ((agent_mask & layers[p_other]) == 0) {
+			return;
+		}
+		if ((agent_elevation > elevation[p_other] + height[p_other]) || (agent_elevation + agent_height < elevation[p_other])) {
+			return;
+		}
+		if (agent_priority > priority[p_other]) {
+			return;
+		}
+
+		if (neighbors.size() < neighbor_count) {
+			neighbors.push_back(AgentNeighbor());
+		}
+		uint32_t slot = neighbors.size() - 1;
+		while (slot != 0 && p_distance_squared < neighbors[slot - 1].distance_squared) {
+			neighbors[slot] = neighbors[slot - 1];
+			slot--;
+		}
+		neighbors[slot].distance_squared = p_distance_squared;
+		neighbors[slot].agent = p_other;
+
+		if (neighbors.size() == neighbor_count) {
+			range_squared = neighbors[neighbors.size() - 1].distance_squared;
+		}
+	};
+
+	auto visit_row = [&](uint32_t p_y, float p_range) {
+		// The cells of a grid row are consecutive, so their agents are one range of the sorted agents.
+		const uint32_t row = p_y * agent_grid.width;
+		const uint32_t begin = agent_grid.cell_starts[row + agent_grid.get_cell_x(agent_x - p_range)];
+		const uint32_t end = agent_grid.cell_starts[row + agent_grid.get_cell_x(agent_x + p_range) + 1];
+
+		for (uint32_t other = begin; other < end; other++) {
+			const float delta_x = agent_x - position_x[other];
+			const float delta_y = agent_y - position_y[other];
+			insert_neighbor(other, delta_x * delta_x + delta_y * delta_y);
+		}
+	};
+
+	// Visit the rows from the row of the agent outwards. Once the neighbor list is full the range shrinks, and the rows and cells
+	// that are out of the new range are skipped.
+	const uint32_t center_y = agent_grid.get_cell_y(agent_y);
+	visit_row(center_y, range);
+	for (uint32_t offset = 1;; offset++) {
+		const float current_range = std::sqrt(range_squared);
+		const bool visit_above = center_y >= offset && center_y - offset >= agent_grid.get_cell_y(agent_y - current_range);
+		const bool visit_below = center_y + offset <= agent_grid.get_cell_y(agent_y + current_range);
+		if (!visit_above && !visit_below) {
+			break;
+		}
+
+		if (visit_above) {
+			visit_row(center_y - offset, current_range);
+		}
+		if (visit_below) {
+			visit_row(center_y + offset, std::sqrt(range_squared));
+		}
+	}
+}
+
+void NavBatchAvoidance2D::_compute_obstacle_neighbors(uint32_t p_agent, Scratch &r_scratch) const {
+	LocalVector<ObstacleNeighbor> &neighbors = r_scratch.obstacle_neighbors;
+	neighbors.clear();
+
+	if (obstacle_cell_entries.is_empty()) {
+		return;
+	}
+
+	const RVO2D::Vector2 agent_position(position_x[p_agent], position_y[p_agent]);
+	const float agent_elevation = elevation[p_agent];
+	const float agent_height = height[p_agent];
+	const uint32_t agent_mask = mask[p_agent];
+	const float range = time_horizon_obstacles[p_agent] * max_speed[p_agent] + radius[p_agent];
+	const float range_squared = range * range;
+
+	const uint32_t from_x = obstacle_grid.get_cell_x(agent_position.x() - range);
+	const uint32_t to_x = obstacle_grid.get_cell_x(agent_position.x() + range);
+	const uint32_t from_y = obstacle_grid.get_cell_y(agent_position.y() - range);
+	const uint32_t to_y = obstacle_grid.get_cell_y(agent_position.y() + range);
+
+	for (uint32_t y = from_y; y <= to_y; y++) {
+		const uint32_t row = y * obstacle_grid.width;
+		const uint32_t begin = obstacle_grid.cell_starts[row + from_x];
+		const uint32_t end = obstacle_grid.cell_starts[row + to_x + 1];
+
+		for (uint32_t entry = begin; entry < end; entry++) {
+			const RVO2D::Obstacle2D *obstacle = obstacle_cell_entries[entry];
+			const RVO2D::Obstacle2D *next_obstacle = obstacle->nextObstacle_;
+
+			// Like the RVO2 obstacle tree, only obstacles that the agent sees from their right side are considered.
+			if (RVO2D::leftOf(obstacle->point_, next_obstacle->point_, agent_position) >= 0.0f) {
+				continue;
+			}
+			// Same filters as RVO2D::Agent2D::insertObstacleNeighbor().
+			if ((agent_mask & next_obstacle->avoidance_layers_) == 0) {
+				continue;
+			}
+			if ((agent_elevation > obstacle->elevation_ + obstacle->height_) || (agent_elevation + agent_height < obstacle->elevation_)) {
+				continue;
+			}
+
+			const float distance_squared = RVO2D::distSqPointLineSegment(obstacle->point_, next_obstacle->point_, agent_position);
+			if (distance_squared >= range_squared) {
+				continue;
+			}
+
+			// Segments spanning several cells are found once per cell.
+			bool known = false;
+			for (const ObstacleNeighbor &neighbor : neighbors) {
+				if (neighbor.obstacle == obstacle) {
+					known = true;
+					break;
+				}
+			}
+			if (known) {
+				continue;
+			}
+
+			neighbors.push_back(ObstacleNeighbor());
+			uint32_t slot = neighbors.size() - 1;
+			while (slot != 0 && distance_squared < neighbors[slot - 1].distance_squared) {
+				neighbors[slot] = neighbors[slot - 1];
+				slot--;
+			}
+			neighbors[slot].distance_squared = distance_squared;
+			neighbors[slot].obstacle = obstacle;
+		}
+	}
+}
+
+uint32_t NavBatchAvoidance2D::_compute_orca_lines(uint32_t p_agent, const Scratch &p_scratch, Lines &r_lines) const {
+	// This follows RVO2D::Agent2D::computeNewVelocity() step by step, so both solvers give the same velocities.
+	r_lines.clear();
+
+	const RVO2D::Vector2 position(position_x[p_agent], position_y[p_agent]);
+	const RVO2D::Vector2 velocity(velocity_x[p_agent], velocity_y[p_agent]);
+	const float agent_radius = radius[p_agent];
+	const float radius_squared = agent_radius * agent_radius;
+	const float inv_time_horizon_obstacles = 1.0f / time_horizon_obstacles[p_agent];
+
+	// Create obstacle ORCA lines.
+	for (const ObstacleNeighbor &neighbor : p_scratch.obstacle_neighbors) {
+		const RVO2D::Obstacle2D *obstacle_1 = neighbor.obstacle;
+		const RVO2D::Obstacle2D *obstacle_2 = obstacle_1->nextObstacle_;
+
+		const RVO2D::Vector2 relative_position_1 = obstacle_1->point_ - position;
+		const RVO2D::Vector2 relative_position_2 = obstacle_2->point_ - position;
+
+		// Check if velocity obstacle of obstacle is already taken care of by previously constructed obstacle ORCA lines.
+		bool already_covered = false;
+		for (uint32_t j = 0; j < r_lines.size(); j++) {
+			const RVO2D::Vector2 line_point(r_lines.point_x[j], r_lines.point_y[j]);
+			const RVO2D::Vector2 line_direction(r_lines.direction_x[j], r_lines.direction_y[j]);
+			if (RVO2D::det(inv_time_horizon_obstacles * relative_position_1 - line_point, line_direction) - inv_time_horizon_obstacles * agent_radius >= -RVO_EPSILON && RVO2D::det(inv_time_horizon_obstacles * relative_position_2 - line_point, line_direction) - inv_time_horizon_obstacles * agent_radius >= -RVO_EPSILON) {
+				already_covered = true;
+				break;
+			}
+		}
+		if (already_covered) {
+			continue;
+		}
+
+		// Not yet covered. Check for collisions.
+		const float distance_squared_1 = RVO2D::absSq(relative_position_1);
+		const float distance_squared_2 = RVO2D::absSq(relative_position_2);
+
+		const RVO2D::Vector2 obstacle_vector = obstacle_2->point_ - obstacle_1->point_;
+		const float s = (-relative_position_1 * obstacle_vector) / RVO2D::absSq(obstacle_vector);
+		const float distance_squared_line = RVO2D::absSq(-relative_position_1 - s * obstacle_vector);
+
+		if (s < 0.0f && distance_squared_1 <= radius_squared) {
+			// Collision with left vertex. Ignore if non-convex.
+			if (obstacle_1->isConvex_) {
+				const RVO2D::Vector2 direction = RVO2D::normalize(RVO2D::Vector2(-relative_position_1.y(), relative_position_1.x()));
+				r_lines.push_back(0.0f, 0.0f, direction.x(), direction.y());
+			}
+			continue;
+		} else if (s > 1.0f && distance_squared_2 <= radius_squared) {
+			// Collision with right vertex. Ignore if non-convex or if it will be taken care of by neighboring obstacle.
+			if (obstacle_2->isConvex_ && RVO2D::det(relative_position_2, obstacle_2->unitDir_) >= 0.0f) {
+				const RVO2D::Vector2 direction = RVO2D::normalize(RVO2D::Vector2(-relative_position_2.y(), relative_position_2.x()));
+				r_lines.push_back(0.0f, 0.0f, direction.x(), direction.y());
+			}
+			continue;
+		} else if (s >= 0.0f && s < 1.0f && distance_squared_line <= radius_squared) {
+			// Collision with obstacle segment.
+			r_lines.push_back(0.0f, 0.0f, -obstacle_1->unitDir_.x(), -obstacle_1->unitDir_.y());
+			continue;
+		}
+
+		// No collision. Compute legs. When obliquely viewed, both legs can come from a single vertex. Legs extend cut-off line when non-convex vertex.
+		RVO2D::Vector2 left_leg_direction;
+		RVO2D::Vector2 right_leg_direction;
+
+		if (s < 0.0f && distance_squared_line <= radius_squared) {
+			// Obstacle viewed obliquely so that left vertex defines velocity obstacle.
+			if (!obstacle_1->isConvex_) {
+				continue;
+			}
+
+			obstacle_2 = obstacle_1;
+
+			const float leg_1 = std::sqrt(distance_squared_1 - radius_squared);
+			left_leg_direction = RVO2D::Vector2(relative_position_1.x() * leg_1 - relative_position_1.y() * agent_radius, relative_position_1.x() * agent_radius + relative_position_1.y() * leg_1) / distance_squared_1;
+			right_leg_direction = RVO2D::Vector2(relative_position_1.x() * leg_1 + relative_position_1.y() * agent_radius, -relative_position_1.x() * agent_radius + relative_position_1.y() * leg_1) / distance_squared_1;
+		} else if (s > 1.0f && distance_squared_line <= radius_squared) {
+			// Obstacle viewed obliquely so that right vertex defines velocity obstacle.
+			if (!obstacle_2->isConvex_) {
+				continue;
+			}
+
+			obstacle_1 = obstacle_2;
+
+			const float leg_2 = std::sqrt(distance_squared_2 - radius_squared);
+			left_leg_direction = RVO2D::Vector2(relative_position_2.x() * leg_2 - relative_position_2.y() * agent_radius, relative_position_2.x() * agent_radius + relative_position_2.y() * leg_2) / distance_squared_2;
+			right_leg_direction = RVO2D::Vector2(relative_position_2.x() * leg_2 + relative_position_2.y() * agent_radius, -relative_position_2.x() * agent_radius + relative_position_2.y() * leg_2) / distance_squared_2;
+		} else {
+			// Usual situation.
+			if (obstacle_1->isConvex_) {
+				const float leg_1 = std::sqrt(distance_squared_1 - radius_squared);
+				left_leg_direction = RVO2D::Vector2(relative_position_1.x() * leg_1 - relative_position_1.y() * agent_radius, relative_position_1.x() * agent_radius + relative_position_1.y() * leg_1) / distance_squared_1;
+			} else {
+				// Left vertex non-convex; left leg extends cut-off line.
+				left_leg_direction = -obstacle_1->unitDir_;
+			}
+
+			if (obstacle_2->isConvex_) {
+				const float leg_2 = std::sqrt(distance_squared_2 - radius_squared);
+				right_leg_direction = RVO2D::Vector2(relative_position_2.x() * leg_2 + relative_position_2.y() * agent_radius, -relative_position_2.x() * agent_radius + relative_position_2.y() * leg_2) / distance_squared_2;
+			} else {
+				// Right vertex non-convex; right leg extends cut-off line.
+				right_leg_direction = obstacle_1->unitDir_;
+			}
+		}
+
+		// Legs can never point into neighboring edge when convex vertex, take cutoff-line of neighboring edge instead. If velocity projected on "foreign" leg, no constraint is added.
+		const RVO2D::Obstacle2D *const left_neighbor = obstacle_1->prevObstacle_;
+
+		bool is_left_leg_foreign = false;
+		bool is_right_leg_foreign = false;
+
+		if (obstacle_1->isConvex_ && RVO2D::det(left_leg_direction, -left_neighbor->unitDir_) >= 0.0f) {
+			// Left leg points into obstacle.
+			left_leg_direction = -left_neighbor->unitDir_;
+			is_left_leg_foreign = true;
+		}
+
+		if (obstacle_2->isConvex_ && RVO2D::det(right_leg_direction, obstacle_2->unitDir_) <= 0.0f) {
+			// Right leg points into obstacle.
+			right_leg_direction = obstacle_2->unitDir_;
+			is_right_leg_foreign = true;
+		}
+
+		// Compute cut-off centers.
+		const RVO2D::Vector2 left_cutoff = inv_time_horizon_obstacles * (obstacle_1->point_ - position);
+		const RVO2D::Vector2 right_cutoff = inv_time_horizon_obstacles * (obstacle_2->point_ - position);
+		const RVO2D::Vector2 cutoff_vector = right_cutoff - left_cutoff;
+
+		// Project current velocity on velocity obstacle. Check if current velocity is projected on cutoff circles.
+		const float t = (obstacle_1 == obstacle_2 ? 0.5f : ((velocity - left_cutoff) * cutoff_vector) / RVO2D::absSq(cutoff_vector));
+		const float t_left = ((velocity - left_cutoff) * left_leg_direction);
+		const float t_right = ((velocity - right_cutoff) * right_leg_direction);
+
+		if ((t < 0.0f && t_left < 0.0f) || (obstacle_1 == obstacle_2 && t_left < 0.0f && t_right < 0.0f)) {
+			// Project on left cut-off circle.
+			const RVO2D::Vector2 unit_w = RVO2D::normalize(velocity - left_cutoff);
+			const RVO2D::Vector2 point = left_cutoff + agent_radius * inv_time_horizon_obstacles * unit_w;
+			r_lines.push_back(point.x(), point.y(), unit_w.y(), -unit_w.x());
+			continue;
+		} else if (t > 1.0f && t_right < 0.0f) {
+			// Project on right cut-off circle.
+			const RVO2D::Vector2 unit_w = RVO2D::normalize(velocity - right_cutoff);
+			const RVO2D::Vector2 point = right_cutoff + agent_radius * inv_time_horizon_obstacles * unit_w;
+			r_lines.push_back(point.x(), point.y(), unit_w.y(), -unit_w.x());
+			continue;
+		}
+
+		// Project on left leg, right leg, or cut-off line, whichever is closest to velocity.
+		const float distance_squared_cutoff = ((t < 0.0f || t > 1.0f || obstacle_1 == obstacle_2) ? std::numeric_limits<float>::infinity() : RVO2D::absSq(velocity - (left_cutoff + t * cutoff_vector)));
+		const float distance_squared_left = ((t_left < 0.0f) ? std::numeric_limits<float>::infinity() : RVO2D::absSq(velocity - (left_cutoff + t_left * left_leg_direction)));
+		const float distance_squared_right = ((t_right < 0.0f) ? std::numeric_limits<float>::infinity() : RVO2D::absSq(velocity - (right_cutoff + t_right * right_leg_direction)));
+
+		if (distance_squared_cutoff <= distance_squared_left && distance_squared_cutoff <= distance_squared_right) {
+			// Project on cut-off line.
+			const RVO2D::Vector2 direction = -obstacle_1->unitDir_;
+			const RVO2D::Vector2 point = left_cutoff + agent_radius * inv_time_horizon_obstacles * RVO2D::Vector2(-direction.y(), direction.x());
+			r_lines.push_back(point.x(), point.y(), direction.x(), direction.y());
+		} else if (distance_squared_left <= distance_squared_right) {
+			// Project on left leg.
+			if (is_left_leg_foreign) {
+				continue;
+			}
+			const RVO2D::Vector2 point = left_cutoff + agent_radius * inv_time_horizon_obstacles * RVO2D::Vector2(-left_leg_direction.y(), left_leg_direction.x());
+			r_lines.push_back(point.x(), point.y(), left_leg_direction.x(), left_leg_direction.y());
+		} else {
+			// Project on right leg.
+			if (is_right_leg_foreign) {
+				continue;
+			}
+			const RVO2D::Vector2 direction = -right_leg_direction;
+			const RVO2D::Vector2 point = right_cutoff + agent_radius * inv_time_horizon_obstacles * RVO2D::Vector2(-direction.y(), direction.x());
+			r_lines.push_back(point.x(), point.y(), direction.x(), direction.y());
+		}
+	}
+
+	const uint32_t obstacle_line_count = r_lines.size();
+
+	// Create agent ORCA lines. The neighbor data is read from the arrays of the previous step.
+	const float inv_time_horizon = 1.0f / time_horizon[p_agent];
+	const float inv_time_step = 1.0f / time_step;
+
+	for (const AgentNeighbor &neighbor : p_scratch.agent_neighbors) {
+		const uint32_t other = neighbor.agent;
+
+		const float relative_position_x = position_x[other] - position.x();
+		const float relative_position_y = position_y[other] - position.y();
+		const float relative_velocity_x = velocity.x() - velocity_x[other];
+		const float relative_velocity_y = velocity.y() - velocity_y[other];
+		const float distance_squared = relative_position_x * relative_position_x + relative_position_y * relative_position_y;
+		const float combined_radius = agent_radius + radius[other];
+		const float combined_radius_squared = combined_radius * combined_radius;
+
+		float direction_x;
+		float direction_y;
+		float u_x;
+		float u_y;
+
+		if (distance_squared > combined_radius_squared) {
+			// No collision. Vector from cutoff center to relative velocity.
+			const float w_x = relative_velocity_x - inv_time_horizon * relative_position_x;
+			const float w_y = relative_velocity_y - inv_time_horizon * relative_position_y;
+			const float w_length_squared = w_x * w_x + w_y * w_y;
+			const float dot_product_1 = w_x * relative_position_x + w_y * relative_position_y;
+
+			if (dot_product_1 < 0.0f && dot_product_1 * dot_product_1 > combined_radius_squared * w_length_squared) {
+				// Project on cut-off circle.
+				const float w_length = std::sqrt(w_length_squared);
+				const float unit_w_x = w_x / w_length;
+				const float unit_w_y = w_y / w_length;
+
+				direction_x = unit_w_y;
+				direction_y = -unit_w_x;
+				u_x = (combined_radius * inv_time_horizon - w_length) * unit_w_x;
+				u_y = (combined_radius * inv_time_horizon - w_length) * unit_w_y;
+			} else {
+				// Project on legs.
+				const float leg = std::sqrt(distance_squared - combined_radius_squared);
+
+				if (relative_position_x * w_y - relative_position_y * w_x > 0.0f) {
+					// Project on left leg.
+					direction_x = (relative_position_x * leg - relative_position_y * combined_radius) / distance_squared;
+					direction_y = (relative_position_x * combined_radius + relative_position_y * leg) / distance_squared;
+				} else {
+					// Project on right leg.
+					direction_x = -(relative_position_x * leg + relative_position_y * combined_radius) / distance_squared;
+					direction_y = -(-relative_position_x * combined_radius + relative_position_y * leg) / distance_squared;
+				}
+
+				const float dot_product_2 = relative_velocity_x * direction_x + relative_velocity_y * direction_y;
+				u_x = dot_product_2 * direction_x - relative_velocity_x;
+				u_y = dot_product_2 * direction_y - relative_velocity_y;
+			}
+		} else {
+			// Collision. Project on cut-off circle of time step.
+			const float w_x = relative_velocity_x - inv_time_step * relative_position_x;
+			const float w_y = relative_velocity_y - inv_time_step * relative_position_y;
+			const float w_length = std::sqrt(w_x * w_x + w_y * w_y);
+			const float unit_w_x = w_x / w_length;
+			const float unit_w_y = w_y / w_length;
+
+			direction_x = unit_w_y;
+			direction_y = -unit_w_x;
+			u_x = (combined_radius * inv_time_step - w_length) * unit_w_x;
+			u_y = (combined_radius * inv_time_step - w_length) * unit_w_y;
+		}
+
+		r_lines.push_back(velocity.x() + 0.5f * u_x, velocity.y() + 0.5f * u_y, direction_x, direction_y);
+	}
+
+	return obstacle_line_count;
+}
+
+void NavBatchAvoidance2D::_compute_new_velocities(uint32_t p_first_agent, uint32_t p_agent_count, Scratch &r_scratch, float *r_velocity_x, float *r_velocity_y) const {
+#ifdef SIMD_FLOAT
+	float lane_max_speed[SOLVER_LANES];
+	float lane_preferred_velocity_x[SOLVER_LANES];
+	float lane_preferred_velocity_y[SOLVER_LANES];
+	float lane_obstacle_line_count[SOLVER_LANES];
+	uint32_t line_count = 0;
+	uint32_t obstacle_line_count = 0;
+
+	for (uint32_t lane = 0; lane < SOLVER_LANES; lane++) {
+		Lines &lines = r_scratch.lines[lane];
+		lines.clear();
+		lane_max_speed[lane] = 0.0f;
+		lane_preferred_velocity_x[lane] = 0.0f;
+		lane_preferred_velocity_y[lane] = 0.0f;
+		lane_obstacle_line_count[lane] = 0.0f;
+
+		if (lane < p_agent_count) {
+			const uint32_t agent = p_first_agent + lane;
+			_compute_obstacle_neighbors(agent, r_scratch);
+			_compute_agent_neighbors(agent, r_scratch);
+			const uint32_t agent_obstacle_line_count = _compute_orca_lines(agent, r_scratch, lines);
+
+			lane_max_speed[lane] = max_speed[agent];
+			lane_preferred_velocity_x[lane] = preferred_velocity_x[agent];
+			lane_preferred_velocity_y[lane] = preferred_velocity_y[agent];
+			lane_obstacle_line_count[lane] = float(agent_obstacle_line_count);
+			obstacle_line_count = MAX(obstacle_line_count, agent_obstacle_line_count);
+		}
+		line_count = MAX(line_count, lines.size());
+	}
+
+	// Interleave the lines of the lanes. Lanes with fewer lines are padded with zero lines, which never constrain the result.
+	Lines &lane_lines = r_scratch.lane_lines;
+	lane_lines.resize(line_count * SOLVER_LANES);
+	for (uint32_t lane = 0; lane < SOLVER_LANES; lane++) {
+		const Lines &lines = r_scratch.lines[lane];
+		for (uint32_t i = 0; i < line_count; i++) {
+			const uint32_t slot = i * SOLVER_LANES + lane;
+			const bool valid = i < lines.size();
+			lane_lines.point_x[slot] = valid ? lines.point_x[i] : 0.0f;
+			lane_lines.point_y[slot] = valid ? lines.point_y[i] : 0.0f;
+			lane_lines.direction_x[slot] = valid ? lines.direction_x[i] : 0.0f;
+			lane_lines.direction_y[slot] = valid ? lines.direction_y[i] : 0.0f;
+		}
+	}
+
+	const LaneLines lines = { lane_lines.point_x.ptr(), lane_lines.point_y.ptr(), lane_lines.direction_x.ptr(), lane_lines.direction_y.ptr(), line_count };
+	const SIMD_FLOAT lane_radius = SIMD_LOAD(lane_max_speed);
+	const SIMD_MASK lanes = SIMD_LESS(SIMD_LOAD(lane_ids), SIMD_SET1(float(p_agent_count)));
+
+	SIMD_FLOAT result_x;
+	SIMD_FLOAT result_y;
+	SIMD_FLOAT line_fail;
+	const SIMD_MASK failed = _linear_program_2_x4(lines, lanes, lane_radius, SIMD_LOAD(lane_preferred_velocity_x), SIMD_LOAD(lane_preferred_velocity_y), false, result_x, result_y, line_fail);
+
+	if (SIMD_MASK_BITS(failed) != 0) {
+		Lines &lane_projected_lines = r_scratch.lane_projected_lines;
+		lane_projected_lines.resize(line_count * SOLVER_LANES);
+		const LaneLines projected_lines = { lane_projected_lines.point_x.ptr(), lane_projected_lines.point_y.ptr(), lane_projected_lines.direction_x.ptr(), lane_projected_lines.direction_y.ptr(), 0 };
+
+		_linear_program_3_x4(lines, SIMD_LOAD(lane_obstacle_line_count), obstacle_line_count, failed, line_fail, lane_radius, projected_lines, result_x, result_y);
+	}
+
+	float lane_result_x[SOLVER_LANES];
+	float lane_result_y[SOLVER_LANES];
+	SIMD_STORE(lane_result_x, result_x);
+	SIMD_STORE(lane_result_y, result_y);
+	for (uint32_t lane = 0; lane < p_agent_count; lane++) {
+		r_velocity_x[lane] = lane_result_x[lane];
+		r_velocity_y[lane] = lane_result_y[lane];
+	}
+#else
+	for (uint32_t lane = 0; lane < p_agent_count; lane++) {
+		const uint32_t agent = p_first_agent + lane;
+		_compute_obstacle_neighbors(agent, r_scratch);
+		_compute_agent_neighbors(agent, r_scratch);
+
+		Lines &lines = r_scratch.lines[0];
+		const uint32_t obstacle_line_count = _compute_orca_lines(agent, r_scratch, lines);
+
+		float result_x = 0.0f;
+		float result_y = 0.0f;
+		const uint32_t line_fail = _linear_program_2(lines, max_speed[agent], preferred_velocity_x[agent], preferred_velocity_y[agent], false, result_x, result_y);
+
+		if (line_fail < lines.size()) {
+			_linear_program_3(lines, obstacle_line_count, line_fail, max_speed[agent], r_scratch.projected_lines, result_x, result_y);
+		}
+
+		r_velocity_x[lane] = result_x;
+		r_velocity_y[lane] = result_y;
+	}
+#endif
+}
+
+bool NavBatchAvoidance2D::_linear_program_1(const Lines &p_lines, uint32_t p_line, float p_radius, float p_opt_x, float p_opt_y, bool p_direction_opt, float &r_x, float &r_y) {
+	const float point_x = p_lines.point_x[p_line];
+	const float point_y = p_lines.point_y[p_line];
+	const float direction_x = p_lines.direction_x[p_line];
+	const float direction_y = p_lines.direction_y[p_line];
+
+	const float dot_product = point_x * direction_x + point_y * direction_y;
+	const float discriminant = dot_product * dot_product + p_radius * p_radius - (point_x * point_x + point_y * point_y);
+
+	if (discriminant < 0.0f) {
+		// Max speed circle fully invalidates line.
+		return false;
+	}
+
+	const float sqrt_discriminant = std::sqrt(discriminant);
+	float t_left = -dot_product - sqrt_discriminant;
+	float t_right = -dot_product + sqrt_discriminant;
+
+	const float *other_point_x = p_lines.point_x.ptr();
+	const float *other_point_y = p_lines.point_y.ptr();
+	const float *other_direction_x = p_lines.direction_x.ptr();
+	const float *other_direction_y = p_lines.direction_y.ptr();
+
+	for (uint32_t i = 0; i < p_line; i++) {
+		const float denominator = direction_x * other_direction_y[i] - direction_y * other_direction_x[i];
+		const float numerator = other_direction_x[i] * (point_y - other_point_y[i]) - other_direction_y[i] * (point_x - other_point_x[i]);
+
+		if (std::fabs(denominator) <= RVO_EPSILON) {
+			// Lines are (almost) parallel.
+			if (numerator < 0.0f) {
+				return false;
+			}
+			continue;
+		}
+
+		const float t = numerator / denominator;
+
+		if (denominator >= 0.0f) {
+			// Line i bounds the line on the right.
+			t_right = MIN(t_right, t);
+		} else {
+			// Line i bounds the line on the left.
+			t_left = MAX(t_left, t);
+		}
+
+		if (t_left > t_right) {
+			return false;
+		}
+	}
+
+	float t;
+	if (p_direction_opt) {
+		// Optimize direction.
+		t = (p_opt_x * direction_x + p_opt_y * direction_y > 0.0f) ? t_right : t_left;
+	} else {
+		// Optimize closest point.
+		t = direction_x * (p_opt_x - point_x) + direction_y * (p_opt_y - point_y);
+		if (t < t_left) {
+			t = t_left;
+		} else if (t > t_right) {
+			t = t_right;
+		}
+	}
+
+	r_x = point_x + t * direction_x;
+	r_y = point_y + t * direction_y;
+	return true;
+}
+
+uint32_t NavBatchAvoidance2D::_linear_program_2(const Lines &p_lines, float p_radius, float p_opt_x, float p_opt_y, bool p_direction_opt, float &r_x, float &r_y) {
+	const float opt_length_squared = p_opt_x * p_opt_x + p_opt_y * p_opt_y;
+
+	if (p_direction_opt) {
+		// Optimize direction. Note that the optimization velocity is of unit length in this case.
+		r_x = p_opt_x * p_radius;
+		r_y = p_opt_y * p_radius;
+	} else if (opt_length_squared > p_radius * p_radius) {
+		// Optimize closest point and outside circle.
+		const float opt_length = std::sqrt(opt_length_squared);
+		r_x = p_opt_x / opt_length * p_radius;
+		r_y = p_opt_y / opt_length * p_radius;
+	} else {
+		// Optimize closest point and inside circle.
+		r_x = p_opt_x;
+		r_y = p_opt_y;
+	}
+
+	for (uint32_t i = 0; i < p_lines.size(); i++) {
+		if (p_lines.direction_x[i] * (p_lines.point_y[i] - r_y) - p_lines.direction_y[i] * (p_lines.point_x[i] - r_x) > 0.0f) {
+			// Result does not satisfy constraint i. Compute new optimal result.
+			const float previous_x = r_x;
+			const float previous_y = r_y;
+
+			if (!_linear_program_1(p_lines, i, p_radius, p_opt_x, p_opt_y, p_direction_opt, r_x, r_y)) {
+				r_x = previous_x;
+				r_y = previous_y;
+				return i;
+			}
+		}
+	}
+
+	return p_lines.size();
+}
+
+void NavBatchAvoidance2D::_linear_program_3(const Lines &p_lines, uint32_t p_obstacle_line_count, uint32_t p_begin_line, float p_radius, Lines &r_projected_lines, float &r_x, float &r_y) {
+	float distance = 0.0f;
+
+	for (uint32_t i = p_begin_line; i < p_lines.size(); i++) {
+		const float point_x = p_lines.point_x[i];
+		const float point_y = p_lines.point_y[i];
+		const float direction_x = p_lines.direction_x[i];
+		const float direction_y = p_lines.direction_y[i];
+
+		if (direction_x * (point_y - r_y) - direction_y * (point_x - r_x) <= distance) {
+			continue;
+		}
+
+		// Result does not satisfy constraint of line i.
+		r_projected_lines.clear();
+		for (uint32_t j = 0; j < p_obstacle_line_count; j++) {
+			r_projected_lines.push_back(p_lines.point_x[j], p_lines.point_y[j], p_lines.direction_x[j], p_lines.direction_y[j]);
+		}
+
+		for (uint32_t j = p_obstacle_line_count; j < i; j++) {
+			const float other_point_x = p_lines.point_x[j];
+			const float other_point_y = p_lines.point_y[j];
+			const float other_direction_x = p_lines.direction_x[j];
+			const float other_direction_y = p_lines.direction_y[j];
+
+			float projected_point_x;
+			float projected_point_y;
+
+			const float determinant = direction_x * other_direction_y - direction_y * other_direction_x;
+
+			if (std::fabs(determinant) <= RVO_EPSILON) {
+				// Line i and line j are parallel.
+				if (direction_x * other_direction_x + direction_y * other_direction_y > 0.0f) {
+					// Line i and line j point in the same direction.
+					continue;
+				}
+				// Line i and line j point in opposite direction.
+				projected_point_x = 0.5f * (point_x + other_point_x);
+				projected_point_y = 0.5f * (point_y + other_point_y);
+			} else {
+				const float t = (other_direction_x * (point_y - other_point_y) - other_direction_y * (point_x - other_point_x)) / determinant;
+				projected_point_x = point_x + t * direction_x;
+				projected_point_y = point_y + t * direction_y;
+			}
+
+			const RVO2D::Vector2 projected_direction = RVO2D::normalize(RVO2D::Vector2(other_direction_x - direction_x, other_direction_y - direction_y));
+			r_projected_lines.push_back(projected_point_x, projected_point_y, projected_direction.x(), projected_direction.y());
+		}
+
+		const float previous_x = r_x;
+		const float previous_y = r_y;
+
+		if (_linear_program_2(r_projected_lines, p_radius, -direction_y, direction_x, true, r_x, r_y) < r_projected_lines.size()) {
+			// This should in principle not happen. The result is by definition already in the feasible region of this linear program. If it fails, it is due to small floating point error, and the current result is kept.
+			r_x = previous_x;
+			r_y = previous_y;
+		}
+
+		distance = direction_x * (point_y - r_y) - direction_y * (point_x - r_x);
+	}
+}
@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*  nav_batch_avoidance_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_BATCH_AVOIDANCE_2D_H
+#define NAV_BATCH_AVOIDANCE_2D_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+#include <Agent2d.h>
+#include <Obstacle2d.h>
+
+/// Alternative solver for the 2D (XZ plane) avoidance agents of a map.
+///
+/// It computes the same ORCA velocities as the RVO2 agents, but copies the
+/// agents into structure-of-arrays buffers first, sorted by the cells of a
+/// uniform neighbor grid. The grid replaces the RVO2 k-d trees and is built
+/// in parallel. Agents of one grid block are solved together, so the
+/// neighbors an agent reads are mostly already in cache. Where SSE2 or NEON
+/// is available, the linear programs of SOLVER_LANES agents are solved at
+/// once, one agent per SIMD lane. All agents read the velocities of the
+/// previous step, so unlike the RVO2 solver the result does not depend on
+/// the order in which the worker threads reach the agents.
+///
+/// The 3D avoidance agents keep using the RVO2 3D solver.
+///
+/// The RVO2 agents stay the owners of the agent state. The solver reads
+/// their properties, and writes the new velocity and position back like
+/// `RVO2D::Agent2D::update()` does.
+class NavBatchAvoidance2D {
+	static const uint32_t AGENT_BLOCK_SIZE = 64;
+	static const uint32_t SOLVER_LANES = 4;
+	static const uint32_t MAX_GRID_DIMENSION = 1024;
+
+	struct AgentNeighbor {
+		float distance_squared = 0.0f;
+		uint32_t agent = 0;
+	};
+
+	struct ObstacleNeighbor {
+		float distance_squared = 0.0f;
+		const RVO2D::Obstacle2D *obstacle = nullptr;
+	};
+
+	/// ORCA half-planes in structure-of-arrays layout.
+	struct Lines {
+		LocalVector<float> point_x;
+		LocalVector<float> point_y;
+		LocalVector<float> direction_x;
+		LocalVector<float> direction_y;
+
+		uint32_t size() const { return point_x.size(); }
+		void clear();
+		void resize(uint32_t p_size);
+		void push_back(float p_point_x, float p_point_y, float p_direction_x, float p_direction_y);
+	};
+
+	/// Buffers of one solving task, reused for all agents of a block.
+	struct Scratch {
+		LocalVector<AgentNeighbor> agent_neighbors;
+		LocalVector<ObstacleNeighbor> obstacle_neighbors;
+		Lines lines[SOLVER_LANES];
+		Lines projected_lines;
+		// The lines of all lanes, interleaved so that line k of every lane is at k * SOLVER_LANES + lane.
+		Lines lane_lines;
+		Lines lane_projected_lines;
+	};
+
+	struct Grid {
+		float min_x = 0.0f;
+		float min_y = 0.0f;
+		float cell_size = 1.0f;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		/// Start of the entries of each cell, with one extra entry for the end of the last cell.
+		LocalVector<uint32_t> cell_starts;
+
+		void setup(float p_min_x, float p_min_y, float p_max_x, float p_max_y, float p_cell_size);
+		uint32_t get_cell_x(float p_x) const;
+		uint32_t get_cell_y(float p_y) const;
+	};
+
+	// Agents sorted by grid cell.
+	LocalVector<RVO2D::Agent2D *> agents;
+	LocalVector<float> position_x;
+	LocalVector<float> position_y;
+	LocalVector<float> velocity_x;
+	LocalVector<float> velocity_y;
+	LocalVector<float> preferred_velocity_x;
+	LocalVector<float> preferred_velocity_y;
+	LocalVector<float> radius;
+	LocalVector<float> max_speed;
+	LocalVector<float> neighbor_distance;
+	LocalVector<float> time_horizon;
+	LocalVector<float> time_horizon_obstacles;
+	LocalVector<float> elevation;
+	LocalVector<float> height;
+	LocalVector<float> priority;
+	LocalVector<uint32_t> max_neighbors;
+	LocalVector<uint32_t> layers;
+	LocalVector<uint32_t> mask;
+
+	// Cell, and index among the agents of its cell, of every agent in input order.
+	LocalVector<uint32_t> agent_cells;
+	LocalVector<uint32_t> agent_cell_slots;
+	LocalVector<SafeNumeric<uint32_t>> agent_cell_counts;
+	// Input index of every sorted agent.
+	LocalVector<uint32_t> agent_indices;
+	Grid agent_grid;
+
+	LocalVector<const RVO2D::Obstacle2D *> obstacle_cell_entries;
+	Grid obstacle_grid;
+
+	float time_step = 0.0f;
+
+	void _compute_agent_cell(uint32_t p_index, RVO2D::Agent2D *const *p_agents);
+	void _scatter_agent(uint32_t p_index, void *p_unused);
+	void _sort_agent_row(uint32_t p_row, void *p_unused);
+	void _gather_agent(uint32_t p_index, RVO2D::Agent2D *const *p_agents);
+	void _solve_agent_block(uint32_t p_block, void *p_unused);
+
+	void _compute_agent_neighbors(uint32_t p_agent, Scratch &r_scratch) const;
+	void _compute_obstacle_neighbors(uint32_t p_agent, Scratch &r_scratch) const;
+	uint32_t _compute_orca_lines(uint32_t p_agent, const Scratch &p_scratch, Lines &r_lines) const;
+	void _compute_new_velocities(uint32_t p_first_agent, uint32_t p_agent_count, Scratch &r_scratch, float *r_velocity_x, float *r_velocity_y) const;
+
+	static bool _linear_program_1(const Lines &p_lines, uint32_t p_line, float p_radius, float p_opt_x, float p_opt_y, bool p_direction_opt, float &r_x, float &r_y);
+	static uint32_t _linear_program_2(const Lines &p_lines, float p_radius, float p_opt_x, float p_opt_y, bool p_direction_opt, float &r_x, float &r_y);
+	static void _linear_program_3(const Lines &p_lines, uint32_t p_obstacle_line_count, uint32_t p_begin_line, float p_radius, Lines &r_projected_lines, float &r_x, float &r_y);
+
+public:
+	/// Builds the obstacle grid. The obstacles must be the ones of the RVO2 simulation after its obstacle tree was built, as the tree splits obstacles.
+	void set_obstacles(const std::vector<RVO2D::Obstacle2D *> &p_obstacles);
+
+	/// Computes and applies the new velocities of all agents.
+	void solve(RVO2D::Agent2D *const *p_agents, uint32_t p_agent_count, float p_time_step, bool p_use_threads, bool p_use_high_priority_threads);
+};
+
+#endif // NAV_BATCH_AVOIDANCE_2D_H
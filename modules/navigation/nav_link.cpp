@@ -59,6 +59,36 @@ void NavLink::set_enabled(bool p_enabled) {
 	link_dirty = true;
 };
 
+void NavLink::set_navigation_layers(uint32_t p_navigation_layers) {
+	if (navigation_layers == p_navigation_layers) {
+		return;
+	}
+	NavBase::set_navigation_layers(p_navigation_layers);
+	if (map) {
+		map->invalidate_path_caches();
+	}
+}
+
+void NavLink::set_enter_cost(real_t p_enter_cost) {
+	if (enter_cost == MAX(p_enter_cost, 0.0)) {
+		return;
+	}
+	NavBase::set_enter_cost(p_enter_cost);
+	if (map) {
+		map->invalidate_path_caches();
+	}
+}
+
+void NavLink::set_travel_cost(real_t p_travel_cost) {
+	if (travel_cost == MAX(p_travel_cost, 0.0)) {
+		return;
+	}
+	NavBase::set_travel_cost(p_travel_cost);
+	if (map) {
+		map->invalidate_path_caches();
+	}
+}
+
 void NavLink::set_bidirectional(bool p_bidirectional) {
 	if (bidirectional == p_bidirectional) {
 		return;
@@ -56,6 +56,10 @@ public:
 	void set_enabled(bool p_enabled);
 	bool get_enabled() const { return enabled; }
 
+	void set_navigation_layers(uint32_t p_navigation_layers) override;
+	void set_enter_cost(real_t p_enter_cost) override;
+	void set_travel_cost(real_t p_travel_cost) override;
+
 	void set_bidirectional(bool p_bidirectional);
 	bool is_bidirectional() const {
 		return bidirectional;
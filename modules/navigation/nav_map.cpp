@@ -103,6 +103,7 @@ void NavMap::set_use_edge_connections(bool p_enabled) {
 		return;
 	}
 	use_edge_connections = p_enabled;
+	regenerate_connections = true;
 	regenerate_links = true;
 }
 
@@ -111,9 +112,26 @@ void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
 		return;
 	}
 	edge_connection_margin = p_edge_connection_margin;
+	regenerate_connections = true;
 	regenerate_links = true;
 }
 
+void NavMap::set_use_hierarchical_pathfinding(bool p_enabled) {
+	if (use_hierarchical_pathfinding == p_enabled) {
+		return;
+	}
+	use_hierarchical_pathfinding = p_enabled;
+	regenerate_links = true;
+}
+
+void NavMap::set_use_path_corridor_cache(bool p_enabled) {
+	if (use_path_corridor_cache == p_enabled) {
+		return;
+	}
+	use_path_corridor_cache = p_enabled;
+	_clear_path_corridors();
+}
+
 void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
 	if (link_connection_radius == p_link_connection_radius) {
 		return;
@@ -135,6 +153,696 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
+void NavMap::PathQuerySlot::begin_search() {
+	traversable_polys.clear();
+	generation++;
+	if (unlikely(generation == 0)) {
+		// Wrapped around, forget every older search for good.
+		for (gd::NavigationPoly &navigation_poly : navigation_polys) {
+			navigation_poly.generation = 0;
+		}
+		generation = 1;
+	}
+}
+
+void NavMap::PathQuerySlot::begin_hierarchy_search() {
+	hierarchy_open.clear();
+	hierarchy_generation++;
+	if (unlikely(hierarchy_generation == 0)) {
+		for (HierarchyNode &node : hierarchy_nodes) {
+			node.generation = 0;
+			node.exit_generation = 0;
+		}
+		for (uint32_t &corridor_cluster : corridor_clusters) {
+			corridor_cluster = 0;
+		}
+		hierarchy_generation = 1;
+	}
+}
+
+uint32_t NavMap::_acquire_path_query_slot() const {
+	// Waits for a slot when more threads than slots query the map at once.
+	path_query_slots_semaphore.wait();
+	MutexLock lock(path_query_slots_mutex);
+	const uint32_t slot = path_query_free_slots[path_query_free_slots.size() - 1];
+	path_query_free_slots.resize(path_query_free_slots.size() - 1);
+	return slot;
+}
+
+void NavMap::_release_path_query_slot(uint32_t p_slot) const {
+	{
+		MutexLock lock(path_query_slots_mutex);
+		path_query_free_slots.push_back(p_slot);
+	}
+	path_query_slots_semaphore.post();
+}
+
+void NavMap::_update_path_query_slots() {
+	// Only called while holding the map write lock, so no slot is in use.
+	const uint32_t polygon_count = polygons.size() + link_polygons.size();
+	for (PathQuerySlot &slot : path_query_slots) {
+		// The heap may still hold entries of the last search, and clearing it
+		// writes to them, so it must be emptied before the polygons move.
+		slot.traversable_polys.clear();
+		slot.navigation_polys.resize(polygon_count);
+		for (gd::NavigationPoly &navigation_poly : slot.navigation_polys) {
+			navigation_poly.generation = 0;
+		}
+		slot.generation = 0;
+		slot.traversable_polys.reserve(polygon_count);
+	}
+}
+
+void NavMap::_build_region_edges(const NavRegion *p_region, RegionConnectionCache &r_cache) {
+	const LocalVector<gd::Polygon> &region_polygons_source = p_region->get_polygons();
+	r_cache.has_polygons = !region_polygons_source.is_empty();
+	r_cache.bounds = p_region->get_polygon_bvh().get_aabb();
+
+	// Group the edges per key, the first two edges of a key are merged.
+	struct EdgeGroup {
+		RegionEdge first;
+		RegionEdge second;
+		uint32_t count = 0;
+		gd::EdgeKey key;
+	};
+	LocalVector<EdgeGroup> edge_groups;
+	HashMap<gd::EdgeKey, uint32_t, gd::EdgeKey> edge_group_indices;
+	for (uint32_t i = 0; i < region_polygons_source.size(); i++) {
+		const gd::Polygon &poly = region_polygons_source[i];
+		for (uint32_t p = 0; p < poly.points.size(); p++) {
+			const int next_point = (p + 1) % poly.points.size();
+			const gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			HashMap<gd::EdgeKey, uint32_t, gd::EdgeKey>::Iterator group_index = edge_group_indices.find(ek);
+			if (!group_index) {
+				edge_group_indices.insert(ek, edge_groups.size());
+				EdgeGroup group;
+				group.first = { i, p };
+				group.count = 1;
+				group.key = ek;
+				edge_groups.push_back(group);
+				continue;
+			}
+
+			EdgeGroup &group = edge_groups[group_index->value];
+			if (group.count == 1) {
+				group.second = { i, p };
+				group.count = 2;
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+			}
+		}
+	}
+
+	for (const EdgeGroup &group : edge_groups) {
+		if (group.count == 2) {
+			r_cache.internal_merges.push_back({ group.first, group.second });
+			r_cache.internal_edge_count++;
+		} else {
+			r_cache.boundary_edges.push_back({ group.first, group.key });
+			boundary_edges[group.key].push_back({ p_region, group.first });
+		}
+	}
+}
+
+void NavMap::_remove_region_boundary_edges(const NavRegion *p_region, const RegionConnectionCache &p_cache) {
+	for (const RegionBoundaryEdge &boundary_edge : p_cache.boundary_edges) {
+		HashMap<gd::EdgeKey, LocalVector<BoundaryEdgeOwner>, gd::EdgeKey>::Iterator owners = boundary_edges.find(boundary_edge.key);
+		ERR_CONTINUE(!owners);
+		for (uint32_t i = 0; i < owners->value.size(); i++) {
+			if (owners->value[i].region == p_region) {
+				owners->value.remove_at(i);
+				break;
+			}
+		}
+		if (owners->value.is_empty()) {
+			boundary_edges.remove(owners);
+		}
+	}
+}
+
+void NavMap::_connect_region_free_edges(const NavRegion *p_region, RegionConnectionCache &r_cache, const NavRegion *p_other_region, const RegionConnectionCache &p_other_cache) const {
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	const LocalVector<gd::Polygon> &polygons_source = p_region->get_polygons();
+	const LocalVector<gd::Polygon> &other_polygons_source = p_other_region->get_polygons();
+
+	for (const RegionEdge &free_edge : r_cache.free_edges) {
+		const gd::Polygon &free_edge_polygon = polygons_source[free_edge.polygon];
+		Vector3 edge_p1 = free_edge_polygon.points[free_edge.edge].pos;
+		Vector3 edge_p2 = free_edge_polygon.points[(free_edge.edge + 1) % free_edge_polygon.points.size()].pos;
+
+		for (const RegionEdge &other_edge : p_other_cache.free_edges) {
+			const gd::Polygon &other_edge_polygon = other_polygons_source[other_edge.polygon];
+			Vector3 other_edge_p1 = other_edge_polygon.points[other_edge.edge].pos;
+			Vector3 other_edge_p2 = other_edge_polygon.points[(other_edge.edge + 1) % other_edge_polygon.points.size()].pos;
+
+			// Compute the projection of the opposite edge on the current one
+			Vector3 edge_vector = edge_p2 - edge_p1;
+			real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+			real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+			if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+				continue;
+			}
+
+			// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+			Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+			Vector3 other1;
+			if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+				other1 = other_edge_p1;
+			} else {
+				other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+			}
+			if (other1.distance_to(self1) > edge_connection_margin) {
+				continue;
+			}
+
+			Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+			Vector3 other2;
+			if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+				other2 = other_edge_p2;
+			} else {
+				other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+			}
+			if (other2.distance_to(self2) > edge_connection_margin) {
+				continue;
+			}
+
+			// The edges can now be connected.
+			RegionConnection connection;
+			connection.edge = free_edge;
+			connection.target_region = p_other_region;
+			connection.target_polygon = other_edge.polygon;
+			connection.target_edge = other_edge.edge;
+			connection.pathway_start = (self1 + other1) / 2.0;
+			connection.pathway_end = (self2 + other2) / 2.0;
+			r_cache.edge_connections.push_back(connection);
+		}
+	}
+}
+
+void NavMap::_update_region_connections(const HashSet<const NavRegion *> &p_changed_regions) {
+	if (regenerate_connections) {
+		region_connection_cache.clear();
+		boundary_edges.clear();
+		regenerate_connections = false;
+	}
+
+	// Regions closer than this may share edges or be connected by their free edges.
+	const real_t neighbor_margin = MAX(edge_connection_margin, real_t(MAX(merge_rasterizer_cell_size, merge_rasterizer_cell_height))) + CMP_EPSILON;
+
+	HashSet<const NavRegion *> enabled_regions;
+	for (const RegionPolygons &E : region_polygons) {
+		enabled_regions.insert(E.region);
+	}
+
+	// The bounds of the changed regions, before and after the change.
+	LocalVector<AABB> changed_bounds;
+
+	// Forget the edges of the regions that changed or left the map.
+	LocalVector<const NavRegion *> stale_regions;
+	for (const KeyValue<const NavRegion *, RegionConnectionCache> &E : region_connection_cache) {
+		if (!enabled_regions.has(E.key) || p_changed_regions.has(E.key)) {
+			stale_regions.push_back(E.key);
+		}
+	}
+	for (const NavRegion *region : stale_regions) {
+		const RegionConnectionCache &cache = region_connection_cache[region];
+		if (cache.has_polygons) {
+			changed_bounds.push_back(cache.bounds);
+		}
+		_remove_region_boundary_edges(region, cache);
+		region_connection_cache.erase(region);
+	}
+
+	// Build the edges of the regions that changed or joined the map.
+	for (const RegionPolygons &E : region_polygons) {
+		if (region_connection_cache.has(E.region)) {
+			continue;
+		}
+		RegionConnectionCache &cache = region_connection_cache.insert(E.region, RegionConnectionCache())->value;
+		_build_region_edges(E.region, cache);
+		if (cache.has_polygons) {
+			changed_bounds.push_back(cache.bounds);
+		}
+	}
+
+	if (changed_bounds.is_empty()) {
+		return;
+	}
+
+	// The regions next to a changed region reconnect their edges too.
+	LocalVector<const NavRegion *> dirty_regions;
+	HashSet<const NavRegion *> dirty_region_set;
+	for (const RegionPolygons &E : region_polygons) {
+		const RegionConnectionCache &cache = region_connection_cache[E.region];
+		if (!cache.has_polygons) {
+			continue;
+		}
+		const AABB neighbor_bounds = cache.bounds.grow(neighbor_margin);
+		for (const AABB &bounds : changed_bounds) {
+			if (neighbor_bounds.intersects(bounds)) {
+				dirty_regions.push_back(E.region);
+				dirty_region_set.insert(E.region);
+				break;
+			}
+		}
+	}
+
+	// Merge the boundary edges shared with another region, the others are free edges.
+	for (const NavRegion *region : dirty_regions) {
+		RegionConnectionCache &cache = region_connection_cache[region];
+		cache.merged_connections.clear();
+		cache.free_edges.clear();
+		cache.edge_connections.clear();
+
+		for (const RegionBoundaryEdge &boundary_edge : cache.boundary_edges) {
+			const LocalVector<BoundaryEdgeOwner> &owners = boundary_edges[boundary_edge.key];
+			if (owners.size() == 1) {
+				if (use_edge_connections && region->get_use_edge_connections()) {
+					cache.free_edges.push_back(boundary_edge.edge);
+				}
+				continue;
+			}
+
+			// Only the first two edges of a key are merged.
+			const BoundaryEdgeOwner *other = nullptr;
+			if (owners[0].region == region) {
+				other = &owners[1];
+			} else if (owners[1].region == region) {
+				other = &owners[0];
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+				continue;
+			}
+
+			const gd::Polygon &other_polygon = other->region->get_polygons()[other->edge.polygon];
+			RegionConnection connection;
+			connection.edge = boundary_edge.edge;
+			connection.target_region = other->region;
+			connection.target_polygon = other->edge.polygon;
+			connection.target_edge = other->edge.edge;
+			// Note: The pathway_start/end are full for those connection and do not need to be modified.
+			connection.pathway_start = other_polygon.points[other->edge.edge].pos;
+			connection.pathway_end = other_polygon.points[(other->edge.edge + 1) % other_polygon.points.size()].pos;
+			cache.merged_connections.push_back(connection);
+		}
+	}
+
+	// Connect the free edges of the dirty regions to the free edges of their neighbors.
+	for (const NavRegion *region : dirty_regions) {
+		RegionConnectionCache &cache = region_connection_cache[region];
+		if (cache.free_edges.is_empty()) {
+			continue;
+		}
+		const AABB neighbor_bounds = cache.bounds.grow(neighbor_margin);
+		for (const RegionPolygons &E : region_polygons) {
+			const RegionConnectionCache &other_cache = region_connection_cache[E.region];
+			if (E.region == region || other_cache.free_edges.is_empty() || !neighbor_bounds.intersects(other_cache.bounds)) {
+				continue;
+			}
+			_connect_region_free_edges(region, cache, E.region, other_cache);
+		}
+	}
+
+	// The other regions next to the dirty ones reconnect their free edges to them.
+	for (const RegionPolygons &E : region_polygons) {
+		if (dirty_region_set.has(E.region)) {
+			continue;
+		}
+		RegionConnectionCache &cache = region_connection_cache[E.region];
+		if (cache.free_edges.is_empty()) {
+			continue;
+		}
+		const AABB neighbor_bounds = cache.bounds.grow(neighbor_margin);
+
+		bool has_dirty_neighbors = false;
+		for (const NavRegion *region : dirty_regions) {
+			if (neighbor_bounds.intersects(region_connection_cache[region].bounds)) {
+				has_dirty_neighbors = true;
+				break;
+			}
+		}
+		if (!has_dirty_neighbors) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < cache.edge_connections.size(); i++) {
+			if (dirty_region_set.has(cache.edge_connections[i].target_region)) {
+				cache.edge_connections.remove_at(i);
+				i--;
+			}
+		}
+		for (const NavRegion *region : dirty_regions) {
+			const RegionConnectionCache &other_cache = region_connection_cache[region];
+			if (other_cache.free_edges.is_empty() || !neighbor_bounds.intersects(other_cache.bounds)) {
+				continue;
+			}
+			_connect_region_free_edges(E.region, cache, region, other_cache);
+		}
+	}
+}
+
+void NavMap::_clear_hierarchy() {
+	hierarchy_ready.clear();
+	hierarchy_pending_clusters.clear();
+	hierarchy_clusters.clear();
+	hierarchy_polygon_clusters.clear();
+	hierarchy_portals.clear();
+	hierarchy_portal_links_offsets.clear();
+	hierarchy_portal_links.clear();
+	hierarchy_cluster_cache.clear();
+	for (PathQuerySlot &slot : path_query_slots) {
+		slot.hierarchy_nodes.clear();
+		slot.hierarchy_open.clear();
+		slot.corridor_clusters.clear();
+		slot.hierarchy_generation = 0;
+	}
+}
+
+void NavMap::_update_hierarchy(const HashSet<const NavRegion *> &p_changed_regions) {
+	// Only called while holding the map write lock, so no slot is in use.
+	const uint32_t polygon_count = polygons.size() + link_polygons.size();
+
+	// One cluster per region, and one per link.
+	hierarchy_clusters.clear();
+	hierarchy_clusters.resize(region_polygons.size() + link_polygons.size());
+	hierarchy_polygon_clusters.resize(polygon_count);
+	for (uint32_t i = 0; i < region_polygons.size(); i++) {
+		hierarchy_clusters[i].owner = region_polygons[i].region;
+		const uint32_t end = i + 1 < region_polygons.size() ? region_polygons[i + 1].polygon_offset : polygons.size();
+		for (uint32_t j = region_polygons[i].polygon_offset; j < end; j++) {
+			hierarchy_polygon_clusters[j] = i;
+		}
+	}
+	for (uint32_t i = 0; i < link_polygons.size(); i++) {
+		hierarchy_clusters[region_polygons.size() + i].owner = link_polygons[i].owner;
+		hierarchy_polygon_clusters[polygons.size() + i] = region_polygons.size() + i;
+	}
+
+	// Portals are the polygons connected to, or from, another cluster.
+	LocalVector<uint32_t> polygon_portals;
+	polygon_portals.resize(polygon_count);
+	for (uint32_t &polygon_portal : polygon_portals) {
+		polygon_portal = UINT32_MAX;
+	}
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		const gd::Polygon &polygon = _get_polygon(i);
+		for (const gd::Edge &edge : polygon.edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (connection.polygon->owner != polygon.owner) {
+					polygon_portals[i] = 0;
+					polygon_portals[connection.polygon->id] = 0;
+				}
+			}
+		}
+	}
+
+	// Polygon ids grow with the cluster index, so the portals end up grouped by cluster.
+	hierarchy_portals.clear();
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_portals[i] == UINT32_MAX) {
+			continue;
+		}
+		HierarchyCluster &cluster = hierarchy_clusters[hierarchy_polygon_clusters[i]];
+		if (cluster.portal_count == 0) {
+			cluster.first_portal = hierarchy_portals.size();
+		}
+		cluster.portal_count++;
+		polygon_portals[i] = hierarchy_portals.size();
+		hierarchy_portals.push_back(i);
+	}
+
+	// Travel distances between the portals of each cluster, reused for the regions that did not change.
+	// The others are searched by _update_hierarchy_distances() once the map is readable again.
+	hierarchy_pending_clusters.clear();
+	HashSet<const NavRegion *> current_regions;
+	for (uint32_t i = 0; i < hierarchy_clusters.size(); i++) {
+		HierarchyCluster &cluster = hierarchy_clusters[i];
+		if (i >= region_polygons.size()) {
+			cluster.portal_distances.resize(cluster.portal_count * cluster.portal_count);
+			for (real_t &distance : cluster.portal_distances) {
+				distance = 0.0;
+			}
+			continue;
+		}
+
+		const NavRegion *region = region_polygons[i].region;
+		const uint32_t polygon_offset = region_polygons[i].polygon_offset;
+		current_regions.insert(region);
+
+		LocalVector<uint32_t> local_portals;
+		local_portals.resize(cluster.portal_count);
+		for (uint32_t j = 0; j < cluster.portal_count; j++) {
+			local_portals[j] = hierarchy_portals[cluster.first_portal + j] - polygon_offset;
+		}
+
+		HierarchyClusterCache *cache = hierarchy_cluster_cache.getptr(region);
+		if (cache && !p_changed_regions.has(region) && cache->local_portals.size() == local_portals.size()) {
+			bool same_portals = true;
+			for (uint32_t j = 0; j < local_portals.size() && same_portals; j++) {
+				same_portals = cache->local_portals[j] == local_portals[j];
+			}
+			if (same_portals) {
+				cluster.portal_distances = cache->portal_distances;
+				continue;
+			}
+		}
+
+		hierarchy_pending_clusters.push_back(i);
+	}
+
+	// Forget the regions that left the map.
+	LocalVector<const NavRegion *> removed_regions;
+	for (const KeyValue<const NavRegion *, HierarchyClusterCache> &E : hierarchy_cluster_cache) {
+		if (!current_regions.has(E.key)) {
+			removed_regions.push_back(E.key);
+		}
+	}
+	for (const NavRegion *region : removed_regions) {
+		hierarchy_cluster_cache.erase(region);
+	}
+
+	// Links between the portals of different clusters.
+	hierarchy_portal_links_offsets.resize(hierarchy_portals.size() + 1);
+	hierarchy_portal_links.clear();
+	for (uint32_t i = 0; i < hierarchy_portals.size(); i++) {
+		hierarchy_portal_links_offsets[i] = hierarchy_portal_links.size();
+		const gd::Polygon &polygon = _get_polygon(hierarchy_portals[i]);
+		for (const gd::Edge &edge : polygon.edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (connection.polygon->owner != polygon.owner) {
+					hierarchy_portal_links.push_back({ polygon_portals[connection.polygon->id], polygon.center.distance_to(connection.polygon->center) });
+				}
+			}
+		}
+	}
+	hierarchy_portal_links_offsets[hierarchy_portals.size()] = hierarchy_portal_links.size();
+
+	for (PathQuerySlot &path_query_slot : path_query_slots) {
+		// Same as the polygon heap, empty it before the nodes move.
+		path_query_slot.hierarchy_open.clear();
+		path_query_slot.hierarchy_nodes.resize(hierarchy_portals.size());
+		for (HierarchyNode &node : path_query_slot.hierarchy_nodes) {
+			node.generation = 0;
+			node.exit_generation = 0;
+		}
+		path_query_slot.corridor_clusters.resize(hierarchy_clusters.size());
+		for (uint32_t &corridor_cluster : path_query_slot.corridor_clusters) {
+			corridor_cluster = 0;
+		}
+		path_query_slot.hierarchy_open.reserve(hierarchy_portals.size());
+		path_query_slot.hierarchy_generation = 0;
+	}
+
+	hierarchy_ready.set_to(hierarchy_pending_clusters.is_empty());
+}
+
+void NavMap::_update_hierarchy_distances() {
+	// Only called while holding the map read lock, queries do not use the hierarchy until it is ready.
+	const uint32_t slot_index = _acquire_path_query_slot();
+	PathQuerySlot &slot = path_query_slots[slot_index];
+
+	for (const uint32_t cluster_index : hierarchy_pending_clusters) {
+		HierarchyCluster &cluster = hierarchy_clusters[cluster_index];
+		cluster.portal_distances.resize(cluster.portal_count * cluster.portal_count);
+		for (uint32_t j = 0; j < cluster.portal_count; j++) {
+			_search_hierarchy_cluster(slot, &polygons[hierarchy_portals[cluster.first_portal + j]]);
+			for (uint32_t k = 0; k < cluster.portal_count; k++) {
+				const gd::NavigationPoly &navigation_poly = slot.navigation_polys[hierarchy_portals[cluster.first_portal + k]];
+				cluster.portal_distances[j * cluster.portal_count + k] = navigation_poly.generation == slot.generation ? navigation_poly.traveled_distance : FLT_MAX;
+			}
+		}
+
+		const NavRegion *region = region_polygons[cluster_index].region;
+		const uint32_t polygon_offset = region_polygons[cluster_index].polygon_offset;
+		HierarchyClusterCache &cache = hierarchy_cluster_cache[region];
+		cache.local_portals.resize(cluster.portal_count);
+		for (uint32_t j = 0; j < cluster.portal_count; j++) {
+			cache.local_portals[j] = hierarchy_portals[cluster.first_portal + j] - polygon_offset;
+		}
+		cache.portal_distances = cluster.portal_distances;
+	}
+	hierarchy_pending_clusters.clear();
+
+	_release_path_query_slot(slot_index);
+	hierarchy_ready.set();
+}
+
+void NavMap::_search_hierarchy_cluster(PathQuerySlot &p_slot, const gd::Polygon *p_start) const {
+	// Dijkstra over the polygon centers of the cluster, the distances are left in the slot polygons.
+	LocalVector<gd::NavigationPoly> &navigation_polys = p_slot.navigation_polys;
+	p_slot.begin_search();
+
+	gd::NavigationPoly &start_navigation_poly = navigation_polys[p_start->id];
+	start_navigation_poly = gd::NavigationPoly(p_start);
+	start_navigation_poly.self_id = p_start->id;
+	start_navigation_poly.generation = p_slot.generation;
+	p_slot.traversable_polys.push(&start_navigation_poly);
+
+	while (!p_slot.traversable_polys.is_empty()) {
+		const gd::NavigationPoly *current = p_slot.traversable_polys.pop();
+		for (const gd::Edge &edge : current->poly->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (connection.polygon->owner != p_start->owner) {
+					continue;
+				}
+
+				const real_t distance = current->traveled_distance + current->poly->center.distance_to(connection.polygon->center);
+				gd::NavigationPoly &next = navigation_polys[connection.polygon->id];
+				if (next.generation != p_slot.generation) {
+					next = gd::NavigationPoly(connection.polygon);
+					next.self_id = connection.polygon->id;
+					next.generation = p_slot.generation;
+					next.traveled_distance = distance;
+					p_slot.traversable_polys.push(&next);
+				} else if (distance < next.traveled_distance && next.traversable_poly_index != UINT32_MAX) {
+					next.traveled_distance = distance;
+					p_slot.traversable_polys.shift(next.traversable_poly_index);
+				}
+			}
+		}
+	}
+}
+
+bool NavMap::_find_hierarchy_corridor(PathQuerySlot &p_slot, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers) const {
+	LocalVector<HierarchyNode> &nodes = p_slot.hierarchy_nodes;
+	p_slot.begin_hierarchy_search();
+	const uint32_t generation = p_slot.hierarchy_generation;
+
+	// Cost from the portals of the end cluster to the end point.
+	const HierarchyCluster &end_cluster = hierarchy_clusters[hierarchy_polygon_clusters[p_end_poly->id]];
+	const real_t end_travel_cost = end_cluster.owner->get_travel_cost();
+	_search_hierarchy_cluster(p_slot, p_end_poly);
+	for (uint32_t i = end_cluster.first_portal; i < end_cluster.first_portal + end_cluster.portal_count; i++) {
+		const gd::NavigationPoly &navigation_poly = p_slot.navigation_polys[hierarchy_portals[i]];
+		if (navigation_poly.generation == p_slot.generation) {
+			nodes[i].exit_cost = (navigation_poly.traveled_distance + p_end_poly->center.distance_to(p_end_point)) * end_travel_cost;
+			nodes[i].exit_generation = generation;
+		}
+	}
+
+	// Cost from the begin point to the portals of the begin cluster.
+	const HierarchyCluster &begin_cluster = hierarchy_clusters[hierarchy_polygon_clusters[p_begin_poly->id]];
+	const real_t begin_travel_cost = begin_cluster.owner->get_travel_cost();
+	_search_hierarchy_cluster(p_slot, p_begin_poly);
+	for (uint32_t i = begin_cluster.first_portal; i < begin_cluster.first_portal + begin_cluster.portal_count; i++) {
+		const gd::NavigationPoly &navigation_poly = p_slot.navigation_polys[hierarchy_portals[i]];
+		if (navigation_poly.generation != p_slot.generation) {
+			continue;
+		}
+		HierarchyNode &node = nodes[i];
+		node.cost = (p_begin_point.distance_to(p_begin_poly->center) + navigation_poly.traveled_distance) * begin_travel_cost;
+		node.estimate = navigation_poly.poly->center.distance_to(p_end_point);
+		node.parent = UINT32_MAX;
+		node.generation = generation;
+		p_slot.hierarchy_open.push(&node);
+	}
+
+	// A* over the portals.
+	real_t best_cost = FLT_MAX;
+	uint32_t best_portal = UINT32_MAX;
+	while (!p_slot.hierarchy_open.is_empty()) {
+		HierarchyNode *node = p_slot.hierarchy_open.pop();
+		if (node->cost + node->estimate >= best_cost) {
+			break;
+		}
+		const uint32_t portal = node - nodes.ptr();
+
+		if (node->exit_generation == generation && node->cost + node->exit_cost < best_cost) {
+			best_cost = node->cost + node->exit_cost;
+			best_portal = portal;
+		}
+
+		const HierarchyCluster &cluster = hierarchy_clusters[hierarchy_polygon_clusters[hierarchy_portals[portal]]];
+		const real_t travel_cost = cluster.owner->get_travel_cost();
+
+		// Through the cluster to its other portals.
+		const uint32_t row = (portal - cluster.first_portal) * cluster.portal_count;
+		for (uint32_t i = 0; i < cluster.portal_count; i++) {
+			const real_t distance = cluster.portal_distances[row + i];
+			const uint32_t next_portal = cluster.first_portal + i;
+			if (next_portal == portal || distance == FLT_MAX) {
+				continue;
+			}
+			const real_t cost = node->cost + distance * travel_cost;
+			HierarchyNode &next = nodes[next_portal];
+			if (next.generation != generation) {
+				next.cost = cost;
+				next.estimate = _get_polygon(hierarchy_portals[next_portal]).center.distance_to(p_end_point);
+				next.parent = portal;
+				next.generation = generation;
+				p_slot.hierarchy_open.push(&next);
+			} else if (cost < next.cost && next.heap_index != UINT32_MAX) {
+				next.cost = cost;
+				next.parent = portal;
+				p_slot.hierarchy_open.shift(next.heap_index);
+			}
+		}
+
+		// Across to the portals of other clusters.
+		for (uint32_t i = hierarchy_portal_links_offsets[portal]; i < hierarchy_portal_links_offsets[portal + 1]; i++) {
+			const HierarchyPortalLink &link = hierarchy_portal_links[i];
+			const NavBase *next_owner = hierarchy_clusters[hierarchy_polygon_clusters[hierarchy_portals[link.portal]]].owner;
+			if ((p_navigation_layers & next_owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+			const real_t cost = node->cost + link.distance * travel_cost + next_owner->get_enter_cost();
+			HierarchyNode &next = nodes[link.portal];
+			if (next.generation != generation) {
+				next.cost = cost;
+				next.estimate = _get_polygon(hierarchy_portals[link.portal]).center.distance_to(p_end_point);
+				next.parent = portal;
+				next.generation = generation;
+				p_slot.hierarchy_open.push(&next);
+			} else if (cost < next.cost && next.heap_index != UINT32_MAX) {
+				next.cost = cost;
+				next.parent = portal;
+				p_slot.hierarchy_open.shift(next.heap_index);
+			}
+		}
+	}
+
+	if (best_portal == UINT32_MAX) {
+		return false;
+	}
+
+	// Limit the polygon search to the clusters along the way.
+	p_slot.corridor_clusters[hierarchy_polygon_clusters[p_begin_poly->id]] = generation;
+	p_slot.corridor_clusters[hierarchy_polygon_clusters[p_end_poly->id]] = generation;
+	for (uint32_t portal = best_portal; portal != UINT32_MAX; portal = nodes[portal].parent) {
+		p_slot.corridor_clusters[hierarchy_polygon_clusters[hierarchy_portals[portal]]] = generation;
+	}
+	return true;
+}
+
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	RWLockRead read_lock(map_rwlock);
 	if (iteration_id == 0) {
@@ -153,46 +861,29 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		r_path_owners->clear();
 	}
 
-	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
-	Vector3 begin_point;
-	Vector3 end_point;
-	real_t begin_d = FLT_MAX;
-	real_t end_d = FLT_MAX;
-	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : polygons) {
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			real_t distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
+	const uint32_t slot = _acquire_path_query_slot();
+	Vector<Vector3> path = _get_path(path_query_slots[slot], p_origin, p_destination, p_optimize, p_navigation_layers, r_path_types, r_path_rids, r_path_owners);
+	_release_path_query_slot(slot);
+	return path;
+}
 
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
+Vector<Vector3> NavMap::_get_path(PathQuerySlot &p_slot, const Vector3 &p_origin, const Vector3 &p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
+	// Find the start poly and the end poly on this map.
+	NavPolygonBVH::ClosestPoint begin_closest;
+	_get_closest_polygon_point(p_origin, p_navigation_layers, true, begin_closest);
+	NavPolygonBVH::ClosestPoint end_closest;
+	_get_closest_polygon_point(p_destination, p_navigation_layers, true, end_closest);
 
 	// Check for trivial cases
-	if (!begin_poly || !end_poly) {
+	if (!begin_closest.is_valid() || !end_closest.is_valid()) {
 		return Vector<Vector3>();
 	}
+
+	const gd::Polygon *begin_poly = &polygons[begin_closest.polygon];
+	const gd::Polygon *end_poly = &polygons[end_closest.polygon];
+	const Vector3 begin_point = begin_closest.point;
+	Vector3 end_point = end_closest.point;
+
 	if (begin_poly == end_poly) {
 		if (r_path_types) {
 			r_path_types->resize(2);
@@ -219,24 +910,35 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	// List of all reachable navigation polys.
-	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	// Paths along a recent path only need the post-processing.
+	if (use_path_corridor_cache && _reuse_path_corridor(p_slot, begin_poly, begin_point, end_poly, p_navigation_layers)) {
+		return _build_path(p_slot.navigation_polys, end_poly->id, begin_poly, begin_point, end_poly, end_point, p_optimize, r_path_types, r_path_rids, r_path_owners);
+	}
+
+	// Between different clusters, first find the clusters to cross and only search the polygons of those.
+	bool use_corridor = false;
+	if (hierarchy_ready.is_set() && !hierarchy_clusters.is_empty() && hierarchy_polygon_clusters[begin_poly->id] != hierarchy_polygon_clusters[end_poly->id]) {
+		use_corridor = _find_hierarchy_corridor(p_slot, begin_poly, begin_point, end_poly, end_point, p_navigation_layers);
+	}
+
+	// Search state of all the navigation polys, reused between queries.
+	LocalVector<gd::NavigationPoly> &navigation_polys = p_slot.navigation_polys;
+	p_slot.begin_search();
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
-	begin_navigation_poly.self_id = 0;
+	begin_navigation_poly.self_id = begin_poly->id;
+	begin_navigation_poly.generation = p_slot.generation;
 	begin_navigation_poly.entry = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
-	navigation_polys.push_back(begin_navigation_poly);
+	navigation_polys[begin_poly->id] = begin_navigation_poly;
 
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	// Polygons to visit, cheapest first.
+	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostLessThan, gd::NavPolyHeapIndexer> &traversable_polys = p_slot.traversable_polys;
 
 	// This is an implementation of the A* algorithm.
-	int least_cost_id = 0;
+	int least_cost_id = begin_poly->id;
 	int prev_least_cost_id = -1;
 	bool found_route = false;
 
@@ -256,6 +958,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
+				// Stay in the clusters of the hierarchy corridor.
+				if (use_corridor && p_slot.corridor_clusters[hierarchy_polygon_clusters[connection.polygon->id]] != p_slot.hierarchy_generation) {
+					continue;
+				}
+
 				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				real_t poly_enter_cost = 0.0;
 				real_t poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
@@ -269,42 +976,61 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
 				const real_t new_distance = (least_cost_poly.entry.distance_to(new_entry) * poly_travel_cost) + poly_enter_cost + least_cost_poly.traveled_distance;
 
-				int64_t already_visited_polygon_index = navigation_polys.find(gd::NavigationPoly(connection.polygon));
+				gd::NavigationPoly &neighbor_poly = navigation_polys[connection.polygon->id];
 
-				if (already_visited_polygon_index != -1) {
+				if (neighbor_poly.generation == p_slot.generation) {
 					// Polygon already visited, check if we can reduce the travel cost.
-					gd::NavigationPoly &avp = navigation_polys[already_visited_polygon_index];
-					if (new_distance < avp.traveled_distance) {
-						avp.back_navigation_poly_id = least_cost_id;
-						avp.back_navigation_edge = connection.edge;
-						avp.back_navigation_edge_pathway_start = connection.pathway_start;
-						avp.back_navigation_edge_pathway_end = connection.pathway_end;
-						avp.traveled_distance = new_distance;
-						avp.entry = new_entry;
+					if (new_distance < neighbor_poly.traveled_distance) {
+						neighbor_poly.back_navigation_poly_id = least_cost_id;
+						neighbor_poly.back_navigation_edge = connection.edge;
+						neighbor_poly.back_navigation_edge_pathway_start = connection.pathway_start;
+						neighbor_poly.back_navigation_edge_pathway_end = connection.pathway_end;
+						neighbor_poly.traveled_distance = new_distance;
+						neighbor_poly.entry = new_entry;
+						neighbor_poly.distance_to_destination = new_entry.distance_to(end_point) * neighbor_poly.poly->owner->get_travel_cost();
+
+						// Move it up if it is still waiting to be visited.
+						if (neighbor_poly.traversable_poly_index != UINT32_MAX) {
+							traversable_polys.shift(neighbor_poly.traversable_poly_index);
+						}
 					}
 				} else {
 					// Add the neighbor polygon to the reachable ones.
-					gd::NavigationPoly new_navigation_poly = gd::NavigationPoly(connection.polygon);
-					new_navigation_poly.self_id = navigation_polys.size();
-					new_navigation_poly.back_navigation_poly_id = least_cost_id;
-					new_navigation_poly.back_navigation_edge = connection.edge;
-					new_navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
-					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
-					new_navigation_poly.traveled_distance = new_distance;
-					new_navigation_poly.entry = new_entry;
-					navigation_polys.push_back(new_navigation_poly);
+					neighbor_poly = gd::NavigationPoly(connection.polygon);
+					neighbor_poly.self_id = connection.polygon->id;
+					neighbor_poly.generation = p_slot.generation;
+					neighbor_poly.back_navigation_poly_id = least_cost_id;
+					neighbor_poly.back_navigation_edge = connection.edge;
+					neighbor_poly.back_navigation_edge_pathway_start = connection.pathway_start;
+					neighbor_poly.back_navigation_edge_pathway_end = connection.pathway_end;
+					neighbor_poly.traveled_distance = new_distance;
+					neighbor_poly.entry = new_entry;
+					neighbor_poly.distance_to_destination = new_entry.distance_to(end_point) * neighbor_poly.poly->owner->get_travel_cost();
 
 					// Add the neighbor polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					traversable_polys.push(&neighbor_poly);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
+		// When there are no polygons left to visit at this point it means the End Polygon is not reachable
+		if (traversable_polys.is_empty()) {
+			if (use_corridor) {
+				// The corridor is only an estimate, search the whole map before giving up on the end polygon.
+				use_corridor = false;
+				gd::NavigationPoly np = navigation_polys[begin_poly->id];
+				p_slot.begin_search();
+				np.generation = p_slot.generation;
+				navigation_polys[begin_poly->id] = np;
+				least_cost_id = begin_poly->id;
+				prev_least_cost_id = -1;
+
+				reachable_end = nullptr;
+				reachable_d = FLT_MAX;
+
+				continue;
+			}
 
-		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -315,7 +1041,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Set as end point the furthest reachable point.
 			end_poly = reachable_end;
-			end_d = FLT_MAX;
+			real_t end_d = FLT_MAX;
 			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
 				Face3 f(end_poly->points[0].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
 				Vector3 spoint = f.get_closest_point_to(p_destination);
@@ -366,13 +1092,12 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				return path;
 			}
 
-			// Reset open and navigation_polys
-			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
-			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
-			least_cost_id = 0;
+			// Restart the search from the start polygon only.
+			gd::NavigationPoly np = navigation_polys[begin_poly->id];
+			p_slot.begin_search();
+			np.generation = p_slot.generation;
+			navigation_polys[begin_poly->id] = np;
+			least_cost_id = begin_poly->id;
 			prev_least_cost_id = -1;
 
 			reachable_end = nullptr;
@@ -380,20 +1105,8 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		real_t least_cost = FLT_MAX;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			real_t cost = np->traveled_distance;
-			cost += (np->entry.distance_to(end_point) * np->poly->owner->get_travel_cost());
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
-
-		ERR_BREAK(least_cost_id == -1);
+		// Visit the polygon with the minimum cost next.
+		least_cost_id = traversable_polys.pop()->self_id;
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -414,7 +1127,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	// We did not find a route but we have both a start polygon and an end polygon at this point.
 	// Usually this happens because there was not a single external or internal connected edge, e.g. our start polygon is an isolated, single convex polygon.
 	if (!found_route) {
-		end_d = FLT_MAX;
+		real_t end_d = FLT_MAX;
 		// Search all faces of the start polygon for the closest point to our target position.
 		for (size_t point_id = 2; point_id < begin_poly->points.size(); point_id++) {
 			Face3 f(begin_poly->points[0].pos, begin_poly->points[point_id - 1].pos, begin_poly->points[point_id].pos);
@@ -451,23 +1164,31 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	if (use_path_corridor_cache) {
+		_add_path_corridor(navigation_polys, least_cost_id, p_navigation_layers);
+	}
+
+	return _build_path(navigation_polys, least_cost_id, begin_poly, begin_point, end_poly, end_point, p_optimize, r_path_types, r_path_rids, r_path_owners);
+}
+
+Vector<Vector3> NavMap::_build_path(LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, bool p_optimize, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	Vector<Vector3> path;
 	// Optimize the path.
 	if (p_optimize) {
 		// Set the apex poly/point to the end point
-		gd::NavigationPoly *apex_poly = &navigation_polys[least_cost_id];
+		gd::NavigationPoly *apex_poly = &p_navigation_polys[p_end_id];
 
 		Vector3 back_pathway[2] = { apex_poly->back_navigation_edge_pathway_start, apex_poly->back_navigation_edge_pathway_end };
-		const Vector3 back_edge_closest_point = Geometry3D::get_closest_point_to_segment(end_point, back_pathway);
-		if (end_point.is_equal_approx(back_edge_closest_point)) {
+		const Vector3 back_edge_closest_point = Geometry3D::get_closest_point_to_segment(p_end_point, back_pathway);
+		if (p_end_point.is_equal_approx(back_edge_closest_point)) {
 			// The end point is basically on top of the last crossed edge, funneling around the corners would at best do nothing.
 			// At worst it would add an unwanted path point before the last point due to precision issues so skip to the next polygon.
 			if (apex_poly->back_navigation_poly_id != -1) {
-				apex_poly = &navigation_polys[apex_poly->back_navigation_poly_id];
+				apex_poly = &p_navigation_polys[apex_poly->back_navigation_poly_id];
 			}
 		}
 
-		Vector3 apex_point = end_point;
+		Vector3 apex_point = p_end_point;
 
 		gd::NavigationPoly *left_poly = apex_poly;
 		Vector3 left_portal = apex_point;
@@ -476,8 +1197,8 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 		gd::NavigationPoly *p = apex_poly;
 
-		path.push_back(end_point);
-		APPEND_METADATA(end_poly);
+		path.push_back(p_end_point);
+		APPEND_METADATA(p_end_poly);
 
 		while (p) {
 			// Set left and right points of the pathway between polygons.
@@ -494,7 +1215,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					left_poly = p;
 					left_portal = left;
 				} else {
-					clip_path(navigation_polys, path, apex_poly, right_portal, right_poly, r_path_types, r_path_rids, r_path_owners);
+					clip_path(p_navigation_polys, path, apex_poly, right_portal, right_poly, r_path_types, r_path_rids, r_path_owners);
 
 					apex_point = right_portal;
 					p = right_poly;
@@ -515,7 +1236,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					right_poly = p;
 					right_portal = right;
 				} else {
-					clip_path(navigation_polys, path, apex_poly, left_portal, left_poly, r_path_types, r_path_rids, r_path_owners);
+					clip_path(p_navigation_polys, path, apex_poly, left_portal, left_poly, r_path_types, r_path_rids, r_path_owners);
 
 					apex_point = left_portal;
 					p = left_poly;
@@ -531,7 +1252,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Go to the previous polygon.
 			if (p->back_navigation_poly_id != -1) {
-				p = &navigation_polys[p->back_navigation_poly_id];
+				p = &p_navigation_polys[p->back_navigation_poly_id];
 			} else {
 				// The end
 				p = nullptr;
@@ -539,9 +1260,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		}
 
 		// If the last point is not the begin point, add it to the list.
-		if (path[path.size() - 1] != begin_point) {
-			path.push_back(begin_point);
-			APPEND_METADATA(begin_poly);
+		if (path[path.size() - 1] != p_begin_point) {
+			path.push_back(p_begin_point);
+			APPEND_METADATA(p_begin_poly);
 		}
 
 		path.reverse();
@@ -556,29 +1277,29 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		}
 
 	} else {
-		path.push_back(end_point);
-		APPEND_METADATA(end_poly);
+		path.push_back(p_end_point);
+		APPEND_METADATA(p_end_poly);
 
 		// Add mid points
-		int np_id = least_cost_id;
-		while (np_id != -1 && navigation_polys[np_id].back_navigation_poly_id != -1) {
-			if (navigation_polys[np_id].back_navigation_edge != -1) {
-				int prev = navigation_polys[np_id].back_navigation_edge;
-				int prev_n = (navigation_polys[np_id].back_navigation_edge + 1) % navigation_polys[np_id].poly->points.size();
-				Vector3 point = (navigation_polys[np_id].poly->points[prev].pos + navigation_polys[np_id].poly->points[prev_n].pos) * 0.5;
+		int np_id = p_end_id;
+		while (np_id != -1 && p_navigation_polys[np_id].back_navigation_poly_id != -1) {
+			if (p_navigation_polys[np_id].back_navigation_edge != -1) {
+				int prev = p_navigation_polys[np_id].back_navigation_edge;
+				int prev_n = (p_navigation_polys[np_id].back_navigation_edge + 1) % p_navigation_polys[np_id].poly->points.size();
+				Vector3 point = (p_navigation_polys[np_id].poly->points[prev].pos + p_navigation_polys[np_id].poly->points[prev_n].pos) * 0.5;
 
 				path.push_back(point);
-				APPEND_METADATA(navigation_polys[np_id].poly);
+				APPEND_METADATA(p_navigation_polys[np_id].poly);
 			} else {
-				path.push_back(navigation_polys[np_id].entry);
-				APPEND_METADATA(navigation_polys[np_id].poly);
+				path.push_back(p_navigation_polys[np_id].entry);
+				APPEND_METADATA(p_navigation_polys[np_id].poly);
 			}
 
-			np_id = navigation_polys[np_id].back_navigation_poly_id;
+			np_id = p_navigation_polys[np_id].back_navigation_poly_id;
 		}
 
-		path.push_back(begin_point);
-		APPEND_METADATA(begin_poly);
+		path.push_back(p_begin_point);
+		APPEND_METADATA(p_begin_poly);
 
 		path.reverse();
 		if (r_path_types) {
@@ -600,57 +1321,371 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	return path;
 }
 
-Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
+bool NavMap::_reuse_path_corridor(PathQuerySlot &p_slot, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, uint32_t p_navigation_layers) const {
+	RWLockRead read_lock(path_corridors_rwlock);
+
+	const PathCorridor *corridor = nullptr;
+	uint32_t begin_index = 0;
+	uint32_t end_index = 0;
+
+	for (PathCorridor *E : path_corridors) {
+		if (E->navigation_layers != p_navigation_layers) {
+			continue;
+		}
+		const int64_t begin = E->polygons.find(p_begin_poly->id);
+		if (begin == -1) {
+			continue;
+		}
+
+		// The end polygon is further along the corridor.
+		const int64_t end = E->polygons.find(p_end_poly->id, begin);
+		if (end != -1) {
+			corridor = E;
+			begin_index = begin;
+			end_index = end;
+			break;
+		}
+	}
+
+	if (!corridor) {
+		return false;
+	}
+	const_cast<PathCorridor *>(corridor)->last_used.set(path_corridor_use_count.increment());
+
+	// Rebuild the search state a path search along the corridor would leave behind.
+	LocalVector<gd::NavigationPoly> &navigation_polys = p_slot.navigation_polys;
+	p_slot.begin_search();
+
+	int previous_id = -1;
+	for (uint32_t i = begin_index; i <= end_index; i++) {
+		const uint32_t id = corridor->polygons[i];
+		gd::NavigationPoly &navigation_poly = navigation_polys[id];
+		navigation_poly = gd::NavigationPoly(&_get_polygon(id));
+		navigation_poly.self_id = id;
+		navigation_poly.generation = p_slot.generation;
+		navigation_poly.back_navigation_poly_id = previous_id;
+		if (previous_id == -1) {
+			navigation_poly.entry = p_begin_point;
+			navigation_poly.back_navigation_edge_pathway_start = p_begin_point;
+			navigation_poly.back_navigation_edge_pathway_end = p_begin_point;
+		} else {
+			navigation_poly.entry = corridor->entries[i];
+			navigation_poly.back_navigation_edge = corridor->edges[i];
+			navigation_poly.back_navigation_edge_pathway_start = corridor->pathway_starts[i];
+			navigation_poly.back_navigation_edge_pathway_end = corridor->pathway_ends[i];
+		}
+		previous_id = id;
+	}
+
+	return true;
+}
+
+void NavMap::_add_path_corridor(const LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id, uint32_t p_navigation_layers) const {
+	PathCorridor *corridor = memnew(PathCorridor);
+	corridor->navigation_layers = p_navigation_layers;
+	for (int id = p_end_id; id != -1; id = p_navigation_polys[id].back_navigation_poly_id) {
+		const gd::NavigationPoly &navigation_poly = p_navigation_polys[id];
+		corridor->polygons.push_back(id);
+		corridor->edges.push_back(navigation_poly.back_navigation_edge);
+		corridor->pathway_starts.push_back(navigation_poly.back_navigation_edge_pathway_start);
+		corridor->pathway_ends.push_back(navigation_poly.back_navigation_edge_pathway_end);
+		corridor->entries.push_back(navigation_poly.entry);
+	}
+	corridor->polygons.invert();
+	corridor->edges.invert();
+	corridor->pathway_starts.invert();
+	corridor->pathway_ends.invert();
+	corridor->entries.invert();
+
+	RWLockWrite write_lock(path_corridors_rwlock);
+	corridor->last_used.set(path_corridor_use_count.increment());
+
+	// Replace the corridor between the same polygons, or forget the least recently used one.
+	int64_t replaced = -1;
+	for (uint32_t i = 0; i < path_corridors.size(); i++) {
+		const PathCorridor *E = path_corridors[i];
+		if (E->navigation_layers == p_navigation_layers && E->polygons[0] == corridor->polygons[0] && E->polygons[E->polygons.size() - 1] == uint32_t(p_end_id)) {
+			replaced = i;
+			break;
+		}
+	}
+	if (replaced == -1 && path_corridors.size() >= MAX_PATH_CORRIDORS) {
+		replaced = 0;
+		for (uint32_t i = 1; i < path_corridors.size(); i++) {
+			if (path_corridors[i]->last_used.get() < path_corridors[replaced]->last_used.get()) {
+				replaced = i;
+			}
+		}
+	}
+
+	if (replaced == -1) {
+		path_corridors.push_back(corridor);
+	} else {
+		memdelete(path_corridors[replaced]);
+		path_corridors[replaced] = corridor;
+	}
+}
+
+void NavMap::_clear_path_corridors() {
+	RWLockWrite write_lock(path_corridors_rwlock);
+	for (PathCorridor *corridor : path_corridors) {
+		memdelete(corridor);
+	}
+	path_corridors.clear();
+}
+
+Vector3 NavMap::get_flow_field_next_position(const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers) const {
 	RWLockRead read_lock(map_rwlock);
 	if (iteration_id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	bool use_collision = p_use_collision;
-	Vector3 closest_point;
-	real_t closest_point_d = FLT_MAX;
+	Vector3 next_position;
+	real_t distance = 0.0;
+	_sample_flow_field(p_destination, p_position, p_navigation_layers, next_position, distance);
+	return next_position;
+}
 
-	for (const gd::Polygon &p : polygons) {
-		// For each face check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
+real_t NavMap::get_flow_field_distance(const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	RWLockRead read_lock(map_rwlock);
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return -1.0;
+	}
+
+	Vector3 next_position;
+	real_t distance = 0.0;
+	if (!_sample_flow_field(p_destination, p_position, p_navigation_layers, next_position, distance)) {
+		return -1.0;
+	}
+	return distance;
+}
+
+bool NavMap::_sample_flow_field(const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers, Vector3 &r_next_position, real_t &r_distance) const {
+	NavPolygonBVH::ClosestPoint closest;
+	_get_closest_polygon_point(p_position, p_navigation_layers, true, closest);
+	if (!closest.is_valid()) {
+		r_next_position = p_position;
+		return false;
+	}
+	r_next_position = closest.point;
+
+	FlowField *field = nullptr;
+	flow_fields_mutex.lock();
+	_update_flow_field_connections();
+	for (FlowField *E : flow_fields) {
+		if (E->navigation_layers == p_navigation_layers && E->destination == p_destination) {
+			field = E;
+			break;
+		}
+	}
+
+	if (!field) {
+		// Built outside of the lock, so queries towards other destinations are not blocked meanwhile.
+		flow_fields_mutex.unlock();
+		FlowField *new_field = memnew(FlowField);
+		new_field->destination = p_destination;
+		new_field->navigation_layers = p_navigation_layers;
+		const uint32_t slot = _acquire_path_query_slot();
+		_build_flow_field(path_query_slots[slot], *new_field);
+		_release_path_query_slot(slot);
+		flow_fields_mutex.lock();
+
+		for (FlowField *E : flow_fields) {
+			if (E->navigation_layers == p_navigation_layers && E->destination == p_destination) {
+				// Another query built the same flow field meanwhile.
+				field = E;
+				break;
+			}
+		}
+		if (field) {
+			memdelete(new_field);
+		} else {
+			if (flow_fields.size() >= MAX_FLOW_FIELDS) {
+				// Forget the least recently used flow field.
+				uint32_t oldest = 0;
+				for (uint32_t i = 1; i < flow_fields.size(); i++) {
+					if (flow_fields[i]->last_used < flow_fields[oldest]->last_used) {
+						oldest = i;
+					}
 				}
+				memdelete(flow_fields[oldest]);
+				flow_fields.remove_at_unordered(oldest);
+			}
+			flow_fields.push_back(new_field);
+			field = new_field;
+		}
+	}
+
+	field->last_used = ++flow_field_use_count;
+	uint32_t polygon = closest.polygon;
+	if (field->costs[polygon] == FLT_MAX) {
+		// The destination can not be reached from here.
+		flow_fields_mutex.unlock();
+		return false;
+	}
+
+	// Standing on the pathway to the next polygon already, so continue from that polygon.
+	while (polygon != field->end_polygon && closest.point.is_equal_approx(field->next_points[polygon])) {
+		polygon = field->next_polygons[polygon];
+	}
+	const real_t cost = field->costs[polygon];
+	const Vector3 next_point = field->next_points[polygon];
+	const real_t travel_cost = _get_polygon(polygon).owner->get_travel_cost();
+	flow_fields_mutex.unlock();
+
+	r_next_position = next_point;
+	r_distance = cost + closest.point.distance_to(next_point) * travel_cost;
+	return true;
+}
+
+void NavMap::_update_flow_field_connections() const {
+	// Only called while holding the flow fields lock.
+	if (!flow_field_connections_dirty) {
+		return;
+	}
+	flow_field_connections_dirty = false;
+
+	const uint32_t polygon_count = polygons.size() + link_polygons.size();
+	flow_field_connection_offsets.resize(polygon_count + 1);
+	for (uint32_t &offset : flow_field_connection_offsets) {
+		offset = 0;
+	}
+
+	for (uint32_t id = 0; id < polygon_count; id++) {
+		for (const gd::Edge &edge : _get_polygon(id).edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				flow_field_connection_offsets[connection.polygon->id + 1]++;
+			}
+		}
+	}
+	for (uint32_t i = 1; i < flow_field_connection_offsets.size(); i++) {
+		flow_field_connection_offsets[i] += flow_field_connection_offsets[i - 1];
+	}
+
+	flow_field_connections.resize(flow_field_connection_offsets[polygon_count]);
+	LocalVector<uint32_t> fill_offsets = flow_field_connection_offsets;
+	for (uint32_t id = 0; id < polygon_count; id++) {
+		for (const gd::Edge &edge : _get_polygon(id).edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				FlowFieldConnection &flow_field_connection = flow_field_connections[fill_offsets[connection.polygon->id]++];
+				flow_field_connection.polygon = id;
+				flow_field_connection.connection = &connection;
 			}
 		}
+	}
+}
 
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
+void NavMap::_build_flow_field(PathQuerySlot &p_slot, FlowField &r_field) const {
+	const uint32_t polygon_count = polygons.size() + link_polygons.size();
+	r_field.costs.resize(polygon_count);
+	r_field.next_points.resize(polygon_count);
+	r_field.next_polygons.resize(polygon_count);
+	for (real_t &cost : r_field.costs) {
+		cost = FLT_MAX;
+	}
+
+	NavPolygonBVH::ClosestPoint end_closest;
+	_get_closest_polygon_point(r_field.destination, r_field.navigation_layers, true, end_closest);
+	if (!end_closest.is_valid()) {
+		return;
+	}
+	r_field.end_polygon = end_closest.polygon;
+	r_field.end_point = end_closest.point;
+
+	// Dijkstra search from the end point, following the polygon connections backwards.
+	// The entry of a navigation poly is where it is left towards the end point, its traveled distance the cost from there.
+	LocalVector<gd::NavigationPoly> &navigation_polys = p_slot.navigation_polys;
+	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostLessThan, gd::NavPolyHeapIndexer> &traversable_polys = p_slot.traversable_polys;
+	p_slot.begin_search();
+
+	gd::NavigationPoly &end_navigation_poly = navigation_polys[r_field.end_polygon];
+	end_navigation_poly = gd::NavigationPoly(&polygons[r_field.end_polygon]);
+	end_navigation_poly.self_id = r_field.end_polygon;
+	end_navigation_poly.generation = p_slot.generation;
+	end_navigation_poly.entry = r_field.end_point;
+	traversable_polys.push(&end_navigation_poly);
+
+	while (!traversable_polys.is_empty()) {
+		const gd::NavigationPoly *least_cost_poly = traversable_polys.pop();
+		const uint32_t least_cost_id = least_cost_poly->self_id;
+		r_field.costs[least_cost_id] = least_cost_poly->traveled_distance;
+		r_field.next_points[least_cost_id] = least_cost_poly->entry;
+		r_field.next_polygons[least_cost_id] = least_cost_poly->back_navigation_poly_id == -1 ? least_cost_id : uint32_t(least_cost_poly->back_navigation_poly_id);
+
+		const NavBase *owner = least_cost_poly->poly->owner;
+		const real_t travel_cost = owner->get_travel_cost();
+
+		for (uint32_t i = flow_field_connection_offsets[least_cost_id]; i < flow_field_connection_offsets[least_cost_id + 1]; i++) {
+			const FlowFieldConnection &flow_field_connection = flow_field_connections[i];
+			const gd::Polygon &polygon = _get_polygon(flow_field_connection.polygon);
+
+			// Path queries only move into polygons with compatible layers.
+			if ((r_field.navigation_layers & polygon.owner->get_navigation_layers()) == 0) {
+				continue;
+			}
 
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
+			Vector3 pathway[2] = { flow_field_connection.connection->pathway_start, flow_field_connection.connection->pathway_end };
+			const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly->entry, pathway);
+			real_t new_distance = least_cost_poly->traveled_distance + new_entry.distance_to(least_cost_poly->entry) * travel_cost;
+			if (polygon.owner != owner) {
+				new_distance += owner->get_enter_cost();
+			}
 
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
+			gd::NavigationPoly &neighbor_poly = navigation_polys[flow_field_connection.polygon];
+			if (neighbor_poly.generation == p_slot.generation) {
+				// Only the polygons still waiting to be visited can get cheaper.
+				if (neighbor_poly.traversable_poly_index != UINT32_MAX && new_distance < neighbor_poly.traveled_distance) {
+					neighbor_poly.back_navigation_poly_id = least_cost_id;
+					neighbor_poly.traveled_distance = new_distance;
+					neighbor_poly.entry = new_entry;
+					traversable_polys.shift(neighbor_poly.traversable_poly_index);
 				}
+			} else {
+				neighbor_poly = gd::NavigationPoly(&polygon);
+				neighbor_poly.self_id = flow_field_connection.polygon;
+				neighbor_poly.generation = p_slot.generation;
+				neighbor_poly.back_navigation_poly_id = least_cost_id;
+				neighbor_poly.traveled_distance = new_distance;
+				neighbor_poly.entry = new_entry;
+				traversable_polys.push(&neighbor_poly);
 			}
 		}
 	}
+}
 
-	return closest_point;
+void NavMap::_clear_flow_fields() {
+	MutexLock lock(flow_fields_mutex);
+	for (FlowField *field : flow_fields) {
+		memdelete(field);
+	}
+	flow_fields.clear();
+	flow_field_connections_dirty = true;
+}
+
+Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
+	RWLockRead read_lock(map_rwlock);
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return Vector3();
+	}
+
+	// The closest point is where the segment first crosses the navigation mesh.
+	NavPolygonBVH::SegmentHit hit;
+	for (const RegionPolygons &E : region_polygons) {
+		E.region->get_polygon_bvh().intersect_segment(polygons.ptr() + E.polygon_offset, E.polygon_offset, p_from, p_to, hit);
+	}
+	if (hit.is_valid() || p_use_collision) {
+		return hit.point;
+	}
+
+	// Otherwise it is on the polygon edge closest to the segment.
+	NavPolygonBVH::SegmentHit closest;
+	for (const RegionPolygons &E : region_polygons) {
+		E.region->get_polygon_bvh().get_closest_edge_point_to_segment(polygons.ptr() + E.polygon_offset, E.polygon_offset, p_from, p_to, closest);
+	}
+	return closest.point;
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
@@ -687,26 +1722,57 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 	RWLockRead read_lock(map_rwlock);
 
 	gd::ClosestPointQueryResult result;
-	real_t closest_point_ds = FLT_MAX;
 
-	for (const gd::Polygon &p : polygons) {
-		// For each face check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t ds = inters.distance_squared_to(p_point);
-			if (ds < closest_point_ds) {
-				result.point = inters;
-				result.normal = f.get_plane().normal;
-				result.owner = p.owner->get_self();
-				closest_point_ds = ds;
-			}
-		}
+	NavPolygonBVH::ClosestPoint closest;
+	_get_closest_polygon_point(p_point, 0, false, closest);
+	if (!closest.is_valid()) {
+		return result;
 	}
 
+	const gd::Polygon &p = polygons[closest.polygon];
+	const Face3 f(p.points[0].pos, p.points[closest.face - 1].pos, p.points[closest.face].pos);
+	result.point = closest.point;
+	result.normal = f.get_plane().normal;
+	result.owner = p.owner->get_self();
+
 	return result;
 }
 
+void NavMap::_get_closest_polygon_point(const Vector3 &p_point, uint32_t p_navigation_layers, bool p_use_navigation_layers, NavPolygonBVH::ClosestPoint &r_closest) const {
+	// Search the nearest region first, so its closest point rules out most of the other regions from their bounds alone.
+	int64_t nearest_index = -1;
+	real_t nearest_distance_squared = FLT_MAX;
+	for (uint32_t i = 0; i < region_polygons.size(); i++) {
+		const NavRegion *region = region_polygons[i].region;
+		if (p_use_navigation_layers && (p_navigation_layers & region->get_navigation_layers()) == 0) {
+			continue;
+		}
+		const real_t distance_squared = region->get_polygon_bvh().get_distance_squared_to(p_point);
+		if (distance_squared < nearest_distance_squared) {
+			nearest_index = i;
+			nearest_distance_squared = distance_squared;
+		}
+	}
+	if (nearest_index == -1) {
+		return;
+	}
+
+	const RegionPolygons &nearest = region_polygons[nearest_index];
+	nearest.region->get_polygon_bvh().get_closest_point(polygons.ptr() + nearest.polygon_offset, nearest.polygon_offset, p_point, r_closest);
+
+	for (uint32_t i = 0; i < region_polygons.size(); i++) {
+		const RegionPolygons &E = region_polygons[i];
+		if (i == nearest_index || (p_use_navigation_layers && (p_navigation_layers & E.region->get_navigation_layers()) == 0)) {
+			continue;
+		}
+		const NavPolygonBVH &bvh = E.region->get_polygon_bvh();
+		if (bvh.get_distance_squared_to(p_point) > r_closest.distance_squared) {
+			continue;
+		}
+		bvh.get_closest_point(polygons.ptr() + E.polygon_offset, E.polygon_offset, p_point, r_closest);
+	}
+}
+
 void NavMap::add_region(NavRegion *p_region) {
 	regions.push_back(p_region);
 	regenerate_links = true;
@@ -880,6 +1946,16 @@ Vector3 NavMap::get_random_point(uint32_t p_navigation_layers, bool p_uniformly)
 }
 
 void NavMap::sync() {
+	_sync();
+
+	// Searching the clusters that changed is the slow part of the hierarchy update, queries can run meanwhile.
+	if (!hierarchy_pending_clusters.is_empty()) {
+		RWLockRead read_lock(map_rwlock);
+		_update_hierarchy_distances();
+	}
+}
+
+void NavMap::_sync() {
 	RWLockWrite write_lock(map_rwlock);
 
 	// Performance Monitor
@@ -900,8 +1976,10 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	HashSet<const NavRegion *> changed_regions;
 	for (NavRegion *region : regions) {
 		if (region->sync()) {
+			changed_regions.insert(region);
 			regenerate_links = true;
 		}
 	}
@@ -936,6 +2014,7 @@ void NavMap::sync() {
 
 		// Copy all region polygons in the map.
 		count = 0;
+		region_polygons.clear();
 		for (const NavRegion *region : regions) {
 			if (!region->get_enabled()) {
 				continue;
@@ -944,119 +2023,77 @@ void NavMap::sync() {
 			for (uint32_t n = 0; n < polygons_source.size(); n++) {
 				polygons[count + n] = polygons_source[n];
 			}
+			region_polygons.push_back({ region, uint32_t(count) });
 			count += region->get_polygons().size();
 		}
 
 		_new_pm_polygon_count = polygons.size();
 
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
-
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
-				}
-			}
+		for (uint32_t i = 0; i < polygons.size(); i++) {
+			polygons[i].id = i;
 		}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
-			}
-		}
+		// Only the regions that changed, and their neighbors, merge and connect their edges again.
+		_update_region_connections(changed_regions);
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
-
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
+		for (const RegionPolygons &E : region_polygons) {
+			region_connection_cache[E.region].polygon_offset = E.polygon_offset;
+		}
 
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
+		// Connect the map polygons.
+		for (const RegionPolygons &E : region_polygons) {
+			const RegionConnectionCache &cache = region_connection_cache[E.region];
+
+			for (const RegionEdgeMerge &merge : cache.internal_merges) {
+				gd::Polygon &polygon_a = polygons[E.polygon_offset + merge.a.polygon];
+				gd::Polygon &polygon_b = polygons[E.polygon_offset + merge.b.polygon];
+
+				gd::Edge::Connection connection_a;
+				connection_a.polygon = &polygon_b;
+				connection_a.edge = merge.b.edge;
+				connection_a.pathway_start = polygon_b.points[merge.b.edge].pos;
+				connection_a.pathway_end = polygon_b.points[(merge.b.edge + 1) % polygon_b.points.size()].pos;
+				polygon_a.edges[merge.a.edge].connections.push_back(connection_a);
+
+				gd::Edge::Connection connection_b;
+				connection_b.polygon = &polygon_a;
+				connection_b.edge = merge.a.edge;
+				connection_b.pathway_start = polygon_a.points[merge.a.edge].pos;
+				connection_b.pathway_end = polygon_a.points[(merge.a.edge + 1) % polygon_a.points.size()].pos;
+				polygon_b.edges[merge.b.edge].connections.push_back(connection_b);
+			}
 
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+			for (const RegionConnection &region_connection : cache.merged_connections) {
+				gd::Edge::Connection connection;
+				connection.polygon = &polygons[region_connection_cache[region_connection.target_region].polygon_offset + region_connection.target_polygon];
+				connection.edge = region_connection.target_edge;
+				connection.pathway_start = region_connection.pathway_start;
+				connection.pathway_end = region_connection.pathway_end;
+				polygons[E.polygon_offset + region_connection.edge.polygon].edges[region_connection.edge.edge].connections.push_back(connection);
+			}
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
+			for (const RegionConnection &region_connection : cache.edge_connections) {
+				gd::Edge::Connection connection;
+				connection.polygon = &polygons[region_connection_cache[region_connection.target_region].polygon_offset + region_connection.target_polygon];
+				connection.edge = region_connection.target_edge;
+				connection.pathway_start = region_connection.pathway_start;
+				connection.pathway_end = region_connection.pathway_end;
+				polygons[E.polygon_offset + region_connection.edge.polygon].edges[region_connection.edge.edge].connections.push_back(connection);
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
-
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
+				// Add the connection to the region_connection map.
+				((NavRegion *)E.region)->get_connections().push_back(connection);
+			}
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+			_new_pm_edge_count += cache.internal_edge_count;
+			_new_pm_edge_merge_count += cache.internal_merges.size();
+			_new_pm_edge_free_count += cache.free_edges.size();
+			_new_pm_edge_connection_count += cache.edge_connections.size();
+		}
 
-				// Add the connection to the region_connection map.
-				((NavRegion *)free_edge.polygon->owner)->get_connections().push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
+		_new_pm_edge_count += boundary_edges.size();
+		for (const KeyValue<gd::EdgeKey, LocalVector<BoundaryEdgeOwner>> &E : boundary_edges) {
+			if (E.value.size() >= 2) {
+				_new_pm_edge_merge_count += 1;
 			}
 		}
 
@@ -1071,48 +2108,25 @@ void NavMap::sync() {
 			const Vector3 start = link->get_start_position();
 			const Vector3 end = link->get_end_position();
 
+			// Find the closest polygons within the search radius of the start and end points.
 			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
 			Vector3 closest_start_point;
+			NavPolygonBVH::ClosestPoint start_closest;
+			start_closest.distance_squared = link_connection_radius * link_connection_radius;
+			_get_closest_polygon_point(start, 0, false, start_closest);
+			if (start_closest.is_valid() && start_closest.distance_squared < link_connection_radius * link_connection_radius) {
+				closest_start_polygon = &polygons[start_closest.polygon];
+				closest_start_point = start_closest.point;
+			}
 
 			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
 			Vector3 closest_end_point;
-
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
-
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
-				}
-			}
-
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
-				}
+			NavPolygonBVH::ClosestPoint end_closest;
+			end_closest.distance_squared = link_connection_radius * link_connection_radius;
+			_get_closest_polygon_point(end, 0, false, end_closest);
+			if (end_closest.is_valid() && end_closest.distance_squared < link_connection_radius * link_connection_radius) {
+				closest_end_polygon = &polygons[end_closest.polygon];
+				closest_end_point = end_closest.point;
 			}
 
 			// If we have both a start and end point, then create a synthetic polygon to route through.
@@ -1174,9 +2188,34 @@ void NavMap::sync() {
 			}
 		}
 
+		// Drop the polygons of the disabled or unconnected links, shrinking keeps the connections to the others valid.
+		link_polygons.resize(link_poly_idx);
+
+		// Link polygons are searched after the map polygons.
+		for (uint32_t i = 0; i < link_polygons.size(); i++) {
+			link_polygons[i].id = polygons.size() + i;
+		}
+
+		_update_path_query_slots();
+
+		if (use_hierarchical_pathfinding) {
+			_update_hierarchy(changed_regions);
+		} else {
+			_clear_hierarchy();
+		}
+
+		// The flow fields, path corridors and their connections point into the old polygons.
+		_clear_flow_fields();
+		_clear_path_corridors();
+
 		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
 		iteration_id = iteration_id % UINT32_MAX + 1;
+	} else if (path_caches_dirty) {
+		// The flow fields and path corridors were found with the previous layers and costs.
+		_clear_flow_fields();
+		_clear_path_corridors();
 	}
+	path_caches_dirty = false;
 
 	// Do we have modified obstacle positions?
 	for (NavObstacle *obstacle : obstacles) {
@@ -1288,9 +2327,23 @@ void NavMap::_update_rvo_obstacles_tree_2d() {
 	}
 
 	rvo_simulation_2d.kdTree_->buildObstacleTree(raw_obstacles);
+
+	if (avoidance_use_batched_solver) {
+		batch_avoidance_2d.set_obstacles(rvo_simulation_2d.obstacles_);
+	}
 }
 
 void NavMap::_update_rvo_agents_tree_2d() {
+	if (avoidance_use_batched_solver) {
+		// The batched solver builds its own neighbor grid each step.
+		batch_avoidance_agents_2d.clear();
+		batch_avoidance_agents_2d.reserve(active_2d_avoidance_agents.size());
+		for (NavAgent *agent : active_2d_avoidance_agents) {
+			batch_avoidance_agents_2d.push_back(agent->get_rvo_agent_2d());
+		}
+		return;
+	}
+
 	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
 	std::vector<RVO2D::Agent2D *> raw_agents;
 	raw_agents.reserve(active_2d_avoidance_agents.size());
@@ -1340,7 +2393,12 @@ void NavMap::step(real_t p_deltatime) {
 	rvo_simulation_2d.setTimeStep(float(deltatime));
 	rvo_simulation_3d.setTimeStep(float(deltatime));
 
-	if (active_2d_avoidance_agents.size() > 0) {
+	if (active_2d_avoidance_agents.size() > 0 && avoidance_use_batched_solver) {
+		batch_avoidance_2d.solve(batch_avoidance_agents_2d.ptr(), batch_avoidance_agents_2d.size(), float(deltatime), use_threads && avoidance_use_multiple_threads, avoidance_use_high_priority_threads);
+		for (NavAgent *agent : active_2d_avoidance_agents) {
+			agent->update();
+		}
+	} else if (active_2d_avoidance_agents.size() > 0) {
 		if (use_threads && avoidance_use_multiple_threads) {
 			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_2d, active_2d_avoidance_agents.ptr(), active_2d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents2D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
@@ -1420,7 +2478,22 @@ void NavMap::_update_merge_rasterizer_cell_dimensions() {
 NavMap::NavMap() {
 	avoidance_use_multiple_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_multiple_threads");
 	avoidance_use_high_priority_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_high_priority_threads");
+	avoidance_use_batched_solver = int(GLOBAL_GET("navigation/avoidance/avoidance_solver")) == 1;
+
+	// One path query slot for each thread that may query the map at the same time.
+	uint32_t path_query_slot_count = 4;
+	if (WorkerThreadPool::get_singleton()) {
+		path_query_slot_count = MAX(path_query_slot_count, uint32_t(WorkerThreadPool::get_singleton()->get_thread_count() + 1));
+	}
+	path_query_slots.resize(path_query_slot_count);
+	path_query_free_slots.reserve(path_query_slot_count);
+	for (uint32_t i = 0; i < path_query_slot_count; i++) {
+		path_query_free_slots.push_back(i);
+	}
+	path_query_slots_semaphore.post(path_query_slot_count);
 }
 
 NavMap::~NavMap() {
+	_clear_flow_fields();
+	_clear_path_corridors();
 }
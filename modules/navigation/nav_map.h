@@ -31,11 +31,16 @@
 #ifndef NAV_MAP_H
 #define NAV_MAP_H
 
+#include "nav_batch_avoidance_2d.h"
+#include "nav_polygon_bvh.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 
 #include "core/math/math_defs.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/templates/hash_set.h"
 
 #include <KdTree2d.h>
 #include <KdTree3d.h>
@@ -73,6 +78,8 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	/// Forces every region to rebuild its edge connections, when the edge connection settings change.
+	bool regenerate_connections = true;
 
 	/// Map regions
 	LocalVector<NavRegion *> regions;
@@ -84,10 +91,220 @@ class NavMap : public NavRid {
 	/// Map polygons
 	LocalVector<gd::Polygon> polygons;
 
+	/// Where the polygons of each enabled region start in `polygons`.
+	/// The region polygon BVHs are searched with these offsets, so only the regions that changed rebuild their hierarchy on sync.
+	struct RegionPolygons {
+		const NavRegion *region = nullptr;
+		uint32_t polygon_offset = 0;
+	};
+	LocalVector<RegionPolygons> region_polygons;
+
+	/// Edge of a region polygon.
+	struct RegionEdge {
+		uint32_t polygon = 0;
+		uint32_t edge = 0;
+	};
+
+	struct RegionEdgeMerge {
+		RegionEdge a;
+		RegionEdge b;
+	};
+
+	struct RegionBoundaryEdge {
+		RegionEdge edge;
+		gd::EdgeKey key;
+	};
+
+	/// Connection from a region polygon edge to the polygon of another region.
+	struct RegionConnection {
+		RegionEdge edge;
+		const NavRegion *target_region = nullptr;
+		uint32_t target_polygon = 0;
+		int target_edge = -1;
+		Vector3 pathway_start;
+		Vector3 pathway_end;
+	};
+
+	/// Edges and connections of a region, in region polygon indices so they survive the map polygons being rebuilt.
+	/// Only the regions that changed, and the regions next to them, are reconnected on sync.
+	struct RegionConnectionCache {
+		bool has_polygons = false;
+		AABB bounds;
+		uint32_t polygon_offset = 0;
+
+		/// Edges shared by two polygons of the region.
+		LocalVector<RegionEdgeMerge> internal_merges;
+		uint32_t internal_edge_count = 0;
+		/// Edges not shared inside the region, they may be shared with another region.
+		LocalVector<RegionBoundaryEdge> boundary_edges;
+
+		/// Boundary edges shared with another region.
+		LocalVector<RegionConnection> merged_connections;
+		/// Boundary edges not shared with any region, connected by proximity.
+		LocalVector<RegionEdge> free_edges;
+		LocalVector<RegionConnection> edge_connections;
+	};
+	HashMap<const NavRegion *, RegionConnectionCache> region_connection_cache;
+
+	struct BoundaryEdgeOwner {
+		const NavRegion *region = nullptr;
+		RegionEdge edge;
+	};
+	/// Boundary edges of all the regions, by key.
+	HashMap<gd::EdgeKey, LocalVector<BoundaryEdgeOwner>, gd::EdgeKey> boundary_edges;
+
+	/// Hierarchical pathfinding.
+	/// Every region, and every link polygon, is a cluster. Portals are the polygons connected to other clusters.
+	/// The travel distances between the portals of a cluster are precomputed on sync, so paths between clusters
+	/// first find the clusters to cross, and then only search the polygons of those clusters.
+	bool use_hierarchical_pathfinding = false;
+
+	struct HierarchyCluster {
+		const NavBase *owner = nullptr;
+		uint32_t first_portal = 0;
+		uint32_t portal_count = 0;
+		/// Travel distances from each portal to the others through the cluster, FLT_MAX when not connected.
+		LocalVector<real_t> portal_distances;
+	};
+
+	struct HierarchyPortalLink {
+		uint32_t portal = 0;
+		real_t distance = 0.0;
+	};
+
+	/// Portal distances kept for the regions that did not change since the last sync.
+	struct HierarchyClusterCache {
+		LocalVector<uint32_t> local_portals;
+		LocalVector<real_t> portal_distances;
+	};
+
+	LocalVector<HierarchyCluster> hierarchy_clusters;
+	/// Cluster of each polygon, indexed by polygon id.
+	LocalVector<uint32_t> hierarchy_polygon_clusters;
+	/// Polygon id of each portal, grouped by cluster.
+	LocalVector<uint32_t> hierarchy_portals;
+	/// Links from the portals to portals of other clusters, those of portal `i` start at `hierarchy_portal_links_offsets[i]`.
+	LocalVector<uint32_t> hierarchy_portal_links_offsets;
+	LocalVector<HierarchyPortalLink> hierarchy_portal_links;
+	HashMap<const NavRegion *, HierarchyClusterCache> hierarchy_cluster_cache;
+	/// Clusters whose portal distances still have to be searched after the map write lock is released.
+	LocalVector<uint32_t> hierarchy_pending_clusters;
+	/// Set once every cluster has its portal distances, until then path queries search without the hierarchy.
+	SafeFlag hierarchy_ready;
+
+	/// Search state of a portal in the hierarchy.
+	struct HierarchyNode {
+		real_t cost = 0.0;
+		real_t estimate = 0.0;
+		/// Cost from this portal to the end point, when it is in the end cluster.
+		real_t exit_cost = 0.0;
+		uint32_t parent = UINT32_MAX;
+		uint32_t generation = 0;
+		uint32_t exit_generation = 0;
+		uint32_t heap_index = UINT32_MAX;
+	};
+
+	struct HierarchyNodeLessThan {
+		bool operator()(const HierarchyNode *p_node_a, const HierarchyNode *p_node_b) const {
+			return p_node_a->cost + p_node_a->estimate < p_node_b->cost + p_node_b->estimate;
+		}
+	};
+
+	struct HierarchyNodeIndexer {
+		void operator()(HierarchyNode *p_node, uint32_t p_heap_index) const {
+			p_node->heap_index = p_heap_index;
+		}
+	};
+
+	/// Reusable pathfinding state, one per concurrent get_path() query.
+	struct PathQuerySlot {
+		/// Search state of every map and link polygon, indexed by polygon id.
+		LocalVector<gd::NavigationPoly> navigation_polys;
+		/// Polygons to visit, cheapest first.
+		gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostLessThan, gd::NavPolyHeapIndexer> traversable_polys;
+		/// Current search, so the polygons do not need to be reset between searches.
+		uint32_t generation = 0;
+
+		/// Search state of each hierarchy portal, indexed like `hierarchy_portals`.
+		LocalVector<HierarchyNode> hierarchy_nodes;
+		gd::Heap<HierarchyNode *, HierarchyNodeLessThan, HierarchyNodeIndexer> hierarchy_open;
+		/// Clusters the current search is limited to, those stamped with the current `hierarchy_generation`.
+		LocalVector<uint32_t> corridor_clusters;
+		uint32_t hierarchy_generation = 0;
+
+		void begin_search();
+		void begin_hierarchy_search();
+	};
+	mutable LocalVector<PathQuerySlot> path_query_slots;
+	mutable LocalVector<uint32_t> path_query_free_slots;
+	Mutex path_query_slots_mutex;
+	Semaphore path_query_slots_semaphore;
+
+	/// Polygons crossed by recent paths, with the pathways between them.
+	/// Path queries whose start and end polygons lie along one of them only run the post-processing
+	/// on that part of the corridor, instead of searching the map again.
+	bool use_path_corridor_cache = false;
+
+	struct PathCorridor {
+		uint32_t navigation_layers = 0;
+		/// Polygon ids from the start to the end polygon.
+		LocalVector<uint32_t> polygons;
+		/// The edge and the pathway crossed to enter each polygon, and the entry point on it.
+		LocalVector<int> edges;
+		LocalVector<Vector3> pathway_starts;
+		LocalVector<Vector3> pathway_ends;
+		LocalVector<Vector3> entries;
+		SafeNumeric<uint64_t> last_used;
+	};
+
+	static const uint32_t MAX_PATH_CORRIDORS = 64;
+	mutable LocalVector<PathCorridor *> path_corridors;
+	mutable SafeNumeric<uint64_t> path_corridor_use_count;
+	/// Lookups only read the corridors, so concurrent queries share the lock and only adding a corridor is exclusive.
+	mutable RWLock path_corridors_rwlock;
+
+	/// Flow fields, for every polygon where to go next to reach a destination.
+	/// They are shared by all the queries towards the same destination until the map changes.
+	struct FlowField {
+		Vector3 destination;
+		uint32_t navigation_layers = 0;
+		/// Closest point to the destination on the navigation mesh, and its polygon.
+		Vector3 end_point;
+		uint32_t end_polygon = UINT32_MAX;
+		/// Travel cost from the next point of each polygon to the end point, FLT_MAX when the end point is not reachable.
+		LocalVector<real_t> costs;
+		/// Point on the pathway to the next polygon towards the end point, the end point itself in the end polygon.
+		LocalVector<Vector3> next_points;
+		LocalVector<uint32_t> next_polygons;
+		uint64_t last_used = 0;
+	};
+
+	/// Connection leading into a polygon, used to search the polygons backwards from the destination.
+	struct FlowFieldConnection {
+		uint32_t polygon = 0;
+		const gd::Edge::Connection *connection = nullptr;
+	};
+
+	static const uint32_t MAX_FLOW_FIELDS = 16;
+	mutable LocalVector<FlowField *> flow_fields;
+	mutable uint64_t flow_field_use_count = 0;
+	/// Connections into the polygon `i` start at `flow_field_connection_offsets[i]`, built on the first flow field query after a sync.
+	mutable LocalVector<uint32_t> flow_field_connection_offsets;
+	mutable LocalVector<FlowFieldConnection> flow_field_connections;
+	mutable bool flow_field_connections_dirty = true;
+	mutable Mutex flow_fields_mutex;
+
+	/// Set when the layers or costs of a region or link changed, the flow fields and path corridors found with the previous ones are cleared on the next sync.
+	bool path_caches_dirty = false;
+
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
 	RVO3D::RVOSimulator3D rvo_simulation_3d;
 
+	/// Solver replacing the RVO2 simulation for the 2D avoidance agents when batched avoidance is used.
+	NavBatchAvoidance2D batch_avoidance_2d;
+	LocalVector<RVO2D::Agent2D *> batch_avoidance_agents_2d;
+
 	/// avoidance controlled agents
 	LocalVector<NavAgent *> active_2d_avoidance_agents;
 	LocalVector<NavAgent *> active_3d_avoidance_agents;
@@ -113,6 +330,7 @@ class NavMap : public NavRid {
 	bool use_threads = true;
 	bool avoidance_use_multiple_threads = true;
 	bool avoidance_use_high_priority_threads = true;
+	bool avoidance_use_batched_solver = false;
 
 	// Performance Monitor
 	int pm_region_count = 0;
@@ -158,6 +376,20 @@ public:
 		return edge_connection_margin;
 	}
 
+	void set_use_hierarchical_pathfinding(bool p_enabled);
+	bool get_use_hierarchical_pathfinding() const {
+		return use_hierarchical_pathfinding;
+	}
+
+	void set_use_path_corridor_cache(bool p_enabled);
+	bool get_use_path_corridor_cache() const {
+		return use_path_corridor_cache;
+	}
+
+	void invalidate_path_caches() {
+		path_caches_dirty = true;
+	}
+
 	void set_link_connection_radius(real_t p_link_connection_radius);
 	real_t get_link_connection_radius() const {
 		return link_connection_radius;
@@ -166,6 +398,8 @@ public:
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
 	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	Vector3 get_flow_field_next_position(const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers) const;
+	real_t get_flow_field_distance(const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers) const;
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
@@ -223,6 +457,37 @@ private:
 	void compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent);
 	void compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent);
 
+	uint32_t _acquire_path_query_slot() const;
+	void _release_path_query_slot(uint32_t p_slot) const;
+	void _update_path_query_slots();
+	void _build_region_edges(const NavRegion *p_region, RegionConnectionCache &r_cache);
+	void _remove_region_boundary_edges(const NavRegion *p_region, const RegionConnectionCache &p_cache);
+	void _connect_region_free_edges(const NavRegion *p_region, RegionConnectionCache &r_cache, const NavRegion *p_other_region, const RegionConnectionCache &p_other_cache) const;
+	void _update_region_connections(const HashSet<const NavRegion *> &p_changed_regions);
+
+	const gd::Polygon &_get_polygon(uint32_t p_id) const {
+		return p_id < polygons.size() ? polygons[p_id] : link_polygons[p_id - polygons.size()];
+	}
+	void _sync();
+	void _update_hierarchy(const HashSet<const NavRegion *> &p_changed_regions);
+	void _update_hierarchy_distances();
+	void _clear_hierarchy();
+	void _search_hierarchy_cluster(PathQuerySlot &p_slot, const gd::Polygon *p_start) const;
+	bool _find_hierarchy_corridor(PathQuerySlot &p_slot, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers) const;
+	Vector<Vector3> _get_path(PathQuerySlot &p_slot, const Vector3 &p_origin, const Vector3 &p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+
+	Vector<Vector3> _build_path(LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, bool p_optimize, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	bool _reuse_path_corridor(PathQuerySlot &p_slot, const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, uint32_t p_navigation_layers) const;
+	void _add_path_corridor(const LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id, uint32_t p_navigation_layers) const;
+	void _clear_path_corridors();
+
+	void _update_flow_field_connections() const;
+	void _build_flow_field(PathQuerySlot &p_slot, FlowField &r_field) const;
+	bool _sample_flow_field(const Vector3 &p_destination, const Vector3 &p_position, uint32_t p_navigation_layers, Vector3 &r_next_position, real_t &r_distance) const;
+	void _clear_flow_fields();
+
+	void _get_closest_polygon_point(const Vector3 &p_point, uint32_t p_navigation_layers, bool p_use_navigation_layers, NavPolygonBVH::ClosestPoint &r_closest) const;
+
 	void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree_2d();
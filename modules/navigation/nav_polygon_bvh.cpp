@@ -0,0 +1,276 @@
+/**************************************************************************/
+/*  nav_polygon_bvh.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_polygon_bvh.h"
+
+#include "core/math/face3.h"
+#include "core/math/geometry_3d.h"
+#include "core/templates/sort_array.h"
+
+// Slack added to the bounds when testing segments, as flat navigation meshes have bounds with no thickness.
+#define SEGMENT_BOUNDS_MARGIN 0.001
+
+struct PolygonCenterComparator {
+	const AABB *aabbs = nullptr;
+	int axis = 0;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return aabbs[p_a].get_center()[axis] < aabbs[p_b].get_center()[axis];
+	}
+};
+
+void NavPolygonBVH::_build_node(uint32_t p_node, uint32_t p_begin, uint32_t p_end, const LocalVector<AABB> &p_polygon_aabbs, uint32_t p_depth) {
+	AABB aabb = p_polygon_aabbs[polygon_indices[p_begin]];
+	AABB centers(aabb.get_center(), Vector3());
+	for (uint32_t i = p_begin + 1; i < p_end; i++) {
+		const AABB &polygon_aabb = p_polygon_aabbs[polygon_indices[i]];
+		aabb.merge_with(polygon_aabb);
+		centers.expand_to(polygon_aabb.get_center());
+	}
+	nodes[p_node].aabb = aabb;
+
+	// The depth is bounded by the median split, the check only guards the query stacks.
+	if (p_end - p_begin <= MAX_LEAF_POLYGONS || p_depth + 1 >= MAX_DEPTH) {
+		nodes[p_node].first = p_begin;
+		nodes[p_node].count = p_end - p_begin;
+		return;
+	}
+
+	// Split at the median along the axis where the polygon centers spread the most.
+	SortArray<uint32_t, PolygonCenterComparator> sorter;
+	sorter.compare.aabbs = p_polygon_aabbs.ptr();
+	sorter.compare.axis = centers.get_longest_axis_index();
+	const uint32_t middle = (p_begin + p_end) / 2;
+	sorter.nth_element(p_begin, p_end, middle, polygon_indices.ptr());
+
+	const uint32_t first_child = nodes.size();
+	nodes.resize(first_child + 2);
+	nodes[p_node].first = first_child;
+	nodes[p_node].count = 0;
+
+	_build_node(first_child, p_begin, middle, p_polygon_aabbs, p_depth + 1);
+	_build_node(first_child + 1, middle, p_end, p_polygon_aabbs, p_depth + 1);
+}
+
+void NavPolygonBVH::build(const LocalVector<gd::Polygon> &p_polygons) {
+	clear();
+
+	LocalVector<AABB> polygon_aabbs;
+	polygon_aabbs.resize(p_polygons.size());
+	polygon_indices.reserve(p_polygons.size());
+
+	for (uint32_t i = 0; i < p_polygons.size(); i++) {
+		const gd::Polygon &polygon = p_polygons[i];
+		// Polygons that failed to build have no faces, and are never the closest.
+		if (polygon.points.size() < 3) {
+			continue;
+		}
+
+		AABB aabb(polygon.points[0].pos, Vector3());
+		for (uint32_t j = 1; j < polygon.points.size(); j++) {
+			aabb.expand_to(polygon.points[j].pos);
+		}
+		polygon_aabbs[i] = aabb;
+		polygon_indices.push_back(i);
+	}
+
+	if (polygon_indices.is_empty()) {
+		return;
+	}
+
+	nodes.reserve(2 * (polygon_indices.size() / MAX_LEAF_POLYGONS + 1));
+	nodes.resize(1);
+	_build_node(0, 0, polygon_indices.size(), polygon_aabbs, 0);
+}
+
+void NavPolygonBVH::clear() {
+	nodes.clear();
+	polygon_indices.clear();
+}
+
+real_t NavPolygonBVH::get_distance_squared_to(const Vector3 &p_point) const {
+	if (nodes.is_empty()) {
+		return FLT_MAX;
+	}
+	const AABB &aabb = nodes[0].aabb;
+	return p_point.distance_squared_to(p_point.clamp(aabb.position, aabb.position + aabb.size));
+}
+
+void NavPolygonBVH::get_closest_point(const gd::Polygon *p_polygons, uint32_t p_polygon_offset, const Vector3 &p_point, ClosestPoint &r_closest) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	// Depth first, visiting the nearest child first so the search bound shrinks quickly.
+	uint32_t stack[MAX_DEPTH + 1];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		const Vector3 closest_on_bounds = p_point.clamp(node.aabb.position, node.aabb.position + node.aabb.size);
+		if (p_point.distance_squared_to(closest_on_bounds) > r_closest.distance_squared) {
+			continue;
+		}
+
+		if (node.count == 0) {
+			const AABB &first = nodes[node.first].aabb;
+			const AABB &second = nodes[node.first + 1].aabb;
+			const real_t first_distance = p_point.distance_squared_to(p_point.clamp(first.position, first.position + first.size));
+			const real_t second_distance = p_point.distance_squared_to(p_point.clamp(second.position, second.position + second.size));
+			if (first_distance <= second_distance) {
+				stack[stack_size++] = node.first + 1;
+				stack[stack_size++] = node.first;
+			} else {
+				stack[stack_size++] = node.first;
+				stack[stack_size++] = node.first + 1;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const uint32_t polygon_index = polygon_indices[i];
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+			const uint32_t result_index = p_polygon_offset + polygon_index;
+
+			for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				const Vector3 point = face.get_closest_point_to(p_point);
+				const real_t distance_squared = point.distance_squared_to(p_point);
+				if (distance_squared < r_closest.distance_squared || (distance_squared == r_closest.distance_squared && result_index < r_closest.polygon)) {
+					r_closest.polygon = result_index;
+					r_closest.face = point_id;
+					r_closest.point = point;
+					r_closest.distance_squared = distance_squared;
+				}
+			}
+		}
+	}
+}
+
+void NavPolygonBVH::intersect_segment(const gd::Polygon *p_polygons, uint32_t p_polygon_offset, const Vector3 &p_from, const Vector3 &p_to, SegmentHit &r_hit) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	uint32_t stack[MAX_DEPTH + 1];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (!node.aabb.grow(SEGMENT_BOUNDS_MARGIN).intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		if (node.count == 0) {
+			stack[stack_size++] = node.first + 1;
+			stack[stack_size++] = node.first;
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const uint32_t polygon_index = polygon_indices[i];
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+			const uint32_t result_index = p_polygon_offset + polygon_index;
+
+			for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				Vector3 intersection;
+				if (!face.intersects_segment(p_from, p_to, &intersection)) {
+					continue;
+				}
+				const real_t distance = p_from.distance_to(intersection);
+				if (distance < r_hit.distance || (distance == r_hit.distance && result_index < r_hit.polygon)) {
+					r_hit.polygon = result_index;
+					r_hit.point = intersection;
+					r_hit.distance = distance;
+				}
+			}
+		}
+	}
+}
+
+void NavPolygonBVH::get_closest_edge_point_to_segment(const gd::Polygon *p_polygons, uint32_t p_polygon_offset, const Vector3 &p_from, const Vector3 &p_to, SegmentHit &r_closest) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	uint32_t stack[MAX_DEPTH + 1];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	const Vector3 segment_center = (p_from + p_to) * 0.5;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		// The segment misses the bounds grown by the current distance only if every edge inside is further away.
+		if (r_closest.distance < FLT_MAX && !node.aabb.grow(r_closest.distance + SEGMENT_BOUNDS_MARGIN).intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		if (node.count == 0) {
+			const real_t first_distance = nodes[node.first].aabb.get_center().distance_squared_to(segment_center);
+			const real_t second_distance = nodes[node.first + 1].aabb.get_center().distance_squared_to(segment_center);
+			if (first_distance <= second_distance) {
+				stack[stack_size++] = node.first + 1;
+				stack[stack_size++] = node.first;
+			} else {
+				stack[stack_size++] = node.first;
+				stack[stack_size++] = node.first + 1;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const uint32_t polygon_index = polygon_indices[i];
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+			const uint32_t result_index = p_polygon_offset + polygon_index;
+
+			for (uint32_t point_id = 0; point_id < polygon.points.size(); point_id++) {
+				Vector3 on_segment, on_edge;
+				Geometry3D::get_closest_points_between_segments(
+						p_from,
+						p_to,
+						polygon.points[point_id].pos,
+						polygon.points[(point_id + 1) % polygon.points.size()].pos,
+						on_segment,
+						on_edge);
+
+				const real_t distance = on_segment.distance_to(on_edge);
+				if (distance < r_closest.distance || (distance == r_closest.distance && result_index < r_closest.polygon)) {
+					r_closest.polygon = result_index;
+					r_closest.point = on_edge;
+					r_closest.distance = distance;
+				}
+			}
+		}
+	}
+}
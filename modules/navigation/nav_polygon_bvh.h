@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*  nav_polygon_bvh.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_POLYGON_BVH_H
+#define NAV_POLYGON_BVH_H
+
+#include "nav_utils.h"
+
+#include "core/math/aabb.h"
+
+/// Static bounding volume hierarchy over the polygons of a navigation region.
+/// It is rebuilt by the region when its polygons change, and lets the map
+/// find the closest polygon to a point without visiting every polygon.
+///
+/// The queries take the polygons to test, which must be the polygons the
+/// hierarchy was built from or copies of them (the map keeps copies of the
+/// region polygons). `p_polygon_offset` is added to the polygon indices
+/// reported in the results, so the map can search several regions in turn.
+/// Ties are resolved towards the lowest reported index, which gives the
+/// same results as testing every polygon in order.
+class NavPolygonBVH {
+public:
+	struct ClosestPoint {
+		uint32_t polygon = UINT32_MAX;
+		/// Index of the last point of the closest face of the polygon fan.
+		uint32_t face = 0;
+		Vector3 point;
+		real_t distance_squared = FLT_MAX;
+
+		bool is_valid() const { return polygon != UINT32_MAX; }
+	};
+
+	struct SegmentHit {
+		uint32_t polygon = UINT32_MAX;
+		Vector3 point;
+		real_t distance = FLT_MAX;
+
+		bool is_valid() const { return polygon != UINT32_MAX; }
+	};
+
+private:
+	struct Node {
+		AABB aabb;
+		/// Leaves: first entry in `polygon_indices`. Inner nodes: index of the first child, the second one follows it.
+		uint32_t first = 0;
+		/// Number of polygons in a leaf, 0 for inner nodes.
+		uint32_t count = 0;
+	};
+
+	static const uint32_t MAX_LEAF_POLYGONS = 4;
+	static const uint32_t MAX_DEPTH = 64;
+
+	LocalVector<Node> nodes;
+	LocalVector<uint32_t> polygon_indices;
+
+	void _build_node(uint32_t p_node, uint32_t p_begin, uint32_t p_end, const LocalVector<AABB> &p_polygon_aabbs, uint32_t p_depth);
+
+public:
+	void build(const LocalVector<gd::Polygon> &p_polygons);
+	void clear();
+
+	bool is_empty() const { return nodes.is_empty(); }
+	AABB get_aabb() const { return nodes.is_empty() ? AABB() : nodes[0].aabb; }
+
+	/// Squared distance from `p_point` to the bounds of all the polygons, a lower bound for `get_closest_point()`.
+	real_t get_distance_squared_to(const Vector3 &p_point) const;
+
+	/// Updates `r_closest` if a face is closer to `p_point` than the one it holds.
+	void get_closest_point(const gd::Polygon *p_polygons, uint32_t p_polygon_offset, const Vector3 &p_point, ClosestPoint &r_closest) const;
+	/// Updates `r_hit` if the segment crosses a face closer to `p_from` than the one it holds.
+	void intersect_segment(const gd::Polygon *p_polygons, uint32_t p_polygon_offset, const Vector3 &p_from, const Vector3 &p_to, SegmentHit &r_hit) const;
+	/// Updates `r_closest` if a polygon edge gets closer to the segment than the one it holds, `distance` being the distance to the segment.
+	void get_closest_edge_point_to_segment(const gd::Polygon *p_polygons, uint32_t p_polygon_offset, const Vector3 &p_from, const Vector3 &p_to, SegmentHit &r_closest) const;
+};
+
+#endif // NAV_POLYGON_BVH_H
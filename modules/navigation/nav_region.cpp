@@ -61,6 +61,36 @@ void NavRegion::set_enabled(bool p_enabled) {
 	polygons_dirty = true;
 };
 
+void NavRegion::set_navigation_layers(uint32_t p_navigation_layers) {
+	if (navigation_layers == p_navigation_layers) {
+		return;
+	}
+	NavBase::set_navigation_layers(p_navigation_layers);
+	if (map) {
+		map->invalidate_path_caches();
+	}
+}
+
+void NavRegion::set_enter_cost(real_t p_enter_cost) {
+	if (enter_cost == MAX(p_enter_cost, 0.0)) {
+		return;
+	}
+	NavBase::set_enter_cost(p_enter_cost);
+	if (map) {
+		map->invalidate_path_caches();
+	}
+}
+
+void NavRegion::set_travel_cost(real_t p_travel_cost) {
+	if (travel_cost == MAX(p_travel_cost, 0.0)) {
+		return;
+	}
+	NavBase::set_travel_cost(p_travel_cost);
+	if (map) {
+		map->invalidate_path_caches();
+	}
+}
+
 void NavRegion::set_use_edge_connections(bool p_enabled) {
 	if (use_edge_connections != p_enabled) {
 		use_edge_connections = p_enabled;
@@ -195,6 +225,7 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	polygon_bvh.clear();
 	surface_area = 0.0;
 	polygons_dirty = false;
 
@@ -301,4 +332,6 @@ void NavRegion::update_polygons() {
 	}
 
 	surface_area = _new_region_surface_area;
+
+	polygon_bvh.build(polygons);
 }
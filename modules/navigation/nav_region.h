@@ -32,6 +32,7 @@
 #define NAV_REGION_H
 
 #include "nav_base.h"
+#include "nav_polygon_bvh.h"
 #include "nav_utils.h"
 
 #include "scene/resources/navigation_mesh.h"
@@ -49,6 +50,7 @@ class NavRegion : public NavBase {
 
 	/// Cache
 	LocalVector<gd::Polygon> polygons;
+	NavPolygonBVH polygon_bvh;
 
 	real_t surface_area = 0.0;
 
@@ -69,6 +71,10 @@ public:
 		return map;
 	}
 
+	void set_navigation_layers(uint32_t p_navigation_layers) override;
+	void set_enter_cost(real_t p_enter_cost) override;
+	void set_travel_cost(real_t p_travel_cost) override;
+
 	void set_use_edge_connections(bool p_enabled);
 	bool get_use_edge_connections() const {
 		return use_edge_connections;
@@ -95,6 +101,10 @@ public:
 		return polygons;
 	}
 
+	const NavPolygonBVH &get_polygon_bvh() const {
+		return polygon_bvh;
+	}
+
 	Vector3 get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const;
 
 	real_t get_surface_area() const { return surface_area; };
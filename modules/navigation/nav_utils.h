@@ -114,6 +114,9 @@ struct Polygon {
 	Vector3 center;
 
 	real_t surface_area = 0.0;
+
+	/// Index of this `Polygon` in the map search buffers, set by the map.
+	uint32_t id = UINT32_MAX;
 };
 
 struct NavigationPoly {
@@ -121,6 +124,11 @@ struct NavigationPoly {
 	/// This poly.
 	const Polygon *poly;
 
+	/// The search this state belongs to, older ones are treated as not visited.
+	uint32_t generation = 0;
+	/// Position in the heap of polygons to visit, `UINT32_MAX` when not in it.
+	uint32_t traversable_poly_index = UINT32_MAX;
+
 	/// Those 4 variables are used to travel the path backwards.
 	int back_navigation_poly_id = -1;
 	int back_navigation_edge = -1;
@@ -129,8 +137,10 @@ struct NavigationPoly {
 
 	/// The entry position of this poly.
 	Vector3 entry;
-	/// The distance to the destination.
+	/// The distance traveled from the start.
 	real_t traveled_distance = 0.0;
+	/// The estimated cost to reach the destination from the entry.
+	real_t distance_to_destination = 0.0;
 
 	NavigationPoly() { poly = nullptr; }
 
@@ -144,6 +154,126 @@ struct NavigationPoly {
 	bool operator!=(const NavigationPoly &other) const {
 		return !operator==(other);
 	}
+
+	real_t total_travel_cost() const {
+		return traveled_distance + distance_to_destination;
+	}
+};
+
+struct NavPolyTravelCostLessThan {
+	bool operator()(const NavigationPoly *p_poly_a, const NavigationPoly *p_poly_b) const {
+		return p_poly_a->total_travel_cost() < p_poly_b->total_travel_cost();
+	}
+};
+
+struct NavPolyHeapIndexer {
+	void operator()(NavigationPoly *p_poly, uint32_t p_heap_index) const {
+		p_poly->traversable_poly_index = p_heap_index;
+	}
+};
+
+template <typename T>
+struct NoopIndexer {
+	void operator()(const T &p_value, uint32_t p_index) const {}
+};
+
+/// Binary heap keeping the smallest element, as ordered by `LessThan`, on top.
+/// `Indexer` is told where elements move to (`UINT32_MAX` once removed), so an
+/// element whose key decreased can be moved up in place with `shift()`.
+template <typename T, typename LessThan = Comparator<T>, typename Indexer = NoopIndexer<T>>
+class Heap {
+	LocalVector<T> _buffer;
+
+	LessThan _less_than;
+	Indexer _indexer;
+
+	void _shift_up(uint32_t p_index) {
+		T value = _buffer[p_index];
+		while (p_index > 0) {
+			const uint32_t parent_index = (p_index - 1) / 2;
+			if (!_less_than(value, _buffer[parent_index])) {
+				break;
+			}
+			_buffer[p_index] = _buffer[parent_index];
+			_indexer(_buffer[p_index], p_index);
+			p_index = parent_index;
+		}
+		_buffer[p_index] = value;
+		_indexer(value, p_index);
+	}
+
+	void _shift_down(uint32_t p_index) {
+		const uint32_t size = _buffer.size();
+		T value = _buffer[p_index];
+		while (true) {
+			uint32_t child_index = 2 * p_index + 1;
+			if (child_index >= size) {
+				break;
+			}
+			if (child_index + 1 < size && _less_than(_buffer[child_index + 1], _buffer[child_index])) {
+				child_index++;
+			}
+			if (!_less_than(_buffer[child_index], value)) {
+				break;
+			}
+			_buffer[p_index] = _buffer[child_index];
+			_indexer(_buffer[p_index], p_index);
+			p_index = child_index;
+		}
+		_buffer[p_index] = value;
+		_indexer(value, p_index);
+	}
+
+public:
+	void reserve(uint32_t p_size) {
+		_buffer.reserve(p_size);
+	}
+
+	uint32_t size() const {
+		return _buffer.size();
+	}
+
+	bool is_empty() const {
+		return _buffer.is_empty();
+	}
+
+	const T &top() const {
+		return _buffer[0];
+	}
+
+	void push(const T &p_element) {
+		_buffer.push_back(p_element);
+		_shift_up(_buffer.size() - 1);
+	}
+
+	T pop() {
+		ERR_FAIL_COND_V_MSG(_buffer.is_empty(), T(), "Can't pop an empty heap.");
+		T value = _buffer[0];
+		_indexer(value, UINT32_MAX);
+		const uint32_t last = _buffer.size() - 1;
+		if (last > 0) {
+			_buffer[0] = _buffer[last];
+			_buffer.resize(last);
+			_shift_down(0);
+		} else {
+			_buffer.resize(0);
+		}
+		return value;
+	}
+
+	/// Restores the order after the element at `p_index` became smaller.
+	void shift(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, _buffer.size());
+		_shift_up(p_index);
+	}
+
+	/// Removes all elements, keeping the allocated memory.
+	void clear() {
+		for (const T &element : _buffer) {
+			_indexer(element, UINT32_MAX);
+		}
+		_buffer.clear();
+	}
 };
 
 struct ClosestPointQueryResult {
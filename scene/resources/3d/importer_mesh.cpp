@@ -31,6 +31,7 @@
 #include "importer_mesh.h"
 
 #include "core/io/marshalls.h"
+#include "core/math/batch_math.h"
 #include "core/math/convex_hull.h"
 #include "core/math/random_pcg.h"
 #include "core/math/static_raycaster.h"
@@ -1150,6 +1151,17 @@ Error ImporterMesh::lightmap_unwrap_cached(const Transform3D &p_base_transform,
 			continue;
 		}
 
+		ERR_FAIL_COND_V(rnormals.size() != vc, ERR_INVALID_DATA);
+
+		// Transform the whole surface at once, the triangles below reuse the transformed vertices.
+		const PackedVector3Array tvertices = transform.xform(rvertices);
+		const Vector3 *tvertices_ptr = tvertices.ptr();
+		PackedVector3Array tnormals;
+		tnormals.resize(vc);
+		BatchMath::transform(normal_basis, rnormals.ptr(), tnormals.ptrw(), vc);
+		BatchMath::normalize(tnormals.ptr(), tnormals.ptrw(), vc);
+		const Vector3 *tnormals_ptr = tnormals.ptr();
+
 		int vertex_ofs = vertices.size() / 3;
 
 		vertices.resize((vertex_ofs + vc) * 3);
@@ -1157,8 +1169,8 @@ Error ImporterMesh::lightmap_unwrap_cached(const Transform3D &p_base_transform,
 		uv_indices.resize(vertex_ofs + vc);
 
 		for (int j = 0; j < vc; j++) {
-			Vector3 v = transform.xform(rvertices[j]);
-			Vector3 n = normal_basis.xform(rnormals[j]).normalized();
+			const Vector3 &v = tvertices_ptr[j];
+			const Vector3 &n = tnormals_ptr[j];
 
 			vertices[(j + vertex_ofs) * 3 + 0] = v.x;
 			vertices[(j + vertex_ofs) * 3 + 1] = v.y;
@@ -1175,9 +1187,9 @@ Error ImporterMesh::lightmap_unwrap_cached(const Transform3D &p_base_transform,
 		float eps = 1.19209290e-7F; // Taken from xatlas.h
 		if (ic == 0) {
 			for (int j = 0; j < vc / 3; j++) {
-				Vector3 p0 = transform.xform(rvertices[j * 3 + 0]);
-				Vector3 p1 = transform.xform(rvertices[j * 3 + 1]);
-				Vector3 p2 = transform.xform(rvertices[j * 3 + 2]);
+				const Vector3 &p0 = tvertices_ptr[j * 3 + 0];
+				const Vector3 &p1 = tvertices_ptr[j * 3 + 1];
+				const Vector3 &p2 = tvertices_ptr[j * 3 + 2];
 
 				if ((p0 - p1).length_squared() < eps || (p1 - p2).length_squared() < eps || (p2 - p0).length_squared() < eps) {
 					continue;
@@ -1193,9 +1205,9 @@ Error ImporterMesh::lightmap_unwrap_cached(const Transform3D &p_base_transform,
 				ERR_FAIL_INDEX_V(rindices[j * 3 + 0], rvertices.size(), ERR_INVALID_DATA);
 				ERR_FAIL_INDEX_V(rindices[j * 3 + 1], rvertices.size(), ERR_INVALID_DATA);
 				ERR_FAIL_INDEX_V(rindices[j * 3 + 2], rvertices.size(), ERR_INVALID_DATA);
-				Vector3 p0 = transform.xform(rvertices[rindices[j * 3 + 0]]);
-				Vector3 p1 = transform.xform(rvertices[rindices[j * 3 + 1]]);
-				Vector3 p2 = transform.xform(rvertices[rindices[j * 3 + 2]]);
+				const Vector3 &p0 = tvertices_ptr[rindices[j * 3 + 0]];
+				const Vector3 &p1 = tvertices_ptr[rindices[j * 3 + 1]];
+				const Vector3 &p2 = tvertices_ptr[rindices[j * 3 + 2]];
 
 				if ((p0 - p1).length_squared() < eps || (p1 - p2).length_squared() < eps || (p2 - p0).length_squared() < eps) {
 					continue;
@@ -126,16 +126,25 @@ void NavigationMeshSourceGeometryData3D::_add_mesh_array(const Array &p_mesh_arr
 
 	const int face_count = mesh_indices.size() / 3;
 	const int current_vertex_count = vertices.size() / 3;
+	const int current_index_count = indices.size();
 
+	// Grow the arrays once instead of pushing every component, meshes with many instances add a lot of geometry here.
+	vertices.resize(vertices.size() + mesh_vertices.size() * 3);
+	float *vertices_ptrw = vertices.ptrw() + current_vertex_count * 3;
 	for (int j = 0; j < mesh_vertices.size(); j++) {
-		_add_vertex(p_xform.xform(vr[j]));
+		const Vector3 vertex = p_xform.xform(vr[j]);
+		vertices_ptrw[j * 3 + 0] = vertex.x;
+		vertices_ptrw[j * 3 + 1] = vertex.y;
+		vertices_ptrw[j * 3 + 2] = vertex.z;
 	}
 
+	indices.resize(current_index_count + face_count * 3);
+	int *indices_ptrw = indices.ptrw() + current_index_count;
 	for (int j = 0; j < face_count; j++) {
 		// CCW
-		indices.push_back(current_vertex_count + (ir[j * 3 + 0]));
-		indices.push_back(current_vertex_count + (ir[j * 3 + 2]));
-		indices.push_back(current_vertex_count + (ir[j * 3 + 1]));
+		indices_ptrw[j * 3 + 0] = current_vertex_count + (ir[j * 3 + 0]);
+		indices_ptrw[j * 3 + 1] = current_vertex_count + (ir[j * 3 + 2]);
+		indices_ptrw[j * 3 + 2] = current_vertex_count + (ir[j * 3 + 1]);
 	}
 }
 
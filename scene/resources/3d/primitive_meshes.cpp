@@ -31,6 +31,7 @@
 #include "primitive_meshes.h"
 
 #include "core/config/project_settings.h"
+#include "core/math/batch_math.h"
 #include "scene/resources/theme.h"
 #include "scene/theme/theme_db.h"
 #include "servers/rendering_server.h"
@@ -58,16 +59,7 @@ void PrimitiveMesh::_update() const {
 
 	int pc = points.size();
 	ERR_FAIL_COND(pc == 0);
-	{
-		const Vector3 *r = points.ptr();
-		for (int i = 0; i < pc; i++) {
-			if (i == 0) {
-				aabb.position = r[i];
-			} else {
-				aabb.expand_to(r[i]);
-			}
-		}
-	}
+	aabb = BatchMath::get_aabb(points.ptr(), pc);
 
 	Vector<int> indices = arr[RS::ARRAY_INDEX];
 
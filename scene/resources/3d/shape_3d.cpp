@@ -30,6 +30,7 @@
 
 #include "shape_3d.h"
 
+#include "core/math/batch_math.h"
 #include "core/os/os.h"
 #include "scene/main/scene_tree.h"
 #include "scene/resources/mesh.h"
@@ -41,10 +42,7 @@ void Shape3D::add_vertices_to_array(Vector<Vector3> &array, const Transform3D &p
 	if (toadd.size()) {
 		int base = array.size();
 		array.resize(base + toadd.size());
-		Vector3 *w = array.ptrw();
-		for (int i = 0; i < toadd.size(); i++) {
-			w[i + base] = p_xform.xform(toadd[i]);
-		}
+		BatchMath::transform(p_xform, toadd.ptr(), array.ptrw() + base, toadd.size());
 	}
 }
 
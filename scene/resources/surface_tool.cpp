@@ -30,6 +30,8 @@
 
 #include "surface_tool.h"
 
+#include "core/math/batch_math.h"
+
 #define EQ_VERTEX_DIST 0.00001
 
 SurfaceTool::OptimizeVertexCacheFunc SurfaceTool::optimize_vertex_cache_func = nullptr;
@@ -1024,10 +1026,19 @@ void SurfaceTool::append_from(const Ref<Mesh> &p_existing, int p_surface, const
 		format = 0;
 	}
 
+	Array arr = p_existing->surface_get_arrays(p_surface);
+	ERR_FAIL_COND(arr.size() != RS::ARRAY_MAX);
+
+	// Transform the positions in bulk, before they are spread over the vertices.
+	PackedVector3Array positions = arr[RS::ARRAY_VERTEX];
+	Vector3 *positions_ptrw = positions.ptrw();
+	BatchMath::transform(p_xform, positions_ptrw, positions_ptrw, positions.size());
+	arr[RS::ARRAY_VERTEX] = positions;
+
 	uint64_t nformat = 0;
 	LocalVector<Vertex> nvertices;
 	LocalVector<int> nindices;
-	_create_list(p_existing, p_surface, &nvertices, &nindices, nformat);
+	_create_list_from_arrays(arr, &nvertices, &nindices, nformat);
 	format |= nformat;
 
 	for (int j = 0; j < RS::ARRAY_CUSTOM_COUNT; j++) {
@@ -1039,7 +1050,6 @@ void SurfaceTool::append_from(const Ref<Mesh> &p_existing, int p_surface, const
 	int vfrom = vertex_array.size();
 
 	for (Vertex &v : nvertices) {
-		v.vertex = p_xform.xform(v.vertex);
 		if (nformat & RS::ARRAY_FORMAT_NORMAL) {
 			v.normal = p_xform.basis.xform(v.normal);
 		}
@@ -32,6 +32,7 @@
 #define NAVIGATION_UTILITIES_H
 
 #include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 namespace NavigationUtilities {
@@ -77,6 +78,17 @@ struct PathQueryResult {
 	PackedInt64Array path_owner_ids;
 };
 
+/// Path queries solved together in the background, see `NavigationServer3D::_query_path_batch()`.
+struct PathQueryBatch {
+	LocalVector<PathQueryParameters> parameters;
+	/// Called on the main thread once every query of the batch is solved.
+	Callable callback;
+
+	virtual ~PathQueryBatch() {}
+	/// Called from the worker threads, once per query.
+	virtual void set_result(uint32_t p_index, const PathQueryResult &p_result) = 0;
+};
+
 } //namespace NavigationUtilities
 
 #endif // NAVIGATION_UTILITIES_H
@@ -78,6 +78,12 @@ public:
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) = 0;
 	virtual bool map_get_use_edge_connections(RID p_map) const = 0;
 
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const = 0;
+
+	virtual void map_set_use_path_corridor_cache(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_path_corridor_cache(RID p_map) const = 0;
+
 	/// Set the map edge connection margin used to weld the compatible region edges.
 	virtual void map_set_edge_connection_margin(RID p_map, real_t p_connection_margin) = 0;
 
@@ -93,6 +99,10 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const = 0;
 
+	/// Returns the next position towards the destination from a flow field that is shared by all the queries to the same destination.
+	virtual Vector2 map_get_flow_field_next_position(RID p_map, const Vector2 &p_destination, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+	virtual real_t map_get_flow_field_distance(RID p_map, const Vector2 &p_destination, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	virtual Vector2 map_get_closest_point(RID p_map, const Vector2 &p_point) const = 0;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector2 &p_point) const = 0;
 
@@ -294,6 +304,11 @@ public:
 	/// Returns a customized navigation path using a query parameters object
 	virtual void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const = 0;
 
+	/// Solves many path queries in parallel, the results are written to the query result objects.
+	/// Returns the batch id used to poll it, the callback is called once the batch is completed.
+	virtual int64_t query_path_batch(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) = 0;
+	virtual bool is_path_query_batch_completed(int64_t p_batch_id) const = 0;
+
 	virtual void init() = 0;
 	virtual void sync() = 0;
 	virtual void finish() = 0;
@@ -1374,6 +1374,16 @@ void GodotPhysicsServer2D::_update_shapes() {
 	}
 }
 
+uint64_t GodotPhysicsServer2D::get_elapsed_time(GodotSpace2D::ElapsedTime p_time) const {
+	ERR_FAIL_INDEX_V(p_time, GodotSpace2D::ELAPSED_TIME_MAX, 0);
+
+	uint64_t total = 0;
+	for (const GodotSpace2D *E : active_spaces) {
+		total += E->get_elapsed_time(p_time);
+	}
+	return total;
+}
+
 int GodotPhysicsServer2D::get_process_info(ProcessInfo p_info) {
 	switch (p_info) {
 		case INFO_ACTIVE_OBJECTS: {
@@ -300,6 +300,9 @@ public:
 
 	int get_process_info(ProcessInfo p_info) override;
 
+	// Time spent in the given phase of the last step, summed over all active spaces.
+	uint64_t get_elapsed_time(GodotSpace2D::ElapsedTime p_time) const;
+
 	GodotPhysicsServer2D(bool p_using_threads = false);
 	~GodotPhysicsServer2D() {}
 };
@@ -62,6 +62,11 @@ void GodotArea3D::_shapes_changed() {
 }
 
 void GodotArea3D::set_transform(const Transform3D &p_transform) {
+	if (get_space() && p_transform == get_transform()) {
+		// Nothing moved, no need to check the overlaps again.
+		return;
+	}
+
 	if (!moved_list.in_list() && get_space()) {
 		get_space()->area_add_to_moved_list(&moved_list);
 	}
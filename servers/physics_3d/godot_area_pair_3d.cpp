@@ -34,8 +34,14 @@
 
 bool GodotAreaPair3D::setup(real_t p_step) {
 	bool result = false;
-	if (area->collides_with(body) && GodotCollisionSolver3D::solve_static(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), nullptr, this)) {
-		result = true;
+	if (area->collides_with(body)) {
+		// Only test the shapes again if one of them moved or changed since the last test.
+		if (body->get_geometry_version() != tested_body_version || area->get_geometry_version() != tested_area_version) {
+			shapes_overlap = GodotCollisionSolver3D::solve_static(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), nullptr, this);
+			tested_body_version = body->get_geometry_version();
+			tested_area_version = area->get_geometry_version();
+		}
+		result = shapes_overlap;
 	}
 
 	process_collision = false;
@@ -123,9 +129,17 @@ GodotAreaPair3D::~GodotAreaPair3D() {
 bool GodotArea2Pair3D::setup(real_t p_step) {
 	bool result_a = area_a->collides_with(area_b);
 	bool result_b = area_b->collides_with(area_a);
-	if ((result_a || result_b) && !GodotCollisionSolver3D::solve_static(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), nullptr, this)) {
-		result_a = false;
-		result_b = false;
+	if (result_a || result_b) {
+		// Only test the shapes again if one of them moved or changed since the last test.
+		if (area_a->get_geometry_version() != tested_version_a || area_b->get_geometry_version() != tested_version_b) {
+			shapes_overlap = GodotCollisionSolver3D::solve_static(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), nullptr, this);
+			tested_version_a = area_a->get_geometry_version();
+			tested_version_b = area_b->get_geometry_version();
+		}
+		if (!shapes_overlap) {
+			result_a = false;
+			result_b = false;
+		}
 	}
 
 	bool process_collision = false;
@@ -45,6 +45,10 @@ class GodotAreaPair3D : public GodotConstraint3D {
 	bool process_collision = false;
 	bool has_space_override = false;
 	bool body_has_attached_area = false;
+	// Result of the last overlap test, and the geometry versions it was done with.
+	bool shapes_overlap = false;
+	uint64_t tested_body_version = 0;
+	uint64_t tested_area_version = 0;
 
 public:
 	virtual bool setup(real_t p_step) override;
@@ -66,6 +70,10 @@ class GodotArea2Pair3D : public GodotConstraint3D {
 	bool process_collision_b = false;
 	bool area_a_monitorable;
 	bool area_b_monitorable;
+	// Result of the last overlap test, and the geometry versions it was done with.
+	bool shapes_overlap = false;
+	uint64_t tested_version_a = 0;
+	uint64_t tested_version_b = 0;
 
 public:
 	virtual bool setup(real_t p_step) override;
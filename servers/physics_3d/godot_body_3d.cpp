@@ -295,10 +295,36 @@ Variant GodotBody3D::get_param(PhysicsServer3D::BodyParameter p_param) const {
 	return 0;
 }
 
+void GodotBody3D::add_constraint(GodotConstraint3D *p_constraint, int p_pos) {
+	constraint_map[p_constraint] = p_pos;
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+}
+
+void GodotBody3D::remove_constraint(GodotConstraint3D *p_constraint) {
+	constraint_map.erase(p_constraint);
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+}
+
+void GodotBody3D::clear_constraint_map() {
+	constraint_map.clear();
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+}
+
 void GodotBody3D::set_mode(PhysicsServer3D::BodyMode p_mode) {
 	PhysicsServer3D::BodyMode prev = mode;
 	mode = p_mode;
 
+	// The mode decides how the body takes part in islands.
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+
 	switch (p_mode) {
 		case PhysicsServer3D::BODY_MODE_STATIC:
 		case PhysicsServer3D::BODY_MODE_KINEMATIC: {
@@ -153,6 +153,8 @@ void GodotCollisionObject3D::_unregister_shapes() {
 }
 
 void GodotCollisionObject3D::_update_shapes() {
+	geometry_version++;
+
 	if (!space) {
 		return;
 	}
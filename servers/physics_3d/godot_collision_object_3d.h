@@ -76,6 +76,8 @@ private:
 	Transform3D transform;
 	Transform3D inv_transform;
 	bool _static = true;
+	// Incremented when the object moves or its shapes change, so pairs can tell their overlap is still valid.
+	uint64_t geometry_version = 1;
 
 	SelfList<GodotCollisionObject3D> pending_shape_update_list;
 
@@ -91,6 +93,9 @@ protected:
 		ERR_FAIL_COND_MSG(p_transform.origin.length_squared() > MAX_OBJECT_DISTANCE_X2, "Object went too far away (more than '" + itos(MAX_OBJECT_DISTANCE) + "' units from origin).");
 #endif
 
+		if (transform != p_transform) {
+			geometry_version++;
+		}
 		transform = p_transform;
 		if (p_update_shapes) {
 			_update_shapes();
@@ -143,6 +148,7 @@ public:
 
 	_FORCE_INLINE_ const Transform3D &get_transform() const { return transform; }
 	_FORCE_INLINE_ const Transform3D &get_inv_transform() const { return inv_transform; }
+	_FORCE_INLINE_ uint64_t get_geometry_version() const { return geometry_version; }
 	_FORCE_INLINE_ GodotSpace3D *get_space() const { return space; }
 
 	_FORCE_INLINE_ void set_ray_pickable(bool p_enable) { ray_pickable = p_enable; }
@@ -1640,11 +1640,15 @@ void GodotPhysicsServer3D::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	islands_rebuilt = 0;
+	areas_processed = 0;
 	for (const GodotSpace3D *E : active_spaces) {
 		stepper->step(const_cast<GodotSpace3D *>(E), p_step);
 		island_count += E->get_island_count();
 		active_objects += E->get_active_objects();
 		collision_pairs += E->get_collision_pairs();
+		islands_rebuilt += E->get_islands_rebuilt();
+		areas_processed += E->get_areas_processed();
 	}
 #endif
 }
@@ -1675,6 +1679,7 @@ void GodotPhysicsServer3D::flush_queries() {
 		uint64_t total_time[GodotSpace3D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace3D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broadphase",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
@@ -1714,6 +1719,16 @@ void GodotPhysicsServer3D::finish() {
 	memdelete(stepper);
 }
 
+uint64_t GodotPhysicsServer3D::get_elapsed_time(GodotSpace3D::ElapsedTime p_time) const {
+	ERR_FAIL_INDEX_V(p_time, GodotSpace3D::ELAPSED_TIME_MAX, 0);
+
+	uint64_t total = 0;
+	for (const GodotSpace3D *E : active_spaces) {
+		total += E->get_elapsed_time(p_time);
+	}
+	return total;
+}
+
 int GodotPhysicsServer3D::get_process_info(ProcessInfo p_info) {
 	switch (p_info) {
 		case INFO_ACTIVE_OBJECTS: {
@@ -1725,6 +1740,12 @@ int GodotPhysicsServer3D::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_ISLANDS_REBUILT: {
+			return islands_rebuilt;
+		} break;
+		case INFO_AREAS_PROCESSED: {
+			return areas_processed;
+		} break;
 	}
 
 	return 0;
@@ -48,6 +48,8 @@ class GodotPhysicsServer3D : public PhysicsServer3D {
 	int island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
+	int islands_rebuilt = 0;
+	int areas_processed = 0;
 
 	bool using_threads = false;
 	bool doing_sync = false;
@@ -378,6 +380,9 @@ public:
 
 	int get_process_info(ProcessInfo p_info) override;
 
+	// Time spent in the given phase of the last step, summed over all active spaces.
+	uint64_t get_elapsed_time(GodotSpace3D::ElapsedTime p_time) const;
+
 	GodotPhysicsServer3D(bool p_using_threads = false);
 	~GodotPhysicsServer3D() {}
 };
@@ -33,7 +33,7 @@
 #include "core/io/image.h"
 #include "core/math/convex_hull.h"
 #include "core/math/geometry_3d.h"
-#include "core/templates/sort_array.h"
+#include "core/math/wide_bvh_simd.h"
 
 // GodotHeightMapShape3D is based on Bullet btHeightfieldTerrainShape.
 
@@ -1345,42 +1345,15 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
-
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
-	}
-
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		int face_index = params_bvh->face_index;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->face_index = face_index;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
-		}
+// Returns a bit mask of the children of p_node whose bounds overlap [p_min, p_max]. Empty children have
+// inverted bounds, so they never overlap. All lanes are evaluated without early outs so the loop can be vectorized.
+static _FORCE_INLINE_ uint32_t _bvh_cull_aabb(const GodotConcavePolygonShape3D::BVH &p_node, const Vector3 &p_min, const Vector3 &p_max) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 4; i++) {
+		const bool overlap = (p_node.bounds[0][i] <= p_max.x) & (p_node.bounds[3][i] >= p_min.x) & (p_node.bounds[1][i] <= p_max.y) & (p_node.bounds[4][i] >= p_min.y) & (p_node.bounds[2][i] <= p_max.z) & (p_node.bounds[5][i] >= p_min.z);
+		mask |= uint32_t(overlap) << i;
 	}
+	return mask;
 }
 
 bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
@@ -1391,75 +1364,110 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	const uint32_t *bfr = bvh_faces.ptr();
 
 	GodotFaceShape3D face;
 	face.backface_collision = backface_collision && p_hit_back_faces;
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.dir = (p_end - p_begin).normalized();
+	const Vector3 rel = p_end - p_begin;
+	const real_t length = rel.length();
+	if (length == 0) {
+		return false;
+	}
+	const Vector3 dir = rel / length;
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	WideBVH::Ray<real_t> ray;
+	ray.set(p_begin, rel);
 
-	params.face = &face;
+	Vector3 result;
+	Vector3 result_normal;
+	int result_face_index = -1;
+	real_t min_d = 1e20;
+	real_t max_t = 1.0;
 
-	// cull
-	_cull_segment(0, &params);
+	struct StackEntry {
+		uint32_t child;
+		uint32_t face_count;
+		real_t near;
+	};
 
-	if (params.collisions > 0) {
-		r_result = params.result;
-		r_normal = params.normal;
-		r_face_index = params.face_index;
-		return true;
-	} else {
-		return false;
-	}
-}
+	StackEntry stack[WideBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
 
-bool GodotConcavePolygonShape3D::intersect_point(const Vector3 &p_point) const {
-	return false; //face is flat
-}
+	stack[stack_size++] = { 0, 0, 0.0 };
 
-Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point) const {
-	return Vector3();
-}
+	while (stack_size > 0) {
+		const StackEntry entry = stack[--stack_size];
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+		// A hit closer than the child may have been found since it was pushed.
+		if (entry.near > max_t) {
+			continue;
+		}
 
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
-		return false;
-	}
+		if (entry.face_count > 0) {
+			for (uint32_t i = entry.child; i < entry.child + entry.face_count; i++) {
+				const Face *f = &fr[bfr[i]];
+				face.normal = f->normal;
+				face.vertex[0] = vr[f->indices[0]];
+				face.vertex[1] = vr[f->indices[1]];
+				face.vertex[2] = vr[f->indices[2]];
+
+				Vector3 res;
+				Vector3 normal;
+				int face_index = bfr[i];
+				if (face.intersect_segment(p_begin, p_end, res, normal, face_index, true)) {
+					real_t d = dir.dot(res) - dir.dot(p_begin);
+					if ((d > 0) && (d < min_d)) {
+						min_d = d;
+						max_t = MIN(max_t, d / length + (real_t)CMP_EPSILON);
+						result = res;
+						result_normal = normal;
+						result_face_index = face_index;
+					}
+				}
+			}
+			continue;
+		}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
+		const BVH &node = bvh[entry.child];
+		real_t near[4];
+		const uint32_t mask = wide_bvh_intersect_children(node, ray, real_t(0.0), max_t, near);
+		if (mask == 0) {
+			continue;
 		}
-	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
+
+		// Push the farthest children first, so the nearest ones are visited first and shorten the segment early.
+		uint32_t order[4] = { 0, 1, 2, 3 };
+		for (uint32_t i = 1; i < 4; i++) {
+			for (uint32_t j = i; j > 0 && near[order[j - 1]] < near[order[j]]; j--) {
+				SWAP(order[j - 1], order[j]);
 			}
 		}
 
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
+		for (uint32_t i = 0; i < 4; i++) {
+			const uint32_t child = order[i];
+			if (mask & (1 << child)) {
+				stack[stack_size++] = { node.children[child], node.item_counts[child], near[child] };
 			}
 		}
 	}
 
-	return false;
+	if (result_face_index >= 0) {
+		r_result = result;
+		r_normal = result_normal;
+		r_face_index = result_face_index;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool GodotConcavePolygonShape3D::intersect_point(const Vector3 &p_point) const {
+	return false; //face is flat
+}
+
+Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point) const {
+	return Vector3();
 }
 
 void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
@@ -1468,145 +1476,73 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 		return;
 	}
 
-	AABB local_aabb = p_local_aabb;
+	const Vector3 query_min = p_local_aabb.position;
+	const Vector3 query_max = p_local_aabb.position + p_local_aabb.size;
 
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	const uint32_t *bfr = bvh_faces.ptr();
 
 	GodotFaceShape3D face; // use this to send in the callback
 	face.backface_collision = backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
-	params.callback = p_callback;
-	params.userdata = p_userdata;
+	uint32_t stack[WideBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
 
-	// cull
-	_cull(0, &params);
-}
-
-Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
-	// use bad AABB approximation
-	Vector3 extents = get_aabb().size * 0.5;
+	stack[stack_size++] = 0;
 
-	return Vector3(
-			(p_mass / 3.0) * (extents.y * extents.y + extents.z * extents.z),
-			(p_mass / 3.0) * (extents.x * extents.x + extents.z * extents.z),
-			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
-}
-
-struct _Volume_BVH_Element {
-	AABB aabb;
-	Vector3 center;
-	int face_index = 0;
-};
-
-struct _Volume_BVH_CompareX {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.x < b.center.x;
-	}
-};
+	while (stack_size > 0) {
+		const BVH &node = bvh[stack[--stack_size]];
+		const uint32_t mask = _bvh_cull_aabb(node, query_min, query_max);
 
-struct _Volume_BVH_CompareY {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.y < b.center.y;
-	}
-};
-
-struct _Volume_BVH_CompareZ {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.z < b.center.z;
-	}
-};
-
-struct _Volume_BVH {
-	AABB aabb;
-	_Volume_BVH *left = nullptr;
-	_Volume_BVH *right = nullptr;
+		// Children are pushed in reverse, so they are visited in tree order.
+		for (int i = 3; i >= 0; i--) {
+			if (!(mask & (1u << i))) {
+				continue;
+			}
 
-	int face_index = 0;
-};
+			if (node.item_counts[i] == 0) {
+				stack[stack_size++] = node.children[i];
+				continue;
+			}
 
-_Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int &count) {
-	_Volume_BVH *bvh = memnew(_Volume_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
-	}
+			for (uint32_t j = node.children[i]; j < node.children[i] + node.item_counts[i]; j++) {
+				const Face *f = &fr[bfr[j]];
+				const Vector3 &v0 = vr[f->indices[0]];
+				const Vector3 &v1 = vr[f->indices[1]];
+				const Vector3 &v2 = vr[f->indices[2]];
+
+				// Leaves hold several faces, so only report the ones whose bounds actually overlap.
+				const Vector3 face_min = v0.min(v1).min(v2);
+				const Vector3 face_max = v0.max(v1).max(v2);
+				if (face_min.x >= query_max.x || face_max.x <= query_min.x ||
+						face_min.y >= query_max.y || face_max.y <= query_min.y ||
+						face_min.z >= query_max.z || face_max.z <= query_min.z) {
+					continue;
+				}
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
+				face.normal = f->normal;
+				face.vertex[0] = v0;
+				face.vertex[1] = v1;
+				face.vertex[2] = v2;
+				if (p_callback(p_userdata, &face)) {
+					return;
+				}
+			}
 		}
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
-
-		} break;
-		case 1: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
-	}
-
-	int split = p_size / 2;
-	bvh->left = _volume_build_bvh(p_elements, split, count);
-	bvh->right = _volume_build_bvh(&p_elements[split], p_size - split, count);
-
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
 }
 
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
-
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
-
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].left = -1;
-	}
-
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].right = -1;
-	}
+Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
+	// use bad AABB approximation
+	Vector3 extents = get_aabb().size * 0.5;
 
-	memdelete(p_bvh_tree);
+	return Vector3(
+			(p_mass / 3.0) * (extents.y * extents.y + extents.z * extents.z),
+			(p_mass / 3.0) * (extents.x * extents.x + extents.z * extents.z),
+			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
 void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
@@ -1620,10 +1556,8 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_Volume_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptrw();
+	WideBVH builder;
+	builder.resize(src_face_count);
 
 	faces.resize(src_face_count);
 	Face *facesw = faces.ptrw();
@@ -1637,9 +1571,8 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 	for (int i = 0; i < src_face_count; i++) {
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.get_center();
-		bvh_arrayw[i].face_index = i;
+		const AABB face_aabb = face.get_aabb();
+		builder.set_item_bounds(i, face_aabb.position, face_aabb.position + face_aabb.size);
 		facesw[i].indices[0] = i * 3 + 0;
 		facesw[i].indices[1] = i * 3 + 1;
 		facesw[i].indices[2] = i * 3 + 2;
@@ -1648,21 +1581,16 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 		verticesw[i * 3 + 1] = face.vertex[1];
 		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = face_aabb;
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(face_aabb);
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
-
-	BVH *bvh_arrayw2 = bvh.ptrw();
-
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	// Pad the node bounds, as the face tests are imprecise for grazing segments and can hit slightly outside
+	// of the faces.
+	builder.build(bvh, 0.0001);
+	bvh_faces = builder.get_item_order();
 
 	backface_collision = p_backface_collision;
 
@@ -32,6 +32,7 @@
 #define GODOT_SHAPE_3D_H
 
 #include "core/math/geometry_3d.h"
+#include "core/math/wide_bvh.h"
 #include "core/templates/local_vector.h"
 #include "servers/physics_server_3d.h"
 
@@ -302,7 +303,6 @@ public:
 	GodotConvexPolygonShape3D();
 };
 
-struct _Volume_BVH;
 struct GodotFaceShape3D;
 
 struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
@@ -316,49 +316,15 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
+	// Node of the 4-wide BVH of the faces.
+	typedef WideBVH::Node<real_t> BVH;
 
-		int face_index = 0;
-	};
-
-	Vector<BVH> bvh;
-
-	struct _CullParams {
-		AABB aabb;
-		QueryCallback callback = nullptr;
-		void *userdata = nullptr;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-	};
-
-	struct _SegmentCullParams {
-		Vector3 from;
-		Vector3 to;
-		Vector3 dir;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-
-		Vector3 result;
-		Vector3 normal;
-		int face_index = -1;
-		real_t min_d = 1e20;
-		int collisions = 0;
-	};
+	LocalVector<BVH> bvh;
+	// Index in faces of the faces in the order of the leaves of the tree.
+	LocalVector<uint32_t> bvh_faces;
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
-
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
-
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
 public:
@@ -110,6 +110,27 @@ Variant GodotSoftBody3D::get_state(PhysicsServer3D::BodyState p_state) const {
 	return Variant();
 }
 
+void GodotSoftBody3D::add_constraint(GodotConstraint3D *p_constraint) {
+	constraints.insert(p_constraint);
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+}
+
+void GodotSoftBody3D::remove_constraint(GodotConstraint3D *p_constraint) {
+	constraints.erase(p_constraint);
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+}
+
+void GodotSoftBody3D::clear_constraints() {
+	constraints.clear();
+	if (get_space()) {
+		get_space()->invalidate_islands();
+	}
+}
+
 void GodotSoftBody3D::set_space(GodotSpace3D *p_space) {
 	if (get_space()) {
 		get_space()->soft_body_remove_from_active_list(&active_list);
@@ -41,11 +41,45 @@
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// Number of spatially sorted queries processed by each task of a batch.
+	static const int BATCH_CHUNK_SIZE = 64;
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		LocalVector<uint32_t> order;
+	};
+
+	struct ShapeBatch {
+		const ShapeParameters *parameters = nullptr;
+		const Transform3D *transforms = nullptr;
+		const Vector3 *motions = nullptr;
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+		LocalVector<uint32_t> order;
+	};
+
+	// The broadphase results are passed in, so queries can run concurrently with their own buffers.
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, GodotCollisionObject3D **r_query_results, int *r_query_subindex_results);
+	int _intersect_shape(const ShapeParameters &p_parameters, const Transform3D &p_transform, ShapeResult *r_results, int p_result_max, GodotCollisionObject3D **r_query_results, int *r_query_subindex_results);
+	bool _cast_motion(const ShapeParameters &p_parameters, const Transform3D &p_transform, const Vector3 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, GodotCollisionObject3D **r_query_results, int *r_query_subindex_results);
+
+	void _intersect_ray_batch_chunk(uint32_t p_chunk, RayBatch *p_batch);
+	void _intersect_shape_batch_chunk(uint32_t p_chunk, ShapeBatch *p_batch);
+	void _cast_motion_batch_chunk(uint32_t p_chunk, ShapeBatch *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
@@ -57,6 +91,10 @@ public:
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
+	virtual int intersect_ray_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
+	virtual void intersect_shape_batch(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
+	virtual void cast_motion_batch(const ShapeParameters &p_parameters, const Transform3D *p_transforms, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
+
 	GodotPhysicsDirectSpaceState3D();
 };
 
@@ -64,6 +102,7 @@ class GodotSpace3D {
 public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
+		ELAPSED_TIME_BROADPHASE,
 		ELAPSED_TIME_GENERATE_ISLANDS,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
@@ -118,6 +157,15 @@ private:
 	int island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
+	int islands_rebuilt = 0;
+	int areas_processed = 0;
+
+	// Body islands of the last step. GodotStep3D reuses them as long as no constraint
+	// is added or removed and the active bodies stay the same, instead of walking
+	// the constraint graph again every step.
+	LocalVector<LocalVector<GodotBody3D *>> cached_body_islands;
+	LocalVector<LocalVector<GodotConstraint3D *>> cached_constraint_islands;
+	bool islands_dirty = true;
 
 	RID static_global_body;
 
@@ -125,6 +173,7 @@ private:
 	int contact_debug_count = 0;
 
 	friend class GodotPhysicsDirectSpaceState3D;
+	friend class GodotStep3D;
 
 	int _cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb);
 
@@ -191,6 +240,14 @@ public:
 
 	int get_collision_pairs() const { return collision_pairs; }
 
+	void set_islands_rebuilt(int p_islands_rebuilt) { islands_rebuilt = p_islands_rebuilt; }
+	int get_islands_rebuilt() const { return islands_rebuilt; }
+
+	void set_areas_processed(int p_areas_processed) { areas_processed = p_areas_processed; }
+	int get_areas_processed() const { return areas_processed; }
+
+	_FORCE_INLINE_ void invalidate_islands() { islands_dirty = true; }
+
 	GodotPhysicsDirectSpaceState3D *get_direct_state();
 
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
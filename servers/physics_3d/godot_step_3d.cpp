@@ -35,7 +35,6 @@
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
-#define BODY_ISLAND_COUNT_RESERVE 128
 #define BODY_ISLAND_SIZE_RESERVE 512
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
@@ -57,8 +56,6 @@ void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D
 		constraint->set_island_step(_step);
 		p_constraint_island.push_back(constraint);
 
-		all_constraints.push_back(constraint);
-
 		// Find connected rigid bodies.
 		for (int i = 0; i < constraint->get_body_count(); i++) {
 			if (i == E.value) {
@@ -96,8 +93,6 @@ void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, Local
 		constraint->set_island_step(_step);
 		p_constraint_island.push_back(constraint);
 
-		all_constraints.push_back(constraint);
-
 		// Find connected rigid bodies.
 		for (int i = 0; i < constraint->get_body_count(); i++) {
 			GodotBody3D *body = constraint->get_body_ptr()[i];
@@ -182,6 +177,89 @@ void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island
 	}
 }
 
+void GodotStep3D::_generate_body_islands(GodotSpace3D *p_space) {
+	LocalVector<LocalVector<GodotBody3D *>> &cached_body_islands = p_space->cached_body_islands;
+	LocalVector<LocalVector<GodotConstraint3D *>> &cached_constraint_islands = p_space->cached_constraint_islands;
+
+	uint32_t body_island_count = 0;
+	uint32_t island_count = 0;
+
+	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
+
+	const SelfList<GodotBody3D> *b = p_space->get_active_body_list().first();
+	while (b) {
+		GodotBody3D *body = b->self();
+
+		if (body->get_island_step() != _step) {
+			++body_island_count;
+			if (cached_body_islands.size() < body_island_count) {
+				cached_body_islands.resize(body_island_count);
+			}
+			LocalVector<GodotBody3D *> &body_island = cached_body_islands[body_island_count - 1];
+			body_island.clear();
+			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
+
+			++island_count;
+			if (cached_constraint_islands.size() < island_count) {
+				cached_constraint_islands.resize(island_count);
+			}
+			LocalVector<GodotConstraint3D *> &constraint_island = cached_constraint_islands[island_count - 1];
+			constraint_island.clear();
+			constraint_island.reserve(ISLAND_SIZE_RESERVE);
+
+			_populate_island(body, body_island, constraint_island);
+
+			if (body_island.is_empty()) {
+				--body_island_count;
+			}
+
+			if (constraint_island.is_empty()) {
+				--island_count;
+			}
+		}
+		b = b->next();
+	}
+
+	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE SOFT BODIES */
+
+	const SelfList<GodotSoftBody3D> *sb = p_space->get_active_soft_body_list().first();
+	while (sb) {
+		GodotSoftBody3D *soft_body = sb->self();
+
+		if (soft_body->get_island_step() != _step) {
+			++body_island_count;
+			if (cached_body_islands.size() < body_island_count) {
+				cached_body_islands.resize(body_island_count);
+			}
+			LocalVector<GodotBody3D *> &body_island = cached_body_islands[body_island_count - 1];
+			body_island.clear();
+			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
+
+			++island_count;
+			if (cached_constraint_islands.size() < island_count) {
+				cached_constraint_islands.resize(island_count);
+			}
+			LocalVector<GodotConstraint3D *> &constraint_island = cached_constraint_islands[island_count - 1];
+			constraint_island.clear();
+			constraint_island.reserve(ISLAND_SIZE_RESERVE);
+
+			_populate_island_soft_body(soft_body, body_island, constraint_island);
+
+			if (body_island.is_empty()) {
+				--body_island_count;
+			}
+
+			if (constraint_island.is_empty()) {
+				--island_count;
+			}
+		}
+		sb = sb->next();
+	}
+
+	cached_body_islands.resize(body_island_count);
+	cached_constraint_islands.resize(island_count);
+}
+
 void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	p_space->lock(); // can't access space during this
 
@@ -221,18 +299,54 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	p_space->set_active_objects(active_count);
 
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		profile_begtime = profile_endtime;
+	}
+
+	/* BROADPHASE */
+
 	// Update the broadphase to register collision pairs.
 	p_space->update();
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROADPHASE, profile_endtime - profile_begtime);
 		profile_begtime = profile_endtime;
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
+	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE BODIES */
 
 	uint32_t island_count = 0;
+	int islands_rebuilt = 0;
+
+	if (p_space->islands_dirty) {
+		_generate_body_islands(p_space);
+		p_space->islands_dirty = false;
+		islands_rebuilt = p_space->cached_constraint_islands.size();
+	}
+
+	// The constraint islands are copied, as pre-solving and solving modify them.
+	// Marking the constraints keeps moving areas from adding them a second time below.
+	for (const LocalVector<GodotConstraint3D *> &cached_constraint_island : p_space->cached_constraint_islands) {
+		++island_count;
+		if (constraint_islands.size() < island_count) {
+			constraint_islands.resize(island_count);
+		}
+		LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
+		constraint_island.clear();
+
+		for (GodotConstraint3D *constraint : cached_constraint_island) {
+			constraint->set_island_step(_step);
+			constraint_island.push_back(constraint);
+			all_constraints.push_back(constraint);
+		}
+	}
+
+	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
+
+	int areas_processed = 0;
 
 	const SelfList<GodotArea3D>::List &aml = p_space->get_moved_area_list();
 
@@ -256,82 +370,11 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 			constraint_island.push_back(constraint);
 		}
 		p_space->area_remove_from_moved_list((SelfList<GodotArea3D> *)aml.first()); //faster to remove here
+		areas_processed++;
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
-
-	b = body_list->first();
-
-	uint32_t body_island_count = 0;
-
-	while (b) {
-		GodotBody3D *body = b->self();
-
-		if (body->get_island_step() != _step) {
-			++body_island_count;
-			if (body_islands.size() < body_island_count) {
-				body_islands.resize(body_island_count);
-			}
-			LocalVector<GodotBody3D *> &body_island = body_islands[body_island_count - 1];
-			body_island.clear();
-			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
-
-			++island_count;
-			if (constraint_islands.size() < island_count) {
-				constraint_islands.resize(island_count);
-			}
-			LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
-			constraint_island.clear();
-			constraint_island.reserve(ISLAND_SIZE_RESERVE);
-
-			_populate_island(body, body_island, constraint_island);
-
-			if (body_island.is_empty()) {
-				--body_island_count;
-			}
-
-			if (constraint_island.is_empty()) {
-				--island_count;
-			}
-		}
-		b = b->next();
-	}
-
-	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE SOFT BODIES */
-
-	sb = soft_body_list->first();
-	while (sb) {
-		GodotSoftBody3D *soft_body = sb->self();
-
-		if (soft_body->get_island_step() != _step) {
-			++body_island_count;
-			if (body_islands.size() < body_island_count) {
-				body_islands.resize(body_island_count);
-			}
-			LocalVector<GodotBody3D *> &body_island = body_islands[body_island_count - 1];
-			body_island.clear();
-			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
-
-			++island_count;
-			if (constraint_islands.size() < island_count) {
-				constraint_islands.resize(island_count);
-			}
-			LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
-			constraint_island.clear();
-			constraint_island.reserve(ISLAND_SIZE_RESERVE);
-
-			_populate_island_soft_body(soft_body, body_island, constraint_island);
-
-			if (body_island.is_empty()) {
-				--body_island_count;
-			}
-
-			if (constraint_island.is_empty()) {
-				--island_count;
-			}
-		}
-		sb = sb->next();
-	}
+	p_space->set_islands_rebuilt(islands_rebuilt);
+	p_space->set_areas_processed(areas_processed);
 
 	p_space->set_island_count((int)island_count);
 
@@ -384,8 +427,8 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+	for (const LocalVector<GodotBody3D *> &body_island : p_space->cached_body_islands) {
+		_check_suspend(body_island);
 	}
 
 	/* UPDATE SOFT BODY CONSTRAINTS */
@@ -409,7 +452,6 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 }
 
 GodotStep3D::GodotStep3D() {
-	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
 }
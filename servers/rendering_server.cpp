@@ -32,6 +32,7 @@
 #include "rendering_server.compat.inc"
 
 #include "core/config/project_settings.h"
+#include "core/math/batch_math.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 #include "servers/rendering/rendering_server_globals.h"
@@ -444,12 +445,9 @@ Error RenderingServer::_surface_set_data(Array p_arrays, uint64_t p_format, uint
 
 					if (p_format & ARRAY_FLAG_COMPRESS_ATTRIBUTES) {
 						// First we need to generate the AABB for the entire surface.
-						for (int i = 0; i < p_vertex_array_len; i++) {
-							if (i == 0) {
-								r_aabb = AABB(src[i], SMALL_VEC3);
-							} else {
-								r_aabb.expand_to(src[i]);
-							}
+						if (p_vertex_array_len > 0) {
+							r_aabb = BatchMath::get_aabb(src, p_vertex_array_len);
+							r_aabb.merge_with(AABB(src[0], SMALL_VEC3)); // Must have a bit of size.
 						}
 
 						if (!(p_format & RS::ARRAY_FORMAT_NORMAL)) {
@@ -592,12 +590,11 @@ Error RenderingServer::_surface_set_data(Array p_arrays, uint64_t p_format, uint
 							float vector[3] = { (float)src[i].x, (float)src[i].y, (float)src[i].z };
 
 							memcpy(&vw[p_offsets[ai] + i * p_vertex_stride], vector, sizeof(float) * 3);
+						}
 
-							if (i == 0) {
-								r_aabb = AABB(src[i], SMALL_VEC3);
-							} else {
-								r_aabb.expand_to(src[i]);
-							}
+						if (p_vertex_array_len > 0) {
+							r_aabb = BatchMath::get_aabb(src, p_vertex_array_len);
+							r_aabb.merge_with(AABB(src[0], SMALL_VEC3)); // Must have a bit of size.
 						}
 					}
 				}
@@ -33,7 +33,9 @@
 
 #include "core/io/image.h"
 #include "core/os/os.h"
+#include "core/templates/local_vector.h"
 
+#include "tests/test_macros.h"
 #include "tests/test_utils.h"
 #include "thirdparty/doctest/doctest.h"
 
@@ -432,6 +434,313 @@ TEST_CASE("[Image] Convert image") {
 	CHECK_MESSAGE(image2->get_data() == image_data, "Image conversion to invalid type (Image::FORMAT_MAX + 1) should not alter image.");
 }
 
+// Large enough to be processed in several parallel stripes.
+static Ref<Image> _create_noise_image(int p_width, int p_height, Image::Format p_format) {
+	Ref<Image> image = memnew(Image(p_width, p_height, false, p_format));
+	PackedByteArray data = image->get_data();
+	uint8_t *data_ptr = data.ptrw();
+	uint32_t state = 12345;
+	if (p_format >= Image::FORMAT_RF && p_format <= Image::FORMAT_RGBAF) {
+		float *float_ptr = reinterpret_cast<float *>(data_ptr);
+		for (int i = 0; i < data.size() / 4; i++) {
+			state = state * 1664525u + 1013904223u;
+			float_ptr[i] = (state >> 8) / float(1 << 24);
+		}
+	} else {
+		for (int i = 0; i < data.size(); i++) {
+			state = state * 1664525u + 1013904223u;
+			data_ptr[i] = state >> 24;
+		}
+	}
+	image->set_data(p_width, p_height, false, p_format, data);
+	return image;
+}
+
+TEST_CASE("[Image] Processing large images") {
+	SUBCASE("Generate RGBA8 mipmaps") {
+		Ref<Image> image = _create_noise_image(512, 512, Image::FORMAT_RGBA8);
+		image->generate_mipmaps();
+		const PackedByteArray data = image->get_data();
+		const uint8_t *src = data.ptr();
+		const uint8_t *dst = data.ptr() + image->get_mipmap_offset(1);
+
+		bool matches = true;
+		for (int y = 0; y < 256; y++) {
+			for (int x = 0; x < 256; x++) {
+				for (int c = 0; c < 4; c++) {
+					const int a = src[((y * 2) * 512 + x * 2) * 4 + c];
+					const int b = src[((y * 2) * 512 + x * 2 + 1) * 4 + c];
+					const int d = src[((y * 2 + 1) * 512 + x * 2) * 4 + c];
+					const int e = src[((y * 2 + 1) * 512 + x * 2 + 1) * 4 + c];
+					matches = matches && dst[(y * 256 + x) * 4 + c] == (a + b + d + e + 2) >> 2;
+				}
+			}
+		}
+		CHECK_MESSAGE(matches, "Every pixel of the first mipmap should be the average of 4 pixels.");
+	}
+
+	SUBCASE("Generate RGBAF mipmaps") {
+		Ref<Image> image = _create_noise_image(512, 512, Image::FORMAT_RGBAF);
+		image->generate_mipmaps();
+		const PackedByteArray data = image->get_data();
+		const float *src = reinterpret_cast<const float *>(data.ptr());
+		const float *dst = reinterpret_cast<const float *>(data.ptr() + image->get_mipmap_offset(1));
+
+		bool matches = true;
+		for (int y = 0; y < 256; y++) {
+			for (int x = 0; x < 256; x++) {
+				for (int c = 0; c < 4; c++) {
+					const float a = src[((y * 2) * 512 + x * 2) * 4 + c];
+					const float b = src[((y * 2) * 512 + x * 2 + 1) * 4 + c];
+					const float d = src[((y * 2 + 1) * 512 + x * 2) * 4 + c];
+					const float e = src[((y * 2 + 1) * 512 + x * 2 + 1) * 4 + c];
+					matches = matches && dst[(y * 256 + x) * 4 + c] == (a + b + d + e) * 0.25f;
+				}
+			}
+		}
+		CHECK_MESSAGE(matches, "Every pixel of the first mipmap should be the average of 4 pixels.");
+	}
+
+	SUBCASE("Convert") {
+		Ref<Image> image = _create_noise_image(512, 512, Image::FORMAT_RGBA8);
+		Ref<Image> image_rgb = memnew(Image());
+		image_rgb->copy_internals_from(image);
+		image_rgb->convert(Image::FORMAT_RGB8);
+		const PackedByteArray data = image->get_data();
+		const PackedByteArray data_rgb = image_rgb->get_data();
+
+		bool matches = true;
+		for (int i = 0; i < 512 * 512; i++) {
+			for (int c = 0; c < 3; c++) {
+				matches = matches && data_rgb[i * 3 + c] == data[i * 4 + c];
+			}
+		}
+		CHECK_MESSAGE(matches, "Every pixel should be converted.");
+
+		Ref<Image> image_float = _create_noise_image(512, 512, Image::FORMAT_RGBAF);
+		Ref<Image> image_half = memnew(Image());
+		image_half->copy_internals_from(image_float);
+		image_half->convert(Image::FORMAT_RGBAH);
+		const PackedByteArray data_float = image_float->get_data();
+		const PackedByteArray data_half = image_half->get_data();
+		const float *float_ptr = reinterpret_cast<const float *>(data_float.ptr());
+		const uint16_t *half_ptr = reinterpret_cast<const uint16_t *>(data_half.ptr());
+
+		matches = true;
+		for (int i = 0; i < 512 * 512 * 4; i++) {
+			matches = matches && half_ptr[i] == Math::make_half_float(float_ptr[i]);
+		}
+		CHECK_MESSAGE(matches, "Every pixel should be converted.");
+	}
+
+	SUBCASE("Resize") {
+		Ref<Image> image = _create_noise_image(512, 512, Image::FORMAT_RGBA8);
+		Ref<Image> image_nearest = memnew(Image());
+		image_nearest->copy_internals_from(image);
+		image_nearest->resize(300, 700, Image::INTERPOLATE_NEAREST);
+
+		bool matches = true;
+		for (int y = 0; y < 700; y++) {
+			for (int x = 0; x < 300; x++) {
+				matches = matches && image_nearest->get_pixel(x, y) == image->get_pixel(x * 512 / 300, y * 512 / 700);
+			}
+		}
+		CHECK_MESSAGE(matches, "Every pixel should be resized.");
+
+		// The float and byte paths should agree, within the precision of bytes.
+		Ref<Image> image_float = memnew(Image());
+		image_float->copy_internals_from(image);
+		image_float->convert(Image::FORMAT_RGBAF);
+		Ref<Image> image_bilinear = memnew(Image());
+		image_bilinear->copy_internals_from(image);
+		image_bilinear->resize(700, 300, Image::INTERPOLATE_BILINEAR);
+		image_float->resize(700, 300, Image::INTERPOLATE_BILINEAR);
+
+		float max_difference = 0.0f;
+		for (int y = 0; y < 300; y++) {
+			for (int x = 0; x < 700; x++) {
+				const Color difference = image_float->get_pixel(x, y) - image_bilinear->get_pixel(x, y);
+				max_difference = MAX(max_difference, MAX(MAX(Math::abs(difference.r), Math::abs(difference.g)), MAX(Math::abs(difference.b), Math::abs(difference.a))));
+			}
+		}
+		CHECK_MESSAGE(max_difference <= 2.0f / 255.0f, "Bilinear resizing of float and byte images should give the same result.");
+
+		const Color fill_color = Color(10 / 255.0f, 100 / 255.0f, 200 / 255.0f);
+		for (Image::Interpolation interpolation : { Image::INTERPOLATE_CUBIC, Image::INTERPOLATE_LANCZOS }) {
+			Ref<Image> image_constant = memnew(Image(512, 512, false, Image::FORMAT_RGBA8));
+			image_constant->fill(fill_color);
+			image_constant->resize(1000, 300, interpolation);
+
+			// Skip the first row and column, where the cubic kernel is clamped.
+			matches = true;
+			for (int y = 1; y < 300; y++) {
+				for (int x = 1; x < 1000; x++) {
+					matches = matches && image_constant->get_pixel(x, y).is_equal_approx(fill_color);
+				}
+			}
+			CHECK_MESSAGE(matches, "Every pixel should be resized.");
+		}
+	}
+}
+
+static void _benchmark_image(int p_width, int p_height, Image::Format p_format) {
+	const String name = vformat("%dx%d %s", p_width, p_height, Image::format_names[p_format]);
+	Ref<Image> image = _create_noise_image(p_width, p_height, p_format);
+
+	const Image::Interpolation interpolations[] = { Image::INTERPOLATE_NEAREST, Image::INTERPOLATE_BILINEAR, Image::INTERPOLATE_CUBIC, Image::INTERPOLATE_LANCZOS };
+	const char *interpolation_names[] = { "nearest", "bilinear", "cubic", "lanczos" };
+	for (int i = 0; i < 4; i++) {
+		Ref<Image> resized = memnew(Image());
+		resized->copy_internals_from(image);
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		resized->resize(p_width * 3 / 4, p_height * 3 / 4, interpolations[i]);
+		print_line(vformat("Image: %s resize (%s): %.1f ms.", name, interpolation_names[i], (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+	}
+
+	{
+		Ref<Image> converted = memnew(Image());
+		converted->copy_internals_from(image);
+		const Image::Format new_format = p_format == Image::FORMAT_RGBA8 ? Image::FORMAT_RGB8 : Image::FORMAT_RGBAH;
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		converted->convert(new_format);
+		print_line(vformat("Image: %s convert to %s: %.1f ms.", name, Image::format_names[new_format], (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+	}
+
+	{
+		Ref<Image> mipmapped = memnew(Image());
+		mipmapped->copy_internals_from(image);
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		mipmapped->generate_mipmaps();
+		print_line(vformat("Image: %s generate_mipmaps: %.1f ms.", name, (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+	}
+}
+
+TEST_CASE_BENCHMARK("[Image][Benchmark] Processing 4K images") {
+	_benchmark_image(3840, 2160, Image::FORMAT_RGBA8);
+	_benchmark_image(3840, 2160, Image::FORMAT_RGBAF);
+}
+
+TEST_CASE_BENCHMARK("[Image][Benchmark] Processing 8K images") {
+	_benchmark_image(7680, 4320, Image::FORMAT_RGBA8);
+	_benchmark_image(7680, 4320, Image::FORMAT_RGBAF);
+}
+
+struct BlockRowsRecord {
+	LocalVector<int> first_row; // Index of the first block row of each mipmap in the vectors below.
+	LocalVector<uint32_t> visits;
+	LocalVector<int> band_offsets; // Offset of bands starting at that row, -1 for other rows.
+	LocalVector<uint32_t> slots;
+};
+
+static void _record_block_rows(void *p_userdata, const Image::BlockRows &p_rows) {
+	BlockRowsRecord *record = static_cast<BlockRowsRecord *>(p_userdata);
+	for (int i = p_rows.block_row_from; i < p_rows.block_row_to; i++) {
+		const int row = record->first_row[p_rows.mipmap] + i;
+		record->visits[row]++;
+		record->band_offsets[row] = i == p_rows.block_row_from ? p_rows.dst_offset : -1;
+		record->slots[row] = p_rows.slot;
+	}
+}
+
+static void _check_block_rows(int p_width, int p_height, bool p_mipmaps, Image::Format p_format) {
+	const int block = Image::get_format_block_size(p_format);
+	const int mipmaps = p_mipmaps ? Image::get_image_required_mipmaps(p_width, p_height, p_format) : 0;
+
+	BlockRowsRecord record;
+	int rows = 0;
+	for (int i = 0; i <= mipmaps; i++) {
+		int w, h;
+		Image::get_image_mipmap_offset_and_dimensions(p_width, p_height, p_format, i, w, h);
+		record.first_row.push_back(rows);
+		rows += (h + block - 1) / block;
+	}
+	record.visits.resize(rows);
+	record.band_offsets.resize(rows);
+	record.slots.resize(rows);
+	for (int i = 0; i < rows; i++) {
+		record.visits[i] = 0;
+	}
+
+	Image::compress_block_rows(p_width, p_height, p_mipmaps, p_format, &_record_block_rows, &record);
+
+	const uint32_t slot_count = Image::get_block_rows_slot_count();
+	for (int i = 0; i <= mipmaps; i++) {
+		const int mipmap_offset = Image::get_image_mipmap_offset(p_width, p_height, p_format, i);
+		const int mipmap_size = (i < mipmaps ? Image::get_image_mipmap_offset(p_width, p_height, p_format, i + 1) : Image::get_image_data_size(p_width, p_height, p_format, p_mipmaps)) - mipmap_offset;
+		const int mipmap_rows = (i < mipmaps ? record.first_row[i + 1] : rows) - record.first_row[i];
+		CHECK_MESSAGE(record.band_offsets[record.first_row[i]] == mipmap_offset, vformat("Mipmap %d should start with a band at its offset.", i));
+		for (int j = 0; j < mipmap_rows; j++) {
+			const int row = record.first_row[i] + j;
+			CHECK_MESSAGE(record.visits[row] == 1, vformat("Block row %d of mipmap %d should be compressed exactly once.", j, i));
+			CHECK(record.slots[row] < slot_count);
+			if (record.band_offsets[row] != -1) {
+				CHECK_MESSAGE(record.band_offsets[row] == mipmap_offset + j * (mipmap_size / mipmap_rows), vformat("Band at block row %d of mipmap %d should write at the offset of that row.", j, i));
+			}
+		}
+	}
+}
+
+TEST_CASE("[Image] Compressing block rows") {
+	_check_block_rows(2048, 2048, true, Image::FORMAT_DXT1);
+	_check_block_rows(1000, 600, true, Image::FORMAT_BPTC_RGBA);
+	_check_block_rows(100, 60, true, Image::FORMAT_ASTC_8x8);
+	_check_block_rows(3, 5, false, Image::FORMAT_ETC2_RGBA8);
+}
+
+static void _benchmark_compression(int p_width, int p_height) {
+	struct Compression {
+		const char *name;
+		Image::CompressMode mode;
+		Image::UsedChannels channels;
+		Image::ASTCFormat astc_format;
+		bool hdr;
+		bool available;
+	};
+	const Compression compressions[] = {
+		{ "DXT1", Image::COMPRESS_S3TC, Image::USED_CHANNELS_RGB, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_bc_func != nullptr },
+		{ "DXT5", Image::COMPRESS_S3TC, Image::USED_CHANNELS_RGBA, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_bc_func != nullptr },
+		{ "RGTC_RG", Image::COMPRESS_S3TC, Image::USED_CHANNELS_RG, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_bc_func != nullptr },
+		{ "ETC", Image::COMPRESS_ETC, Image::USED_CHANNELS_RGB, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_etc1_func != nullptr },
+		{ "ETC2_RGB8", Image::COMPRESS_ETC2, Image::USED_CHANNELS_RGB, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_etc2_func != nullptr },
+		{ "ETC2_RGBA8", Image::COMPRESS_ETC2, Image::USED_CHANNELS_RGBA, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_etc2_func != nullptr },
+		{ "BPTC_RGBA", Image::COMPRESS_BPTC, Image::USED_CHANNELS_RGBA, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_bptc_func != nullptr },
+		{ "BPTC_RGBFU", Image::COMPRESS_BPTC, Image::USED_CHANNELS_RGB, Image::ASTC_FORMAT_4x4, true, Image::_image_compress_bptc_func != nullptr },
+		{ "ASTC_4x4", Image::COMPRESS_ASTC, Image::USED_CHANNELS_RGBA, Image::ASTC_FORMAT_4x4, false, Image::_image_compress_astc_func != nullptr },
+		{ "ASTC_8x8", Image::COMPRESS_ASTC, Image::USED_CHANNELS_RGBA, Image::ASTC_FORMAT_8x8, false, Image::_image_compress_astc_func != nullptr },
+	};
+
+	Ref<Image> image = _create_noise_image(p_width, p_height, Image::FORMAT_RGBA8);
+	image->generate_mipmaps();
+	Ref<Image> image_hdr = _create_noise_image(p_width, p_height, Image::FORMAT_RGBAF);
+	image_hdr->convert(Image::FORMAT_RGBAH);
+	image_hdr->generate_mipmaps();
+
+	int64_t pixels = 0;
+	for (int i = 0; i <= image->get_mipmap_count(); i++) {
+		int w, h;
+		Image::get_image_mipmap_offset_and_dimensions(p_width, p_height, Image::FORMAT_RGBA8, i, w, h);
+		pixels += w * h;
+	}
+
+	for (const Compression &compression : compressions) {
+		if (!compression.available) {
+			print_line(vformat("Image: %dx%d %s compression: skipped, compressor not available.", p_width, p_height, compression.name));
+			continue;
+		}
+		Ref<Image> compressed = memnew(Image());
+		compressed->copy_internals_from(compression.hdr ? image_hdr : image);
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		compressed->compress_from_channels(compression.mode, compression.channels, compression.astc_format);
+		const double msec = (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0;
+		print_line(vformat("Image: %dx%d %s compression: %.1f ms, %.2f Mpixels/s.", p_width, p_height, compression.name, msec, pixels / (msec * 1000.0)));
+	}
+}
+
+TEST_CASE_BENCHMARK("[Image][Benchmark] Block compression throughput") {
+	_benchmark_compression(1024, 1024);
+	_benchmark_compression(3840, 2160);
+}
+
 } // namespace TestImage
 
 #endif // TEST_IMAGE_H
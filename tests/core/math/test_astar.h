@@ -32,6 +32,11 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 
 #include "tests/test_macros.h"
 
@@ -357,6 +362,475 @@ TEST_CASE("[Stress][AStar3D] Find paths") {
 		CHECK_MESSAGE(match, "Found all paths.");
 	}
 }
+
+TEST_CASE("[AStar3D] Closest point queries should match a full search") {
+	AStar3D a;
+	const int N = 1000;
+	RandomPCG rng(3);
+
+	for (int i = 0; i < N; i++) {
+		// Mostly flat, like a 2D graph, with some points above.
+		a.add_point(i, Vector3(rng.random(-50.0, 50.0), rng.random(-50.0, 50.0), (i % 4 == 0) ? rng.random(-5.0, 5.0) : 0.0));
+	}
+	for (int i = 0; i + 1 < N; i += 2) {
+		a.connect_points(i, i + 1);
+	}
+
+	bool points_match = true;
+	bool segments_match = true;
+	for (int test = 0; test < 500; test++) {
+		// Change the graph between queries.
+		const int id = rng.rand() % N;
+		switch (test % 5) {
+			case 0:
+				if (a.has_point(id)) {
+					a.remove_point(id);
+				} else {
+					a.add_point(id, Vector3(rng.random(-60.0, 60.0), rng.random(-60.0, 60.0), 0.0));
+				}
+				break;
+			case 1:
+				if (a.has_point(id)) {
+					// Sometimes far away, so the grid has to be sized anew.
+					a.set_point_position(id, Vector3(rng.random(-80.0, 80.0), rng.random(-50.0, 50.0), 2.0) * ((test % 7 == 1) ? 20.0 : 1.0));
+				}
+				break;
+			case 2:
+				if (a.has_point(id)) {
+					a.set_point_disabled(id, !a.is_point_disabled(id));
+				}
+				break;
+			case 3: {
+				const int with_id = rng.rand() % N;
+				if (id != with_id && a.has_point(id) && a.has_point(with_id)) {
+					a.connect_points(id, with_id);
+				}
+			} break;
+			case 4:
+				if (a.has_point(id)) {
+					const Vector<int64_t> connections = a.get_point_connections(id);
+					if (!connections.is_empty()) {
+						a.disconnect_points(id, connections[rng.rand() % connections.size()], test % 2 == 0);
+					}
+				}
+				break;
+		}
+
+		// Also query far from every point.
+		const Vector3 position = Vector3(rng.random(-100.0, 100.0), rng.random(-100.0, 100.0), rng.random(-10.0, 10.0)) * ((test % 10 == 0) ? 10.0 : 1.0);
+		const bool include_disabled = test % 3 == 0;
+
+		int64_t closest_id = -1;
+		real_t closest_dist = 1e20;
+		real_t closest_segment_dist = 1e20;
+		for (int i = 0; i < N; i++) {
+			if (!a.has_point(i)) {
+				continue;
+			}
+			const Vector3 point = a.get_point_position(i);
+			if (include_disabled || !a.is_point_disabled(i)) {
+				const real_t d = position.distance_squared_to(point);
+				if (d < closest_dist) {
+					closest_dist = d;
+					closest_id = i;
+				}
+			}
+
+			const Vector<int64_t> connections = a.get_point_connections(i);
+			for (int j = 0; j < connections.size(); j++) {
+				if (a.is_point_disabled(i) || a.is_point_disabled(connections[j])) {
+					continue;
+				}
+				Vector3 segment[2] = { point, a.get_point_position(connections[j]) };
+				closest_segment_dist = MIN(closest_segment_dist, position.distance_squared_to(Geometry3D::get_closest_point_to_segment(position, segment)));
+			}
+		}
+
+		points_match = points_match && a.get_closest_point(position, include_disabled) == closest_id;
+		segments_match = segments_match && Math::is_equal_approx(position.distance_squared_to(a.get_closest_position_in_segment(position)), closest_segment_dist);
+	}
+	CHECK(points_match);
+	CHECK(segments_match);
+}
+
+TEST_CASE("[AStar3D] Closest point queries on nearly flat points should match a full search") {
+	AStar3D a;
+	const int N = 1000;
+	RandomPCG rng(5);
+
+	// Spread over a plane, with a thickness far below the spacing of the points.
+	for (int i = 0; i < N; i++) {
+		a.add_point(i, Vector3(rng.random(-1000.0, 1000.0), rng.random(-1000.0, 1000.0), rng.random(0.0, 0.0001)));
+	}
+
+	bool points_match = true;
+	for (int test = 0; test < 200; test++) {
+		const Vector3 position = Vector3(rng.random(-1100.0, 1100.0), rng.random(-1100.0, 1100.0), rng.random(-1.0, 1.0));
+		int64_t closest_id = -1;
+		real_t closest_dist = 1e20;
+		for (int i = 0; i < N; i++) {
+			const real_t d = position.distance_squared_to(a.get_point_position(i));
+			if (d < closest_dist) {
+				closest_dist = d;
+				closest_id = i;
+			}
+		}
+		points_match = points_match && a.get_closest_point(position) == closest_id;
+	}
+	CHECK(points_match);
+}
+
+struct ConcurrentClosestQueries {
+	const AStar3D *astar = nullptr;
+	LocalVector<Vector3> positions;
+	LocalVector<int64_t> closest_ids;
+	LocalVector<Vector3> closest_positions;
+};
+
+static void run_concurrent_closest_query(void *p_userdata, uint32_t p_index) {
+	ConcurrentClosestQueries *queries = static_cast<ConcurrentClosestQueries *>(p_userdata);
+	queries->closest_ids[p_index] = queries->astar->get_closest_point(queries->positions[p_index]);
+	queries->closest_positions[p_index] = queries->astar->get_closest_position_in_segment(queries->positions[p_index]);
+}
+
+TEST_CASE("[AStar3D] Closest point queries from several threads should match serial queries") {
+	AStar3D a;
+	const int N = 2000;
+	RandomPCG rng(9);
+	for (int i = 0; i < N; i++) {
+		a.add_point(i, Vector3(rng.random(-100.0, 100.0), rng.random(-100.0, 100.0), 0.0));
+	}
+	for (int i = 0; i + 1 < N; i += 2) {
+		a.connect_points(i, i + 1);
+	}
+	// Moved and disconnected points are read from the grid as it was kept up to date.
+	for (int i = 0; i < N; i += 10) {
+		a.set_point_position(i, Vector3(rng.random(-300.0, 300.0), rng.random(-300.0, 300.0), 0.0));
+		a.disconnect_points(i + 2, i + 3);
+	}
+
+	ConcurrentClosestQueries queries;
+	queries.astar = &a;
+	for (int i = 0; i < 256; i++) {
+		queries.positions.push_back(Vector3(rng.random(-320.0, 320.0), rng.random(-320.0, 320.0), rng.random(-1.0, 1.0)));
+	}
+	queries.closest_ids.resize(queries.positions.size());
+	queries.closest_positions.resize(queries.positions.size());
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&run_concurrent_closest_query, &queries, queries.positions.size(), -1, true, "TestConcurrentClosestQueries");
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	bool all_match = true;
+	for (uint32_t i = 0; i < queries.positions.size(); i++) {
+		all_match = all_match && queries.closest_ids[i] == a.get_closest_point(queries.positions[i]);
+		all_match = all_match && queries.closest_positions[i] == a.get_closest_position_in_segment(queries.positions[i]);
+	}
+	CHECK(all_match);
+}
+
+TEST_CASE("[AStar3D] Build graph") {
+	// A 10x10 grid, connected to the right and downwards.
+	const int size = 10;
+	PackedVector3Array positions;
+	PackedInt64Array connections;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			positions.push_back(Vector3(x, y, 0));
+			if (x > 0) {
+				connections.push_back(y * size + x - 1);
+				connections.push_back(y * size + x);
+			}
+			if (y > 0) {
+				connections.push_back((y - 1) * size + x);
+				connections.push_back(y * size + x);
+			}
+		}
+	}
+
+	AStar3D a;
+	a.add_point(1000, Vector3(-1, -1, 0));
+	a.build_graph(positions, connections);
+	CHECK(a.get_point_count() == size * size);
+	CHECK_FALSE(a.has_point(1000));
+	CHECK(a.get_available_point_id() == size * size);
+	CHECK(a.get_point_position(23) == Vector3(3, 2, 0));
+	CHECK(a.get_point_connections(0).size() == 2);
+	CHECK(a.get_point_connections(55).size() == 4);
+	CHECK(a.are_points_connected(55, 56));
+	CHECK(a.get_closest_point(Vector3(4.2, 6.9, 0)) == 74);
+	CHECK(a.get_id_path(0, size * size - 1).size() == size * 2 - 1);
+
+	// One way connections and weight scales.
+	PackedFloat32Array weight_scales;
+	weight_scales.resize(size * size);
+	weight_scales.fill(2.0);
+	a.build_graph(positions, connections, false, weight_scales);
+	CHECK(a.get_point_weight_scale(42) == 2.0);
+	CHECK(a.are_points_connected(55, 56, false));
+	CHECK_FALSE(a.are_points_connected(56, 55, false));
+	CHECK(a.get_id_path(0, size * size - 1).size() == size * 2 - 1);
+	CHECK(a.get_id_path(size * size - 1, 0).is_empty());
+
+	// Invalid connections leave the graph as it was.
+	ERR_PRINT_OFF;
+	PackedInt64Array invalid_connections = connections;
+	invalid_connections.push_back(size * size);
+	invalid_connections.push_back(0);
+	a.build_graph(positions, invalid_connections);
+	invalid_connections.resize(invalid_connections.size() - 1);
+	a.build_graph(positions, invalid_connections);
+	ERR_PRINT_ON;
+	CHECK(a.get_point_weight_scale(42) == 2.0);
+	CHECK_FALSE(a.are_points_connected(56, 55, false));
+}
+
+TEST_CASE("[AStar2D] Build graph") {
+	PackedVector2Array positions = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1) };
+	PackedInt64Array connections = { 0, 1, 1, 2 };
+
+	AStar2D a;
+	a.build_graph(positions, connections);
+	CHECK(a.get_point_count() == 3);
+	CHECK(a.get_point_position(2) == Vector2(1, 1));
+	CHECK(a.get_closest_point(Vector2(0.9, 1.2)) == 2);
+	CHECK(a.get_closest_position_in_segment(Vector2(0.5, 0.3)) == Vector2(0.5, 0));
+	Vector<int64_t> path = a.get_id_path(0, 2);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == 1);
+}
+
+TEST_CASE_BENCHMARK("[AStar3D][Benchmark] Graph construction and closest point queries") {
+	// A grid of 500000 waypoints with their 4 neighbors.
+	const int width = 1000;
+	const int height = 500;
+	const int query_count = 10000;
+
+	PackedVector3Array positions;
+	PackedInt64Array connections;
+	positions.resize(width * height);
+	connections.resize((width - 1) * height * 2 + width * (height - 1) * 2);
+	int64_t connection_index = 0;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			positions.set(y * width + x, Vector3(x, y, 0));
+			if (x > 0) {
+				connections.set(connection_index++, y * width + x - 1);
+				connections.set(connection_index++, y * width + x);
+			}
+			if (y > 0) {
+				connections.set(connection_index++, (y - 1) * width + x);
+				connections.set(connection_index++, y * width + x);
+			}
+		}
+	}
+
+	AStar3D single;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < positions.size(); i++) {
+		single.add_point(i, positions[i]);
+	}
+	for (int i = 0; i < connections.size(); i += 2) {
+		single.connect_points(connections[i], connections[i + 1]);
+	}
+	const uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	AStar3D bulk;
+	begin = OS::get_singleton()->get_ticks_usec();
+	bulk.build_graph(positions, connections);
+	const uint64_t bulk_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	RandomPCG rng(5);
+	begin = OS::get_singleton()->get_ticks_usec();
+	int64_t id_sum = 0;
+	for (int i = 0; i < query_count; i++) {
+		id_sum += bulk.get_closest_point(Vector3(rng.randf() * width, rng.randf() * height, 0.0));
+	}
+	const uint64_t closest_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < query_count; i++) {
+		bulk.get_closest_position_in_segment(Vector3(rng.randf() * width, rng.randf() * height, 0.0));
+	}
+	const uint64_t segment_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(bulk.get_point_count() == single.get_point_count());
+	CHECK(id_sum > 0);
+	print_line(vformat("%d points: add_point/connect_points %d usec, build_graph %d usec, closest point %.2f usec/query, closest position in segment %.2f usec/query.", positions.size(), single_usec, bulk_usec, double(closest_usec) / query_count, double(segment_usec) / query_count));
+}
+
+static real_t get_path_length(const Vector<Vector2> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+static void fill_random_solid(AStarGrid2D &p_grid, RandomPCG &p_rng, real_t p_density) {
+	const Rect2i region = p_grid.get_region();
+	for (int32_t y = region.position.y; y < region.get_end().y; y++) {
+		for (int32_t x = region.position.x; x < region.get_end().x; x++) {
+			if (p_rng.randf() < p_density) {
+				p_grid.set_point_solid(Vector2i(x, y));
+			}
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Jump point search should find paths as short as a full search") {
+	RandomPCG rng(3);
+	AStarGrid2D a;
+	a.set_region(Rect2i(-10, -5, 70, 60));
+	a.update();
+	fill_random_solid(a, rng, 0.25);
+
+	for (int i = 0; i < 100; i++) {
+		const Vector2i from = Vector2i(-10 + rng.rand() % 70, -5 + rng.rand() % 60);
+		const Vector2i to = Vector2i(-10 + rng.rand() % 70, -5 + rng.rand() % 60);
+
+		a.set_jumping_enabled(false);
+		const Vector<Vector2> path = a.get_point_path(from, to);
+		a.set_jumping_enabled(true);
+		const Vector<Vector2> jump_path = a.get_point_path(from, to);
+
+		REQUIRE(path.is_empty() == jump_path.is_empty());
+		if (!path.is_empty()) {
+			CHECK(jump_path[0] == path[0]);
+			CHECK(jump_path[jump_path.size() - 1] == path[path.size() - 1]);
+			CHECK(get_path_length(jump_path) == doctest::Approx(get_path_length(path)));
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Hierarchical paths") {
+	AStarGrid2D a;
+	a.set_region(Rect2i(0, 0, 100, 40));
+	a.set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	a.set_hierarchical_enabled(true);
+	a.update();
+
+	// A wall with a gap at the bottom.
+	a.fill_solid_region(Rect2i(50, 0, 1, 38));
+
+	TypedArray<Vector2i> path = a.get_id_path(Vector2i(10, 5), Vector2i(90, 5));
+	REQUIRE(path.size() > 0);
+	CHECK(Vector2i(path[0]) == Vector2i(10, 5));
+	CHECK(Vector2i(path[path.size() - 1]) == Vector2i(90, 5));
+	for (int i = 0; i < path.size(); i++) {
+		CHECK_FALSE(a.is_point_solid(path[i]));
+		if (i > 0) {
+			const Vector2i step = Vector2i(path[i]) - Vector2i(path[i - 1]);
+			CHECK(MAX(ABS(step.x), ABS(step.y)) == 1);
+		}
+	}
+
+	// Closing the gap makes the other side unreachable, only partial paths are found.
+	a.fill_solid_region(Rect2i(50, 38, 1, 2));
+	CHECK(a.get_id_path(Vector2i(10, 5), Vector2i(90, 5)).is_empty());
+	path = a.get_id_path(Vector2i(10, 5), Vector2i(90, 5), true);
+	REQUIRE(path.size() > 0);
+	CHECK(Vector2i(path[path.size() - 1]) == Vector2i(49, 5));
+
+	// Reopening it in another cluster.
+	a.set_point_solid(Vector2i(50, 3), false);
+	path = a.get_id_path(Vector2i(10, 5), Vector2i(90, 5));
+	REQUIRE(path.size() > 0);
+	CHECK(path.has(Vector2i(50, 3)));
+
+	// Paths along the borders of the regions stay as short as full paths.
+	RandomPCG rng(7);
+	a.clear();
+	a.set_region(Rect2i(0, 0, 64, 64));
+	a.set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ALWAYS);
+	a.update();
+	fill_random_solid(a, rng, 0.1);
+	for (int i = 0; i < 50; i++) {
+		const Vector2i from = Vector2i(rng.rand() % 64, rng.rand() % 64);
+		const Vector2i to = Vector2i(rng.rand() % 64, rng.rand() % 64);
+		a.set_hierarchical_enabled(true);
+		const Vector<Vector2> hierarchical_path = a.get_point_path(from, to);
+		a.set_hierarchical_enabled(false);
+		const Vector<Vector2> full_path = a.get_point_path(from, to);
+		REQUIRE(hierarchical_path.is_empty() == full_path.is_empty());
+		CHECK(get_path_length(hierarchical_path) <= get_path_length(full_path) * 1.5);
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Batched paths should match single paths") {
+	RandomPCG rng(11);
+	AStarGrid2D a;
+	a.set_region(Rect2i(0, 0, 80, 80));
+	a.update();
+	fill_random_solid(a, rng, 0.3);
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	for (int i = 0; i < 64; i++) {
+		from_ids.push_back(Vector2i(rng.rand() % 80, rng.rand() % 80));
+		to_ids.push_back(Vector2i(rng.rand() % 80, rng.rand() % 80));
+	}
+
+	for (int hierarchical = 0; hierarchical < 2; hierarchical++) {
+		a.set_hierarchical_enabled(hierarchical);
+		const TypedArray<Array> id_paths = a.get_id_paths(from_ids, to_ids, true);
+		const TypedArray<PackedVector2Array> point_paths = a.get_point_paths(from_ids, to_ids, true);
+		REQUIRE(id_paths.size() == from_ids.size());
+		REQUIRE(point_paths.size() == from_ids.size());
+		for (int i = 0; i < from_ids.size(); i++) {
+			CHECK(Array(id_paths[i]) == Array(a.get_id_path(from_ids[i], to_ids[i], true)));
+			CHECK(PackedVector2Array(point_paths[i]) == a.get_point_path(from_ids[i], to_ids[i], true));
+		}
+	}
+
+	ERR_PRINT_OFF;
+	to_ids.resize(10);
+	CHECK(a.get_id_paths(from_ids, to_ids).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE_BENCHMARK("[AStarGrid2D][Benchmark] Paths on a large grid") {
+	const int size = 1024;
+	const int query_count = 64;
+
+	RandomPCG rng(5);
+	AStarGrid2D a;
+	a.set_region(Rect2i(0, 0, size, size));
+	a.update();
+	fill_random_solid(a, rng, 0.2);
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	for (int i = 0; i < query_count; i++) {
+		const Vector2i from = Vector2i(rng.rand() % size, rng.rand() % size);
+		const Vector2i to = Vector2i(rng.rand() % size, rng.rand() % size);
+		a.set_point_solid(from, false);
+		a.set_point_solid(to, false);
+		from_ids.push_back(from);
+		to_ids.push_back(to);
+	}
+
+	for (int hierarchical = 0; hierarchical < 2; hierarchical++) {
+		a.set_hierarchical_enabled(hierarchical);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		a.get_id_path(from_ids[0], from_ids[0]); // Builds the clusters.
+		const uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		int64_t length = 0;
+		for (int i = 0; i < query_count; i++) {
+			length += a.get_id_path(from_ids[i], to_ids[i]).size();
+		}
+		const uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		const TypedArray<Array> paths = a.get_id_paths(from_ids, to_ids);
+		const uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		CHECK(paths.size() == query_count);
+		print_line(vformat("%dx%d grid, hierarchical %s: clusters %d usec, get_id_path %.2f usec/query, get_id_paths %.2f usec/query, %d cells.", size, size, hierarchical ? "on" : "off", build_usec, double(single_usec) / query_count, double(batch_usec) / query_count, length));
+	}
+}
 } // namespace TestAStar
 
 #endif // TEST_ASTAR_H
@@ -0,0 +1,188 @@
+/**************************************************************************/
+/*  test_batch_math.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BATCH_MATH_H
+#define TEST_BATCH_MATH_H
+
+#include "core/math/batch_math.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBatchMath {
+
+static PackedVector3Array random_vectors(int p_count, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	PackedVector3Array vectors;
+	vectors.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		vectors.set(i, Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5) * 100.0);
+	}
+	return vectors;
+}
+
+TEST_CASE("[BatchMath] Matches per-element operations") {
+	const Transform3D transform = Transform3D(Basis(Vector3(1, 2, 3).normalized(), 0.7).scaled(Vector3(1, 2, 0.5)), Vector3(3, -4, 5));
+
+	// Cover the vectorized part and the remainder for every size.
+	for (int count = 0; count < 19; count++) {
+		PackedVector3Array vectors = random_vectors(count, count);
+		if (count > 5) {
+			vectors.set(5, Vector3());
+		}
+		const PackedVector3Array others = random_vectors(count, count + 100);
+
+		PackedVector3Array result;
+		result.resize(count);
+		LocalVector<real_t> dots;
+		dots.resize(count);
+
+		BatchMath::transform(transform, vectors.ptr(), result.ptrw(), count);
+		for (int i = 0; i < count; i++) {
+			CHECK(result[i].is_equal_approx(transform.xform(vectors[i])));
+		}
+
+		BatchMath::transform_inv(transform, vectors.ptr(), result.ptrw(), count);
+		for (int i = 0; i < count; i++) {
+			CHECK(result[i].is_equal_approx(transform.xform_inv(vectors[i])));
+		}
+
+		BatchMath::transform(transform.basis, vectors.ptr(), result.ptrw(), count);
+		for (int i = 0; i < count; i++) {
+			CHECK(result[i].is_equal_approx(transform.basis.xform(vectors[i])));
+		}
+
+		BatchMath::normalize(vectors.ptr(), result.ptrw(), count);
+		for (int i = 0; i < count; i++) {
+			CHECK(result[i].is_equal_approx(vectors[i].normalized()));
+		}
+
+		BatchMath::dot(vectors.ptr(), others.ptr(), dots.ptr(), count);
+		for (int i = 0; i < count; i++) {
+			CHECK(Math::is_equal_approx(dots[i], vectors[i].dot(others[i])));
+		}
+
+		const AABB aabb = BatchMath::get_aabb(vectors.ptr(), count);
+		AABB expected;
+		for (int i = 0; i < count; i++) {
+			if (i == 0) {
+				expected.position = vectors[i];
+			} else {
+				expected.expand_to(vectors[i]);
+			}
+		}
+		CHECK(aabb.is_equal_approx(expected));
+	}
+}
+
+TEST_CASE("[BatchMath] In-place operations") {
+	PackedVector3Array vectors = random_vectors(11, 3);
+	const PackedVector3Array original = vectors;
+
+	BatchMath::normalize(vectors.ptr(), vectors.ptrw(), vectors.size());
+	for (int i = 0; i < vectors.size(); i++) {
+		CHECK(vectors[i].is_equal_approx(original[i].normalized()));
+	}
+
+	const Transform3D transform = Transform3D(Basis().rotated(Vector3(0, 1, 0), 1.0), Vector3(1, 2, 3));
+	vectors = original;
+	BatchMath::transform(transform, vectors.ptr(), vectors.ptrw(), vectors.size());
+	for (int i = 0; i < vectors.size(); i++) {
+		CHECK(vectors[i].is_equal_approx(transform.xform(original[i])));
+	}
+}
+
+TEST_CASE("[BatchMath] PackedVector3Array script methods") {
+	const PackedVector3Array vectors = { Vector3(3, 0, 0), Vector3(0, -2, 0), Vector3(), Vector3(1, 1, 1), Vector3(-4, 5, 6) };
+
+	const PackedVector3Array normalized = Variant(vectors).call("normalized");
+	REQUIRE(normalized.size() == vectors.size());
+	CHECK(normalized[0].is_equal_approx(Vector3(1, 0, 0)));
+	CHECK(normalized[1].is_equal_approx(Vector3(0, -1, 0)));
+	CHECK_MESSAGE(normalized[2] == Vector3(), "Zero vectors should stay zero.");
+
+	const PackedFloat32Array dots = Variant(vectors).call("dot", normalized);
+	REQUIRE(dots.size() == vectors.size());
+	CHECK(dots[0] == doctest::Approx(3));
+	CHECK(dots[1] == doctest::Approx(2));
+	CHECK(dots[3] == doctest::Approx(Math::sqrt(3.0)));
+
+	const AABB aabb = Variant(vectors).call("get_aabb");
+	CHECK(aabb.is_equal_approx(AABB(Vector3(-4, -2, 0), Vector3(7, 7, 6))));
+	CHECK(AABB(Variant(PackedVector3Array()).call("get_aabb")) == AABB());
+
+	const Transform3D transform = Transform3D(Basis().scaled(Vector3(2, 2, 2)), Vector3(1, 0, 0));
+	const PackedVector3Array transformed = transform.xform(vectors);
+	CHECK(transformed[4].is_equal_approx(Vector3(-7, 10, 12)));
+}
+
+TEST_CASE_BENCHMARK("[BatchMath][Benchmark] Bulk operations against per-element loops") {
+	const int count = 1000000;
+	const PackedVector3Array vectors = random_vectors(count, 1);
+	const Vector3 *src = vectors.ptr();
+	PackedVector3Array result;
+	result.resize(count);
+	Vector3 *dst = result.ptrw();
+	const Transform3D transform = Transform3D(Basis(Vector3(1, 2, 3).normalized(), 0.7), Vector3(3, -4, 5));
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		dst[i] = transform.xform(src[i]);
+	}
+	uint64_t middle = OS::get_singleton()->get_ticks_usec();
+	BatchMath::transform(transform, src, dst, count);
+	uint64_t end = OS::get_singleton()->get_ticks_usec();
+	print_line(vformat("Transform: %d usec per element, %d usec batched.", middle - begin, end - middle));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		dst[i] = src[i].normalized();
+	}
+	middle = OS::get_singleton()->get_ticks_usec();
+	BatchMath::normalize(src, dst, count);
+	end = OS::get_singleton()->get_ticks_usec();
+	print_line(vformat("Normalize: %d usec per element, %d usec batched.", middle - begin, end - middle));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	AABB aabb = AABB(src[0], Vector3());
+	for (int i = 1; i < count; i++) {
+		aabb.expand_to(src[i]);
+	}
+	middle = OS::get_singleton()->get_ticks_usec();
+	const AABB batched_aabb = BatchMath::get_aabb(src, count);
+	end = OS::get_singleton()->get_ticks_usec();
+	CHECK(aabb.is_equal_approx(batched_aabb));
+	print_line(vformat("AABB: %d usec per element, %d usec batched.", middle - begin, end - middle));
+}
+
+} // namespace TestBatchMath
+
+#endif // TEST_BATCH_MATH_H
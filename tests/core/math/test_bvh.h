@@ -0,0 +1,226 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBVH {
+
+struct TestItem {
+	uint32_t id = 0;
+};
+
+template <typename T>
+class TestPairFunction {
+public:
+	static bool user_pair_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+template <typename T>
+class TestCullFunction {
+public:
+	static bool user_cull_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+typedef BVH_Manager<TestItem, 1, true, 32, TestPairFunction<TestItem>, TestCullFunction<TestItem>> TestBVHManager;
+
+struct TestWorld {
+	TestBVHManager bvh;
+	LocalVector<TestItem> items;
+	LocalVector<BVHHandle> handles;
+	HashSet<uint64_t> pairs;
+
+	static uint64_t pair_key(const TestItem *p_a, const TestItem *p_b) {
+		uint32_t a = MIN(p_a->id, p_b->id);
+		uint32_t b = MAX(p_a->id, p_b->id);
+		return ((uint64_t)a << 32) | b;
+	}
+
+	static void *pair_callback(void *p_self, uint32_t p_id_a, TestItem *p_a, int p_subindex_a, uint32_t p_id_b, TestItem *p_b, int p_subindex_b) {
+		TestWorld *self = (TestWorld *)p_self;
+		self->pairs.insert(pair_key(p_a, p_b));
+		return nullptr;
+	}
+
+	static void unpair_callback(void *p_self, uint32_t p_id_a, TestItem *p_a, int p_subindex_a, uint32_t p_id_b, TestItem *p_b, int p_subindex_b, void *p_pair_data) {
+		TestWorld *self = (TestWorld *)p_self;
+		self->pairs.erase(pair_key(p_a, p_b));
+	}
+
+	TestWorld(uint32_t p_count, uint32_t p_parallel_threshold) {
+		bvh.params_set_parallel_refit_threshold(p_parallel_threshold);
+		bvh.params_set_parallel_pairing_threshold(p_parallel_threshold);
+		bvh.set_pair_callback(pair_callback, this);
+		bvh.set_unpair_callback(unpair_callback, this);
+
+		// must not reallocate once the BVH holds pointers to the items
+		items.resize(p_count);
+		for (uint32_t i = 0; i < p_count; i++) {
+			items[i].id = i;
+		}
+	}
+};
+
+static AABB random_box(RandomPCG &p_rng, real_t p_world_size) {
+	Vector3 pos(p_rng.randf() * p_world_size, p_rng.randf() * p_world_size, p_rng.randf() * p_world_size);
+	return AABB(pos, Vector3(1, 1, 1));
+}
+
+// Runs identical moves through both worlds, with a random walk so pairs are made and broken.
+static void step_worlds(TestWorld &p_a, TestWorld &p_b, LocalVector<AABB> &r_boxes, RandomPCG &p_rng, real_t p_step) {
+	for (uint32_t i = 0; i < r_boxes.size(); i++) {
+		r_boxes[i].position += Vector3(p_rng.randf() - 0.5, p_rng.randf() - 0.5, p_rng.randf() - 0.5) * p_step;
+		p_a.bvh.move(p_a.handles[i], r_boxes[i]);
+		p_b.bvh.move(p_b.handles[i], r_boxes[i]);
+	}
+	p_a.bvh.update();
+	p_b.bvh.update();
+}
+
+TEST_CASE("[BVH] Parallel refit and pairing match the single threaded path") {
+	const uint32_t count = 2000;
+	const real_t world_size = 40.0;
+
+	// threshold 0 is single threaded, 1 is parallel whenever possible
+	TestWorld single(count, 0);
+	TestWorld parallel(count, 1);
+
+	RandomPCG rng(7);
+	LocalVector<AABB> boxes;
+	boxes.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		boxes[i] = random_box(rng, world_size);
+		single.handles.push_back(single.bvh.create(&single.items[i], true, 0, 1, boxes[i]));
+		parallel.handles.push_back(parallel.bvh.create(&parallel.items[i], true, 0, 1, boxes[i]));
+	}
+
+	CHECK_MESSAGE(single.pairs.size() > 0, "The test scene should have overlapping items.");
+
+	for (int tick = 0; tick < 20; tick++) {
+		step_worlds(single, parallel, boxes, rng, 2.0);
+
+		CHECK(single.pairs.size() == parallel.pairs.size());
+		bool same_pairs = true;
+		for (const uint64_t &key : single.pairs) {
+			same_pairs = same_pairs && parallel.pairs.has(key);
+		}
+		CHECK_MESSAGE(same_pairs, "Pairs should be the same on both paths.");
+	}
+
+	// the refit trees should return the same culls
+	const int max_results = count;
+	LocalVector<TestItem *> results_single;
+	LocalVector<TestItem *> results_parallel;
+	results_single.resize(max_results);
+	results_parallel.resize(max_results);
+
+	int mismatches = 0;
+	for (int i = 0; i < 200; i++) {
+		AABB query = random_box(rng, world_size).grow(3.0);
+		int num_single = single.bvh.cull_aabb(query, results_single.ptr(), max_results, nullptr);
+		int num_parallel = parallel.bvh.cull_aabb(query, results_parallel.ptr(), max_results, nullptr);
+		if (num_single != num_parallel) {
+			mismatches++;
+			continue;
+		}
+
+		HashSet<uint32_t> ids;
+		for (int n = 0; n < num_single; n++) {
+			ids.insert(results_single[n]->id);
+		}
+		for (int n = 0; n < num_parallel; n++) {
+			if (!ids.has(results_parallel[n]->id)) {
+				mismatches++;
+				break;
+			}
+		}
+	}
+	CHECK_MESSAGE(mismatches == 0, "AABB culls should match after parallel refits.");
+}
+
+TEST_CASE_BENCHMARK("[BVH][Benchmark] Broadphase update with many moving items") {
+	const uint32_t count = 20000;
+	const real_t world_size = 200.0;
+	const int ticks = 30;
+
+	TestWorld single(count, 0);
+	TestWorld parallel(count, 256);
+
+	RandomPCG rng(11);
+	LocalVector<AABB> boxes;
+	boxes.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		boxes[i] = random_box(rng, world_size);
+		single.handles.push_back(single.bvh.create(&single.items[i], true, 0, 1, boxes[i]));
+		parallel.handles.push_back(parallel.bvh.create(&parallel.items[i], true, 0, 1, boxes[i]));
+	}
+
+	uint64_t time_single = 0;
+	uint64_t time_parallel = 0;
+
+	for (int tick = 0; tick < ticks; tick++) {
+		for (uint32_t i = 0; i < count; i++) {
+			boxes[i].position += Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < count; i++) {
+			single.bvh.move(single.handles[i], boxes[i]);
+		}
+		single.bvh.update();
+		time_single += OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < count; i++) {
+			parallel.bvh.move(parallel.handles[i], boxes[i]);
+		}
+		parallel.bvh.update();
+		time_parallel += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	print_line(vformat("%d items, %d ticks (%d pairs): single threaded %d usec, parallel %d usec.", count, ticks, single.pairs.size(), time_single, time_parallel));
+
+	CHECK(single.pairs.size() == parallel.pairs.size());
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
@@ -0,0 +1,254 @@
+/**************************************************************************/
+/*  test_convex_hull.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_CONVEX_HULL_H
+#define TEST_CONVEX_HULL_H
+
+#include "core/math/convex_hull.h"
+#include "core/math/quick_hull.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestConvexHull {
+
+// Triangle soup of a box, like the vertices of a mesh with flat shading.
+static void add_box(Vector<Vector3> &r_points, const Vector3 &p_center, const Vector3 &p_extents) {
+	static const int quad[6] = { 0, 1, 2, 1, 3, 2 };
+	for (int axis = 0; axis < 6; axis++) {
+		for (int i = 0; i < 6; i++) {
+			Vector3 p;
+			p[axis / 2] = (axis & 1) ? 1 : -1;
+			p[(axis / 2 + 1) % 3] = (quad[i] & 1) ? 1 : -1;
+			p[(axis / 2 + 2) % 3] = (quad[i] & 2) ? 1 : -1;
+			r_points.push_back(p_center + p * p_extents);
+		}
+	}
+}
+
+// Triangle soup of a UV sphere, with each vertex moved along its normal by up to p_noise times the radius.
+static void add_sphere(Vector<Vector3> &r_points, RandomPCG &p_rng, const Vector3 &p_center, real_t p_radius, int p_rings, int p_segments, real_t p_noise) {
+	LocalVector<Vector3> grid;
+	for (int i = 0; i <= p_rings; i++) {
+		const real_t v = Math_PI * i / p_rings;
+		for (int j = 0; j <= p_segments; j++) {
+			const real_t u = Math_TAU * (j % p_segments) / p_segments;
+			const real_t radius = p_radius * (1.0 + p_noise * (p_rng.randf() - 0.5));
+			grid.push_back(p_center + Vector3(Math::sin(v) * Math::cos(u), Math::cos(v), Math::sin(v) * Math::sin(u)) * radius);
+		}
+	}
+	for (int i = 0; i < p_rings; i++) {
+		for (int j = 0; j < p_segments; j++) {
+			const int a = i * (p_segments + 1) + j;
+			const int c = a + p_segments + 1;
+			r_points.append_array({ grid[a], grid[a + 1], grid[c], grid[a + 1], grid[c + 1], grid[c] });
+		}
+	}
+}
+
+// Checks the hull is closed, and that all the points are inside it. Hull vertices are snapped to a grid of
+// about 1/10000th of the size of the points, so points on the hull may be slightly outside its faces.
+static void check_hull(const Vector<Vector3> &p_points, const Geometry3D::MeshData &p_mesh, real_t p_tolerance) {
+	CHECK(int(p_mesh.vertices.size()) - int(p_mesh.edges.size()) + int(p_mesh.faces.size()) == 2);
+	for (const Geometry3D::MeshData::Edge &edge : p_mesh.edges) {
+		CHECK(edge.face_a >= 0);
+		CHECK(edge.face_b >= 0);
+	}
+
+	real_t max_distance = 0;
+	for (const Geometry3D::MeshData::Face &face : p_mesh.faces) {
+		for (const Vector3 &point : p_points) {
+			max_distance = MAX(max_distance, face.plane.distance_to(point));
+		}
+	}
+	CHECK(max_distance < p_tolerance);
+}
+
+TEST_CASE("[ConvexHullComputer] Box with interior and duplicate points") {
+	RandomPCG rng(7);
+	Vector<Vector3> points;
+	add_box(points, Vector3(1, 2, 3), Vector3(1, 2, 0.5));
+	for (int i = 0; i < 500; i++) {
+		points.push_back(Vector3(1, 2, 3) + (Vector3(rng.randf(), rng.randf(), rng.randf()) - Vector3(0.5, 0.5, 0.5)) * Vector3(1, 2, 0.5));
+	}
+
+	Geometry3D::MeshData mesh;
+	CHECK(ConvexHullComputer::convex_hull(points, mesh) == OK);
+	CHECK(mesh.vertices.size() == 8);
+	CHECK(mesh.edges.size() == 12);
+	CHECK(mesh.faces.size() == 6);
+	for (const Vector3 &vertex : mesh.vertices) {
+		CHECK((vertex - Vector3(1, 2, 3)).abs().is_equal_approx(Vector3(1, 2, 0.5)));
+	}
+	check_hull(points, mesh, 0.01);
+}
+
+TEST_CASE("[ConvexHullComputer] Random point clouds") {
+	RandomPCG rng(11);
+	for (int count : { 4, 10, 100, 1000, 10000 }) {
+		Vector<Vector3> points;
+		for (int i = 0; i < count; i++) {
+			points.push_back(Vector3(rng.randf(), rng.randf(), rng.randf()) * 10.0);
+		}
+
+		Geometry3D::MeshData mesh;
+		CHECK(ConvexHullComputer::convex_hull(points, mesh) == OK);
+		check_hull(points, mesh, 0.01);
+		for (const Vector3 &vertex : mesh.vertices) {
+			bool found = false;
+			for (const Vector3 &point : points) {
+				found = found || vertex.distance_to(point) < 0.01;
+			}
+			CHECK(found);
+		}
+
+		// QuickHull merges nearly coplanar faces, so only check it gives a closed hull.
+		Geometry3D::MeshData quick_hull_mesh;
+		CHECK(QuickHull::build(points, quick_hull_mesh) == OK);
+		CHECK(quick_hull_mesh.faces.size() >= 4);
+		for (const Geometry3D::MeshData::Face &face : quick_hull_mesh.faces) {
+			CHECK(face.indices.size() >= 3);
+		}
+		for (const Geometry3D::MeshData::Edge &edge : quick_hull_mesh.edges) {
+			CHECK(edge.face_a >= 0);
+			CHECK(edge.face_b >= 0);
+		}
+	}
+
+	Geometry3D::MeshData mesh;
+	CHECK(ConvexHullComputer::convex_hull(Vector<Vector3>(), mesh) == FAILED);
+}
+
+TEST_CASE("[ConvexHullComputer] Batch matches single hulls") {
+	RandomPCG rng(3);
+	Vector<Vector<Vector3>> point_sets;
+	for (int i = 0; i < 40; i++) {
+		Vector<Vector3> points;
+		if (i % 4 == 0) {
+			add_box(points, Vector3(i, 0, 0), Vector3(1, 1 + i * 0.1, 2));
+		} else if (i % 4 == 1) {
+			add_sphere(points, rng, Vector3(0, i, 0), 1 + i * 0.05, 8, 16, 0.2);
+		} else {
+			for (int j = 0; j < 20 + i * 50; j++) {
+				points.push_back(Vector3(rng.randf(), rng.randf(), rng.randf()) * i);
+			}
+		}
+		point_sets.push_back(points);
+	}
+
+	Vector<Geometry3D::MeshData> meshes;
+	CHECK(ConvexHullComputer::convex_hull_batch(point_sets, meshes) == OK);
+	REQUIRE(meshes.size() == point_sets.size());
+	for (int i = 0; i < point_sets.size(); i++) {
+		Geometry3D::MeshData mesh;
+		CHECK(ConvexHullComputer::convex_hull(point_sets[i], mesh) == OK);
+		REQUIRE(meshes[i].vertices.size() == mesh.vertices.size());
+		for (uint32_t j = 0; j < mesh.vertices.size(); j++) {
+			CHECK(meshes[i].vertices[j] == mesh.vertices[j]);
+		}
+		CHECK(meshes[i].edges.size() == mesh.edges.size());
+		REQUIRE(meshes[i].faces.size() == mesh.faces.size());
+		for (uint32_t j = 0; j < mesh.faces.size(); j++) {
+			REQUIRE(meshes[i].faces[j].indices.size() == mesh.faces[j].indices.size());
+			for (uint32_t k = 0; k < mesh.faces[j].indices.size(); k++) {
+				CHECK(meshes[i].faces[j].indices[k] == mesh.faces[j].indices[k]);
+			}
+		}
+	}
+
+	// An empty set fails, but doesn't keep the other hulls from being built.
+	point_sets.write[5] = Vector<Vector3>();
+	CHECK(ConvexHullComputer::convex_hull_batch(point_sets, meshes) == FAILED);
+	CHECK(meshes[5].vertices.is_empty());
+	CHECK(meshes[6].faces.size() > 0);
+
+	CHECK(ConvexHullComputer::convex_hull_batch(Vector<Vector<Vector3>>(), meshes) == OK);
+	CHECK(meshes.is_empty());
+}
+
+TEST_CASE_BENCHMARK("[ConvexHullComputer][Benchmark] Hulls of imported props") {
+	RandomPCG rng(1);
+	struct Prop {
+		const char *name;
+		Vector<Vector3> points;
+	};
+	LocalVector<Prop> props;
+
+	props.push_back({ "crate" });
+	add_box(props[props.size() - 1].points, Vector3(), Vector3(0.5, 0.5, 0.5));
+	props.push_back({ "table" });
+	add_box(props[props.size() - 1].points, Vector3(0, 0.9, 0), Vector3(1, 0.05, 0.6));
+	for (int i = 0; i < 4; i++) {
+		add_box(props[props.size() - 1].points, Vector3((i & 1) ? 0.9 : -0.9, 0.45, (i & 2) ? 0.5 : -0.5), Vector3(0.05, 0.45, 0.05));
+	}
+	props.push_back({ "barrel" });
+	add_sphere(props[props.size() - 1].points, rng, Vector3(), 0.5, 4, 32, 0);
+	props.push_back({ "rock" });
+	add_sphere(props[props.size() - 1].points, rng, Vector3(), 1, 24, 48, 0.3);
+	props.push_back({ "statue" });
+	for (int i = 0; i < 7; i++) {
+		add_sphere(props[props.size() - 1].points, rng, Vector3(0, i * 0.3, 0), 0.4 - i * 0.03, 32, 48, 0.05);
+	}
+	props.push_back({ "scan" });
+	add_sphere(props[props.size() - 1].points, rng, Vector3(), 2, 128, 256, 0.01);
+
+	for (const Prop &prop : props) {
+		const int iterations = MAX(1, 200000 / prop.points.size());
+		Geometry3D::MeshData mesh;
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			ConvexHullComputer::convex_hull(prop.points, mesh);
+		}
+		const uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+		print_line(vformat("%s: %d points, %d faces, %.1f us per hull.", prop.name, prop.points.size(), mesh.faces.size(), usec / double(iterations)));
+	}
+
+	// A level's worth of props, cooked one by one and as a batch.
+	Vector<Vector<Vector3>> point_sets;
+	for (int i = 0; i < 2000; i++) {
+		point_sets.push_back(props[i % (props.size() - 1)].points);
+	}
+	Vector<Geometry3D::MeshData> meshes;
+	meshes.resize(point_sets.size());
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < point_sets.size(); i++) {
+		ConvexHullComputer::convex_hull(point_sets[i], meshes.write[i]);
+	}
+	const uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	begin = OS::get_singleton()->get_ticks_usec();
+	ConvexHullComputer::convex_hull_batch(point_sets, meshes);
+	const uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("%d props: %d ms one by one, %d ms batched.", point_sets.size(), single_usec / 1000, batch_usec / 1000));
+}
+
+} // namespace TestConvexHull
+
+#endif // TEST_CONVEX_HULL_H
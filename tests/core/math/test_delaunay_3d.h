@@ -0,0 +1,506 @@
+/**************************************************************************/
+/*  test_delaunay_3d.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_DELAUNAY_3D_H
+#define TEST_DELAUNAY_3D_H
+
+#include "core/math/delaunay_3d.h"
+#include "core/math/projection.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/list.h"
+#include "core/templates/oa_hash_map.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDelaunay3D {
+
+// Previous implementation of Delaunay3D::tetrahedralize(), which scans every simplex overlapping the grid cell of
+// each inserted point. It is quadratic in the number of points, and kept as a reference for the new one.
+class Delaunay3DScan {
+	struct Simplex;
+
+	enum {
+		ACCEL_GRID_SIZE = 16
+	};
+	struct GridPos {
+		Vector3i pos;
+		List<Simplex *>::Element *E = nullptr;
+	};
+
+	struct Simplex {
+		uint32_t points[4];
+		R128 circum_center_x;
+		R128 circum_center_y;
+		R128 circum_center_z;
+		R128 circum_r2;
+		LocalVector<GridPos> grid_positions;
+		List<Simplex *>::Element *SE = nullptr;
+
+		_FORCE_INLINE_ Simplex() {}
+		_FORCE_INLINE_ Simplex(uint32_t p_a, uint32_t p_b, uint32_t p_c, uint32_t p_d) {
+			points[0] = p_a;
+			points[1] = p_b;
+			points[2] = p_c;
+			points[3] = p_d;
+		}
+	};
+
+	struct Triangle {
+		uint32_t triangle[3];
+		bool bad = false;
+		_FORCE_INLINE_ bool operator==(const Triangle &p_triangle) const {
+			return triangle[0] == p_triangle.triangle[0] && triangle[1] == p_triangle.triangle[1] && triangle[2] == p_triangle.triangle[2];
+		}
+
+		_FORCE_INLINE_ Triangle() {}
+		_FORCE_INLINE_ Triangle(uint32_t p_a, uint32_t p_b, uint32_t p_c) {
+			if (p_a > p_b) {
+				SWAP(p_a, p_b);
+			}
+			if (p_b > p_c) {
+				SWAP(p_b, p_c);
+			}
+			if (p_a > p_b) {
+				SWAP(p_a, p_b);
+			}
+
+			triangle[0] = p_a;
+			triangle[1] = p_b;
+			triangle[2] = p_c;
+		}
+	};
+
+	struct TriangleHasher {
+		_FORCE_INLINE_ static uint32_t hash(const Triangle &p_triangle) {
+			uint32_t h = hash_djb2_one_32(p_triangle.triangle[0]);
+			h = hash_djb2_one_32(p_triangle.triangle[1], h);
+			return hash_fmix32(hash_djb2_one_32(p_triangle.triangle[2], h));
+		}
+	};
+
+	_FORCE_INLINE_ static void circum_sphere_compute(const Vector3 *p_points, Simplex *p_simplex) {
+		// The only part in the algorithm where there may be precision errors is this one,
+		// so ensure that we do it with the maximum precision possible.
+
+		R128 v0_x = p_points[p_simplex->points[0]].x;
+		R128 v0_y = p_points[p_simplex->points[0]].y;
+		R128 v0_z = p_points[p_simplex->points[0]].z;
+		R128 v1_x = p_points[p_simplex->points[1]].x;
+		R128 v1_y = p_points[p_simplex->points[1]].y;
+		R128 v1_z = p_points[p_simplex->points[1]].z;
+		R128 v2_x = p_points[p_simplex->points[2]].x;
+		R128 v2_y = p_points[p_simplex->points[2]].y;
+		R128 v2_z = p_points[p_simplex->points[2]].z;
+		R128 v3_x = p_points[p_simplex->points[3]].x;
+		R128 v3_y = p_points[p_simplex->points[3]].y;
+		R128 v3_z = p_points[p_simplex->points[3]].z;
+
+		// Create the rows of our "unrolled" 3x3 matrix.
+		R128 row1_x = v1_x - v0_x;
+		R128 row1_y = v1_y - v0_y;
+		R128 row1_z = v1_z - v0_z;
+
+		R128 row2_x = v2_x - v0_x;
+		R128 row2_y = v2_y - v0_y;
+		R128 row2_z = v2_z - v0_z;
+
+		R128 row3_x = v3_x - v0_x;
+		R128 row3_y = v3_y - v0_y;
+		R128 row3_z = v3_z - v0_z;
+
+		R128 sq_lenght1 = row1_x * row1_x + row1_y * row1_y + row1_z * row1_z;
+		R128 sq_lenght2 = row2_x * row2_x + row2_y * row2_y + row2_z * row2_z;
+		R128 sq_lenght3 = row3_x * row3_x + row3_y * row3_y + row3_z * row3_z;
+
+		// Compute the determinant of said matrix.
+		R128 determinant = row1_x * (row2_y * row3_z - row3_y * row2_z) - row2_x * (row1_y * row3_z - row3_y * row1_z) + row3_x * (row1_y * row2_z - row2_y * row1_z);
+
+		// Compute the volume of the tetrahedron, and precompute a scalar quantity for reuse in the formula.
+		R128 volume = determinant / R128(6.f);
+		R128 i12volume = R128(1.f) / (volume * R128(12.f));
+
+		R128 center_x = v0_x + i12volume * ((row2_y * row3_z - row3_y * row2_z) * sq_lenght1 - (row1_y * row3_z - row3_y * row1_z) * sq_lenght2 + (row1_y * row2_z - row2_y * row1_z) * sq_lenght3);
+		R128 center_y = v0_y + i12volume * (-(row2_x * row3_z - row3_x * row2_z) * sq_lenght1 + (row1_x * row3_z - row3_x * row1_z) * sq_lenght2 - (row1_x * row2_z - row2_x * row1_z) * sq_lenght3);
+		R128 center_z = v0_z + i12volume * ((row2_x * row3_y - row3_x * row2_y) * sq_lenght1 - (row1_x * row3_y - row3_x * row1_y) * sq_lenght2 + (row1_x * row2_y - row2_x * row1_y) * sq_lenght3);
+
+		// Once we know the center, the radius is clearly the distance to any vertex.
+		R128 rel1_x = center_x - v0_x;
+		R128 rel1_y = center_y - v0_y;
+		R128 rel1_z = center_z - v0_z;
+
+		R128 radius1 = rel1_x * rel1_x + rel1_y * rel1_y + rel1_z * rel1_z;
+
+		p_simplex->circum_center_x = center_x;
+		p_simplex->circum_center_y = center_y;
+		p_simplex->circum_center_z = center_z;
+		p_simplex->circum_r2 = radius1;
+	}
+
+	_FORCE_INLINE_ static bool simplex_contains(const Vector3 *p_points, const Simplex &p_simplex, uint32_t p_vertex) {
+		R128 v_x = p_points[p_vertex].x;
+		R128 v_y = p_points[p_vertex].y;
+		R128 v_z = p_points[p_vertex].z;
+
+		R128 rel2_x = p_simplex.circum_center_x - v_x;
+		R128 rel2_y = p_simplex.circum_center_y - v_y;
+		R128 rel2_z = p_simplex.circum_center_z - v_z;
+
+		R128 radius2 = rel2_x * rel2_x + rel2_y * rel2_y + rel2_z * rel2_z;
+
+		return radius2 < (p_simplex.circum_r2 - R128(0.00001));
+	}
+
+	static bool simplex_is_coplanar(const Vector3 *p_points, const Simplex &p_simplex) {
+		Plane p(p_points[p_simplex.points[0]], p_points[p_simplex.points[1]], p_points[p_simplex.points[2]]);
+		if (ABS(p.distance_to(p_points[p_simplex.points[3]])) < CMP_EPSILON) {
+			return true;
+		}
+
+		Projection cm;
+
+		cm.columns[0][0] = p_points[p_simplex.points[0]].x;
+		cm.columns[0][1] = p_points[p_simplex.points[1]].x;
+		cm.columns[0][2] = p_points[p_simplex.points[2]].x;
+		cm.columns[0][3] = p_points[p_simplex.points[3]].x;
+
+		cm.columns[1][0] = p_points[p_simplex.points[0]].y;
+		cm.columns[1][1] = p_points[p_simplex.points[1]].y;
+		cm.columns[1][2] = p_points[p_simplex.points[2]].y;
+		cm.columns[1][3] = p_points[p_simplex.points[3]].y;
+
+		cm.columns[2][0] = p_points[p_simplex.points[0]].z;
+		cm.columns[2][1] = p_points[p_simplex.points[1]].z;
+		cm.columns[2][2] = p_points[p_simplex.points[2]].z;
+		cm.columns[2][3] = p_points[p_simplex.points[3]].z;
+
+		cm.columns[3][0] = 1.0;
+		cm.columns[3][1] = 1.0;
+		cm.columns[3][2] = 1.0;
+		cm.columns[3][3] = 1.0;
+
+		return ABS(cm.determinant()) <= CMP_EPSILON;
+	}
+
+public:
+	typedef Delaunay3D::OutputSimplex OutputSimplex;
+
+	static Vector<OutputSimplex> tetrahedralize(const Vector<Vector3> &p_points) {
+		uint32_t point_count = p_points.size();
+		Vector3 *points = (Vector3 *)memalloc(sizeof(Vector3) * (point_count + 4));
+
+		{
+			const Vector3 *src_points = p_points.ptr();
+			AABB rect;
+			for (uint32_t i = 0; i < point_count; i++) {
+				Vector3 point = src_points[i];
+				if (i == 0) {
+					rect.position = point;
+				} else {
+					rect.expand_to(point);
+				}
+				points[i] = point;
+			}
+
+			for (uint32_t i = 0; i < point_count; i++) {
+				points[i] = (points[i] - rect.position) / rect.size;
+			}
+
+			const real_t delta_max = Math::sqrt(2.0) * 20.0;
+			Vector3 center = Vector3(0.5, 0.5, 0.5);
+
+			// any simplex that contains everything is good
+			points[point_count + 0] = center + Vector3(0, 1, 0) * delta_max;
+			points[point_count + 1] = center + Vector3(0, -1, 1) * delta_max;
+			points[point_count + 2] = center + Vector3(1, -1, -1) * delta_max;
+			points[point_count + 3] = center + Vector3(-1, -1, -1) * delta_max;
+		}
+
+		List<Simplex *> acceleration_grid[ACCEL_GRID_SIZE][ACCEL_GRID_SIZE][ACCEL_GRID_SIZE];
+
+		List<Simplex *> simplex_list;
+		{
+			//create root simplex
+			Simplex *root = memnew(Simplex(point_count + 0, point_count + 1, point_count + 2, point_count + 3));
+			root->SE = simplex_list.push_back(root);
+
+			for (uint32_t i = 0; i < ACCEL_GRID_SIZE; i++) {
+				for (uint32_t j = 0; j < ACCEL_GRID_SIZE; j++) {
+					for (uint32_t k = 0; k < ACCEL_GRID_SIZE; k++) {
+						GridPos gp;
+						gp.E = acceleration_grid[i][j][k].push_back(root);
+						gp.pos = Vector3i(i, j, k);
+						root->grid_positions.push_back(gp);
+					}
+				}
+			}
+
+			circum_sphere_compute(points, root);
+		}
+
+		OAHashMap<Triangle, uint32_t, TriangleHasher> triangles_inserted;
+		LocalVector<Triangle> triangles;
+
+		for (uint32_t i = 0; i < point_count; i++) {
+			bool unique = true;
+			for (uint32_t j = i + 1; j < point_count; j++) {
+				if (points[i].is_equal_approx(points[j])) {
+					unique = false;
+					break;
+				}
+			}
+			if (!unique) {
+				continue;
+			}
+
+			Vector3i grid_pos = Vector3i(points[i] * ACCEL_GRID_SIZE);
+			grid_pos = grid_pos.clamp(Vector3i(), Vector3i(ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1));
+
+			for (List<Simplex *>::Element *E = acceleration_grid[grid_pos.x][grid_pos.y][grid_pos.z].front(); E;) {
+				List<Simplex *>::Element *N = E->next(); //may be deleted
+
+				Simplex *simplex = E->get();
+
+				if (simplex_contains(points, *simplex, i)) {
+					static const uint32_t triangle_order[4][3] = {
+						{ 0, 1, 2 },
+						{ 0, 1, 3 },
+						{ 0, 2, 3 },
+						{ 1, 2, 3 },
+					};
+
+					for (uint32_t k = 0; k < 4; k++) {
+						Triangle t = Triangle(simplex->points[triangle_order[k][0]], simplex->points[triangle_order[k][1]], simplex->points[triangle_order[k][2]]);
+						uint32_t *p = triangles_inserted.lookup_ptr(t);
+						if (p) {
+							triangles[*p].bad = true;
+						} else {
+							triangles_inserted.insert(t, triangles.size());
+							triangles.push_back(t);
+						}
+					}
+
+					//remove simplex and continue
+					simplex_list.erase(simplex->SE);
+
+					for (const GridPos &gp : simplex->grid_positions) {
+						Vector3i p = gp.pos;
+						acceleration_grid[p.x][p.y][p.z].erase(gp.E);
+					}
+					memdelete(simplex);
+				}
+				E = N;
+			}
+
+			for (const Triangle &triangle : triangles) {
+				if (triangle.bad) {
+					continue;
+				}
+				Simplex *new_simplex = memnew(Simplex(triangle.triangle[0], triangle.triangle[1], triangle.triangle[2], i));
+				circum_sphere_compute(points, new_simplex);
+				new_simplex->SE = simplex_list.push_back(new_simplex);
+				{
+					Vector3 center;
+					center.x = double(new_simplex->circum_center_x);
+					center.y = double(new_simplex->circum_center_y);
+					center.z = double(new_simplex->circum_center_z);
+
+					const real_t radius2 = Math::sqrt(double(new_simplex->circum_r2)) + 0.0001;
+					Vector3 extents = Vector3(radius2, radius2, radius2);
+					Vector3i from = Vector3i((center - extents) * ACCEL_GRID_SIZE);
+					Vector3i to = Vector3i((center + extents) * ACCEL_GRID_SIZE);
+					from = from.clamp(Vector3i(), Vector3i(ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1));
+					to = to.clamp(Vector3i(), Vector3i(ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1, ACCEL_GRID_SIZE - 1));
+
+					for (int32_t x = from.x; x <= to.x; x++) {
+						for (int32_t y = from.y; y <= to.y; y++) {
+							for (int32_t z = from.z; z <= to.z; z++) {
+								GridPos gp;
+								gp.pos = Vector3(x, y, z);
+								gp.E = acceleration_grid[x][y][z].push_back(new_simplex);
+								new_simplex->grid_positions.push_back(gp);
+							}
+						}
+					}
+				}
+			}
+
+			triangles.clear();
+			triangles_inserted.clear();
+		}
+
+		//print_line("end with simplices: " + itos(simplex_list.size()));
+		Vector<OutputSimplex> ret_simplices;
+		ret_simplices.resize(simplex_list.size());
+		OutputSimplex *ret_simplicesw = ret_simplices.ptrw();
+		uint32_t simplices_written = 0;
+
+		for (Simplex *simplex : simplex_list) {
+			bool invalid = false;
+			for (int j = 0; j < 4; j++) {
+				if (simplex->points[j] >= point_count) {
+					invalid = true;
+					break;
+				}
+			}
+			if (invalid || simplex_is_coplanar(points, *simplex)) {
+				memdelete(simplex);
+				continue;
+			}
+
+			ret_simplicesw[simplices_written].points[0] = simplex->points[0];
+			ret_simplicesw[simplices_written].points[1] = simplex->points[1];
+			ret_simplicesw[simplices_written].points[2] = simplex->points[2];
+			ret_simplicesw[simplices_written].points[3] = simplex->points[3];
+			simplices_written++;
+			memdelete(simplex);
+		}
+
+		ret_simplices.resize(simplices_written);
+
+		memfree(points);
+
+		return ret_simplices;
+	}
+};
+
+static Vector<Vector3> random_points(int p_count, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	Vector<Vector3> points;
+	for (int i = 0; i < p_count; i++) {
+		points.push_back(Vector3(rng.randf(), rng.randf(), rng.randf()) * 10.0);
+	}
+	return points;
+}
+
+// Sorted tetrahedra with sorted indices, so outputs can be compared regardless of their order.
+static Vector<Vector4i> sorted_simplices(const Vector<Delaunay3D::OutputSimplex> &p_simplices) {
+	Vector<Vector4i> simplices;
+	for (const Delaunay3D::OutputSimplex &simplex : p_simplices) {
+		int points[4] = { int(simplex.points[0]), int(simplex.points[1]), int(simplex.points[2]), int(simplex.points[3]) };
+		SortArray<int> sorter;
+		sorter.sort(points, 4);
+		simplices.push_back(Vector4i(points[0], points[1], points[2], points[3]));
+	}
+	simplices.sort();
+	return simplices;
+}
+
+static real_t total_volume(const Vector<Vector3> &p_points, const Vector<Delaunay3D::OutputSimplex> &p_simplices) {
+	real_t volume = 0.0;
+	for (const Delaunay3D::OutputSimplex &simplex : p_simplices) {
+		const Vector3 &a = p_points[simplex.points[0]];
+		volume += Math::abs((p_points[simplex.points[1]] - a).dot((p_points[simplex.points[2]] - a).cross(p_points[simplex.points[3]] - a))) / 6.0;
+	}
+	return volume;
+}
+
+TEST_CASE("[Delaunay3D] Single tetrahedron with an inner point") {
+	Vector<Vector3> points = { Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1), Vector3(0.2, 0.2, 0.2) };
+	Vector<Delaunay3D::OutputSimplex> simplices = Delaunay3D::tetrahedralize(points);
+	CHECK(simplices.size() == 4);
+	CHECK(total_volume(points, simplices) == doctest::Approx(1.0 / 6.0));
+	for (const Delaunay3D::OutputSimplex &simplex : simplices) {
+		bool has_inner_point = false;
+		for (int i = 0; i < 4; i++) {
+			has_inner_point = has_inner_point || simplex.points[i] == 4;
+		}
+		CHECK_MESSAGE(has_inner_point, "Every tetrahedron should connect the inner point.");
+	}
+}
+
+TEST_CASE("[Delaunay3D] Flat and too small point sets") {
+	CHECK(Delaunay3D::tetrahedralize(Vector<Vector3>()).is_empty());
+	CHECK(Delaunay3D::tetrahedralize({ Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0) }).is_empty());
+	CHECK(Delaunay3D::tetrahedralize({ Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(1, 1, 0), Vector3(0.5, 0.2, 0) }).is_empty());
+}
+
+TEST_CASE("[Delaunay3D] Matches the previous implementation") {
+	for (int count : { 10, 20, 50 }) {
+		for (uint64_t seed = 0; seed < 5; seed++) {
+			const Vector<Vector3> points = random_points(count, seed);
+			CHECK_MESSAGE(sorted_simplices(Delaunay3D::tetrahedralize(points)) == sorted_simplices(Delaunay3DScan::tetrahedralize(points)),
+					vformat("Tetrahedralization of %d random points (seed %d) should be the same.", count, seed));
+		}
+	}
+
+	// Larger sets may resolve nearly cospherical points differently, but should cover the same volume.
+	const Vector<Vector3> points = random_points(500, 42);
+	const real_t volume = total_volume(points, Delaunay3D::tetrahedralize(points));
+	CHECK(volume == doctest::Approx(total_volume(points, Delaunay3DScan::tetrahedralize(points))).epsilon(0.001));
+}
+
+TEST_CASE("[Delaunay3D] Regular grid with duplicates") {
+	// Lightmap probes are often placed on grids, where many points are cospherical.
+	Vector<Vector3> points;
+	const int size = 6;
+	for (int x = 0; x < size; x++) {
+		for (int y = 0; y < size; y++) {
+			for (int z = 0; z < size; z++) {
+				points.push_back(Vector3(x, y, z * 2));
+			}
+		}
+	}
+	// The first copy of duplicated points is skipped.
+	points.push_back(points[7]);
+	points.push_back(points[20]);
+
+	const Vector<Delaunay3D::OutputSimplex> simplices = Delaunay3D::tetrahedralize(points);
+	CHECK(total_volume(points, simplices) == doctest::Approx((size - 1) * (size - 1) * (size - 1) * 2));
+	for (const Delaunay3D::OutputSimplex &simplex : simplices) {
+		for (int i = 0; i < 4; i++) {
+			CHECK(simplex.points[i] < uint32_t(points.size()));
+			CHECK(simplex.points[i] != 7);
+			CHECK(simplex.points[i] != 20);
+		}
+	}
+}
+
+TEST_CASE_BENCHMARK("[Delaunay3D][Benchmark] Tetrahedralization of random points") {
+	for (int count : { 1000, 10000, 100000 }) {
+		const Vector<Vector3> points = random_points(count, 1);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		const int simplex_count = Delaunay3D::tetrahedralize(points).size();
+		const uint64_t sorted_usec = OS::get_singleton()->get_ticks_usec() - begin;
+		print_line(vformat("%d points: %d tetrahedra in %d ms.", count, simplex_count, sorted_usec / 1000));
+
+		// The previous implementation takes minutes for the largest set.
+		if (count <= 10000) {
+			begin = OS::get_singleton()->get_ticks_usec();
+			Delaunay3DScan::tetrahedralize(points);
+			print_line(vformat("%d points: %d ms with the previous implementation.", count, (OS::get_singleton()->get_ticks_usec() - begin) / 1000));
+		}
+	}
+}
+
+} // namespace TestDelaunay3D
+
+#endif // TEST_DELAUNAY_3D_H
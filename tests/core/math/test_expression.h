@@ -37,6 +37,22 @@
 
 namespace TestExpression {
 
+static inline Array build_array() {
+	return Array();
+}
+template <typename... Targs>
+static inline Array build_array(Variant item, Targs... Fargs) {
+	Array a = build_array(Fargs...);
+	a.push_front(item);
+	return a;
+}
+
+static inline Dictionary build_dictionary(const Variant &p_key, const Variant &p_value) {
+	Dictionary d;
+	d[p_key] = p_value;
+	return d;
+}
+
 TEST_CASE("[Expression] Integer arithmetic") {
 	Expression expression;
 
@@ -439,6 +455,173 @@ TEST_CASE("[Expression] Unusual expressions") {
 	//		int64_t(expression.execute()) == 0,
 	//		"`(-9223372036854775807 - 1) / -1` should return the expected result.");
 }
+
+TEST_CASE("[Expression] Changing input types") {
+	Expression expression;
+
+	CHECK_MESSAGE(
+			expression.parse("a + b", { "a", "b" }) == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			int(expression.execute(build_array(2, 3))) == 5,
+			"Integer addition should return the expected result.");
+	CHECK_MESSAGE(
+			int(expression.execute(build_array(4, 5))) == 9,
+			"Integer addition should return the expected result when executed again.");
+	CHECK_MESSAGE(
+			double(expression.execute(build_array(1.5, 2))) == doctest::Approx(3.5),
+			"Operators should adapt to inputs of other types.");
+	CHECK_MESSAGE(
+			String(expression.execute(build_array("Hello ", "world"))) == "Hello world",
+			"Operators should adapt to inputs of other types.");
+
+	ERR_PRINT_OFF;
+	expression.execute(build_array("Hello", 2));
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Invalid operands should fail.");
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			int(expression.execute(build_array(2, 3))) == 5,
+			"The expression should be executed successfully after a failure.");
+	CHECK_FALSE(expression.has_execute_failed());
+
+	CHECK_MESSAGE(
+			expression.parse("a / b", { "a", "b" }) == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			int(expression.execute(build_array(7, 2))) == 3,
+			"Integer division should return the expected result.");
+	ERR_PRINT_OFF;
+	expression.execute(build_array(7, 0));
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Integer division by zero should fail, even after a successful division.");
+	ERR_PRINT_ON;
+
+	CHECK_MESSAGE(
+			expression.parse("a << b", { "a", "b" }) == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			int(expression.execute(build_array(1, 2))) == 4,
+			"Integer left shift should return the expected result.");
+	ERR_PRINT_OFF;
+	expression.execute(build_array(1, -1));
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Shifting by a negative amount should fail, even after a successful shift.");
+	ERR_PRINT_ON;
+
+	CHECK_MESSAGE(
+			expression.parse("a in b", { "a", "b" }) == OK,
+			"The expression should parse successfully.");
+	Object *object = memnew(Object);
+	Variant object_variant = object;
+	CHECK_MESSAGE(
+			bool(expression.execute(build_array("script", object_variant))),
+			"Checking for a property of an object should return the expected result.");
+	memdelete(object);
+	ERR_PRINT_OFF;
+	expression.execute(build_array("script", object_variant));
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Checking for a property of a freed object should fail, even after a successful check.");
+	ERR_PRINT_ON;
+
+	ERR_PRINT_OFF;
+	expression.execute(build_array(7));
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Missing inputs should fail.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Expression] Method calls on inputs") {
+	Expression expression;
+
+	CHECK_MESSAGE(
+			expression.parse("a.size() + a.count(2) + Vector2(b, 0).rotated(PI).x", { "a", "b" }) == OK,
+			"The expression should parse successfully.");
+
+	PackedInt32Array array = { 1, 2, 2 };
+	CHECK_MESSAGE(
+			double(expression.execute(build_array(array, 2))) == doctest::Approx(3.0),
+			"Method calls on inputs and temporary values should return the expected result.");
+	array.push_back(2);
+	CHECK_MESSAGE(
+			double(expression.execute(build_array(array, 1))) == doctest::Approx(6.0),
+			"Method calls on inputs and temporary values should return the expected result when executed again.");
+}
+
+TEST_CASE("[Expression] Batch execution") {
+	Expression expression;
+
+	CHECK_MESSAGE(
+			expression.parse("strength * 2 + level", { "strength", "level" }) == OK,
+			"The expression should parse successfully.");
+
+	Array rows = build_array(build_array(10, 1), build_array(12, 3), build_array(7.5, 5));
+	Array results = expression.execute_batch(rows);
+	CHECK_FALSE(expression.has_execute_failed());
+	REQUIRE(results.size() == 3);
+	CHECK(int(results[0]) == 21);
+	CHECK(int(results[1]) == 27);
+	CHECK(double(results[2]) == doctest::Approx(20.0));
+
+	ERR_PRINT_OFF;
+	rows = build_array(build_array(10, 1), build_array("a", 1), 5, build_array(1, 1));
+	results = expression.execute_batch(rows);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Invalid rows should fail.");
+	REQUIRE(results.size() == 4);
+	CHECK(int(results[0]) == 21);
+	CHECK_MESSAGE(
+			results[1].get_type() == Variant::NIL,
+			"Rows that fail should return null.");
+	CHECK_MESSAGE(
+			results[2].get_type() == Variant::NIL,
+			"Rows that aren't arrays should return null.");
+	CHECK_MESSAGE(
+			int(results[3]) == 3,
+			"Rows after a failure should still be executed.");
+
+	CHECK_MESSAGE(
+			expression.parse("[x, {\"y\": x * 2}, Vector2(x, 1).length()]", { "x" }) == OK,
+			"The expression should parse successfully.");
+	results = expression.execute_batch(build_array(build_array(0), build_array(3)));
+	REQUIRE(results.size() == 2);
+	CHECK(Array(results[1]) == build_array(3, build_dictionary("y", 6), Vector2(3, 1).length()));
+	CHECK_MESSAGE(
+			Array(results[0]) == build_array(0, build_dictionary("y", 0), 1.0),
+			"Each row should get its own arrays and dictionaries.");
+}
+
+TEST_CASE_BENCHMARK("[Expression][Benchmark] Execution") {
+	Expression expression;
+	REQUIRE(expression.parse("strength * 2.5 + level * level - armor / 2.0 + max(strength, armor) * clamp(level, 1, 5)", { "strength", "level", "armor" }) == OK);
+
+	const int row_count = 100000;
+	Array rows;
+	rows.resize(row_count);
+	for (int i = 0; i < row_count; i++) {
+		rows[i] = build_array(i % 100, i % 7, (i * 3) % 50 + 0.5);
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	double sum = 0.0;
+	for (int i = 0; i < row_count; i++) {
+		sum += double(expression.execute(rows[i]));
+	}
+	const uint64_t execute_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	const Array results = expression.execute_batch(rows);
+	const uint64_t batch_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+	print_line(vformat("Expression: %d rows, %d ns per execute(), %d ns per row with execute_batch(), sum %f.", row_count, execute_usec * 1000 / row_count, batch_usec * 1000 / row_count, sum));
+}
 } // namespace TestExpression
 
 #endif // TEST_EXPRESSION_H
@@ -0,0 +1,248 @@
+/**************************************************************************/
+/*  test_static_raycaster.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STATIC_RAYCASTER_H
+#define TEST_STATIC_RAYCASTER_H
+
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "core/math/static_raycaster.h"
+#include "core/math/static_raycaster_bvh.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStaticRaycaster {
+
+// Adds a unit quad at the given depth, facing the Z axis, made of 2 triangles.
+static void add_quad(StaticRaycaster *p_raycaster, real_t p_z, unsigned int p_id) {
+	PackedVector3Array vertices;
+	vertices.push_back(Vector3(-1, -1, p_z));
+	vertices.push_back(Vector3(1, -1, p_z));
+	vertices.push_back(Vector3(1, 1, p_z));
+	vertices.push_back(Vector3(-1, 1, p_z));
+	PackedInt32Array indices = { 0, 1, 2, 0, 2, 3 };
+	p_raycaster->add_mesh(vertices, indices, p_id);
+}
+
+static void add_random_triangles(StaticRaycaster *p_raycaster, RandomPCG &p_rng, int p_triangle_count, unsigned int p_id, PackedVector3Array &r_all_vertices) {
+	PackedVector3Array vertices;
+	for (int i = 0; i < p_triangle_count; i++) {
+		const Vector3 center = Vector3(p_rng.randf(), p_rng.randf(), p_rng.randf()) * 20.0 - Vector3(10, 10, 10);
+		for (int j = 0; j < 3; j++) {
+			vertices.push_back(center + Vector3(p_rng.randf(), p_rng.randf(), p_rng.randf()) * 2.0 - Vector3(1, 1, 1));
+		}
+	}
+	// Non-indexed meshes use consecutive vertices as triangles.
+	p_raycaster->add_mesh(vertices, PackedInt32Array(), p_id);
+	r_all_vertices.append_array(vertices);
+}
+
+static StaticRaycaster::Ray random_ray(RandomPCG &p_rng) {
+	const Vector3 origin = Vector3(p_rng.randf(), p_rng.randf(), p_rng.randf()) * 30.0 - Vector3(15, 15, 15);
+	const Vector3 target = Vector3(p_rng.randf(), p_rng.randf(), p_rng.randf()) * 10.0 - Vector3(5, 5, 5);
+	return StaticRaycaster::Ray(origin, (target - origin).normalized());
+}
+
+// Returns the distance of the nearest hit, or INFINITY.
+static real_t brute_force_intersect(const PackedVector3Array &p_vertices, const StaticRaycaster::Ray &p_ray) {
+	real_t nearest = INFINITY;
+	for (int i = 0; i < p_vertices.size(); i += 3) {
+		Vector3 hit;
+		if (Geometry3D::ray_intersects_triangle(p_ray.org, p_ray.dir, p_vertices[i], p_vertices[i + 1], p_vertices[i + 2], &hit)) {
+			nearest = MIN(nearest, p_ray.org.distance_to(hit));
+		}
+	}
+	return nearest;
+}
+
+TEST_CASE("[StaticRaycaster] Built-in BVH hits and misses") {
+	Ref<StaticRaycaster> raycaster = Ref<StaticRaycaster>(StaticRaycasterBVH::create_bvh_raycaster());
+	add_quad(raycaster.ptr(), 0, 7);
+	add_quad(raycaster.ptr(), -2, 9);
+	raycaster->commit();
+
+	StaticRaycaster::Ray ray(Vector3(0.5, 0.25, 5), Vector3(0, 0, -1));
+	CHECK(raycaster->intersect(ray));
+	CHECK(ray.geomID == 7);
+	CHECK(ray.primID < 2);
+	CHECK(ray.tfar == doctest::Approx(5));
+	CHECK(ray.u >= 0);
+	CHECK(ray.v >= 0);
+	CHECK(ray.u + ray.v <= 1);
+	CHECK_MESSAGE(ray.normal.normalized().abs().is_equal_approx(Vector3(0, 0, 1)), "The normal should be perpendicular to the quad.");
+
+	// Coming from below, the other quad is hit first.
+	ray = StaticRaycaster::Ray(Vector3(0.5, 0.25, -5), Vector3(0, 0, 1));
+	CHECK(raycaster->intersect(ray));
+	CHECK(ray.geomID == 9);
+	CHECK(ray.tfar == doctest::Approx(3));
+
+	// The ray segment ends before reaching any quad.
+	ray = StaticRaycaster::Ray(Vector3(0.5, 0.25, 5), Vector3(0, 0, -1), 0, 4);
+	CHECK_FALSE(raycaster->intersect(ray));
+
+	// The ray segment starts after the first quad.
+	ray = StaticRaycaster::Ray(Vector3(0.5, 0.25, 5), Vector3(0, 0, -1), 6);
+	CHECK(raycaster->intersect(ray));
+	CHECK(ray.geomID == 9);
+
+	// Next to the quads.
+	ray = StaticRaycaster::Ray(Vector3(2, 0, 5), Vector3(0, 0, -1));
+	CHECK_FALSE(raycaster->intersect(ray));
+	CHECK(ray.geomID == (unsigned int)StaticRaycaster::Ray::INVALID_GEOMETRY_ID);
+
+	// Parallel to the quads.
+	ray = StaticRaycaster::Ray(Vector3(-5, 0, 0), Vector3(1, 0, 0));
+	CHECK_FALSE(raycaster->intersect(ray));
+}
+
+TEST_CASE("[StaticRaycaster] Built-in BVH mesh filter") {
+	Ref<StaticRaycaster> raycaster = Ref<StaticRaycaster>(StaticRaycasterBVH::create_bvh_raycaster());
+	add_quad(raycaster.ptr(), 0, 1);
+	add_quad(raycaster.ptr(), -2, 2);
+	raycaster->commit();
+
+	HashSet<int> filter;
+	filter.insert(1);
+	raycaster->set_mesh_filter(filter);
+
+	StaticRaycaster::Ray ray(Vector3(0, 0, 5), Vector3(0, 0, -1));
+	CHECK(raycaster->intersect(ray));
+	CHECK_MESSAGE(ray.geomID == 2, "Filtered meshes should be ignored.");
+
+	raycaster->clear_mesh_filter();
+	ray = StaticRaycaster::Ray(Vector3(0, 0, 5), Vector3(0, 0, -1));
+	CHECK(raycaster->intersect(ray));
+	CHECK(ray.geomID == 1);
+}
+
+TEST_CASE("[StaticRaycaster] Built-in BVH matches brute force intersection") {
+	RandomPCG rng(11);
+	Ref<StaticRaycaster> raycaster = Ref<StaticRaycaster>(StaticRaycasterBVH::create_bvh_raycaster());
+	PackedVector3Array all_vertices;
+	add_random_triangles(raycaster.ptr(), rng, 500, 0, all_vertices);
+	add_random_triangles(raycaster.ptr(), rng, 300, 1, all_vertices);
+	raycaster->commit();
+
+	Vector<StaticRaycaster::Ray> rays;
+	for (int i = 0; i < 500; i++) {
+		rays.push_back(random_ray(rng));
+	}
+	// Coherent rays, which are traced as packets.
+	for (int i = 0; i < 500; i++) {
+		const Vector3 origin = Vector3(i % 25, i / 25, 0) - Vector3(12, 10, 20);
+		rays.push_back(StaticRaycaster::Ray(origin, Vector3(0.1, 0.05, 1).normalized()));
+	}
+
+	Vector<StaticRaycaster::Ray> single_rays = rays;
+	raycaster->intersect(rays);
+
+	int mismatches = 0;
+	for (int i = 0; i < rays.size(); i++) {
+		const real_t expected = brute_force_intersect(all_vertices, rays[i]);
+		const bool hit = rays[i].geomID != StaticRaycaster::Ray::INVALID_GEOMETRY_ID;
+		if (hit != (expected != INFINITY) || (hit && !Math::is_equal_approx(rays[i].tfar, (float)expected, 0.001f))) {
+			mismatches++;
+		}
+
+		raycaster->intersect(single_rays.write[i]);
+		if (single_rays[i].geomID != rays[i].geomID || single_rays[i].primID != rays[i].primID) {
+			mismatches++;
+		}
+	}
+	CHECK_MESSAGE(mismatches == 0, "Batched and single ray queries should find the nearest triangle.");
+}
+
+TEST_CASE_BENCHMARK("[StaticRaycaster][Benchmark] Ray throughput") {
+	// A sphere of about 320000 triangles.
+	const int rings = 400;
+	const int segments = 400;
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	for (int r = 0; r <= rings; r++) {
+		const real_t theta = Math_PI * r / rings;
+		for (int s = 0; s <= segments; s++) {
+			const real_t phi = Math_TAU * s / segments;
+			vertices.push_back(Vector3(Math::sin(theta) * Math::cos(phi), Math::cos(theta), Math::sin(theta) * Math::sin(phi)));
+		}
+	}
+	for (int r = 0; r < rings; r++) {
+		for (int s = 0; s < segments; s++) {
+			const int a = r * (segments + 1) + s;
+			const int b = a + segments + 1;
+			indices.append_array({ a, b, a + 1, a + 1, b, b + 1 });
+		}
+	}
+
+	RandomPCG rng(3);
+	Vector<StaticRaycaster::Ray> coherent_rays;
+	Vector<StaticRaycaster::Ray> incoherent_rays;
+	const int ray_grid_size = 800;
+	for (int y = 0; y < ray_grid_size; y++) {
+		for (int x = 0; x < ray_grid_size; x++) {
+			const Vector3 target = Vector3(x, y, 0) * (2.0 / ray_grid_size) - Vector3(1, 1, 0);
+			coherent_rays.push_back(StaticRaycaster::Ray(Vector3(0, 0, 3), (target - Vector3(0, 0, 3)).normalized()));
+			incoherent_rays.push_back(StaticRaycaster::Ray(Vector3(), Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5).normalized()));
+		}
+	}
+
+	Vector<Ref<StaticRaycaster>> raycasters;
+	raycasters.push_back(Ref<StaticRaycaster>(StaticRaycasterBVH::create_bvh_raycaster()));
+	// Compare with the raycaster provided by a module (Embree), if one is registered.
+	Ref<StaticRaycaster> registered = StaticRaycaster::create();
+	if (registered.is_valid() && !Object::cast_to<StaticRaycasterBVH>(registered.ptr())) {
+		raycasters.push_back(registered);
+	}
+
+	for (const Ref<StaticRaycaster> &raycaster : raycasters) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		raycaster->add_mesh(vertices, indices, 0);
+		raycaster->commit();
+		const uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		Vector<StaticRaycaster::Ray> rays = coherent_rays;
+		begin = OS::get_singleton()->get_ticks_usec();
+		raycaster->intersect(rays);
+		const uint64_t coherent_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+		rays = incoherent_rays;
+		begin = OS::get_singleton()->get_ticks_usec();
+		raycaster->intersect(rays);
+		const uint64_t incoherent_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+		print_line(vformat("%s: %d triangles built in %d ms, %.2f Mrays/s coherent, %.2f Mrays/s incoherent.", raycaster->get_class(), indices.size() / 3, build_usec / 1000,
+				coherent_rays.size() / double(coherent_usec), incoherent_rays.size() / double(incoherent_usec)));
+	}
+}
+
+} // namespace TestStaticRaycaster
+
+#endif // TEST_STATIC_RAYCASTER_H
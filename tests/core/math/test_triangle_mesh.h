@@ -0,0 +1,292 @@
+/**************************************************************************/
+/*  test_triangle_mesh.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_TRIANGLE_MESH_H
+#define TEST_TRIANGLE_MESH_H
+
+#include "core/math/random_pcg.h"
+#include "core/math/triangle_mesh.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTriangleMesh {
+
+// Adds a quad at the given depth, facing the Z axis, made of 2 triangles.
+static void add_quad(Vector<Vector3> &r_faces, real_t p_z) {
+	r_faces.append_array({ Vector3(-1, -1, p_z), Vector3(1, -1, p_z), Vector3(1, 1, p_z), Vector3(-1, -1, p_z), Vector3(1, 1, p_z), Vector3(-1, 1, p_z) });
+}
+
+static Vector3 random_vector(RandomPCG &p_rng, real_t p_size) {
+	return (Vector3(p_rng.randf(), p_rng.randf(), p_rng.randf()) - Vector3(0.5, 0.5, 0.5)) * p_size;
+}
+
+// Same as TriangleMesh::intersect_segment() and TriangleMesh::intersect_ray(), testing every face.
+static bool brute_force_intersect(const Ref<TriangleMesh> &p_mesh, const Vector3 &p_begin, const Vector3 &p_end, bool p_segment, Vector3 &r_point) {
+	const Vector<Face3> faces = p_mesh->get_faces();
+	const Vector3 n = p_segment ? (p_end - p_begin).normalized() : p_end;
+	real_t d = INFINITY;
+	for (const Face3 &face : faces) {
+		Vector3 res;
+		const bool hit = p_segment ? face.intersects_segment(p_begin, p_end, &res) : face.intersects_ray(p_begin, p_end, &res);
+		if (hit && n.dot(res) < d) {
+			d = n.dot(res);
+			r_point = res;
+		}
+	}
+	return d != INFINITY;
+}
+
+TEST_CASE("[TriangleMesh] Segment and ray intersections") {
+	Vector<Vector3> faces;
+	add_quad(faces, 0);
+	add_quad(faces, -2);
+	// Surface indices are given per face, in an array as large as the vertex array.
+	Vector<int32_t> surface_indices;
+	surface_indices.resize(faces.size());
+	surface_indices.fill(0);
+	surface_indices.set(0, 3);
+	surface_indices.set(1, 3);
+	surface_indices.set(2, 5);
+	surface_indices.set(3, 5);
+
+	Ref<TriangleMesh> mesh;
+	mesh.instantiate();
+	CHECK_FALSE(mesh->is_valid());
+	mesh->create(faces, surface_indices);
+	REQUIRE(mesh->is_valid());
+	CHECK(mesh->get_triangles().size() == 4);
+	CHECK(mesh->get_vertices().size() == 8);
+
+	Vector3 point;
+	Vector3 normal;
+	int32_t surface_index = -1;
+	CHECK(mesh->intersect_ray(Vector3(0.5, 0.25, 5), Vector3(0, 0, -1), point, normal, &surface_index));
+	CHECK(point.is_equal_approx(Vector3(0.5, 0.25, 0)));
+	CHECK_MESSAGE(normal.is_equal_approx(Vector3(0, 0, 1)), "The normal should face the ray.");
+	CHECK(surface_index == 3);
+
+	// Coming from below, the other quad is hit first and the normal is flipped.
+	CHECK(mesh->intersect_segment(Vector3(0.5, 0.25, -5), Vector3(0.5, 0.25, 5), point, normal, &surface_index));
+	CHECK(point.is_equal_approx(Vector3(0.5, 0.25, -2)));
+	CHECK(normal.is_equal_approx(Vector3(0, 0, -1)));
+	CHECK(surface_index == 5);
+
+	// The segment ends before reaching any quad.
+	CHECK_FALSE(mesh->intersect_segment(Vector3(0.5, 0.25, 5), Vector3(0.5, 0.25, 1), point, normal));
+	// The ray goes away from the quads.
+	CHECK_FALSE(mesh->intersect_ray(Vector3(0.5, 0.25, 5), Vector3(0, 0, 1), point, normal));
+	// Next to the quads.
+	CHECK_FALSE(mesh->intersect_ray(Vector3(2, 0, 5), Vector3(0, 0, -1), point, normal));
+}
+
+TEST_CASE("[TriangleMesh] Intersections match brute force") {
+	RandomPCG rng(19);
+	Vector<Vector3> faces;
+	for (int i = 0; i < 2000; i++) {
+		const Vector3 center = random_vector(rng, 20.0);
+		for (int j = 0; j < 3; j++) {
+			faces.push_back(center + random_vector(rng, 2.0));
+		}
+	}
+	// Axis aligned faces, which have flat bounds.
+	for (int i = 0; i < 100; i++) {
+		const Vector3 corner = random_vector(rng, 20.0);
+		faces.append_array({ corner, corner + Vector3(1, 0, 0), corner + Vector3(0, 1, 0) });
+		faces.append_array({ corner, corner + Vector3(0, 0, 1), corner + Vector3(0, 1, 0) });
+	}
+
+	Ref<TriangleMesh> mesh;
+	mesh.instantiate();
+	mesh->create(faces);
+	REQUIRE(mesh->is_valid());
+
+	Vector<Vector3> begins;
+	Vector<Vector3> ends;
+	Vector<Vector3> dirs;
+	for (int i = 0; i < 500; i++) {
+		begins.push_back(random_vector(rng, 30.0));
+		ends.push_back(random_vector(rng, 30.0));
+		dirs.push_back(ends[i] - begins[i]);
+	}
+	// Coherent and axis aligned rays, which are traversed as packets.
+	for (int i = 0; i < 500; i++) {
+		begins.push_back(Vector3(i % 25 - 12, i / 25 - 10, -20));
+		ends.push_back(begins[begins.size() - 1] + Vector3(0, 0, 40));
+		dirs.push_back(i % 2 ? Vector3(0, 0, 1) : Vector3(0.1, 0.05, 1));
+	}
+
+	const int count = begins.size();
+	Vector<bool> hits;
+	hits.resize(count);
+	Vector<Vector3> points;
+	points.resize(count);
+	Vector<Vector3> normals;
+	normals.resize(count);
+
+	for (int segment = 0; segment < 2; segment++) {
+		const Vector<Vector3> &targets = segment ? ends : dirs;
+		const int hit_count = segment ? mesh->intersect_segments(begins.ptr(), targets.ptr(), count, hits.ptrw(), points.ptrw(), normals.ptrw()) : mesh->intersect_rays(begins.ptr(), targets.ptr(), count, hits.ptrw(), points.ptrw(), normals.ptrw());
+
+		int expected_hit_count = 0;
+		int mismatches = 0;
+		for (int i = 0; i < count; i++) {
+			Vector3 expected_point;
+			const bool expected_hit = brute_force_intersect(mesh, begins[i], targets[i], segment, expected_point);
+			expected_hit_count += expected_hit;
+
+			Vector3 point;
+			Vector3 normal;
+			const bool hit = segment ? mesh->intersect_segment(begins[i], targets[i], point, normal) : mesh->intersect_ray(begins[i], targets[i], point, normal);
+			if (hit != expected_hit || hits[i] != expected_hit) {
+				mismatches++;
+			} else if (hit && (!point.is_equal_approx(expected_point) || !points[i].is_equal_approx(expected_point) || !normals[i].is_equal_approx(normal))) {
+				mismatches++;
+			}
+		}
+		CHECK_MESSAGE(mismatches == 0, "Single and batched queries should find the nearest face.");
+		CHECK(hit_count == expected_hit_count);
+		CHECK(hit_count > 0);
+	}
+}
+
+TEST_CASE("[TriangleMesh] Inside convex shape") {
+	Vector<Vector3> faces;
+	add_quad(faces, 0);
+	add_quad(faces, 1);
+
+	Ref<TriangleMesh> mesh;
+	mesh.instantiate();
+	mesh->create(faces);
+
+	const AABB large_box(Vector3(-2, -2, -1), Vector3(4, 4, 3));
+	const AABB small_box(Vector3(-2, -2, -1), Vector3(4, 4, 1.5));
+	for (int i = 0; i < 2; i++) {
+		const AABB &box = i == 0 ? large_box : small_box;
+		Vector<Plane> planes = {
+			Plane(Vector3(1, 0, 0), box.get_end().x),
+			Plane(Vector3(-1, 0, 0), -box.position.x),
+			Plane(Vector3(0, 1, 0), box.get_end().y),
+			Plane(Vector3(0, -1, 0), -box.position.y),
+			Plane(Vector3(0, 0, 1), box.get_end().z),
+			Plane(Vector3(0, 0, -1), -box.position.z),
+		};
+		Vector<Vector3> points;
+		for (int j = 0; j < 8; j++) {
+			points.push_back(box.get_endpoint(j));
+		}
+		CHECK(mesh->inside_convex_shape(planes.ptr(), planes.size(), points.ptr(), points.size()) == (i == 0));
+	}
+
+	// Scaled down, the mesh fits in the small box too.
+	Vector<Plane> planes = {
+		Plane(Vector3(1, 0, 0), 2),
+		Plane(Vector3(-1, 0, 0), 2),
+		Plane(Vector3(0, 1, 0), 2),
+		Plane(Vector3(0, -1, 0), 2),
+		Plane(Vector3(0, 0, 1), 0.5),
+		Plane(Vector3(0, 0, -1), 1),
+	};
+	Vector<Vector3> points;
+	for (int j = 0; j < 8; j++) {
+		points.push_back(small_box.get_endpoint(j));
+	}
+	CHECK(mesh->inside_convex_shape(planes.ptr(), planes.size(), points.ptr(), points.size(), Vector3(1, 1, 0.25)));
+}
+
+TEST_CASE_BENCHMARK("[TriangleMesh][Benchmark] Build and query time") {
+	// A bumpy terrain of 2 million triangles.
+	const int size = 1000;
+	Vector<Vector3> faces;
+	faces.resize(size * size * 6);
+	Vector3 *w = faces.ptrw();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			Vector3 corners[4];
+			for (int i = 0; i < 4; i++) {
+				const real_t cx = x + (i & 1);
+				const real_t cy = y + (i >> 1);
+				corners[i] = Vector3(cx, Math::sin(cx * 0.1) * Math::cos(cy * 0.13) * 10.0, cy);
+			}
+			const int base = (y * size + x) * 6;
+			w[base + 0] = corners[0];
+			w[base + 1] = corners[1];
+			w[base + 2] = corners[2];
+			w[base + 3] = corners[1];
+			w[base + 4] = corners[3];
+			w[base + 5] = corners[2];
+		}
+	}
+
+	Ref<TriangleMesh> mesh;
+	mesh.instantiate();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	mesh->create(faces);
+	const uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	// Rays from a camera above the terrain, like viewport picking.
+	const int ray_grid_size = 500;
+	const int ray_count = ray_grid_size * ray_grid_size;
+	Vector<Vector3> begins;
+	Vector<Vector3> dirs;
+	const Vector3 camera(size * 0.5, 200, -100);
+	for (int y = 0; y < ray_grid_size; y++) {
+		for (int x = 0; x < ray_grid_size; x++) {
+			const Vector3 target = Vector3(x, 0, y) * (real_t(size) / ray_grid_size);
+			begins.push_back(camera);
+			dirs.push_back((target - camera).normalized());
+		}
+	}
+
+	Vector3 point;
+	Vector3 normal;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ray_count; i++) {
+		mesh->intersect_ray(begins[i], dirs[i], point, normal);
+	}
+	const uint64_t single_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+	Vector<bool> hits;
+	hits.resize(ray_count);
+	Vector<Vector3> points;
+	points.resize(ray_count);
+	Vector<Vector3> normals;
+	normals.resize(ray_count);
+	begin = OS::get_singleton()->get_ticks_usec();
+	const int hit_count = mesh->intersect_rays(begins.ptr(), dirs.ptr(), ray_count, hits.ptrw(), points.ptrw(), normals.ptrw());
+	const uint64_t batch_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1u);
+
+	print_line(vformat("TriangleMesh: %d triangles built in %d ms, %.2f Mrays/s single, %.2f Mrays/s batched, %d hits.", faces.size() / 3, build_usec / 1000,
+			ray_count / double(single_usec), ray_count / double(batch_usec), hit_count));
+}
+
+} // namespace TestTriangleMesh
+
+#endif // TEST_TRIANGLE_MESH_H
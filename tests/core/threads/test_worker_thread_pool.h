@@ -173,6 +173,24 @@ TEST_CASE("[WorkerThreadPool] Run a yielding daemon as the only hope for other t
 	CHECK_MESSAGE(all_needed_yield, "All legit tasks should have needed the daemon yielding to run.");
 }
 
+static void static_can_wait_test(void *p_arg) {
+	*(bool *)p_arg = WorkerThreadPool::can_wait_for_group_task();
+}
+
+TEST_CASE("[WorkerThreadPool] Group task waits from tasks") {
+	CHECK_MESSAGE(WorkerThreadPool::can_wait_for_group_task(), "Threads outside of the pool should be able to wait.");
+
+	bool low_priority_can_wait = false;
+	WorkerThreadPool::TaskID task_id = WorkerThreadPool::get_singleton()->add_native_task(static_can_wait_test, &low_priority_can_wait, false);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+	CHECK_MESSAGE(low_priority_can_wait, "Low priority tasks should be able to wait.");
+
+	bool high_priority_can_wait = true;
+	task_id = WorkerThreadPool::get_singleton()->add_native_task(static_can_wait_test, &high_priority_can_wait, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+	CHECK_MESSAGE(!high_priority_can_wait, "High priority tasks should not be able to wait.");
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
@@ -0,0 +1,185 @@
+/**************************************************************************/
+/*  test_godot_shape_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SHAPE_3D_H
+#define TEST_GODOT_SHAPE_3D_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotShape3D {
+
+static Vector<Vector3> create_terrain_faces(int p_size) {
+	Vector<Vector3> faces;
+	faces.resize(p_size * p_size * 6);
+	Vector3 *w = faces.ptrw();
+
+	for (int i = 0; i < p_size; i++) {
+		for (int j = 0; j < p_size; j++) {
+			Vector3 v[4];
+			for (int k = 0; k < 4; k++) {
+				real_t x = i + (k & 1);
+				real_t z = j + (k >> 1);
+				v[k] = Vector3(x, Math::sin(x * 0.3) * 2.0 + Math::cos(z * 0.17) * 3.0, z);
+			}
+			*w++ = v[0];
+			*w++ = v[1];
+			*w++ = v[2];
+			*w++ = v[1];
+			*w++ = v[3];
+			*w++ = v[2];
+		}
+	}
+
+	return faces;
+}
+
+static bool count_faces_callback(void *p_userdata, GodotShape3D *p_shape) {
+	(*(int *)p_userdata)++;
+	return false;
+}
+
+TEST_CASE("[GodotConcavePolygonShape3D] Segment intersection matches brute force") {
+	const int size = 32;
+	Vector<Vector3> faces = create_terrain_faces(size);
+	GodotConcavePolygonShape3D shape;
+	shape._setup(faces, true);
+
+	RandomPCG rng(7);
+	for (int i = 0; i < 200; i++) {
+		Vector3 from(rng.randf() * size, 20, rng.randf() * size);
+		Vector3 to(rng.randf() * size, -20, rng.randf() * size);
+		if (i % 4 == 0) {
+			// Axis aligned.
+			to = Vector3(from.x, -20, from.z);
+		} else if (i % 4 == 1) {
+			// Grazing along the terrain.
+			from = Vector3(-5, rng.randf() * 4.0 - 2.0, rng.randf() * size);
+			to = Vector3(size + 5, rng.randf() * 4.0 - 2.0, rng.randf() * size);
+		}
+
+		Vector3 result;
+		Vector3 normal;
+		int face_index = -1;
+		bool hit = shape.intersect_segment(from, to, result, normal, face_index, true);
+
+		real_t expected_dist = 1e20;
+		Vector3 expected_result;
+		for (int j = 0; j < faces.size() / 3; j++) {
+			GodotFaceShape3D face;
+			face.backface_collision = true;
+			face.vertex[0] = faces[j * 3 + 0];
+			face.vertex[1] = faces[j * 3 + 1];
+			face.vertex[2] = faces[j * 3 + 2];
+			face.normal = Face3(face.vertex[0], face.vertex[1], face.vertex[2]).get_plane().normal;
+
+			Vector3 face_result;
+			Vector3 face_normal;
+			int index = j;
+			if (face.intersect_segment(from, to, face_result, face_normal, index, true) && from.distance_to(face_result) < expected_dist) {
+				expected_dist = from.distance_to(face_result);
+				expected_result = face_result;
+			}
+		}
+
+		CHECK_MESSAGE(hit == (expected_dist < 1e20), "Segment should hit the terrain exactly when a face does.");
+		if (hit) {
+			CHECK_MESSAGE(result.is_equal_approx(expected_result), "Segment should report the closest hit.");
+			CHECK(face_index >= 0);
+			CHECK(face_index < faces.size() / 3);
+		}
+	}
+}
+
+TEST_CASE("[GodotConcavePolygonShape3D] AABB culling matches brute force") {
+	const int size = 32;
+	Vector<Vector3> faces = create_terrain_faces(size);
+	GodotConcavePolygonShape3D shape;
+	shape._setup(faces, false);
+
+	RandomPCG rng(11);
+	for (int i = 0; i < 100; i++) {
+		AABB query(Vector3(rng.randf() * size, rng.randf() * 8.0 - 4.0, rng.randf() * size), Vector3(rng.randf() * 5.0, rng.randf() * 3.0, rng.randf() * 5.0));
+
+		int count = 0;
+		shape.cull(query, count_faces_callback, &count, false);
+
+		int expected_count = 0;
+		for (int j = 0; j < faces.size() / 3; j++) {
+			if (query.intersects(Face3(faces[j * 3 + 0], faces[j * 3 + 1], faces[j * 3 + 2]).get_aabb())) {
+				expected_count++;
+			}
+		}
+
+		CHECK_MESSAGE(count == expected_count, "Only faces overlapping the query should be reported.");
+	}
+}
+
+TEST_CASE_BENCHMARK("[GodotConcavePolygonShape3D][Benchmark] Queries on large terrain") {
+	const int size = 724; // About one million triangles.
+	Vector<Vector3> faces = create_terrain_faces(size);
+	GodotConcavePolygonShape3D shape;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	shape._setup(faces, false);
+	print_line(vformat("Build %d faces: %d usec.", faces.size() / 3, OS::get_singleton()->get_ticks_usec() - begin));
+
+	RandomPCG rng(3);
+	const int ray_count = 100000;
+	int hits = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ray_count; i++) {
+		Vector3 from(rng.randf() * size, 20, rng.randf() * size);
+		Vector3 to = from + Vector3(rng.randf() * 20.0 - 10.0, -40, rng.randf() * 20.0 - 10.0);
+		Vector3 result;
+		Vector3 normal;
+		int face_index;
+		hits += shape.intersect_segment(from, to, result, normal, face_index, false);
+	}
+	print_line(vformat("%d segments (%d hits): %d usec.", ray_count, hits, OS::get_singleton()->get_ticks_usec() - begin));
+
+	const int cull_count = 100000;
+	int culled = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < cull_count; i++) {
+		AABB query(Vector3(rng.randf() * size, rng.randf() * 8.0 - 4.0, rng.randf() * size), Vector3(2, 2, 2));
+		shape.cull(query, count_faces_callback, &culled, false);
+	}
+	print_line(vformat("%d AABB culls (%d faces): %d usec.", cull_count, culled, OS::get_singleton()->get_ticks_usec() - begin));
+
+	CHECK(hits > 0);
+}
+
+} // namespace TestGodotShape3D
+
+#endif // TEST_GODOT_SHAPE_3D_H
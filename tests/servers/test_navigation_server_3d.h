@@ -31,7 +31,12 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/config/project_settings.h"
+#include "core/math/random_pcg.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "scene/3d/mesh_instance_3d.h"
+#include "scene/resources/immediate_mesh.h"
 #include "scene/resources/3d/primitive_meshes.h"
 #include "servers/navigation_server_3d.h"
 
@@ -61,6 +66,79 @@ static inline Array build_array(Variant item, Targs... Fargs) {
 	return a;
 }
 
+// Flat navigation mesh made of `p_size` x `p_size` unit quads, starting at the origin.
+static Ref<NavigationMesh> create_grid_navigation_mesh(int p_size) {
+	Ref<NavigationMesh> navigation_mesh;
+	navigation_mesh.instantiate();
+
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+	navigation_mesh->set_vertices(vertices);
+
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			const int corner = z * (p_size + 1) + x;
+			Vector<int> polygon;
+			polygon.push_back(corner);
+			polygon.push_back(corner + 1);
+			polygon.push_back(corner + p_size + 2);
+			polygon.push_back(corner + p_size + 1);
+			navigation_mesh->add_polygon(polygon);
+		}
+	}
+	return navigation_mesh;
+}
+
+// Covers [0, p_tiles * p_tile_size] on X and Z with one region per tile.
+static void create_tiled_map(NavigationServer3D *p_navigation_server, RID p_map, int p_tiles, int p_tile_size, LocalVector<RID> &r_regions) {
+	Ref<NavigationMesh> navigation_mesh = create_grid_navigation_mesh(p_tile_size);
+	for (int z = 0; z < p_tiles; z++) {
+		for (int x = 0; x < p_tiles; x++) {
+			RID region = p_navigation_server->region_create();
+			p_navigation_server->region_set_map(region, p_map);
+			p_navigation_server->region_set_transform(region, Transform3D(Basis(), Vector3(x * p_tile_size, 0, z * p_tile_size)));
+			p_navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			r_regions.push_back(region);
+		}
+	}
+}
+
+// The avoidance solver is chosen when the map is created.
+static RID create_avoidance_map(NavigationServer3D *p_navigation_server, int p_avoidance_solver) {
+	ProjectSettings::get_singleton()->set_setting("navigation/avoidance/avoidance_solver", p_avoidance_solver);
+	RID map = p_navigation_server->map_create();
+	ProjectSettings::get_singleton()->set_setting("navigation/avoidance/avoidance_solver", 0);
+	return map;
+}
+
+// Runs the rest of the enclosing test case or subcase once for every avoidance solver.
+static int avoidance_solver_subcases() {
+	int avoidance_solver = 0;
+	SUBCASE("With the RVO2 solver") {
+		avoidance_solver = 0;
+	}
+	SUBCASE("With the batched solver") {
+		avoidance_solver = 1;
+	}
+	return avoidance_solver;
+}
+
+struct ConcurrentPathQueries {
+	RID map;
+	LocalVector<Vector3> starts;
+	LocalVector<Vector3> targets;
+	LocalVector<Vector<Vector3>> paths;
+};
+
+static void run_concurrent_path_query(void *p_userdata, uint32_t p_index) {
+	ConcurrentPathQueries *queries = static_cast<ConcurrentPathQueries *>(p_userdata);
+	queries->paths[p_index] = NavigationServer3D::get_singleton()->map_get_path(queries->map, queries->starts[p_index], queries->targets[p_index], true);
+}
+
 TEST_SUITE("[Navigation]") {
 	TEST_CASE("[NavigationServer3D] Server should be empty when initialized") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
@@ -388,7 +466,7 @@ TEST_SUITE("[Navigation]") {
 	TEST_CASE("[NavigationServer3D] Server should make agents avoid each other when avoidance enabled") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
 
-		RID map = navigation_server->map_create();
+		RID map = create_avoidance_map(navigation_server, avoidance_solver_subcases());
 		RID agent_1 = navigation_server->agent_create();
 		RID agent_2 = navigation_server->agent_create();
 
@@ -425,6 +503,7 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->free(agent_2);
 		navigation_server->free(agent_1);
 		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
 	TEST_CASE("[NavigationServer3D] Server should make agents avoid dynamic obstacles when avoidance enabled") {
@@ -465,7 +544,19 @@ TEST_SUITE("[Navigation]") {
 	TEST_CASE("[NavigationServer3D] Server should make agents avoid static obstacles when avoidance enabled") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
 
-		RID map = navigation_server->map_create();
+		real_t elevation = 0.0;
+		int avoidance_solver = 0;
+
+		SUBCASE("Static obstacles should work on ground level") {
+			avoidance_solver = avoidance_solver_subcases();
+		}
+
+		SUBCASE("Static obstacles should work when elevated") {
+			elevation = 5.0;
+			avoidance_solver = avoidance_solver_subcases();
+		}
+
+		RID map = create_avoidance_map(navigation_server, avoidance_solver);
 		RID agent_1 = navigation_server->agent_create();
 		RID agent_2 = navigation_server->agent_create();
 		RID obstacle_1 = navigation_server->obstacle_create();
@@ -474,6 +565,7 @@ TEST_SUITE("[Navigation]") {
 
 		navigation_server->agent_set_map(agent_1, map);
 		navigation_server->agent_set_avoidance_enabled(agent_1, true);
+		navigation_server->agent_set_position(agent_1, Vector3(0, elevation, 0));
 		navigation_server->agent_set_radius(agent_1, 1.6); // Have hit the obstacle already.
 		navigation_server->agent_set_velocity(agent_1, Vector3(1, 0, 0));
 		CallableMock agent_1_avoidance_callback_mock;
@@ -481,6 +573,7 @@ TEST_SUITE("[Navigation]") {
 
 		navigation_server->agent_set_map(agent_2, map);
 		navigation_server->agent_set_avoidance_enabled(agent_2, true);
+		navigation_server->agent_set_position(agent_2, Vector3(0, elevation, 5));
 		navigation_server->agent_set_radius(agent_2, 1.4); // Haven't hit the obstacle yet.
 		navigation_server->agent_set_velocity(agent_2, Vector3(1, 0, 0));
 		CallableMock agent_2_avoidance_callback_mock;
@@ -488,23 +581,10 @@ TEST_SUITE("[Navigation]") {
 
 		navigation_server->obstacle_set_map(obstacle_1, map);
 		navigation_server->obstacle_set_avoidance_enabled(obstacle_1, true);
+		navigation_server->obstacle_set_position(obstacle_1, Vector3(0, elevation, 0));
 		PackedVector3Array obstacle_1_vertices;
-
-		SUBCASE("Static obstacles should work on ground level") {
-			navigation_server->agent_set_position(agent_1, Vector3(0, 0, 0));
-			navigation_server->agent_set_position(agent_2, Vector3(0, 0, 5));
-			obstacle_1_vertices.push_back(Vector3(1.5, 0, 0.5));
-			obstacle_1_vertices.push_back(Vector3(1.5, 0, 4.5));
-		}
-
-		SUBCASE("Static obstacles should work when elevated") {
-			navigation_server->agent_set_position(agent_1, Vector3(0, 5, 0));
-			navigation_server->agent_set_position(agent_2, Vector3(0, 5, 5));
-			obstacle_1_vertices.push_back(Vector3(1.5, 0, 0.5));
-			obstacle_1_vertices.push_back(Vector3(1.5, 0, 4.5));
-			navigation_server->obstacle_set_position(obstacle_1, Vector3(0, 5, 0));
-		}
-
+		obstacle_1_vertices.push_back(Vector3(1.5, 0, 0.5));
+		obstacle_1_vertices.push_back(Vector3(1.5, 0, 4.5));
 		navigation_server->obstacle_set_vertices(obstacle_1, obstacle_1_vertices);
 
 		CHECK_EQ(agent_1_avoidance_callback_mock.function1_calls, 0);
@@ -526,6 +606,47 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE_BENCHMARK("[NavigationServer3D][Benchmark] Avoidance step for 10000 agents") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const char *solver_names[] = { "RVO2", "batched" };
+		const int agent_count = 10000;
+		const int step_count = 20;
+
+		for (int solver = 0; solver < 2; solver++) {
+			RID map = create_avoidance_map(navigation_server, solver);
+			navigation_server->map_set_active(map, true);
+
+			// A dense crowd on a 100x100 grid where every agent walks towards the center.
+			LocalVector<RID> agents;
+			RandomPCG rng(11);
+			for (int i = 0; i < agent_count; i++) {
+				RID agent = navigation_server->agent_create();
+				const Vector3 position = Vector3((i % 100) * 1.5 + rng.randf(), 0.0, (i / 100) * 1.5 + rng.randf());
+				navigation_server->agent_set_map(agent, map);
+				navigation_server->agent_set_avoidance_enabled(agent, true);
+				navigation_server->agent_set_position(agent, position);
+				navigation_server->agent_set_radius(agent, 0.5);
+				navigation_server->agent_set_velocity(agent, (Vector3(75.0, 0.0, 75.0) - position).normalized() * 2.0);
+				agents.push_back(agent);
+			}
+			navigation_server->process(0.016); // Give server some cycles to commit.
+
+			const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < step_count; i++) {
+				navigation_server->process(0.016);
+			}
+			const uint64_t step_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			print_line(vformat("%d agents with the %s solver: %.2f msec per avoidance step.", agent_count, solver_names[solver], step_usec / 1000.0 / step_count));
+
+			for (const RID &agent : agents) {
+				navigation_server->free(agent);
+			}
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+	}
+
 #ifndef DISABLE_DEPRECATED
 	// This test case uses only public APIs on purpose - other test cases use simplified baking.
 	// FIXME: Remove once deprecated `region_bake_navigation_mesh()` is removed.
@@ -619,6 +740,62 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(indices[0] + 4, indices[6]);
 		}
 
+		SUBCASE("Parsing again should pick up changes of already parsed meshes") {
+			plane_mesh->set_subdivide_width(1);
+			navigation_server->parse_source_geometry_data(navigation_mesh, source_geometry, mesh_instance);
+			CHECK_EQ(source_geometry->get_vertices().size(), 18);
+			CHECK_EQ(source_geometry->get_indices().size(), 12);
+
+			plane_mesh->set_size(Size2(20.0, 20.0));
+			navigation_server->parse_source_geometry_data(navigation_mesh, source_geometry, mesh_instance);
+			float max_x = 0.0;
+			for (int i = 0; i < source_geometry->get_vertices().size(); i += 3) {
+				max_x = MAX(max_x, source_geometry->get_vertices()[i]);
+			}
+			CHECK_EQ(max_x, doctest::Approx(10.0));
+		}
+
+		SUBCASE("Parsing again should pick up changes of meshes that do not emit changed") {
+			Ref<ImmediateMesh> immediate_mesh = memnew(ImmediateMesh);
+			immediate_mesh->surface_begin(Mesh::PRIMITIVE_TRIANGLES);
+			immediate_mesh->surface_add_vertex(Vector3(0.0, 0.0, 0.0));
+			immediate_mesh->surface_add_vertex(Vector3(1.0, 0.0, 0.0));
+			immediate_mesh->surface_add_vertex(Vector3(0.0, 0.0, 1.0));
+			immediate_mesh->surface_end();
+			mesh_instance->set_mesh(immediate_mesh);
+
+			navigation_server->parse_source_geometry_data(navigation_mesh, source_geometry, mesh_instance);
+			REQUIRE_EQ(source_geometry->get_vertices().size(), 9);
+			CHECK_EQ(source_geometry->get_vertices()[3], doctest::Approx(1.0));
+
+			// Same surface count, different geometry.
+			immediate_mesh->clear_surfaces();
+			immediate_mesh->surface_begin(Mesh::PRIMITIVE_TRIANGLES);
+			immediate_mesh->surface_add_vertex(Vector3(0.0, 0.0, 0.0));
+			immediate_mesh->surface_add_vertex(Vector3(5.0, 0.0, 0.0));
+			immediate_mesh->surface_add_vertex(Vector3(0.0, 0.0, 5.0));
+			immediate_mesh->surface_end();
+
+			navigation_server->parse_source_geometry_data(navigation_mesh, source_geometry, mesh_instance);
+			REQUIRE_EQ(source_geometry->get_vertices().size(), 9);
+			CHECK_EQ(source_geometry->get_vertices()[3], doctest::Approx(5.0));
+		}
+
+		SUBCASE("Meshes shared by several instances should be parsed for every instance") {
+			MeshInstance3D *other_mesh_instance = memnew(MeshInstance3D);
+			other_mesh_instance->set_mesh(plane_mesh);
+			other_mesh_instance->set_position(Vector3(20.0, 0.0, 0.0));
+			node_3d->add_child(other_mesh_instance);
+
+			navigation_server->parse_source_geometry_data(navigation_mesh, source_geometry, node_3d);
+			const Vector<float> vertices = source_geometry->get_vertices();
+			REQUIRE_EQ(vertices.size(), 24);
+			CHECK_EQ(source_geometry->get_indices().size(), 12);
+			CHECK_EQ(vertices[12] - vertices[0], doctest::Approx(20.0));
+
+			memdelete(other_mesh_instance);
+		}
+
 		memdelete(mesh_instance);
 		memdelete(node_3d);
 	}
@@ -764,6 +941,742 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should bake and rebake tiled navigation meshes") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_tile_size(5.0);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(20.0, 0.001, 20.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		const int polygon_count = navigation_mesh->get_polygon_count();
+		const int vertex_count = navigation_mesh->get_vertices().size();
+		CHECK_GT(polygon_count, 0);
+
+		// Every polygon should stay inside the tile that baked it.
+		const Vector<Vector3> vertices = navigation_mesh->get_vertices();
+		bool polygons_inside_tiles = true;
+		for (int i = 0; i < polygon_count; i++) {
+			AABB bounds;
+			const Vector<int> polygon = navigation_mesh->get_polygon(i);
+			bounds.position = vertices[polygon[0]];
+			for (int index : polygon) {
+				bounds.expand_to(vertices[index]);
+			}
+			if (Math::floor((bounds.position.x + 0.01) / 5.0) != Math::floor((bounds.get_end().x - 0.01) / 5.0) ||
+					Math::floor((bounds.position.z + 0.01) / 5.0) != Math::floor((bounds.get_end().z - 0.01) / 5.0)) {
+				polygons_inside_tiles = false;
+			}
+		}
+		CHECK(polygons_inside_tiles);
+
+		SUBCASE("Tiles should connect to one navigation mesh on the map") {
+			RID map = navigation_server->map_create();
+			RID region = navigation_server->region_create();
+			navigation_server->map_set_active(map, true);
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-8, 0, -8), Vector3(8, 0, 8), true);
+			REQUIRE_GT(path.size(), 0);
+			CHECK_LT(path[path.size() - 1].distance_to(Vector3(8, 0, 8)), 0.5);
+
+			navigation_server->free(region);
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+
+		SUBCASE("Rebaking a tile with unchanged geometry should keep the navigation mesh") {
+			navigation_server->rebake_from_source_geometry_data(navigation_mesh, source_geometry, AABB(Vector3(1, -1, 1), Vector3(1, 2, 1)), Callable());
+			CHECK_EQ(navigation_mesh->get_polygon_count(), polygon_count);
+			CHECK_EQ(navigation_mesh->get_vertices().size(), vertex_count);
+		}
+
+		SUBCASE("Rebaking a tile without geometry should only clear that tile") {
+			Ref<NavigationMeshSourceGeometryData3D> empty_source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+			navigation_server->rebake_from_source_geometry_data(navigation_mesh, empty_source_geometry, AABB(Vector3(1, -1, 1), Vector3(1, 2, 1)), Callable());
+			CHECK_GT(navigation_mesh->get_polygon_count(), 0);
+			CHECK_LT(navigation_mesh->get_polygon_count(), polygon_count);
+
+			const Vector<Vector3> rebaked_vertices = navigation_mesh->get_vertices();
+			bool tile_cleared = true;
+			for (int i = 0; i < navigation_mesh->get_polygon_count(); i++) {
+				Vector3 center;
+				const Vector<int> polygon = navigation_mesh->get_polygon(i);
+				for (int index : polygon) {
+					center += rebaked_vertices[index];
+				}
+				center /= polygon.size();
+				if (center.x > 0.0 && center.x < 5.0 && center.z > 0.0 && center.z < 5.0) {
+					tile_cleared = false;
+				}
+			}
+			CHECK(tile_cleared);
+		}
+	}
+
+	TEST_CASE("[NavigationServer3D] Closest point queries should search every region of the map") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 3, 8, regions);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		// The map is the [0, 24] square on the XZ plane.
+		RandomPCG rng(1234);
+		bool all_closest_points_correct = true;
+		bool all_owners_valid = true;
+		for (int i = 0; i < 500; i++) {
+			const Vector3 point(rng.random(-10.0, 34.0), rng.random(-5.0, 5.0), rng.random(-10.0, 34.0));
+			const Vector3 expected(CLAMP(point.x, 0.0, 24.0), 0.0, CLAMP(point.z, 0.0, 24.0));
+			all_closest_points_correct = all_closest_points_correct && navigation_server->map_get_closest_point(map, point).is_equal_approx(expected);
+			all_owners_valid = all_owners_valid && regions.find(navigation_server->map_get_closest_point_owner(map, point)) >= 0;
+		}
+		CHECK(all_closest_points_correct);
+		CHECK(all_owners_valid);
+		CHECK(navigation_server->map_get_closest_point_normal(map, Vector3(20, 3, 20)).is_equal_approx(Vector3(0, 1, 0)));
+
+		// Segments crossing the map return where they cross it, the others the closest point on the map edges.
+		CHECK(navigation_server->map_get_closest_point_to_segment(map, Vector3(20.5, 5, 20.3), Vector3(20.5, -5, 20.3), true).is_equal_approx(Vector3(20.5, 0, 20.3)));
+		CHECK(navigation_server->map_get_closest_point_to_segment(map, Vector3(30, 0, 2), Vector3(30, 0, 5), true) == Vector3());
+		const Vector3 closest_edge_point = navigation_server->map_get_closest_point_to_segment(map, Vector3(30, 0, 2), Vector3(30, 0, 5), false);
+		CHECK(closest_edge_point.x == doctest::Approx(24.0));
+		CHECK(closest_edge_point.z >= 2.0 - CMP_EPSILON);
+		CHECK(closest_edge_point.z <= 5.0 + CMP_EPSILON);
+
+		// Paths start and end on the closest points of the map, even across regions.
+		const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-2, 1, -2), Vector3(30, 1, 30), true);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[0].is_equal_approx(Vector3(0, 0, 0)));
+		CHECK(path[path.size() - 1].is_equal_approx(Vector3(24, 0, 24)));
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Map sync should reconnect the regions next to a changed region") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = create_grid_navigation_mesh(4);
+
+		// 3x3 tiles sharing their edges, and a region next to them connected by edge connections.
+		const auto create_map = [&](LocalVector<RID> &r_regions) {
+			RID map = navigation_server->map_create();
+			navigation_server->map_set_active(map, true);
+			navigation_server->map_set_edge_connection_margin(map, 0.5);
+			create_tiled_map(navigation_server, map, 3, 4, r_regions);
+			RID region = navigation_server->region_create();
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_transform(region, Transform3D(Basis(), Vector3(12.3, 0, 0)));
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			r_regions.push_back(region);
+			return map;
+		};
+		const auto get_edge_info = [&]() {
+			return Vector4i(
+					navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_COUNT),
+					navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT),
+					navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT),
+					navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT));
+		};
+
+		LocalVector<RID> regions;
+		RID map = create_map(regions);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		const Vector4i all_enabled_info = get_edge_info();
+		CHECK_GT(all_enabled_info.z, 0);
+		const Vector<Vector3> all_enabled_path = navigation_server->map_get_path(map, Vector3(1, 0, 1), Vector3(15, 0, 3), true);
+		REQUIRE(all_enabled_path.size() >= 2);
+		CHECK(all_enabled_path[all_enabled_path.size() - 1].is_equal_approx(Vector3(15, 0, 3)));
+
+		// Disable the tile connected to the separate region, then enable it again.
+		navigation_server->region_set_enabled(regions[2], false);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		const Vector4i disabled_info = get_edge_info();
+		CHECK_NE(disabled_info, all_enabled_info);
+
+		navigation_server->region_set_enabled(regions[2], true);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(get_edge_info(), all_enabled_info);
+		CHECK_EQ(navigation_server->map_get_path(map, Vector3(1, 0, 1), Vector3(15, 0, 3), true), all_enabled_path);
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		// A map built from scratch without the tile has the same edges.
+		regions.clear();
+		map = create_map(regions);
+		navigation_server->free(regions[2]);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(get_edge_info(), disabled_info);
+
+		for (uint32_t i = 0; i < regions.size(); i++) {
+			if (i != 2) {
+				navigation_server->free(regions[i]);
+			}
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Path queries should not depend on previous or concurrent queries") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 2, 16, regions);
+
+		// A separate island, only reachable by getting as close as possible.
+		RID island = navigation_server->region_create();
+		navigation_server->region_set_map(island, map);
+		navigation_server->region_set_transform(island, Transform3D(Basis(), Vector3(50, 0, 0)));
+		navigation_server->region_set_navigation_mesh(island, create_grid_navigation_mesh(4));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		ConcurrentPathQueries queries;
+		queries.map = map;
+		RandomPCG rng(99);
+		for (int i = 0; i < 64; i++) {
+			queries.starts.push_back(Vector3(rng.random(0.0, 32.0), 0.0, rng.random(0.0, 32.0)));
+			// Every fourth query targets the island.
+			queries.targets.push_back(i % 4 == 0 ? Vector3(52, 0, 2) : Vector3(rng.random(0.0, 32.0), 0.0, rng.random(0.0, 32.0)));
+		}
+		queries.paths.resize(queries.starts.size());
+
+		LocalVector<Vector<Vector3>> expected_paths;
+		for (uint32_t i = 0; i < queries.starts.size(); i++) {
+			expected_paths.push_back(navigation_server->map_get_path(map, queries.starts[i], queries.targets[i], true));
+		}
+
+		// The map is open and flat, so optimized paths go straight to reachable targets.
+		for (uint32_t i = 1; i < expected_paths.size(); i += 4) {
+			REQUIRE(expected_paths[i].size() >= 2);
+			CHECK(expected_paths[i][expected_paths[i].size() - 1].is_equal_approx(queries.targets[i]));
+		}
+		// Unreachable targets stop at the closest reachable point.
+		REQUIRE(expected_paths[0].size() >= 2);
+		CHECK(expected_paths[0][expected_paths[0].size() - 1].is_equal_approx(Vector3(32, 0, 2)));
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&run_concurrent_path_query, &queries, queries.starts.size(), -1, true, "TestConcurrentPathQueries");
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		bool all_paths_match = true;
+		for (uint32_t i = 0; i < queries.paths.size(); i++) {
+			all_paths_match = all_paths_match && queries.paths[i] == expected_paths[i];
+		}
+		CHECK(all_paths_match);
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(island);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Path queries should work after the map grows") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		RID region = navigation_server->region_create();
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, create_grid_navigation_mesh(4));
+
+		SUBCASE("Without hierarchy") {
+		}
+		SUBCASE("With hierarchy") {
+			navigation_server->map_set_use_hierarchical_pathfinding(map, true);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		// Ends as soon as the target is reached, with polygons left in the open list.
+		Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(1, 0, 1), Vector3(3, 0, 3), true);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].is_equal_approx(Vector3(3, 0, 3)));
+
+		// Enough new polygons that the search buffers of the map are reallocated.
+		RID other_region = navigation_server->region_create();
+		navigation_server->region_set_map(other_region, map);
+		navigation_server->region_set_transform(other_region, Transform3D(Basis(), Vector3(4, 0, 0)));
+		navigation_server->region_set_navigation_mesh(other_region, create_grid_navigation_mesh(16));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		path = navigation_server->map_get_path(map, Vector3(1, 0, 1), Vector3(18, 0, 12), true);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].is_equal_approx(Vector3(18, 0, 12)));
+
+		navigation_server->free(other_region);
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Hierarchical path queries should reach the same targets") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 3, 8, regions);
+
+		RID island = navigation_server->region_create();
+		navigation_server->region_set_map(island, map);
+		navigation_server->region_set_transform(island, Transform3D(Basis(), Vector3(50, 0, 0)));
+		navigation_server->region_set_navigation_mesh(island, create_grid_navigation_mesh(4));
+
+		CHECK_FALSE(navigation_server->map_get_use_hierarchical_pathfinding(map));
+		navigation_server->map_set_use_hierarchical_pathfinding(map, true);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK(navigation_server->map_get_use_hierarchical_pathfinding(map));
+
+		SUBCASE("Paths across regions should end at the target") {
+			Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(1, 0, 1), Vector3(23, 0, 23), true);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[0].is_equal_approx(Vector3(1, 0, 1)));
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(23, 0, 23)));
+
+			path = navigation_server->map_get_path(map, Vector3(23, 0, 1), Vector3(1, 0, 12), false);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(1, 0, 12)));
+		}
+
+		SUBCASE("Paths should avoid a disabled region") {
+			// Disable the center tile, paths now go around it.
+			navigation_server->region_set_enabled(regions[4], false);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(12, 0, 1), Vector3(12, 0, 23), true);
+			REQUIRE(path.size() >= 3);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(12, 0, 23)));
+			bool crosses_center = false;
+			for (int i = 0; i < path.size(); i++) {
+				crosses_center = crosses_center || (path[i].x > 8.01 && path[i].x < 15.99 && path[i].z > 8.01 && path[i].z < 15.99);
+			}
+			CHECK_FALSE(crosses_center);
+
+			navigation_server->region_set_enabled(regions[4], true);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+
+		SUBCASE("Unreachable targets should stop at the closest reachable point") {
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(1, 0, 1), Vector3(52, 0, 2), true);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(24, 0, 2)));
+		}
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(island);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Flow field queries should lead to the destination") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 2, 16, regions);
+
+		// A separate island, the destination can not be reached from there.
+		RID island = navigation_server->region_create();
+		navigation_server->region_set_map(island, map);
+		navigation_server->region_set_transform(island, Transform3D(Basis(), Vector3(50, 0, 0)));
+		navigation_server->region_set_navigation_mesh(island, create_grid_navigation_mesh(4));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 destination = Vector3(29.5, 0, 30.5);
+
+		SUBCASE("Following the next positions should reach the destination") {
+			RandomPCG rng(21);
+			bool all_reached = true;
+			bool all_distances_plausible = true;
+			for (int i = 0; i < 50; i++) {
+				Vector3 position = Vector3(rng.random(0.0, 32.0), 0.0, rng.random(0.0, 32.0));
+				const real_t distance = navigation_server->map_get_flow_field_distance(map, destination, position);
+				// The map is open and flat, so the flow goes almost straight to the destination.
+				const real_t straight_distance = position.distance_to(destination);
+				all_distances_plausible = all_distances_plausible && distance >= straight_distance - CMP_EPSILON && distance <= straight_distance * 1.5 + 1.0;
+
+				for (int hop = 0; hop < 200 && !position.is_equal_approx(destination); hop++) {
+					position = navigation_server->map_get_flow_field_next_position(map, destination, position);
+				}
+				all_reached = all_reached && position.is_equal_approx(destination);
+			}
+			CHECK(all_reached);
+			CHECK(all_distances_plausible);
+		}
+
+		SUBCASE("The destination should not be reachable from the island") {
+			CHECK_EQ(navigation_server->map_get_flow_field_distance(map, destination, Vector3(52, 0, 2)), -1.0);
+			CHECK(navigation_server->map_get_flow_field_next_position(map, destination, Vector3(52, 0, 2)).is_equal_approx(Vector3(52, 0, 2)));
+		}
+
+		SUBCASE("Flow fields should follow map changes") {
+			CHECK_EQ(navigation_server->map_get_flow_field_distance(map, destination, Vector3(2, 0, 2)), doctest::Approx(double(Vector3(2, 0, 2).distance_to(destination))).epsilon(0.2));
+
+			// Without the tile of the destination, the flow leads to the closest point to it on the other tiles.
+			navigation_server->region_set_enabled(regions[3], false);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			Vector3 position = Vector3(2, 0, 2);
+			for (int hop = 0; hop < 200; hop++) {
+				position = navigation_server->map_get_flow_field_next_position(map, destination, position);
+			}
+			CHECK(position.is_equal_approx(Vector3(16, 0, 30.5)));
+		}
+
+		SUBCASE("Flow fields should follow cost and layer changes") {
+			const Vector3 position = Vector3(2, 0, 2);
+			const real_t distance = navigation_server->map_get_flow_field_distance(map, destination, position);
+			CHECK_EQ(distance, doctest::Approx(double(position.distance_to(destination))).epsilon(0.2));
+
+			// About half of the way lies on the tile of the destination.
+			navigation_server->region_set_travel_cost(regions[3], 2.0);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			const real_t costly_distance = navigation_server->map_get_flow_field_distance(map, destination, position);
+			CHECK(costly_distance > distance + 10.0);
+
+			// The tile of the destination only touches the tile of the position through the two others.
+			navigation_server->region_set_navigation_layers(regions[1], 2);
+			navigation_server->region_set_navigation_layers(regions[2], 2);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->map_get_flow_field_distance(map, destination, position), -1.0);
+			CHECK(navigation_server->map_get_flow_field_next_position(map, destination, position).is_equal_approx(position));
+
+			navigation_server->region_set_navigation_layers(regions[1], 1);
+			navigation_server->region_set_navigation_layers(regions[2], 1);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->map_get_flow_field_distance(map, destination, position), doctest::Approx(costly_distance));
+		}
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(island);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Path corridor cache should follow moving targets") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 2, 16, regions);
+
+		RID cached_map = navigation_server->map_create();
+		navigation_server->map_set_active(cached_map, true);
+		LocalVector<RID> cached_regions;
+		create_tiled_map(navigation_server, cached_map, 2, 16, cached_regions);
+
+		CHECK_FALSE(navigation_server->map_get_use_path_corridor_cache(cached_map));
+		navigation_server->map_set_use_path_corridor_cache(cached_map, true);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK(navigation_server->map_get_use_path_corridor_cache(cached_map));
+
+		SUBCASE("Repaths towards a moving target should end at the target") {
+			// An agent walks towards a target that moves away from it, repathing every step.
+			Vector3 start = Vector3(1.5, 0, 1.5);
+			Vector3 target = Vector3(20.5, 0, 24.5);
+			bool all_ends_match = true;
+			bool all_lengths_match = true;
+			for (int i = 0; i < 30; i++) {
+				const Vector<Vector3> path = navigation_server->map_get_path(map, start, target, true);
+				const Vector<Vector3> cached_path = navigation_server->map_get_path(cached_map, start, target, true);
+				REQUIRE(cached_path.size() >= 2);
+				all_ends_match = all_ends_match && cached_path[0].is_equal_approx(start) && cached_path[cached_path.size() - 1].is_equal_approx(target);
+
+				real_t length = 0.0;
+				for (int j = 1; j < path.size(); j++) {
+					length += path[j - 1].distance_to(path[j]);
+				}
+				real_t cached_length = 0.0;
+				for (int j = 1; j < cached_path.size(); j++) {
+					cached_length += cached_path[j - 1].distance_to(cached_path[j]);
+				}
+				// The map is open and flat, so both paths are almost straight.
+				all_lengths_match = all_lengths_match && cached_length >= start.distance_to(target) - CMP_EPSILON && cached_length <= length * 1.1 + 0.5;
+
+				start += Vector3(0.3, 0, 0.2);
+				target += Vector3(0.2, 0, 0.2);
+			}
+			CHECK(all_ends_match);
+			CHECK(all_lengths_match);
+		}
+
+		SUBCASE("Cached corridors should not cross disabled regions") {
+			navigation_server->map_get_path(cached_map, Vector3(2, 0, 1), Vector3(30, 0, 1), true);
+			navigation_server->region_set_enabled(cached_regions[1], false);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			// The target tile is gone, the path stops at the closest point of the remaining tiles.
+			const Vector<Vector3> path = navigation_server->map_get_path(cached_map, Vector3(2, 0, 1), Vector3(30, 0, 1), true);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(16, 0, 1)));
+		}
+
+		SUBCASE("Cached corridors should follow cost and layer changes") {
+			RID row_map = navigation_server->map_create();
+			navigation_server->map_set_active(row_map, true);
+			navigation_server->map_set_use_path_corridor_cache(row_map, true);
+			LocalVector<RID> row_regions;
+			create_tiled_map(navigation_server, row_map, 3, 8, row_regions);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector3 start = Vector3(1, 0, 1);
+			const Vector3 target = Vector3(23, 0, 1);
+			// Whether the path leaves the first row of tiles to go around the middle tile.
+			const auto goes_around = [](const Vector<Vector3> &p_path) {
+				for (const Vector3 &point : p_path) {
+					if (point.z > 8.0 - CMP_EPSILON) {
+						return true;
+					}
+				}
+				return false;
+			};
+
+			Vector<Vector3> path = navigation_server->map_get_path(row_map, start, target, true);
+			REQUIRE(path.size() >= 2);
+			CHECK_FALSE(goes_around(path));
+
+			navigation_server->region_set_navigation_layers(row_regions[1], 2);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			path = navigation_server->map_get_path(row_map, start, target, true);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[path.size() - 1].is_equal_approx(target));
+			CHECK(goes_around(path));
+
+			navigation_server->region_set_navigation_layers(row_regions[1], 1);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			path = navigation_server->map_get_path(row_map, start, target, true);
+			REQUIRE(path.size() >= 2);
+			CHECK_FALSE(goes_around(path));
+
+			navigation_server->region_set_travel_cost(row_regions[1], 10.0);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			path = navigation_server->map_get_path(row_map, start, target, true);
+			REQUIRE(path.size() >= 2);
+			CHECK(goes_around(path));
+
+			for (const RID &region : row_regions) {
+				navigation_server->free(region);
+			}
+			navigation_server->free(row_map);
+		}
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		for (const RID &region : cached_regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->free(cached_map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Batched path queries should match single queries") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 4, 8, regions);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		// One query per agent.
+		const int agent_count = 10000;
+		TypedArray<NavigationPathQueryParameters3D> query_parameters;
+		TypedArray<NavigationPathQueryResult3D> query_results;
+		RandomPCG rng(7);
+		for (int i = 0; i < agent_count; i++) {
+			Ref<NavigationPathQueryParameters3D> parameters;
+			parameters.instantiate();
+			parameters->set_map(map);
+			parameters->set_start_position(Vector3(rng.random(0.0, 32.0), 0.0, rng.random(0.0, 32.0)));
+			parameters->set_target_position(Vector3(rng.random(0.0, 32.0), 0.0, rng.random(0.0, 32.0)));
+			query_parameters.push_back(parameters);
+			Ref<NavigationPathQueryResult3D> result;
+			result.instantiate();
+			query_results.push_back(result);
+		}
+
+		CallableMock batch_callback_mock;
+		const int64_t batch_id = navigation_server->query_path_batch(query_parameters, query_results, callable_mp(&batch_callback_mock, &CallableMock::function1).bind(true));
+		CHECK_NE(batch_id, 0);
+		CHECK_EQ(batch_callback_mock.function1_calls, 0);
+
+		// The batch completes before the next map changes are applied.
+		navigation_server->process(0.0);
+		CHECK(navigation_server->is_path_query_batch_completed(batch_id));
+		CHECK_EQ(batch_callback_mock.function1_calls, 1);
+
+		bool all_paths_match = true;
+		Ref<NavigationPathQueryResult3D> single_result;
+		single_result.instantiate();
+		for (int i = 0; i < agent_count; i++) {
+			const Ref<NavigationPathQueryResult3D> result = query_results[i];
+			navigation_server->query_path(query_parameters[i], single_result);
+			all_paths_match = all_paths_match && !result->get_path().is_empty() && result->get_path() == single_result->get_path() && result->get_path_rids() == single_result->get_path_rids();
+		}
+		CHECK(all_paths_match);
+
+		SUBCASE("Mismatched or empty batches should be handled") {
+			ERR_PRINT_OFF;
+			CHECK_EQ(navigation_server->query_path_batch(query_parameters, TypedArray<NavigationPathQueryResult3D>()), 0);
+			ERR_PRINT_ON;
+
+			const int64_t empty_batch_id = navigation_server->query_path_batch(TypedArray<NavigationPathQueryParameters3D>(), TypedArray<NavigationPathQueryResult3D>());
+			CHECK(navigation_server->is_path_query_batch_completed(empty_batch_id));
+			navigation_server->process(0.0);
+		}
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationServer3D][Benchmark] Batched path queries for 10000 agents") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 8, 16, regions);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const int agent_count = 10000;
+		TypedArray<NavigationPathQueryParameters3D> query_parameters;
+		TypedArray<NavigationPathQueryResult3D> query_results;
+		RandomPCG rng(7);
+		for (int i = 0; i < agent_count; i++) {
+			Ref<NavigationPathQueryParameters3D> parameters;
+			parameters.instantiate();
+			parameters->set_map(map);
+			parameters->set_start_position(Vector3(rng.random(0.0, 128.0), 0.0, rng.random(0.0, 128.0)));
+			parameters->set_target_position(Vector3(rng.random(0.0, 128.0), 0.0, rng.random(0.0, 128.0)));
+			query_parameters.push_back(parameters);
+			Ref<NavigationPathQueryResult3D> result;
+			result.instantiate();
+			query_results.push_back(result);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < agent_count; i++) {
+			navigation_server->query_path(query_parameters[i], query_results[i]);
+		}
+		const uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		navigation_server->query_path_batch(query_parameters, query_results);
+		navigation_server->process(0.0);
+		const uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(vformat("%d path queries: one by one %.1f queries/msec, batched %.1f queries/msec.", agent_count, agent_count * 1000.0 / MAX(single_usec, uint64_t(1)), agent_count * 1000.0 / MAX(batch_usec, uint64_t(1))));
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationServer3D][Benchmark] Map sync toggling one region of 1024") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		create_tiled_map(navigation_server, map, 32, 4, regions);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		const uint64_t full_sync_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		const int toggle_count = 20;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < toggle_count; i++) {
+			navigation_server->region_set_enabled(regions[528], i % 2 == 1);
+			navigation_server->process(0.0);
+		}
+		const uint64_t toggle_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(vformat("%d regions: first sync %.2f msec, sync after toggling one region %.2f msec, %d edges, %d merged.", regions.size(), full_sync_usec / 1000.0, toggle_usec / 1000.0 / toggle_count, navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_COUNT), navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT)));
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE_BENCHMARK("[NavigationServer3D][Benchmark] Closest point and path queries on growing maps") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int tile_size = 32;
+		const int query_count = 1000;
+
+		for (int tiles = 1; tiles <= 16; tiles *= 2) {
+			RID map = navigation_server->map_create();
+			navigation_server->map_set_active(map, true);
+			LocalVector<RID> regions;
+			create_tiled_map(navigation_server, map, tiles, tile_size, regions);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const real_t map_size = tiles * tile_size;
+			RandomPCG rng(42);
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < query_count; i++) {
+				navigation_server->map_get_closest_point(map, Vector3(rng.random(0.0, map_size), 1.0, rng.random(0.0, map_size)));
+			}
+			const uint64_t closest_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < query_count / 10; i++) {
+				const Vector3 from(rng.random(0.0, map_size), 0.0, rng.random(0.0, map_size));
+				const Vector3 to(rng.random(0.0, map_size), 0.0, rng.random(0.0, map_size));
+				navigation_server->map_get_path(map, from, to, true);
+			}
+			const uint64_t path_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			navigation_server->map_set_use_hierarchical_pathfinding(map, true);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < query_count / 10; i++) {
+				const Vector3 from(rng.random(0.0, map_size), 0.0, rng.random(0.0, map_size));
+				const Vector3 to(rng.random(0.0, map_size), 0.0, rng.random(0.0, map_size));
+				navigation_server->map_get_path(map, from, to, true);
+			}
+			const uint64_t hierarchical_path_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			print_line(vformat("%d polygons in %d regions: closest point %.2f usec/query, path %.2f usec/query, hierarchical path %.2f usec/query.", tiles * tiles * tile_size * tile_size, tiles * tiles, double(closest_usec) / query_count, double(path_usec) / (query_count / 10), double(hierarchical_path_usec) / (query_count / 10)));
+
+			for (const RID &region : regions) {
+				navigation_server->free(region);
+			}
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+	}
+
 	// FIXME: The race condition mentioned below is actually a problem and fails on CI (GH-90613).
 	/*
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {
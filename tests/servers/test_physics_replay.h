@@ -0,0 +1,641 @@
+/**************************************************************************/
+/*  test_physics_replay.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_REPLAY_H
+#define TEST_PHYSICS_REPLAY_H
+
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "servers/physics_2d/godot_physics_server_2d.h"
+
+#ifndef _3D_DISABLED
+#include "servers/physics_3d/godot_physics_server_3d.h"
+#endif // _3D_DISABLED
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+// Replays a recorded physics scenario directly on the physics servers, without the scene system,
+// and reports the time spent in each phase of the step.
+//
+// Run it with: `godot --test physics-replay path/to/scenario.json`
+//
+// Scenarios are JSON files:
+// {
+//     "dimensions": 3,                    // 2 or 3, selects the physics server.
+//     "steps": 600,                       // Number of physics steps to run.
+//     "delta": 0.016667,                  // Step length in seconds.
+//     "solver_iterations": 16,            // Optional.
+//     "gravity": [0, -9.8, 0],            // Optional.
+//     "shapes": [                         // Sizes are full sizes, not half extents.
+//         { "type": "box", "size": [1, 1, 1] },
+//         { "type": "sphere", "radius": 0.5 },
+//         { "type": "capsule", "radius": 0.5, "height": 2 },
+//         { "type": "cylinder", "radius": 0.5, "height": 2 },
+//         { "type": "world_boundary", "normal": [0, 1, 0], "d": 0 },
+//         { "type": "convex", "points": [[0, 0, 0], [1, 0, 0], [0, 1, 0], [0, 0, 1]] }
+//     ],
+//     "bodies": [
+//         {
+//             "shape": 0,                 // Index into "shapes".
+//             "mode": "rigid",            // "static", "kinematic", "rigid" or "rigid_linear".
+//             "position": [0, 5, 0],
+//             "rotation": [0, 0, 0],      // Euler angles in radians, a single angle in 2D.
+//             "count": [10, 10, 10],      // Optional, repeats the body in a grid...
+//             "spacing": [1.1, 1.1, 1.1], // ...with this offset between copies.
+//             "mass": 1, "friction": 1, "bounce": 0,
+//             "linear_velocity": [0, 0, 0], "angular_velocity": [0, 0, 0],
+//             "can_sleep": true, "collision_layer": 1, "collision_mask": 1
+//         }
+//     ],
+//     "events": [                         // Recorded inputs, sorted by step.
+//         { "step": 60, "body": 0, "type": "impulse", "value": [0, 10, 0] }
+//     ]
+// }
+//
+// 2D scenarios use 2D vectors, "rectangle" and "circle" shapes instead of "box" and "sphere",
+// and "capsule", "world_boundary" and "convex" as above.
+// Event types are "position", "linear_velocity", "angular_velocity" and "impulse".
+
+namespace TestPhysicsReplay {
+
+struct ReplayResult {
+	int steps = 0;
+	int bodies = 0;
+	uint64_t total_usec = 0;
+	LocalVector<String> phase_names;
+	LocalVector<uint64_t> phase_usec;
+	int max_active_objects = 0;
+	int max_collision_pairs = 0;
+	// Final body positions (z is 0 in 2D), to compare runs.
+	LocalVector<Vector3> final_positions;
+};
+
+static PhysicsServer3D::BodyMode get_body_mode(const Dictionary &p_body) {
+	String mode = p_body.get("mode", "rigid");
+	if (mode == "static") {
+		return PhysicsServer3D::BODY_MODE_STATIC;
+	} else if (mode == "kinematic") {
+		return PhysicsServer3D::BODY_MODE_KINEMATIC;
+	} else if (mode == "rigid_linear") {
+		return PhysicsServer3D::BODY_MODE_RIGID_LINEAR;
+	}
+	ERR_FAIL_COND_V_MSG(mode != "rigid", PhysicsServer3D::BODY_MODE_RIGID, vformat("Unknown body mode \"%s\".", mode));
+	return PhysicsServer3D::BODY_MODE_RIGID;
+}
+
+static Vector3 get_vector3(const Dictionary &p_dict, const String &p_key, const Vector3 &p_default = Vector3()) {
+	if (!p_dict.has(p_key)) {
+		return p_default;
+	}
+	Array array = p_dict[p_key];
+	ERR_FAIL_COND_V_MSG(array.size() != 3, p_default, vformat("\"%s\" should be an array of 3 numbers.", p_key));
+	return Vector3(array[0], array[1], array[2]);
+}
+
+static Vector2 get_vector2(const Dictionary &p_dict, const String &p_key, const Vector2 &p_default = Vector2()) {
+	if (!p_dict.has(p_key)) {
+		return p_default;
+	}
+	Array array = p_dict[p_key];
+	ERR_FAIL_COND_V_MSG(array.size() != 2, p_default, vformat("\"%s\" should be an array of 2 numbers.", p_key));
+	return Vector2(array[0], array[1]);
+}
+
+// Validates the common part of a scenario, and returns the events sorted by step.
+static Error check_scenario(const Dictionary &p_scenario, Array &r_events) {
+	ERR_FAIL_COND_V_MSG(!p_scenario.has("shapes") || !p_scenario.has("bodies"), ERR_INVALID_DATA, "Scenario needs \"shapes\" and \"bodies\".");
+	ERR_FAIL_COND_V_MSG(int(p_scenario.get("steps", 1)) < 1, ERR_INVALID_DATA, "Scenario needs at least one step.");
+	ERR_FAIL_COND_V_MSG(double(p_scenario.get("delta", 1.0 / 60.0)) <= 0.0, ERR_INVALID_DATA, "Scenario delta must be positive.");
+
+	r_events = p_scenario.get("events", Array());
+	int last_step = 0;
+	for (int i = 0; i < r_events.size(); i++) {
+		Dictionary event = r_events[i];
+		int step = event.get("step", 0);
+		ERR_FAIL_COND_V_MSG(step < last_step, ERR_INVALID_DATA, "Scenario events must be sorted by step.");
+		last_step = step;
+	}
+	return OK;
+}
+
+class PhysicsReplay2D {
+	GodotPhysicsServer2D *server = nullptr;
+	RID space;
+	LocalVector<RID> shapes;
+	LocalVector<RID> bodies;
+	Array events;
+	int steps = 0;
+	real_t delta = 0.0;
+
+	Error _create_shape(const Dictionary &p_shape) {
+		String type = p_shape.get("type", "");
+		RID shape;
+		if (type == "rectangle") {
+			shape = server->rectangle_shape_create();
+			server->shape_set_data(shape, get_vector2(p_shape, "size", Vector2(1, 1)) * 0.5);
+		} else if (type == "circle") {
+			shape = server->circle_shape_create();
+			server->shape_set_data(shape, p_shape.get("radius", 0.5));
+		} else if (type == "capsule") {
+			shape = server->capsule_shape_create();
+			server->shape_set_data(shape, Vector2(p_shape.get("radius", 0.5), p_shape.get("height", 2.0)));
+		} else if (type == "world_boundary") {
+			shape = server->world_boundary_shape_create();
+			Array data;
+			data.push_back(get_vector2(p_shape, "normal", Vector2(0, -1)));
+			data.push_back(p_shape.get("d", 0.0));
+			server->shape_set_data(shape, data);
+		} else if (type == "convex") {
+			shape = server->convex_polygon_shape_create();
+			Array points = p_shape.get("points", Array());
+			PackedVector2Array data;
+			for (int i = 0; i < points.size(); i++) {
+				Array point = points[i];
+				ERR_FAIL_COND_V(point.size() != 2, ERR_INVALID_DATA);
+				data.push_back(Vector2(point[0], point[1]));
+			}
+			server->shape_set_data(shape, data);
+		} else {
+			ERR_FAIL_V_MSG(ERR_INVALID_DATA, vformat("Unknown 2D shape type \"%s\".", type));
+		}
+		shapes.push_back(shape);
+		return OK;
+	}
+
+	Error _create_bodies(const Dictionary &p_body) {
+		int shape_index = p_body.get("shape", 0);
+		ERR_FAIL_INDEX_V(shape_index, (int)shapes.size(), ERR_INVALID_DATA);
+
+		Vector2 count = get_vector2(p_body, "count", Vector2(1, 1));
+		Vector2 spacing = get_vector2(p_body, "spacing");
+		Vector2 position = get_vector2(p_body, "position");
+		PhysicsServer2D::BodyMode mode = PhysicsServer2D::BodyMode(get_body_mode(p_body));
+
+		for (int x = 0; x < int(count.x); x++) {
+			for (int y = 0; y < int(count.y); y++) {
+				RID body = server->body_create();
+				server->body_set_mode(body, mode);
+				server->body_add_shape(body, shapes[shape_index]);
+				server->body_set_collision_layer(body, p_body.get("collision_layer", 1));
+				server->body_set_collision_mask(body, p_body.get("collision_mask", 1));
+				server->body_set_param(body, PhysicsServer2D::BODY_PARAM_MASS, p_body.get("mass", 1.0));
+				server->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, p_body.get("friction", 1.0));
+				server->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, p_body.get("bounce", 0.0));
+				server->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(p_body.get("rotation", 0.0), position + spacing * Vector2(x, y)));
+				server->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, get_vector2(p_body, "linear_velocity"));
+				server->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, p_body.get("angular_velocity", 0.0));
+				server->body_set_state(body, PhysicsServer2D::BODY_STATE_CAN_SLEEP, p_body.get("can_sleep", true));
+				server->body_set_space(body, space);
+				bodies.push_back(body);
+			}
+		}
+		return OK;
+	}
+
+	void _apply_event(const Dictionary &p_event) {
+		int body_index = p_event.get("body", 0);
+		ERR_FAIL_INDEX(body_index, (int)bodies.size());
+		RID body = bodies[body_index];
+
+		String type = p_event.get("type", "");
+		if (type == "position") {
+			Transform2D transform = server->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+			transform.set_origin(get_vector2(p_event, "value"));
+			server->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, transform);
+		} else if (type == "linear_velocity") {
+			server->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, get_vector2(p_event, "value"));
+		} else if (type == "angular_velocity") {
+			server->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, p_event.get("value", 0.0));
+		} else if (type == "impulse") {
+			server->body_apply_central_impulse(body, get_vector2(p_event, "value"));
+		} else {
+			ERR_FAIL_MSG(vformat("Unknown event type \"%s\".", type));
+		}
+	}
+
+public:
+	Error load(const Dictionary &p_scenario) {
+		Error err = check_scenario(p_scenario, events);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		steps = p_scenario.get("steps", 1);
+		delta = p_scenario.get("delta", 1.0 / 60.0);
+
+		space = server->space_create();
+		server->space_set_active(space, true);
+		server->space_set_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_ITERATIONS, p_scenario.get("solver_iterations", 16));
+		Vector2 gravity = get_vector2(p_scenario, "gravity", Vector2(0, 980));
+		server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, gravity.normalized());
+		server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, gravity.length());
+
+		Array scenario_shapes = p_scenario["shapes"];
+		for (int i = 0; i < scenario_shapes.size(); i++) {
+			err = _create_shape(scenario_shapes[i]);
+			ERR_FAIL_COND_V(err != OK, err);
+		}
+
+		Array scenario_bodies = p_scenario["bodies"];
+		for (int i = 0; i < scenario_bodies.size(); i++) {
+			err = _create_bodies(scenario_bodies[i]);
+			ERR_FAIL_COND_V(err != OK, err);
+		}
+		return OK;
+	}
+
+	void run(ReplayResult &r_result) {
+		r_result = ReplayResult();
+		r_result.steps = steps;
+		r_result.bodies = bodies.size();
+		const char *phase_names[GodotSpace2D::ELAPSED_TIME_MAX] = { "integrate_forces", "generate_islands", "narrowphase", "solve", "integrate_velocities" };
+		for (int i = 0; i < GodotSpace2D::ELAPSED_TIME_MAX; i++) {
+			r_result.phase_names.push_back(phase_names[i]);
+			r_result.phase_usec.push_back(0);
+		}
+
+		int next_event = 0;
+		for (int step = 0; step < steps; step++) {
+			while (next_event < events.size() && int(Dictionary(events[next_event]).get("step", 0)) <= step) {
+				_apply_event(events[next_event++]);
+			}
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			server->step(delta);
+			server->flush_queries();
+			r_result.total_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+			for (int i = 0; i < GodotSpace2D::ELAPSED_TIME_MAX; i++) {
+				r_result.phase_usec[i] += server->get_elapsed_time(GodotSpace2D::ElapsedTime(i));
+			}
+			r_result.max_active_objects = MAX(r_result.max_active_objects, server->get_process_info(PhysicsServer2D::INFO_ACTIVE_OBJECTS));
+			r_result.max_collision_pairs = MAX(r_result.max_collision_pairs, server->get_process_info(PhysicsServer2D::INFO_COLLISION_PAIRS));
+		}
+
+		for (const RID &body : bodies) {
+			Transform2D transform = server->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+			r_result.final_positions.push_back(Vector3(transform.get_origin().x, transform.get_origin().y, 0));
+		}
+	}
+
+	PhysicsReplay2D() {
+		server = memnew(GodotPhysicsServer2D);
+		server->init();
+	}
+
+	~PhysicsReplay2D() {
+		for (const RID &body : bodies) {
+			server->free(body);
+		}
+		for (const RID &shape : shapes) {
+			server->free(shape);
+		}
+		if (space.is_valid()) {
+			server->free(space);
+		}
+		server->finish();
+		memdelete(server);
+	}
+};
+
+#ifndef _3D_DISABLED
+class PhysicsReplay3D {
+	GodotPhysicsServer3D *server = nullptr;
+	RID space;
+	LocalVector<RID> shapes;
+	LocalVector<RID> bodies;
+	Array events;
+	int steps = 0;
+	real_t delta = 0.0;
+
+	Error _create_shape(const Dictionary &p_shape) {
+		String type = p_shape.get("type", "");
+		RID shape;
+		if (type == "box") {
+			shape = server->box_shape_create();
+			server->shape_set_data(shape, get_vector3(p_shape, "size", Vector3(1, 1, 1)) * 0.5);
+		} else if (type == "sphere") {
+			shape = server->sphere_shape_create();
+			server->shape_set_data(shape, p_shape.get("radius", 0.5));
+		} else if (type == "capsule" || type == "cylinder") {
+			shape = type == "capsule" ? server->capsule_shape_create() : server->cylinder_shape_create();
+			Dictionary data;
+			data["radius"] = p_shape.get("radius", 0.5);
+			data["height"] = p_shape.get("height", 2.0);
+			server->shape_set_data(shape, data);
+		} else if (type == "world_boundary") {
+			shape = server->world_boundary_shape_create();
+			server->shape_set_data(shape, Plane(get_vector3(p_shape, "normal", Vector3(0, 1, 0)), real_t(p_shape.get("d", 0.0))));
+		} else if (type == "convex") {
+			shape = server->convex_polygon_shape_create();
+			Array points = p_shape.get("points", Array());
+			PackedVector3Array data;
+			for (int i = 0; i < points.size(); i++) {
+				Array point = points[i];
+				ERR_FAIL_COND_V(point.size() != 3, ERR_INVALID_DATA);
+				data.push_back(Vector3(point[0], point[1], point[2]));
+			}
+			server->shape_set_data(shape, data);
+		} else {
+			ERR_FAIL_V_MSG(ERR_INVALID_DATA, vformat("Unknown 3D shape type \"%s\".", type));
+		}
+		shapes.push_back(shape);
+		return OK;
+	}
+
+	Error _create_bodies(const Dictionary &p_body) {
+		int shape_index = p_body.get("shape", 0);
+		ERR_FAIL_INDEX_V(shape_index, (int)shapes.size(), ERR_INVALID_DATA);
+
+		Vector3 count = get_vector3(p_body, "count", Vector3(1, 1, 1));
+		Vector3 spacing = get_vector3(p_body, "spacing");
+		Vector3 position = get_vector3(p_body, "position");
+		Basis basis = Basis::from_euler(get_vector3(p_body, "rotation"));
+		PhysicsServer3D::BodyMode mode = get_body_mode(p_body);
+
+		for (int x = 0; x < int(count.x); x++) {
+			for (int y = 0; y < int(count.y); y++) {
+				for (int z = 0; z < int(count.z); z++) {
+					RID body = server->body_create();
+					server->body_set_mode(body, mode);
+					server->body_add_shape(body, shapes[shape_index]);
+					server->body_set_collision_layer(body, p_body.get("collision_layer", 1));
+					server->body_set_collision_mask(body, p_body.get("collision_mask", 1));
+					server->body_set_param(body, PhysicsServer3D::BODY_PARAM_MASS, p_body.get("mass", 1.0));
+					server->body_set_param(body, PhysicsServer3D::BODY_PARAM_FRICTION, p_body.get("friction", 1.0));
+					server->body_set_param(body, PhysicsServer3D::BODY_PARAM_BOUNCE, p_body.get("bounce", 0.0));
+					server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(basis, position + spacing * Vector3(x, y, z)));
+					server->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, get_vector3(p_body, "linear_velocity"));
+					server->body_set_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, get_vector3(p_body, "angular_velocity"));
+					server->body_set_state(body, PhysicsServer3D::BODY_STATE_CAN_SLEEP, p_body.get("can_sleep", true));
+					server->body_set_space(body, space);
+					bodies.push_back(body);
+				}
+			}
+		}
+		return OK;
+	}
+
+	void _apply_event(const Dictionary &p_event) {
+		int body_index = p_event.get("body", 0);
+		ERR_FAIL_INDEX(body_index, (int)bodies.size());
+		RID body = bodies[body_index];
+
+		String type = p_event.get("type", "");
+		if (type == "position") {
+			Transform3D transform = server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+			transform.origin = get_vector3(p_event, "value");
+			server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, transform);
+		} else if (type == "linear_velocity") {
+			server->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, get_vector3(p_event, "value"));
+		} else if (type == "angular_velocity") {
+			server->body_set_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, get_vector3(p_event, "value"));
+		} else if (type == "impulse") {
+			server->body_apply_central_impulse(body, get_vector3(p_event, "value"));
+		} else {
+			ERR_FAIL_MSG(vformat("Unknown event type \"%s\".", type));
+		}
+	}
+
+public:
+	Error load(const Dictionary &p_scenario) {
+		Error err = check_scenario(p_scenario, events);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		steps = p_scenario.get("steps", 1);
+		delta = p_scenario.get("delta", 1.0 / 60.0);
+
+		space = server->space_create();
+		server->space_set_active(space, true);
+		server->space_set_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS, p_scenario.get("solver_iterations", 16));
+		Vector3 gravity = get_vector3(p_scenario, "gravity", Vector3(0, -9.8, 0));
+		server->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY_VECTOR, gravity.normalized());
+		server->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY, gravity.length());
+
+		Array scenario_shapes = p_scenario["shapes"];
+		for (int i = 0; i < scenario_shapes.size(); i++) {
+			err = _create_shape(scenario_shapes[i]);
+			ERR_FAIL_COND_V(err != OK, err);
+		}
+
+		Array scenario_bodies = p_scenario["bodies"];
+		for (int i = 0; i < scenario_bodies.size(); i++) {
+			err = _create_bodies(scenario_bodies[i]);
+			ERR_FAIL_COND_V(err != OK, err);
+		}
+		return OK;
+	}
+
+	void run(ReplayResult &r_result) {
+		r_result = ReplayResult();
+		r_result.steps = steps;
+		r_result.bodies = bodies.size();
+		const char *phase_names[GodotSpace3D::ELAPSED_TIME_MAX] = { "integrate_forces", "broadphase", "generate_islands", "narrowphase", "solve", "integrate_velocities" };
+		for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
+			r_result.phase_names.push_back(phase_names[i]);
+			r_result.phase_usec.push_back(0);
+		}
+
+		int next_event = 0;
+		for (int step = 0; step < steps; step++) {
+			while (next_event < events.size() && int(Dictionary(events[next_event]).get("step", 0)) <= step) {
+				_apply_event(events[next_event++]);
+			}
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			server->step(delta);
+			server->flush_queries();
+			r_result.total_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+			for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
+				r_result.phase_usec[i] += server->get_elapsed_time(GodotSpace3D::ElapsedTime(i));
+			}
+			r_result.max_active_objects = MAX(r_result.max_active_objects, server->get_process_info(PhysicsServer3D::INFO_ACTIVE_OBJECTS));
+			r_result.max_collision_pairs = MAX(r_result.max_collision_pairs, server->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS));
+		}
+
+		for (const RID &body : bodies) {
+			Transform3D transform = server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+			r_result.final_positions.push_back(transform.origin);
+		}
+	}
+
+	PhysicsReplay3D() {
+		server = memnew(GodotPhysicsServer3D);
+		server->init();
+	}
+
+	~PhysicsReplay3D() {
+		for (const RID &body : bodies) {
+			server->free(body);
+		}
+		for (const RID &shape : shapes) {
+			server->free(shape);
+		}
+		if (space.is_valid()) {
+			server->free(space);
+		}
+		server->finish();
+		memdelete(server);
+	}
+};
+#endif // _3D_DISABLED
+
+static Error replay_scenario(const Dictionary &p_scenario, ReplayResult &r_result) {
+	int dimensions = p_scenario.get("dimensions", 3);
+	if (dimensions == 2) {
+		PhysicsReplay2D replay;
+		Error err = replay.load(p_scenario);
+		ERR_FAIL_COND_V(err != OK, err);
+		replay.run(r_result);
+		return OK;
+	}
+
+	ERR_FAIL_COND_V_MSG(dimensions != 3, ERR_INVALID_DATA, "Scenario \"dimensions\" must be 2 or 3.");
+#ifndef _3D_DISABLED
+	PhysicsReplay3D replay;
+	Error err = replay.load(p_scenario);
+	ERR_FAIL_COND_V(err != OK, err);
+	replay.run(r_result);
+	return OK;
+#else
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "3D physics is disabled in this build.");
+#endif // _3D_DISABLED
+}
+
+static Error load_scenario(const String &p_path, Dictionary &r_scenario) {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_FILE_CANT_OPEN, "Could not open scenario: " + p_path);
+
+	Ref<JSON> json;
+	json.instantiate();
+	Error err = json->parse(file->get_as_utf8_string());
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not parse scenario %s at line %d: %s", p_path, json->get_error_line(), json->get_error_message()));
+	ERR_FAIL_COND_V_MSG(json->get_data().get_type() != Variant::DICTIONARY, ERR_INVALID_DATA, "Scenario must be a JSON object: " + p_path);
+
+	r_scenario = json->get_data();
+	return OK;
+}
+
+static void print_result(const String &p_name, const ReplayResult &p_result) {
+	print_line(vformat("Physics replay %s: %d bodies, %d steps, %d max active objects, %d max collision pairs.", p_name, p_result.bodies, p_result.steps, p_result.max_active_objects, p_result.max_collision_pairs));
+	print_line(vformat("  total: %d usec (%.1f usec/step)", p_result.total_usec, double(p_result.total_usec) / p_result.steps));
+	for (uint32_t i = 0; i < p_result.phase_names.size(); i++) {
+		print_line(vformat("  %s: %d usec (%.1f usec/step)", p_result.phase_names[i], p_result.phase_usec[i], double(p_result.phase_usec[i]) / p_result.steps));
+	}
+}
+
+// `godot --test physics-replay <scenario.json>`
+static void run_replay_command() {
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+
+	String path;
+	for (const String &arg : args) {
+		if (arg.ends_with(".json")) {
+			path = arg;
+		}
+	}
+	if (path.is_empty()) {
+		print_line("Usage: godot --test physics-replay <scenario.json>");
+		return;
+	}
+
+	Dictionary scenario;
+	ERR_FAIL_COND(load_scenario(path, scenario) != OK);
+
+	ReplayResult result;
+	ERR_FAIL_COND(replay_scenario(scenario, result) != OK);
+	print_result(path.get_file(), result);
+}
+
+REGISTER_TEST_COMMAND("physics-replay", &run_replay_command);
+
+TEST_CASE("[PhysicsReplay] Bundled scenarios load, run and are reproducible") {
+	const String files[] = { "physics/box_pile_2d.json", "physics/box_pile_3d.json" };
+
+	for (const String &file : files) {
+		Dictionary scenario;
+		REQUIRE(load_scenario(TestUtils::get_data_path(file), scenario) == OK);
+
+		// A short run is enough to check the scenario works.
+		scenario["steps"] = 30;
+
+		ReplayResult first;
+		REQUIRE(replay_scenario(scenario, first) == OK);
+		CHECK(first.bodies > 1);
+		CHECK(first.max_collision_pairs > 0);
+		CHECK(first.phase_usec.size() == first.phase_names.size());
+
+		ReplayResult second;
+		REQUIRE(replay_scenario(scenario, second) == OK);
+		REQUIRE(first.final_positions.size() == second.final_positions.size());
+		bool same_positions = true;
+		for (uint32_t i = 0; i < first.final_positions.size(); i++) {
+			same_positions = same_positions && first.final_positions[i] == second.final_positions[i];
+		}
+		CHECK_MESSAGE(same_positions, vformat("Replaying %s twice should give the same result.", file));
+	}
+}
+
+TEST_CASE("[PhysicsReplay] Events are applied at their step") {
+	Dictionary scenario = JSON::parse_string(R"({
+		"dimensions": 3,
+		"steps": 10,
+		"gravity": [0, 0, 0],
+		"shapes": [{ "type": "sphere", "radius": 0.5 }],
+		"bodies": [{ "shape": 0, "position": [0, 0, 0] }],
+		"events": [{ "step": 5, "body": 0, "type": "linear_velocity", "value": [6, 0, 0] }]
+	})");
+
+	ReplayResult result;
+	REQUIRE(replay_scenario(scenario, result) == OK);
+	REQUIRE(result.final_positions.size() == 1);
+	// Moving at 6 m/s for the last 5 steps of 1/60 s, minus a bit of default damping.
+	CHECK(result.final_positions[0].x == doctest::Approx(0.5).epsilon(0.02));
+	CHECK(result.final_positions[0].y == doctest::Approx(0.0));
+	CHECK(result.final_positions[0].z == doctest::Approx(0.0));
+}
+
+TEST_CASE_BENCHMARK("[PhysicsReplay][Benchmark] Bundled scenarios") {
+	const String files[] = { "physics/box_pile_2d.json", "physics/box_pile_3d.json" };
+
+	for (const String &file : files) {
+		Dictionary scenario;
+		REQUIRE(load_scenario(TestUtils::get_data_path(file), scenario) == OK);
+
+		ReplayResult result;
+		REQUIRE(replay_scenario(scenario, result) == OK);
+		print_result(file, result);
+	}
+}
+
+} // namespace TestPhysicsReplay
+
+#endif // TEST_PHYSICS_REPLAY_H
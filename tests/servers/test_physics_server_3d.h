@@ -0,0 +1,327 @@
+/**************************************************************************/
+/*  test_physics_server_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+// Fills a space with a grid of static boxes and returns the box shape.
+static RID create_box_grid(PhysicsServer3D *p_server, RID p_space, int p_size, LocalVector<RID> &r_bodies) {
+	RID shape = p_server->shape_create(PhysicsServer3D::SHAPE_BOX);
+	p_server->shape_set_data(shape, Vector3(0.4, 0.4, 0.4));
+
+	for (int i = 0; i < p_size; i++) {
+		for (int j = 0; j < p_size; j++) {
+			RID body = p_server->body_create();
+			p_server->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+			p_server->body_add_shape(body, shape);
+			p_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i, (i + j) % 3, j)));
+			p_server->body_set_space(body, p_space);
+			r_bodies.push_back(body);
+		}
+	}
+
+	return shape;
+}
+
+TEST_CASE("[PhysicsServer3D] Batched space queries match single queries") {
+	PhysicsServer3D *server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	const int size = 16;
+	LocalVector<RID> bodies;
+	RID shape = create_box_grid(server, space, size, bodies);
+	server->step(1.0 / 60.0);
+
+	PhysicsDirectSpaceState3D *space_state = server->space_get_direct_state(space);
+	REQUIRE(space_state);
+
+	// Enough queries to be split across several tasks.
+	const int count = 500;
+	RandomPCG rng(5);
+	Vector<Vector3> from;
+	Vector<Vector3> to;
+	Vector<Transform3D> transforms;
+	Vector<Vector3> motions;
+	for (int i = 0; i < count; i++) {
+		Vector3 origin(rng.randf() * size, 5, rng.randf() * size);
+		from.push_back(origin);
+		to.push_back(origin + Vector3(rng.randf() * 4.0 - 2.0, -10, rng.randf() * 4.0 - 2.0));
+		transforms.push_back(Transform3D(Basis(), Vector3(rng.randf() * size, rng.randf() * 3.0, rng.randf() * size)));
+		motions.push_back(Vector3(rng.randf() * 4.0 - 2.0, -2, rng.randf() * 4.0 - 2.0));
+	}
+
+	SUBCASE("Rays") {
+		PhysicsDirectSpaceState3D::RayParameters parameters;
+		Vector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(count);
+		Vector<bool> hits;
+		hits.resize(count);
+
+		int hit_count = space_state->intersect_ray_batch(parameters, from.ptr(), to.ptr(), count, results.ptrw(), hits.ptrw());
+		CHECK(hit_count > 0);
+
+		for (int i = 0; i < count; i++) {
+			parameters.from = from[i];
+			parameters.to = to[i];
+			PhysicsDirectSpaceState3D::RayResult result;
+			bool hit = space_state->intersect_ray(parameters, result);
+
+			CHECK(hits[i] == hit);
+			if (hit) {
+				CHECK(results[i].rid == result.rid);
+				CHECK(results[i].position.is_equal_approx(result.position));
+				CHECK(results[i].normal.is_equal_approx(result.normal));
+			}
+		}
+	}
+
+	SUBCASE("Shape overlaps") {
+		PhysicsDirectSpaceState3D::ShapeParameters parameters;
+		parameters.shape_rid = shape;
+		const int result_max = 8;
+		Vector<PhysicsDirectSpaceState3D::ShapeResult> results;
+		results.resize(count * result_max);
+		Vector<int> result_counts;
+		result_counts.resize(count);
+
+		space_state->intersect_shape_batch(parameters, transforms.ptr(), count, results.ptrw(), result_max, result_counts.ptrw());
+
+		for (int i = 0; i < count; i++) {
+			parameters.transform = transforms[i];
+			PhysicsDirectSpaceState3D::ShapeResult single_results[result_max];
+			int single_count = space_state->intersect_shape(parameters, single_results, result_max);
+
+			REQUIRE(result_counts[i] == single_count);
+			for (int j = 0; j < single_count; j++) {
+				CHECK(results[i * result_max + j].rid == single_results[j].rid);
+			}
+		}
+	}
+
+	SUBCASE("Shape casts") {
+		PhysicsDirectSpaceState3D::ShapeParameters parameters;
+		parameters.shape_rid = shape;
+		Vector<real_t> closest_safe;
+		closest_safe.resize(count);
+		Vector<real_t> closest_unsafe;
+		closest_unsafe.resize(count);
+
+		space_state->cast_motion_batch(parameters, transforms.ptr(), motions.ptr(), count, closest_safe.ptrw(), closest_unsafe.ptrw());
+
+		for (int i = 0; i < count; i++) {
+			parameters.transform = transforms[i];
+			parameters.motion = motions[i];
+			real_t safe = 1.0;
+			real_t unsafe = 1.0;
+			space_state->cast_motion(parameters, safe, unsafe);
+
+			CHECK(closest_safe[i] == doctest::Approx(safe));
+			CHECK(closest_unsafe[i] == doctest::Approx(unsafe));
+		}
+	}
+
+	for (const RID &body : bodies) {
+		server->free(body);
+	}
+	server->free(shape);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+static int area_body_count = 0;
+
+static void area_body_monitor(int p_status, const RID &p_body, int64_t p_instance_id, int p_body_shape, int p_area_shape) {
+	area_body_count += p_status == PhysicsServer3D::AREA_BODY_ADDED ? 1 : -1;
+}
+
+TEST_CASE("[PhysicsServer3D] Islands are kept while contacts stay the same") {
+	PhysicsServer3D *server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID floor_shape = server->shape_create(PhysicsServer3D::SHAPE_BOX);
+	server->shape_set_data(floor_shape, Vector3(20, 0.5, 20));
+	RID floor = server->body_create();
+	server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	server->body_add_shape(floor, floor_shape);
+	server->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+	server->body_set_space(floor, space);
+
+	// Resting boxes that are kept awake, so they stay in the active islands.
+	RID box_shape = server->shape_create(PhysicsServer3D::SHAPE_BOX);
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	LocalVector<RID> boxes;
+	for (int i = 0; i < 4; i++) {
+		RID box = server->body_create();
+		server->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+		server->body_add_shape(box, box_shape);
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * 3.0, 0.5, 0)));
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_CAN_SLEEP, false);
+		server->body_set_space(box, space);
+		boxes.push_back(box);
+	}
+
+	RID area = server->area_create();
+	server->area_add_shape(area, box_shape);
+	server->area_set_transform(area, Transform3D(Basis(), Vector3(0, 0.5, 0)));
+	server->area_set_space(area, space);
+	area_body_count = 0;
+	server->area_set_monitor_callback(area, callable_mp_static(&area_body_monitor));
+
+	// Let everything settle and pair.
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	SUBCASE("Islands are not rebuilt") {
+		for (int i = 0; i < 10; i++) {
+			server->step(1.0 / 60.0);
+			CHECK(server->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT) > 0);
+			CHECK(server->get_process_info(PhysicsServer3D::INFO_ISLANDS_REBUILT) == 0);
+		}
+
+		// A new joint changes the constraint graph.
+		RID joint = server->joint_create();
+		server->joint_make_pin(joint, boxes[0], Vector3(), boxes[1], Vector3(-3, 0, 0));
+		server->step(1.0 / 60.0);
+		CHECK(server->get_process_info(PhysicsServer3D::INFO_ISLANDS_REBUILT) > 0);
+		server->free(joint);
+	}
+
+	SUBCASE("Only moved areas are processed") {
+		server->area_set_transform(area, Transform3D(Basis(), Vector3(0, 0.5, 0)));
+		server->step(1.0 / 60.0);
+		CHECK(server->get_process_info(PhysicsServer3D::INFO_AREAS_PROCESSED) == 0);
+
+		server->area_set_transform(area, Transform3D(Basis(), Vector3(3, 0.5, 0)));
+		server->step(1.0 / 60.0);
+		CHECK(server->get_process_info(PhysicsServer3D::INFO_AREAS_PROCESSED) == 1);
+	}
+
+	SUBCASE("Areas that don't move still see bodies that do") {
+		server->flush_queries();
+		const int initial_count = area_body_count;
+		CHECK(initial_count > 0);
+
+		server->body_set_state(boxes[0], PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 0.5, 10)));
+		server->step(1.0 / 60.0);
+		server->flush_queries();
+		CHECK(area_body_count == initial_count - 1);
+
+		server->body_set_state(boxes[0], PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 0.5, 0)));
+		server->step(1.0 / 60.0);
+		server->flush_queries();
+		CHECK(area_body_count == initial_count);
+	}
+
+	server->free(area);
+	for (const RID &box : boxes) {
+		server->free(box);
+	}
+	server->free(floor);
+	server->free(box_shape);
+	server->free(floor_shape);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+TEST_CASE_BENCHMARK("[PhysicsServer3D][Benchmark] Batched ray throughput") {
+	PhysicsServer3D *server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	const int size = 64;
+	LocalVector<RID> bodies;
+	RID shape = create_box_grid(server, space, size, bodies);
+	server->step(1.0 / 60.0);
+
+	PhysicsDirectSpaceState3D *space_state = server->space_get_direct_state(space);
+	REQUIRE(space_state);
+
+	const int count = 100000;
+	RandomPCG rng(9);
+	Vector<Vector3> from;
+	Vector<Vector3> to;
+	for (int i = 0; i < count; i++) {
+		Vector3 origin(rng.randf() * size, 5, rng.randf() * size);
+		from.push_back(origin);
+		to.push_back(origin + Vector3(rng.randf() * 20.0 - 10.0, -10, rng.randf() * 20.0 - 10.0));
+	}
+
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+	Vector<PhysicsDirectSpaceState3D::RayResult> results;
+	results.resize(count);
+	Vector<bool> hits;
+	hits.resize(count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int single_hits = 0;
+	for (int i = 0; i < count; i++) {
+		parameters.from = from[i];
+		parameters.to = to[i];
+		single_hits += space_state->intersect_ray(parameters, results.write[i]);
+	}
+	print_line(vformat("%d single rays (%d hits): %d usec.", count, single_hits, OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	int batch_hits = space_state->intersect_ray_batch(parameters, from.ptr(), to.ptr(), count, results.ptrw(), hits.ptrw());
+	print_line(vformat("%d batched rays (%d hits): %d usec.", count, batch_hits, OS::get_singleton()->get_ticks_usec() - begin));
+
+	CHECK(single_hits == batch_hits);
+
+	for (const RID &body : bodies) {
+		server->free(body);
+	}
+	server->free(shape);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H
@@ -53,7 +53,11 @@
 #include "tests/core/math/test_aabb.h"
 #include "tests/core/math/test_astar.h"
 #include "tests/core/math/test_basis.h"
+#include "tests/core/math/test_batch_math.h"
+#include "tests/core/math/test_bvh.h"
 #include "tests/core/math/test_color.h"
+#include "tests/core/math/test_convex_hull.h"
+#include "tests/core/math/test_delaunay_3d.h"
 #include "tests/core/math/test_expression.h"
 #include "tests/core/math/test_geometry_2d.h"
 #include "tests/core/math/test_geometry_3d.h"
@@ -63,8 +67,10 @@
 #include "tests/core/math/test_random_number_generator.h"
 #include "tests/core/math/test_rect2.h"
 #include "tests/core/math/test_rect2i.h"
+#include "tests/core/math/test_static_raycaster.h"
 #include "tests/core/math/test_transform_2d.h"
 #include "tests/core/math/test_transform_3d.h"
+#include "tests/core/math/test_triangle_mesh.h"
 #include "tests/core/math/test_vector2.h"
 #include "tests/core/math/test_vector2i.h"
 #include "tests/core/math/test_vector3.h"
@@ -136,8 +142,11 @@
 #include "tests/scene/test_navigation_region_3d.h"
 #include "tests/scene/test_path_3d.h"
 #include "tests/scene/test_primitives.h"
+#include "tests/servers/physics_3d/test_godot_shape_3d.h"
 #include "tests/servers/test_navigation_server_2d.h"
 #include "tests/servers/test_navigation_server_3d.h"
+#include "tests/servers/test_physics_replay.h"
+#include "tests/servers/test_physics_server_3d.h"
 #endif // _3D_DISABLED
 
 #include "modules/modules_tests.gen.h"